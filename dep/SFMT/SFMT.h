@@ -39,6 +39,7 @@
 #include <emmintrin.h>                 // Define SSE2 intrinsics
 #include "randomc.h"                   // Define integer types etc
 #include <time.h>
+#include <string.h>
 #include <new>
 
 // Choose one of the possible Mersenne exponents.
@@ -249,6 +250,72 @@ public:
         return y;
     }
 
+    // Fill array with size random words straight from the recursion, like sfmt_fill_array32 of the
+    // reference implementation. array must be 16 byte aligned, size a multiple of 4 and at least SFMT_N*4,
+    // and every buffered word must be used (ix == SFMT_N*4). The sequence goes on from the end of array.
+    void FillArray32(uint32_t* array, int size)
+    {
+        __m128i* out = (__m128i*)array;
+        int count = size / 4;
+        int i, j;
+        __m128i r1, r2;
+
+        r1 = state[SFMT_N - 2];
+        r2 = state[SFMT_N - 1];
+        for (i = 0; i < SFMT_N - SFMT_M; i++) {
+            out[i] = sfmt_recursion(state[i], state[i + SFMT_M], r1, r2, mask);
+            r1 = r2;
+            r2 = out[i];
+        }
+        for (; i < SFMT_N; i++) {
+            out[i] = sfmt_recursion(state[i], out[i + SFMT_M - SFMT_N], r1, r2, mask);
+            r1 = r2;
+            r2 = out[i];
+        }
+        for (; i < count - SFMT_N; i++) {
+            out[i] = sfmt_recursion(out[i - SFMT_N], out[i + SFMT_M - SFMT_N], r1, r2, mask);
+            r1 = r2;
+            r2 = out[i];
+        }
+        for (j = 0; j < 2 * SFMT_N - count; j++) {
+            state[j] = out[j + count - SFMT_N];
+        }
+        for (; i < count; i++, j++) {
+            out[i] = sfmt_recursion(out[i - SFMT_N], out[i + SFMT_M - SFMT_N], r1, r2, mask);
+            r1 = r2;
+            r2 = out[i];
+            state[j] = out[i];
+        }
+        ix = SFMT_N*4;
+    }
+
+    // Output count random words, the same ones as count BRandom calls.
+    // Buffered words are copied out, whole aligned blocks go through FillArray32.
+    void BRandomFill(uint32_t* values, size_t count)
+    {
+        while (count) {
+            if (ix >= SFMT_N*4) {
+                size_t block = count & ~size_t(3);
+                if (block > 0x7FFFFFF0)
+                    block = 0x7FFFFFF0;
+                if (block >= SFMT_N*4 && !((size_t)values & 15)) {
+                    FillArray32(values, (int)block);
+                    values += block;
+                    count -= block;
+                    continue;
+                }
+                Generate();
+            }
+            size_t n = SFMT_N*4 - ix;
+            if (n > count)
+                n = count;
+            memcpy(values, (uint32_t*)state + ix, n * sizeof(uint32_t));
+            ix += (uint32_t)n;
+            values += n;
+            count -= n;
+        }
+    }
+
     void* operator new(size_t size, std::nothrow_t const&)
     {
         return _mm_malloc(size, 16);
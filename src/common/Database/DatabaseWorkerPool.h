@@ -288,6 +288,31 @@ public:
         return PreparedQueryResult(ret);
     }
 
+    //! Directly executes an SQL query in string format and hands every row to the callback while the rest is still
+    //! being received, nothing is buffered. Blocks the calling thread until finished, returns the number of rows.
+    //! Meant for big loads during startup: the connection stays busy until the last row, the callback must not
+    //! query this database synchronously (there may be no other connection) and should not take long per row.
+    uint64 StreamQuery(const char* sql, std::function<void(Field*)> const& callback)
+    {
+        T* t = GetFreeConnection();
+        uint64 rowCount = t->StreamQuery(sql, callback);
+        t->Unlock();
+        return rowCount;
+    }
+
+    //! Prepared statement version of StreamQuery(), same restrictions apply.
+    //! Statement must be prepared with CONNECTION_SYNCH flag.
+    uint64 StreamQuery(PreparedStatement* stmt, std::function<void(Field*)> const& callback)
+    {
+        T* t = GetFreeConnection();
+        uint64 rowCount = t->StreamQuery(stmt, callback);
+        t->Unlock();
+
+        //! Delete proxy-class. Not needed anymore
+        delete stmt;
+        return rowCount;
+    }
+
     /**
         Asynchronous query (with resultset) methods.
     */
@@ -36,8 +36,8 @@ uint8 Field::GetUInt8() const
 #endif
 
     if (data.raw)
-        return *reinterpret_cast<uint8*>(data.value);
-    return static_cast<uint8>(strtoul(static_cast<char*>(data.value), nullptr, 10));
+        return *reinterpret_cast<uint8 const*>(data.value);
+    return static_cast<uint8>(strtoul(static_cast<char const*>(data.value), nullptr, 10));
 }
 
 int8 Field::GetInt8() const
@@ -54,8 +54,8 @@ int8 Field::GetInt8() const
 #endif
 
     if (data.raw)
-        return *reinterpret_cast<int8*>(data.value);
-    return static_cast<int8>(strtol(static_cast<char*>(data.value), NULL, 10));
+        return *reinterpret_cast<int8 const*>(data.value);
+    return static_cast<int8>(strtol(static_cast<char const*>(data.value), NULL, 10));
 }
 
 uint16 Field::GetUInt16() const
@@ -72,8 +72,8 @@ uint16 Field::GetUInt16() const
 #endif
 
     if (data.raw)
-        return *reinterpret_cast<uint16*>(data.value);
-    return static_cast<uint16>(strtoul(static_cast<char*>(data.value), nullptr, 10));
+        return *reinterpret_cast<uint16 const*>(data.value);
+    return static_cast<uint16>(strtoul(static_cast<char const*>(data.value), nullptr, 10));
 }
 
 int16 Field::GetInt16() const
@@ -90,8 +90,8 @@ int16 Field::GetInt16() const
 #endif
 
     if (data.raw)
-        return *reinterpret_cast<int16*>(data.value);
-    return static_cast<int16>(strtol(static_cast<char*>(data.value), NULL, 10));
+        return *reinterpret_cast<int16 const*>(data.value);
+    return static_cast<int16>(strtol(static_cast<char const*>(data.value), NULL, 10));
 }
 
 uint32 Field::GetUInt32() const
@@ -108,8 +108,8 @@ uint32 Field::GetUInt32() const
 #endif
 
     if (data.raw)
-        return *reinterpret_cast<uint32*>(data.value);
-    return static_cast<uint32>(strtoul(static_cast<char*>(data.value), nullptr, 10));
+        return *reinterpret_cast<uint32 const*>(data.value);
+    return static_cast<uint32>(strtoul(static_cast<char const*>(data.value), nullptr, 10));
 }
 
 int32 Field::GetInt32() const
@@ -126,8 +126,8 @@ int32 Field::GetInt32() const
 #endif
 
     if (data.raw)
-        return *reinterpret_cast<int32*>(data.value);
-    return static_cast<int32>(strtol(static_cast<char*>(data.value), NULL, 10));
+        return *reinterpret_cast<int32 const*>(data.value);
+    return static_cast<int32>(strtol(static_cast<char const*>(data.value), NULL, 10));
 }
 
 uint64 Field::GetUInt64() const
@@ -144,8 +144,8 @@ uint64 Field::GetUInt64() const
 #endif
 
     if (data.raw)
-        return *reinterpret_cast<uint64*>(data.value);
-    return static_cast<uint64>(strtoull(static_cast<char*>(data.value), nullptr, 10));
+        return *reinterpret_cast<uint64 const*>(data.value);
+    return static_cast<uint64>(strtoull(static_cast<char const*>(data.value), nullptr, 10));
 }
 
 int64 Field::GetInt64() const
@@ -162,8 +162,8 @@ int64 Field::GetInt64() const
 #endif
 
     if (data.raw)
-        return *reinterpret_cast<int64*>(data.value);
-    return static_cast<int64>(strtoll(static_cast<char*>(data.value), NULL, 10));
+        return *reinterpret_cast<int64 const*>(data.value);
+    return static_cast<int64>(strtoll(static_cast<char const*>(data.value), NULL, 10));
 }
 
 float Field::GetFloat() const
@@ -180,8 +180,8 @@ float Field::GetFloat() const
 #endif
 
     if (data.raw)
-        return *reinterpret_cast<float*>(data.value);
-    return static_cast<float>(atof(static_cast<char*>(data.value)));
+        return *reinterpret_cast<float const*>(data.value);
+    return static_cast<float>(atof(static_cast<char const*>(data.value)));
 }
 
 double Field::GetDouble() const
@@ -198,8 +198,8 @@ double Field::GetDouble() const
 #endif
 
     if (data.raw)
-        return *reinterpret_cast<double*>(data.value);
-    return static_cast<double>(atof(static_cast<char*>(data.value)));
+        return *reinterpret_cast<double const*>(data.value);
+    return static_cast<double>(atof(static_cast<char const*>(data.value)));
 }
 
 char const* Field::GetCString() const
@@ -253,51 +253,25 @@ Field::Field()
     data.raw = false;
 }
 
-Field::~Field()
+void Field::SetByteValue(void const* newValue, enum_field_types newType, uint32 length)
 {
-    CleanUp();
-}
-
-void Field::SetByteValue(const void* newValue, const size_t newSize, enum_field_types newType, uint32 length)
-{
-    if (data.value)
-        CleanUp();
-
     // This value stores raw bytes that have to be explicitly cast later
-    if (newValue)
-    {
-        data.value = new char[newSize];
-        memcpy(data.value, newValue, newSize);
-        data.length = length;
-    }
+    data.value = newValue;
+    data.length = newValue ? length : 0;
     data.type = newType;
     data.raw = true;
 }
 
-void Field::SetStructuredValue(char* newValue, enum_field_types newType, uint32 length)
+void Field::SetStructuredValue(char const* newValue, enum_field_types newType, uint32 length)
 {
-    if (data.value)
-        CleanUp();
-
-    // This value stores somewhat structured data that needs function style casting
-    if (newValue)
-    {
-        data.value = new char[length + 1];
-        memcpy(data.value, newValue, length);
-        *(reinterpret_cast<char*>(data.value) + length) = '\0';
-        data.length = length;
-    }
-
+    // This value stores somewhat structured data that needs function style casting,
+    // the client library terminates every value of a row with '\0'
+    data.value = newValue;
+    data.length = newValue ? length : 0;
     data.type = newType;
     data.raw = false;
 }
 
-void Field::CleanUp()
-{
-    delete[]static_cast<char*>(data.value);
-    data.value = NULL;
-}
-
 size_t Field::SizeForType(MYSQL_FIELD* field)
 {
     switch (field->type)
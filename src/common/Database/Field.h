@@ -23,6 +23,10 @@
 
 #include <mysql.h>
 
+/*
+ * View of one value of the current row. Fields don't own their data, it lives in the
+ * result set (or the client library's row buffer) and is only valid as long as the row is.
+ */
 class Field
 {
     friend class ResultSet;
@@ -47,7 +51,6 @@ public:
 
 protected:
     Field();
-    ~Field();
 
 #if defined(__GNUC__)
 #pragma pack(1)
@@ -57,7 +60,7 @@ protected:
     struct
     {
         uint32 length;          // Length (prepared strings only)
-        void* value;            // Actual data in memory
+        void const* value;      // Actual data, owned by the result set
         enum_field_types type;  // Field type
         bool raw;               // Raw bytes? (Prepared statement or ad hoc)
     } data;
@@ -67,10 +70,8 @@ protected:
 #pragma pack(pop)
 #endif
 
-    void SetByteValue(void const* newValue, size_t newSize, enum_field_types newType, uint32 length);
-    void SetStructuredValue(char* newValue, enum_field_types newType, uint32 length);
-
-    void CleanUp();
+    void SetByteValue(void const* newValue, enum_field_types newType, uint32 length);
+    void SetStructuredValue(char const* newValue, enum_field_types newType, uint32 length);
 
     static size_t SizeForType(MYSQL_FIELD* field);
 
@@ -351,6 +351,12 @@ void CharacterDatabaseConnection::DoPrepareStatements()
 
     PrepareStatement(CHAR_INS_AURA_EFFECT, "INSERT INTO character_aura_effect (guid, slot, effect, baseamount, amount) "
     "VALUES (?, ?, ?, ?, ?)",  CONNECTION_ASYNC);
+    PrepareStatement(CHAR_UPD_AURA, "UPDATE character_aura SET recalculate_mask = ?, stackcount = ?, maxduration = ?, remaintime = ?, remaincharges = ? WHERE guid = ? AND slot = ?", CONNECTION_ASYNC);
+    PrepareStatement(CHAR_UPD_AURA_EFFECT, "UPDATE character_aura_effect SET baseamount = ?, amount = ? WHERE guid = ? AND slot = ? AND effect = ?", CONNECTION_ASYNC);
+    PrepareStatement(CHAR_DEL_AURA_BY_SLOT, "DELETE FROM character_aura WHERE guid = ? AND slot = ?", CONNECTION_ASYNC);
+    PrepareStatement(CHAR_DEL_AURA_EFFECT_BY_SLOT, "DELETE FROM character_aura_effect WHERE guid = ? AND slot = ?", CONNECTION_ASYNC);
+    PrepareStatement(CHAR_UPD_SLOTLESS_AURA, "UPDATE character_aura SET recalculate_mask = ?, stackcount = ?, maxduration = ?, remaintime = ?, remaincharges = ? WHERE guid = ? AND slot = ? AND caster_guid = ? AND spell = ? AND effect_mask = ?", CONNECTION_ASYNC);
+    PrepareStatement(CHAR_DEL_SLOTLESS_AURA, "DELETE FROM character_aura WHERE guid = ? AND slot = ? AND caster_guid = ? AND spell = ? AND effect_mask = ?", CONNECTION_ASYNC);
 
     // Currency
     PrepareStatement(CHAR_SEL_PLAYER_CURRENCY, "SELECT currency, week_count, total_count, season_total, flags, curentcap FROM character_currency WHERE guid = ?", CONNECTION_ASYNC);
@@ -309,6 +309,12 @@ enum CharacterDatabaseStatements
 
     CHAR_INS_AURA,
     CHAR_INS_AURA_EFFECT,
+    CHAR_UPD_AURA,
+    CHAR_UPD_AURA_EFFECT,
+    CHAR_DEL_AURA_BY_SLOT,
+    CHAR_DEL_AURA_EFFECT_BY_SLOT,
+    CHAR_UPD_SLOTLESS_AURA,
+    CHAR_DEL_SLOTLESS_AURA,
 
     CHAR_SEL_PLAYER_CURRENCY,
     CHAR_UPD_PLAYER_CURRENCY,
@@ -514,6 +514,64 @@ PreparedResultSet* MySQLConnection::Query(PreparedStatement* stmt)
     return new PreparedResultSet(res.m_stmt->GetSTMT(), result, rowCount, fieldCount);
 }
 
+uint64 MySQLConnection::StreamQuery(const char* sql, std::function<void(Field*)> const& callback)
+{
+    if (!sql || !m_Mysql)
+        return 0;
+
+    if (mysql_query(m_Mysql, sql))
+    {
+        uint32 lErrno = mysql_errno(m_Mysql);
+        TC_LOG_INFO(LOG_FILTER_SQL, "SQL: %s", sql);
+        TC_LOG_ERROR(LOG_FILTER_SQL, "[%u] %s", lErrno, mysql_error(m_Mysql));
+
+        if (_HandleMySQLErrno(lErrno))      // If it returns true, an error was handled successfully (i.e. reconnection)
+            return StreamQuery(sql, callback);    // We try again
+
+        return 0;
+    }
+
+    //- Rows are read from the connection as they are fetched instead of being stored first
+    MYSQL_RES* result = mysql_use_result(m_Mysql);
+    if (!result)
+        return 0;
+
+    uint64 rowCount = 0;
+    ResultSet resultSet(result, mysql_fetch_fields(result), 0, mysql_num_fields(result));
+    while (resultSet.NextRow())
+    {
+        callback(resultSet.Fetch());
+        ++rowCount;
+    }
+
+    if (uint32 lErrno = mysql_errno(m_Mysql))
+        TC_LOG_ERROR(LOG_FILTER_SQL, "SQL: %s\n [ERROR]: [%u] %s (stopped after " UI64FMTD " rows)", sql, lErrno, mysql_error(m_Mysql), rowCount);
+
+    return rowCount;
+}
+
+uint64 MySQLConnection::StreamQuery(PreparedStatement* stmt, std::function<void(Field*)> const& callback)
+{
+    MYSQL_RES *result = NULL;
+    uint64 rowCount = 0;
+    uint32 fieldCount = 0;
+
+    QResult res = _Query(stmt, &result, &rowCount, &fieldCount);
+    if (!res.res)
+        return 0;
+
+    PreparedResultSet resultSet(res.m_stmt->GetSTMT(), result, 0, fieldCount, true);
+    while (resultSet.NextRow())
+        callback(resultSet.Fetch());
+
+    if (mysql_more_results(m_Mysql))
+    {
+        mysql_next_result(m_Mysql);
+    }
+
+    return resultSet.GetRowCount();
+}
+
 bool MySQLConnection::_HandleMySQLErrno(uint32 errNo)
 {
     switch (errNo)
@@ -19,6 +19,7 @@
 #include "Transaction.h"
 #include "Util.h"
 #include "ProducerConsumerQueue.h"
+#include <functional>
 
 #ifndef _MYSQLCONNECTION_H
 #define _MYSQLCONNECTION_H
@@ -103,6 +104,8 @@ class MySQLConnection
         bool Execute(PreparedStatement* stmt);
         ResultSet* Query(const char* sql);
         PreparedResultSet* Query(PreparedStatement* stmt);
+        uint64 StreamQuery(const char* sql, std::function<void(Field*)> const& callback);
+        uint64 StreamQuery(PreparedStatement* stmt, std::function<void(Field*)> const& callback);
         bool _Query(const char *sql, MYSQL_RES **pResult, MYSQL_FIELD **pFields, uint64* pRowCount, uint32* pFieldCount);
         QResult _Query(PreparedStatement* stmt, MYSQL_RES **pResult, uint64* pRowCount, uint32* pFieldCount);
 
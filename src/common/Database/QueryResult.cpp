@@ -18,6 +18,7 @@
 
 #include "DatabaseEnv.h"
 #include "Log.h"
+#include <algorithm>
 
 ResultSet::ResultSet(MYSQL_RES *result, MYSQL_FIELD *fields, uint64 rowCount, uint32 fieldCount) :
     _rowCount(rowCount),
@@ -29,10 +30,44 @@ ResultSet::ResultSet(MYSQL_RES *result, MYSQL_FIELD *fields, uint64 rowCount, ui
     ASSERT(_currentRow);
 }
 
-PreparedResultSet::PreparedResultSet(MYSQL_STMT* stmt, MYSQL_RES *result, uint64 rowCount, uint32 fieldCount) :
+namespace
+{
+    // streamed results don't know the longest value of a column yet, longer values are fetched on their own
+    std::size_t const StreamedValueBufferSize = 1024;
+
+    std::size_t Align(std::size_t offset)
+    {
+        return (offset + 7) & ~std::size_t(7);
+    }
+
+    bool IsStringType(enum_field_types type)
+    {
+        switch (type)
+        {
+            case MYSQL_TYPE_TINY_BLOB:
+            case MYSQL_TYPE_MEDIUM_BLOB:
+            case MYSQL_TYPE_LONG_BLOB:
+            case MYSQL_TYPE_BLOB:
+            case MYSQL_TYPE_STRING:
+            case MYSQL_TYPE_VAR_STRING:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool IsVariableLength(enum_field_types type)
+    {
+        return IsStringType(type) || type == MYSQL_TYPE_DECIMAL || type == MYSQL_TYPE_NEWDECIMAL;
+    }
+}
+
+PreparedResultSet::PreparedResultSet(MYSQL_STMT* stmt, MYSQL_RES *result, uint64 rowCount, uint32 fieldCount, bool streamed) :
     m_rowCount(rowCount),
     m_rowPosition(0),
     m_fieldCount(fieldCount),
+    m_currentRow(NULL),
+    m_streamed(streamed),
     m_rBind(NULL),
     m_stmt(stmt),
     m_res(result),
@@ -56,83 +91,99 @@ PreparedResultSet::PreparedResultSet(MYSQL_STMT* stmt, MYSQL_RES *result, uint64
     memset(m_rBind, 0, sizeof(MYSQL_BIND) * m_fieldCount);
     memset(m_length, 0, sizeof(unsigned long) * m_fieldCount);
 
-    //- This is where we store the (entire) resultset
-    if (mysql_stmt_store_result(m_stmt))
+    //- This is where we store the (entire) resultset, streamed results are read row by row in NextRow()
+    if (!m_streamed && mysql_stmt_store_result(m_stmt))
     {
         TC_LOG_WARN(LOG_FILTER_SQL, "%s:mysql_stmt_store_result, cannot bind result from MySQL server. Error: %s", __FUNCTION__, mysql_stmt_error(m_stmt));
+        m_rowCount = 0;
+        CleanUp();
         return;
     }
 
-    //- This is where we prepare the buffer based on metadata
-    uint32 i = 0;
-    MYSQL_FIELD* field = mysql_fetch_field(m_res);
-    while (field)
+    //- This is where we prepare the buffers based on metadata, all of them in one block
+    m_columns.resize(m_fieldCount);
+    m_truncated.resize(m_fieldCount);
+
+    std::vector<std::size_t> bufferOffsets(m_fieldCount);
+    std::size_t bufferSize = 0;
+    MYSQL_FIELD* fields = mysql_fetch_fields(m_res);
+    for (uint32 i = 0; i < m_fieldCount; ++i)
     {
-        size_t size = Field::SizeForType(field);
+        MYSQL_FIELD* field = &fields[i];
+        std::size_t size = Field::SizeForType(field);
+
+        Column& column = m_columns[i];
+        column.Type = field->type;
+        column.Offset = 0;
+        column.Variable = IsVariableLength(field->type);
+        column.Width = column.Variable ? sizeof(StringCell) : size;
+
+        // max_length is only set by mysql_stmt_store_result()
+        if (m_streamed && column.Variable)
+            size = std::max(size, std::min<std::size_t>(field->length, StreamedValueBufferSize) + 1);
+
+        bufferOffsets[i] = bufferSize;
+        bufferSize = Align(bufferSize + size);
 
         m_rBind[i].buffer_type = field->type;
-        m_rBind[i].buffer = malloc(size);
-        memset(m_rBind[i].buffer, 0, size);
         m_rBind[i].buffer_length = size;
         m_rBind[i].length = &m_length[i];
         m_rBind[i].is_null = &m_isNull[i];
         m_rBind[i].error = NULL;
         m_rBind[i].is_unsigned = field->flags & UNSIGNED_FLAG;
-
-        ++i;
-        field = mysql_fetch_field(m_res);
     }
 
+    m_bindBuffer.assign(bufferSize, 0);
+    for (uint32 i = 0; i < m_fieldCount; ++i)
+        m_rBind[i].buffer = m_bindBuffer.data() + bufferOffsets[i];
+
     //- This is where we bind the bind the buffer to the statement
     if (mysql_stmt_bind_result(m_stmt, m_rBind))
     {
         TC_LOG_WARN(LOG_FILTER_SQL, "%s:mysql_stmt_bind_result, cannot bind result from MySQL server. Error: %s", __FUNCTION__, mysql_stmt_error(m_stmt));
-        delete[] m_rBind;
         delete[] m_isNull;
         delete[] m_length;
+        m_isNull = NULL;
+        m_length = NULL;
+        m_rowCount = 0;
+        CleanUp();
+        return;
+    }
+
+    m_currentRow = new Field[m_fieldCount];
+
+    if (m_streamed)
+    {
+        m_rowCount = 0;
         return;
     }
 
     m_rowCount = mysql_stmt_num_rows(m_stmt);
 
-    m_rows.resize(uint32(m_rowCount));
-    while (_NextRow())
+    //- Null flags of every row first, then the cells of each column
+    std::size_t arenaSize = Align(std::size_t(m_rowCount) * m_fieldCount);
+    for (Column& column : m_columns)
     {
-        m_rows[uint32(m_rowPosition)] = new Field[m_fieldCount];
-        for (uint64 fIndex = 0; fIndex < m_fieldCount; ++fIndex)
-        {
-            if (!*m_rBind[fIndex].is_null)
-                m_rows[uint32(m_rowPosition)][fIndex].SetByteValue(m_rBind[fIndex].buffer,
-                    m_rBind[fIndex].buffer_length,
-                    m_rBind[fIndex].buffer_type,
-                    *m_rBind[fIndex].length);
-            else
-                switch (m_rBind[fIndex].buffer_type)
-                {
-                case MYSQL_TYPE_TINY_BLOB:
-                case MYSQL_TYPE_MEDIUM_BLOB:
-                case MYSQL_TYPE_LONG_BLOB:
-                case MYSQL_TYPE_BLOB:
-                case MYSQL_TYPE_STRING:
-                case MYSQL_TYPE_VAR_STRING:
-                    m_rows[uint32(m_rowPosition)][fIndex].SetByteValue("",
-                        m_rBind[fIndex].buffer_length,
-                        m_rBind[fIndex].buffer_type,
-                        *m_rBind[fIndex].length);
-                    break;
-                default:
-                    m_rows[uint32(m_rowPosition)][fIndex].SetByteValue(0,
-                        m_rBind[fIndex].buffer_length,
-                        m_rBind[fIndex].buffer_type,
-                        *m_rBind[fIndex].length);
-                }
-        }
-        m_rowPosition++;
+        column.Offset = arenaSize;
+        arenaSize = Align(arenaSize + column.Width * std::size_t(m_rowCount));
     }
-    m_rowPosition = 0;
+
+    m_arena.resize(arenaSize);
+
+    uint64 row = 0;
+    while (row < m_rowCount && _NextRow())
+        StoreRow(row++);
+
+    m_rowCount = row;
+
+    // numeric getters used on short strings don't read past the arena
+    m_arena.resize(m_arena.size() + sizeof(uint64));
 
     /// All data is buffered, let go of mysql c api structures
     CleanUp();
+
+    if (m_rowCount)
+        ReadRow(0);
 }
 
 ResultSet::~ResultSet()
@@ -142,8 +193,8 @@ ResultSet::~ResultSet()
 
 PreparedResultSet::~PreparedResultSet()
 {
-    for (uint32 i = 0; i < uint32(m_rowCount); ++i)
-        delete[] m_rows[i];
+    CleanUp();
+    delete[] m_currentRow;
 }
 
 bool ResultSet::NextRow()
@@ -195,11 +246,23 @@ const Field& ResultSet::operator[](uint32 index) const
 
 bool PreparedResultSet::NextRow()
 {
-    /// Only updates the m_rowPosition so upper level code knows in which element
-    /// of the rows vector to look
+    if (m_streamed)
+    {
+        if (!m_rBind || !_NextRow())
+        {
+            CleanUp();
+            return false;
+        }
+
+        ++m_rowCount;
+        ReadStreamedRow();
+        return true;
+    }
+
     if (++m_rowPosition >= m_rowCount)
         return false;
 
+    ReadRow(m_rowPosition);
     return true;
 }
 
@@ -216,27 +279,111 @@ uint32 PreparedResultSet::GetFieldCount() const
 Field* PreparedResultSet::Fetch() const
 {
     ASSERT(m_rowPosition < m_rowCount);
-    return m_rows[uint32(m_rowPosition)];
+    return m_currentRow;
 }
 
 const Field& PreparedResultSet::operator[](uint32 index) const
 {
     ASSERT(m_rowPosition < m_rowCount);
     ASSERT(index < m_fieldCount);
-    return m_rows[uint32(m_rowPosition)][index];
+    return m_currentRow[index];
 }
 
 bool PreparedResultSet::_NextRow()
 {
-    /// Only called in low-level code, namely the constructor
-    /// Will iterate over every row of data and buffer it
-    if (m_rowPosition >= m_rowCount)
-        return false;
-
+    /// Only called in low-level code, fetches the next row into the bind buffers
     int retval = mysql_stmt_fetch(m_stmt);
+    if (retval == 1)
+        TC_LOG_WARN(LOG_FILTER_SQL, "%s:mysql_stmt_fetch, cannot fetch row from MySQL server. Error: %s", __FUNCTION__, mysql_stmt_error(m_stmt));
+
     return retval == 0 || retval == MYSQL_DATA_TRUNCATED;
 }
 
+char const* PreparedResultSet::GetColumnValue(uint32 index)
+{
+    // a value filling the whole buffer has no terminator
+    if (m_length[index] < m_rBind[index].buffer_length)
+        return static_cast<char const*>(m_rBind[index].buffer);
+
+    std::vector<char>& buffer = m_truncated[index];
+    buffer.assign(m_length[index] + 1, '\0');
+
+    unsigned long length = 0;
+    MYSQL_BIND bind;
+    memset(&bind, 0, sizeof(MYSQL_BIND));
+    bind.buffer_type = m_rBind[index].buffer_type;
+    bind.buffer = buffer.data();
+    bind.buffer_length = m_length[index];
+    bind.length = &length;
+
+    if (mysql_stmt_fetch_column(m_stmt, &bind, index, 0))
+        TC_LOG_WARN(LOG_FILTER_SQL, "%s:mysql_stmt_fetch_column, cannot fetch truncated value. Error: %s", __FUNCTION__, mysql_stmt_error(m_stmt));
+
+    return buffer.data();
+}
+
+void PreparedResultSet::StoreRow(uint64 row)
+{
+    for (uint32 i = 0; i < m_fieldCount; ++i)
+    {
+        m_arena[std::size_t(row) * m_fieldCount + i] = m_isNull[i] ? 1 : 0;
+        if (m_isNull[i])
+            continue;
+
+        Column const& column = m_columns[i];
+        std::size_t cellOffset = column.Offset + column.Width * std::size_t(row);
+        if (!column.Variable)
+        {
+            memcpy(m_arena.data() + cellOffset, m_rBind[i].buffer, column.Width);
+            continue;
+        }
+
+        char const* value = GetColumnValue(i);
+
+        StringCell cell;
+        cell.Offset = m_arena.size();
+        cell.Length = uint32(m_length[i]);
+        m_arena.insert(m_arena.end(), value, value + cell.Length);
+        m_arena.push_back('\0');
+        memcpy(m_arena.data() + cellOffset, &cell, sizeof(StringCell));
+    }
+}
+
+void PreparedResultSet::ReadRow(uint64 row)
+{
+    for (uint32 i = 0; i < m_fieldCount; ++i)
+    {
+        Column const& column = m_columns[i];
+        char const* cell = m_arena.data() + column.Offset + column.Width * std::size_t(row);
+
+        if (m_arena[std::size_t(row) * m_fieldCount + i])
+            m_currentRow[i].SetByteValue(IsStringType(column.Type) ? "" : NULL, column.Type, 0);
+        else if (column.Variable)
+        {
+            StringCell stringCell;
+            memcpy(&stringCell, cell, sizeof(StringCell));
+            m_currentRow[i].SetByteValue(m_arena.data() + stringCell.Offset, column.Type, stringCell.Length);
+        }
+        else
+            m_currentRow[i].SetByteValue(cell, column.Type, uint32(column.Width));
+    }
+}
+
+void PreparedResultSet::ReadStreamedRow()
+{
+    for (uint32 i = 0; i < m_fieldCount; ++i)
+    {
+        Column const& column = m_columns[i];
+
+        if (m_isNull[i])
+            m_currentRow[i].SetByteValue(IsStringType(column.Type) ? "" : NULL, column.Type, 0);
+        else if (column.Variable)
+            m_currentRow[i].SetByteValue(GetColumnValue(i), column.Type, uint32(m_length[i]));
+        else
+            m_currentRow[i].SetByteValue(m_rBind[i].buffer, column.Type, uint32(column.Width));
+    }
+}
+
 void ResultSet::CleanUp()
 {
     if (_currentRow)
@@ -254,18 +401,22 @@ void ResultSet::CleanUp()
 
 void PreparedResultSet::CleanUp()
 {
+    if (!m_rBind)
+        return;
+
     /// More of the in our code allocated sources are deallocated by the poorly documented mysql c api
     if (m_res)
+    {
         mysql_free_result(m_res);
+        m_res = NULL;
+    }
 
-    FreeBindBuffer();
     mysql_stmt_free_result(m_stmt);
 
     delete[] m_rBind;
-}
+    m_rBind = NULL;
 
-void PreparedResultSet::FreeBindBuffer()
-{
-    for (uint32 i = 0; i < m_fieldCount; ++i)
-        free(m_rBind[i].buffer);
+    // streamed rows point into these, they are not read after the last row
+    std::vector<char>().swap(m_bindBuffer);
+    m_truncated.clear();
 }
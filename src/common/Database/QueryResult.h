@@ -55,10 +55,17 @@ private:
     ResultSet& operator=(ResultSet const& right) = delete;
 };
 
+/*
+ * Buffered results are copied into one arena per result set: the null flags, then every
+ * column's fixed size cells one column after the other, then the bytes of strings, blobs
+ * and decimals that their cells point at. Fetch() returns views into the current row.
+ * Streamed results (see MySQLConnection::StreamQuery) are not buffered at all, every
+ * NextRow() fetches the next row from the server and Fetch() points into the bind buffers.
+ */
 class PreparedResultSet
 {
 public:
-    PreparedResultSet(MYSQL_STMT* stmt, MYSQL_RES* result, uint64 rowCount, uint32 fieldCount);
+    PreparedResultSet(MYSQL_STMT* stmt, MYSQL_RES* result, uint64 rowCount, uint32 fieldCount, bool streamed = false);
     ~PreparedResultSet();
 
     bool NextRow();
@@ -68,12 +75,32 @@ public:
     const Field& operator [](uint32 index) const;
 
 protected:
-    std::vector<Field*> m_rows;
     uint64 m_rowCount;
     uint64 m_rowPosition;
     uint32 m_fieldCount;
+    Field* m_currentRow;
 
 private:
+    struct Column
+    {
+        enum_field_types Type;
+        std::size_t Offset;     // of the first cell in the arena
+        std::size_t Width;      // of one cell
+        bool Variable;          // cell is a StringCell
+    };
+
+    struct StringCell
+    {
+        std::size_t Offset;
+        uint32 Length;
+    };
+
+    std::vector<Column> m_columns;
+    std::vector<char> m_arena;
+    std::vector<char> m_bindBuffer;
+    std::vector<std::vector<char>> m_truncated;
+    bool m_streamed;
+
     MYSQL_BIND* m_rBind;
     MYSQL_STMT* m_stmt;
     MYSQL_RES* m_res;
@@ -81,7 +108,10 @@ private:
     my_bool* m_isNull;
     unsigned long* m_length;
 
-    void FreeBindBuffer();
+    void StoreRow(uint64 row);
+    void ReadRow(uint64 row);
+    void ReadStreamedRow();
+    char const* GetColumnValue(uint32 index);
     void CleanUp();
     bool _NextRow();
 
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2008-2016 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Lock free queue for exactly one producer and one consumer thread. Items are stored
+ * in a chain of fixed size ring segments, the producer links a new segment when the
+ * current one is full and the consumer hands emptied segments back through a single
+ * spare slot, so a queue that doesn't grow doesn't allocate.
+ * T should be cheap to copy (pointers, small structs); items left in the queue
+ * when it is destroyed are not cleaned up.
+ */
+template <typename T, std::size_t SegmentSize = 256>
+class SPSCQueue
+{
+    struct Segment
+    {
+        T Slots[SegmentSize];
+        Segment* Next = nullptr;
+    };
+
+public:
+    SPSCQueue() : _tail(new Segment()), _tailIndex(0), _pushed(0), _head(_tail), _headIndex(0), _popped(0), _spare(nullptr) { }
+
+    ~SPSCQueue()
+    {
+        while (_head)
+        {
+            Segment* next = _head->Next;
+            delete _head;
+            _head = next;
+        }
+
+        delete _spare.load();
+    }
+
+    SPSCQueue(SPSCQueue const&) = delete;
+    SPSCQueue& operator=(SPSCQueue const&) = delete;
+
+    //! Producer only.
+    void Push(T const& value)
+    {
+        if (_tailIndex == SegmentSize)
+        {
+            Segment* segment = _spare.exchange(nullptr, std::memory_order_acquire);
+            if (segment)
+                segment->Next = nullptr;
+            else
+                segment = new Segment();
+
+            // published together with the item by the store below
+            _tail->Next = segment;
+            _tail = segment;
+            _tailIndex = 0;
+        }
+
+        _tail->Slots[_tailIndex++] = value;
+        _pushed.store(_pushed.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    //! Consumer only. Oldest item or nullptr, stays valid until Pop().
+    T* Front()
+    {
+        if (_popped.load(std::memory_order_relaxed) == _pushed.load(std::memory_order_acquire))
+            return nullptr;
+
+        if (_headIndex == SegmentSize)
+        {
+            // there is an item past this segment, so the producer is done with it
+            Segment* segment = _head;
+            _head = _head->Next;
+            _headIndex = 0;
+
+            Segment* expected = nullptr;
+            if (!_spare.compare_exchange_strong(expected, segment, std::memory_order_release, std::memory_order_relaxed))
+                delete segment;
+        }
+
+        return &_head->Slots[_headIndex];
+    }
+
+    //! Consumer only, after Front() returned an item.
+    void Pop()
+    {
+        ++_headIndex;
+        _popped.store(_popped.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    //! Either thread, exact only on the consumer.
+    std::size_t Size() const
+    {
+        uint64_t popped = _popped.load(std::memory_order_acquire);
+        return std::size_t(_pushed.load(std::memory_order_acquire) - popped);
+    }
+
+private:
+    // producer
+    Segment* _tail;
+    std::size_t _tailIndex;
+    std::atomic<uint64_t> _pushed;
+
+    // consumer
+    Segment* _head;
+    std::size_t _headIndex;
+    std::atomic<uint64_t> _popped;
+
+    std::atomic<Segment*> _spare;
+};
+
+#endif
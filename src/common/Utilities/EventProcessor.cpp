@@ -27,25 +27,48 @@ BasicEvent::BasicEvent()
 
 EventProcessor::EventProcessor()
 {
-    m_time = 0;
+    m_hasQueued = false;
 }
 
 EventProcessor::~EventProcessor()
 {
+    SetTimerWheel(nullptr);
     KillAllEvents(true);
 }
 
 void EventProcessor::Update(uint32 p_time)
 {
+    if (IsOnTimerWheel())
+        return;
+
     //move from queue
     AddEventsFromQueue();
 
     // update time
-    m_time += p_time;
+    AdvanceLocalTime(p_time);
+
+    RunDueEvents(p_time);
+}
+
+void EventProcessor::OnWake()
+{
+    AddEventsFromQueue();
+    ArmTimer(m_events.empty() ? 0 : m_events.begin()->first);
+}
+
+void EventProcessor::OnTimer(uint32 diff)
+{
+    RunDueEvents(diff);
+    ArmTimer(m_events.empty() ? 0 : m_events.begin()->first);
+}
+
+void EventProcessor::RunDueEvents(uint32 p_time)
+{
+    uint64 now = GetProcessorTime();
 
     // main event loop
     EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    while (((i = m_events.begin()) != m_events.end()) && i->first <= now)
     {
         // get and remove event from queue
         BasicEvent* Event = i->second;
@@ -53,7 +76,7 @@ void EventProcessor::Update(uint32 p_time)
 
         if (!Event->to_Abort)
         {
-            if (Event->Execute(m_time, p_time))
+            if (Event->Execute(now, p_time))
             {
                 // completely destroy event if it is not re-added
                 delete Event;
@@ -61,7 +84,7 @@ void EventProcessor::Update(uint32 p_time)
         }
         else
         {
-            Event->Abort(m_time);
+            Event->Abort(now);
             delete Event;
         }
     }
@@ -79,7 +102,7 @@ void EventProcessor::KillAllEvents(bool force)
         if (i_old->second)
         {
             i_old->second->to_Abort = true;
-            i_old->second->Abort(m_time);
+            i_old->second->Abort(GetProcessorTime());
         }
 
         if (force || !i_old->second || i_old->second->IsDeletable())
@@ -99,17 +122,24 @@ void EventProcessor::KillAllEvents(bool force)
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
 {
     std::lock_guard<std::recursive_mutex> _queue_lock(m_queue_lock);
-    if (set_addtime) Event->m_addTime = m_time;
+    if (set_addtime) Event->m_addTime = GetProcessorTime();
     Event->m_execTime = e_time;
     m_events_queue.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    if (!m_hasQueued)
+        RequestWake();
+    m_hasQueued = true;
 }
 
 void EventProcessor::AddEventsFromQueue()
 {
+    if (!m_hasQueued)
+        return;
+
     EventList tempEvents;
     {
         std::lock_guard<std::recursive_mutex> _queue_lock(m_queue_lock);
         std::swap(tempEvents, m_events_queue);
+        m_hasQueued = false;
     }
     EventList::iterator itr = tempEvents.begin();
     for(; itr != tempEvents.end(); ++itr)
@@ -121,6 +151,6 @@ void EventProcessor::AddEventsFromQueue()
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset) const
 {
-    return(m_time + t_offset);
+    return(GetProcessorTime() + t_offset);
 }
 
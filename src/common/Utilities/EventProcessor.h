@@ -20,6 +20,8 @@
 #define __EVENTPROCESSOR_H
 
 #include "Define.h"
+#include "TimerWheel.h"
+#include <atomic>
 #include <mutex>
 
 #include <map>
@@ -52,25 +54,28 @@ class BasicEvent
 
 typedef std::multimap<uint64, BasicEvent*> EventList;
 
-class EventProcessor
+class EventProcessor : public WheelProcessor
 {
     public:
         EventProcessor();
         ~EventProcessor();
 
-        void Update(uint32 p_time);
+        void Update(uint32 p_time);                         // does nothing while on a timer wheel, the wheel runs the events then
         void KillAllEvents(bool force);
         void AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime = true);
         void AddEventsFromQueue();
         uint64 CalculateTime(uint64 t_offset) const;
         bool Empty() const { return m_events.empty(); }
         uint32 Size() const { return m_events.size(); }
-        uint32 SizeQueue() const { return m_events_queue.size(); }
+        uint32 SizeQueue() const { return m_hasQueued ? m_events_queue.size() : 0; }
 
     protected:
-        uint64 m_time;
+        void OnWake() override;
+        void OnTimer(uint32 diff) override;
+        void RunDueEvents(uint32 p_time);
+
         EventList m_events{};
         EventList m_events_queue{};
-        std::recursive_mutex m_queue_lock;
+        std::atomic<bool> m_hasQueued;                      // lets idle owners skip the queue lock every update
 };
 #endif
\ No newline at end of file
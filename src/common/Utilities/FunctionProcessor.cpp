@@ -20,21 +20,25 @@
 
 FunctionProcessor::FunctionProcessor()
 {
-    m_time = 0;
+    m_hasQueued = false;
     clean = false;
 }
 
 FunctionProcessor::~FunctionProcessor()
 {
+    SetTimerWheel(nullptr);
 }
 
 void FunctionProcessor::Update(uint32 p_time)
 {
+    if (IsOnTimerWheel())
+        return;
+
     //move from queue
     AddFunctionsFromQueue();
 
     // update time
-    m_time += p_time;
+    AdvanceLocalTime(p_time);
 
     if (clean)
     {
@@ -43,12 +47,38 @@ void FunctionProcessor::Update(uint32 p_time)
         return;
     }
 
+    RunDueFunctions();
+}
+
+void FunctionProcessor::OnWake()
+{
+    AddFunctionsFromQueue();
+
+    if (clean)
+    {
+        m_functions.clear();
+        clean = false;
+    }
+
+    ArmTimer(m_functions.empty() ? 0 : m_functions.begin()->first);
+}
+
+void FunctionProcessor::OnTimer(uint32 /*diff*/)
+{
+    RunDueFunctions();
+    ArmTimer(m_functions.empty() ? 0 : m_functions.begin()->first);
+}
+
+void FunctionProcessor::RunDueFunctions()
+{
     if (m_functions.empty())
         return;
 
+    uint64 now = GetProcessorTime();
+
     // main event loop
     FunctionList::iterator i;
-    while (((i = m_functions.begin()) != m_functions.end()) && i->first <= m_time)
+    while (((i = m_functions.begin()) != m_functions.end()) && i->first <= now)
     {
         // get and remove event from queue
         i->second();
@@ -58,24 +88,30 @@ void FunctionProcessor::Update(uint32 p_time)
 
 void FunctionProcessor::KillAllFunctions()
 {
+    std::lock_guard<std::recursive_mutex> _queue_lock(m_queue_lock);
     clean = true;
+    RequestWake();
 }
 
 void FunctionProcessor::AddFunction(std::function<void()> && Function, uint64 e_time)
 {
     std::lock_guard<std::recursive_mutex> _queue_lock(m_queue_lock);
     m_functions_queue.insert(std::make_pair(e_time, Function));
+    if (!m_hasQueued)
+        RequestWake();
+    m_hasQueued = true;
 }
 
 void FunctionProcessor::AddFunctionsFromQueue()
 {
-    if (m_functions_queue.empty())
+    if (!m_hasQueued)
         return;
 
     FunctionList tempFunctions;
     {
         std::lock_guard<std::recursive_mutex> _queue_lock(m_queue_lock);
         std::swap(tempFunctions, m_functions_queue);
+        m_hasQueued = false;
     }
     FunctionList::iterator itr = tempFunctions.begin();
     for(; itr != tempFunctions.end(); ++itr)
@@ -84,7 +120,7 @@ void FunctionProcessor::AddFunctionsFromQueue()
 
 uint64 FunctionProcessor::CalculateTime(uint64 t_offset) const
 {
-    return m_time + t_offset;
+    return GetProcessorTime() + t_offset;
 }
 
 bool FunctionProcessor::Empty() const
@@ -99,11 +135,11 @@ uint32 FunctionProcessor::Size() const
 
 uint32 FunctionProcessor::SizeQueue() const
 {
-    return m_functions_queue.size();
+    return m_hasQueued ? m_functions_queue.size() : 0;
 }
 
 void FunctionProcessor::AddDelayedEvent(uint64 t_offset, std::function<void()>&& function)
 {
-    AddFunction(std::move(function), m_time + t_offset);
+    AddFunction(std::move(function), CalculateTime(t_offset));
 }
 
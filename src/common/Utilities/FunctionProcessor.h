@@ -20,17 +20,21 @@
 #define __FunctionProcessor_H
 
 #include "Define.h"
+#include "TimerWheel.h"
+#include <atomic>
+#include <functional>
 #include <map>
+#include <mutex>
 
 typedef std::multimap<uint64, std::function<void()>> FunctionList;
 
-class FunctionProcessor
+class FunctionProcessor : public WheelProcessor
 {
     public:
         FunctionProcessor();
         ~FunctionProcessor();
 
-        void Update(uint32 p_time);
+        void Update(uint32 p_time);                         // does nothing while on a timer wheel, the wheel runs the functions then
         void KillAllFunctions();
         void AddFunction(std::function<void()> && Function, uint64 e_time);
         void AddFunctionsFromQueue();
@@ -41,10 +45,13 @@ class FunctionProcessor
         void AddDelayedEvent(uint64 t_offset, std::function<void()>&& function);
 
     protected:
-        std::atomic<uint64> m_time;
+        void OnWake() override;
+        void OnTimer(uint32 diff) override;
+        void RunDueFunctions();
+
         FunctionList m_functions;
         FunctionList m_functions_queue;
-        std::recursive_mutex m_queue_lock;
+        std::atomic<bool> m_hasQueued;                      // lets idle owners skip the queue lock every update
         bool clean;
 };
 #endif
\ No newline at end of file
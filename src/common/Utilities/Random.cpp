@@ -19,22 +19,33 @@
 #include "Common.h"
 #include "Errors.h"
 #include "SFMT.h"
-#include <boost/thread/tss.hpp>
+#include <atomic>
+#include <cstring>
+#include <ctime>
 
-static boost::thread_specific_ptr<SFMTRand> sfmtRand;
 static SFMTEngine engine;
 
-static SFMTRand* GetRng()
+namespace
 {
-    SFMTRand* rand = sfmtRand.get();
+    // distinct seeds for threads started within the same second
+    std::atomic<uint32> ThreadSeedCounter(0);
 
-    if (!rand)
+    SFMTRand* CreateThreadRng()
     {
-        rand = new SFMTRand();
-        sfmtRand.reset(rand);
+        thread_local SFMTRand rng;
+        rng.RandomInit(int(uint32(time(nullptr)) ^ (++ThreadSeedCounter * 0x9E3779B9u)));
+        return &rng;
     }
 
-    return rand;
+    thread_local SFMTRand* ThreadRng = nullptr;
+}
+
+static inline SFMTRand* GetRng()
+{
+    if (SFMTRand* rand = ThreadRng)
+        return rand;
+
+    return ThreadRng = CreateThreadRng();
 }
 
 int32 irand(int32 min, int32 max)
@@ -86,6 +97,42 @@ uint32 urandweighted(size_t count, double const* chances)
     return dd(SFMTEngine::Instance());
 }
 
+void rand32_fill(uint32* values, size_t count)
+{
+    GetRng()->BRandomFill(values, count);
+}
+
+void urand_fill(uint32* values, size_t count, uint32 min, uint32 max)
+{
+    if (min > max)
+        std::swap(min, max);
+
+    GetRng()->BRandomFill(values, count);
+
+    // same multiply and shift as SFMTRand::URandom
+    uint64 interval = uint64(max - min) + 1;
+    for (size_t i = 0; i < count; ++i)
+        values[i] = uint32((values[i] * interval) >> 32) + min;
+}
+
+void rand_norm_fill(double* values, size_t count)
+{
+    // two words per double like SFMTRand::Random, generated into the output and widened in place
+    uint32* words = reinterpret_cast<uint32*>(values);
+    GetRng()->BRandomFill(words, count * 2);
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint64 bits;
+        memcpy(&bits, words + i * 2, sizeof(bits));
+        values[i] = int64(bits >> 12) * (1.0 / (67108864.0 * 67108864.0));
+    }
+}
+
+void rand_seed_thread(uint32 seed)
+{
+    GetRng()->RandomInit(int(seed));
+}
+
 SFMTEngine& SFMTEngine::Instance()
 {
     return engine;
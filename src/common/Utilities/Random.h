@@ -45,6 +45,18 @@ double rand_chance();
 
 uint32 urandweighted(size_t count, double const* chances);
 
+/* Fill values with count random numbers in the range 0 .. UINT32_MAX. */
+void rand32_fill(uint32* values, size_t count);
+
+/* Fill values with count random numbers in the range min..max (inclusive). */
+void urand_fill(uint32* values, size_t count, uint32 min, uint32 max);
+
+/* Fill values with count random doubles from 0.0 to 1.0 (exclusive). */
+void rand_norm_fill(double* values, size_t count);
+
+/* Re-seed the generator of the calling thread, the numbers it returns afterwards only depend on seed. */
+void rand_seed_thread(uint32 seed);
+
 /* Return true if a random roll fits in the specified chance (range 0-100). */
 inline bool roll_chance_f(float chance)
 {
@@ -0,0 +1,388 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TimerWheel.h"
+#include <algorithm>
+
+TimerWheel::TimerWheel() : _runningHead(InvalidIndex), _overflowHead(InvalidIndex), _now(0), _count(0)
+{
+    for (Level& level : _levels)
+    {
+        level.Heads.fill(InvalidIndex);
+        level.Occupied.fill(0);
+    }
+}
+
+TimerWheel::~TimerWheel()
+{
+}
+
+TimerHandle TimerWheel::Schedule(uint32 delay, TimerCallback&& callback)
+{
+    uint32 index = AllocateNode();
+    Node& node = _nodes[index];
+    node.Callback = std::move(callback);
+    // a timer never fires inside the step it was scheduled from
+    node.Expiry = _now + std::max<uint32>(std::min(delay, MaxDelay), 1);
+    Link(index);
+    ++_count;
+    return TimerHandle(index, node.Generation);
+}
+
+bool TimerWheel::Cancel(TimerHandle const& handle)
+{
+    if (!IsScheduled(handle))
+        return false;
+
+    Unlink(handle.Index);
+    FreeNode(handle.Index);
+    --_count;
+    return true;
+}
+
+bool TimerWheel::IsScheduled(TimerHandle const& handle) const
+{
+    return !handle.IsEmpty() && handle.Index < _nodes.size() && _nodes[handle.Index].Generation == handle.Generation && _nodes[handle.Index].Linked;
+}
+
+void TimerWheel::Advance(uint32 diff)
+{
+    uint64 target = _now + diff;
+    while (_now < target)
+    {
+        if (!_count)
+        {
+            _now = target;
+            return;
+        }
+
+        // nothing left on the lowest level - jump straight to the next cascade point
+        Level const& lowest = _levels[0];
+        if (std::all_of(lowest.Occupied.begin(), lowest.Occupied.end(), [](uint64 bits) { return bits == 0; }))
+        {
+            uint64 boundary = _now | SlotMask;
+            if (boundary >= target)
+            {
+                _now = target;
+                return;
+            }
+            _now = boundary;
+        }
+
+        ++_now;
+
+        // refill lower levels, highest level first so entries can drop through several levels in one step
+        for (uint32 level = LevelCount; level-- > 1;)
+        {
+            if (_now & ((UI64LIT(1) << (SlotBits * level)) - 1))
+                continue;
+
+            if (level == LevelCount - 1 && !(_now & ((UI64LIT(1) << (SlotBits * LevelCount)) - 1)))
+                Relink(OverflowSlot);
+
+            Relink(level * SlotCount + ((_now >> (SlotBits * level)) & SlotMask));
+        }
+
+        RunSlot(_now & SlotMask);
+    }
+}
+
+void TimerWheel::Clear()
+{
+    for (uint32 index = 0; index < _nodes.size(); ++index)
+    {
+        if (!_nodes[index].Linked)
+            continue;
+
+        Unlink(index);
+        FreeNode(index);
+    }
+
+    _count = 0;
+}
+
+uint64 TimerWheel::GetNextExpiry() const
+{
+    uint64 next = 0;
+    for (Node const& node : _nodes)
+        if (node.Linked && (!next || node.Expiry < next))
+            next = node.Expiry;
+
+    return next ? next : _now;
+}
+
+uint32 TimerWheel::AllocateNode()
+{
+    if (!_freeNodes.empty())
+    {
+        uint32 index = _freeNodes.back();
+        _freeNodes.pop_back();
+        return index;
+    }
+
+    _nodes.emplace_back();
+    return uint32(_nodes.size() - 1);
+}
+
+void TimerWheel::FreeNode(uint32 index)
+{
+    Node& node = _nodes[index];
+    node.Callback.Reset();
+    if (++node.Generation == 0)
+        node.Generation = 1;
+
+    _freeNodes.push_back(index);
+}
+
+uint32& TimerWheel::Head(uint16 slot)
+{
+    if (slot == RunningSlot)
+        return _runningHead;
+    if (slot == OverflowSlot)
+        return _overflowHead;
+    return _levels[slot / SlotCount].Heads[slot % SlotCount];
+}
+
+void TimerWheel::Link(uint32 index)
+{
+    Node& node = _nodes[index];
+    uint16 slot = OverflowSlot;
+    uint64 differentBits = node.Expiry ^ _now;
+    for (uint32 level = 0; level < LevelCount; ++level)
+    {
+        if (differentBits < (UI64LIT(1) << (SlotBits * (level + 1))))
+        {
+            slot = level * SlotCount + ((node.Expiry >> (SlotBits * level)) & SlotMask);
+            _levels[level].Occupied[(slot % SlotCount) / 64] |= UI64LIT(1) << (slot % 64);
+            break;
+        }
+    }
+
+    uint32& head = Head(slot);
+    node.Slot = slot;
+    node.Prev = InvalidIndex;
+    node.Next = head;
+    node.Linked = true;
+    if (head != InvalidIndex)
+        _nodes[head].Prev = index;
+    head = index;
+}
+
+void TimerWheel::Unlink(uint32 index)
+{
+    Node& node = _nodes[index];
+    uint32& head = Head(node.Slot);
+    if (node.Prev != InvalidIndex)
+        _nodes[node.Prev].Next = node.Next;
+    else
+        head = node.Next;
+
+    if (node.Next != InvalidIndex)
+        _nodes[node.Next].Prev = node.Prev;
+
+    if (head == InvalidIndex && node.Slot < RunningSlot)
+        _levels[node.Slot / SlotCount].Occupied[(node.Slot % SlotCount) / 64] &= ~(UI64LIT(1) << (node.Slot % 64));
+
+    node.Prev = InvalidIndex;
+    node.Next = InvalidIndex;
+    node.Linked = false;
+}
+
+void TimerWheel::Relink(uint16 slot)
+{
+    uint32 index = Head(slot);
+    Head(slot) = InvalidIndex;
+    if (slot < RunningSlot)
+        _levels[slot / SlotCount].Occupied[(slot % SlotCount) / 64] &= ~(UI64LIT(1) << (slot % 64));
+
+    while (index != InvalidIndex)
+    {
+        uint32 next = _nodes[index].Next;
+        Link(index);
+        index = next;
+    }
+}
+
+void TimerWheel::RunSlot(uint32 slot)
+{
+    uint32 index = _levels[0].Heads[slot];
+    if (index == InvalidIndex)
+        return;
+
+    // move everything due into the running list first, callbacks may cancel each other
+    _levels[0].Heads[slot] = InvalidIndex;
+    _levels[0].Occupied[slot / 64] &= ~(UI64LIT(1) << (slot % 64));
+    _runningHead = index;
+    for (; index != InvalidIndex; index = _nodes[index].Next)
+        _nodes[index].Slot = RunningSlot;
+
+    while (_runningHead != InvalidIndex)
+    {
+        index = _runningHead;
+        Unlink(index);
+        TimerCallback callback = std::move(_nodes[index].Callback);
+        FreeNode(index);
+        --_count;
+        callback();
+    }
+}
+
+WheelProcessor::WheelProcessor() : _wheel(nullptr), _localTime(0), _timeOffset(0), _timerTime(0), _woken(false)
+{
+}
+
+WheelProcessor::~WheelProcessor()
+{
+    // processors unbind in their own destructor already, before the entries a timer could still reach are gone
+    SetTimerWheel(nullptr);
+}
+
+void WheelProcessor::SetTimerWheel(SharedTimerWheel* wheel)
+{
+    if (SharedTimerWheel* old = _wheel)
+    {
+        if (old == wheel)
+            return;
+
+        std::lock_guard<std::recursive_mutex> wheelLock(old->_lock);
+        std::lock_guard<std::recursive_mutex> queueLock(m_queue_lock);
+        _localTime = GetProcessorTime();
+        old->_timers.Cancel(_timer);
+        _timer = TimerHandle();
+        _timerTime = 0;
+        {
+            std::lock_guard<std::mutex> wakeLock(old->_wakeLock);
+            if (_woken)
+            {
+                old->_woken.erase(std::remove(old->_woken.begin(), old->_woken.end(), this), old->_woken.end());
+                _woken = false;
+            }
+        }
+        old->_bound.erase(this);
+        _wheel = nullptr;
+    }
+
+    if (!wheel)
+        return;
+
+    std::lock_guard<std::recursive_mutex> wheelLock(wheel->_lock);
+    std::lock_guard<std::recursive_mutex> queueLock(m_queue_lock);
+    _timeOffset = int64(_localTime) - int64(wheel->GetTime());
+    _wheel = wheel;
+    wheel->_bound.insert(this);
+    OnWake();
+}
+
+uint64 WheelProcessor::GetProcessorTime() const
+{
+    if (SharedTimerWheel* wheel = _wheel)
+        return uint64(int64(wheel->GetTime()) + _timeOffset);
+
+    return _localTime;
+}
+
+void WheelProcessor::RequestWake()
+{
+    SharedTimerWheel* wheel = _wheel;
+    if (!wheel)
+        return;
+
+    std::lock_guard<std::mutex> wakeLock(wheel->_wakeLock);
+    if (_woken)
+        return;
+
+    _woken = true;
+    wheel->_woken.push_back(this);
+}
+
+void WheelProcessor::ArmTimer(uint64 e_time)
+{
+    // the entries that just ran may have taken the owner off the map
+    SharedTimerWheel* wheel = _wheel;
+    if (!wheel)
+        return;
+
+    TimerWheel& timers = wheel->_timers;
+    if (timers.IsScheduled(_timer))
+    {
+        // an earlier timer rearms for the then earliest entry when it fires
+        if (e_time && _timerTime <= e_time)
+            return;
+
+        timers.Cancel(_timer);
+    }
+
+    _timer = TimerHandle();
+    _timerTime = 0;
+    if (!e_time)
+        return;
+
+    // inside Advance the wheel is still mid step, count from its exact time and not from the step end
+    uint64 now = uint64(int64(timers.GetTime()) + _timeOffset);
+    uint64 delay = e_time > now ? e_time - now : 0;
+    _timer = timers.Schedule(uint32(std::min<uint64>(delay, 0x7FFFFFFF)), [this]()
+    {
+        OnTimer(_wheel.load()->_stepDiff);
+    });
+    _timerTime = e_time;
+}
+
+SharedTimerWheel::SharedTimerWheel() : _time(0), _stepDiff(0)
+{
+}
+
+SharedTimerWheel::~SharedTimerWheel()
+{
+    // processors of objects still around fall back to their own clock
+    std::lock_guard<std::recursive_mutex> lock(_lock);
+    for (WheelProcessor* processor : _bound)
+    {
+        std::lock_guard<std::recursive_mutex> queueLock(processor->m_queue_lock);
+        processor->_localTime = processor->GetProcessorTime();
+        processor->_timer = TimerHandle();
+        processor->_timerTime = 0;
+        processor->_woken = false;
+        processor->_wheel = nullptr;
+    }
+}
+
+void SharedTimerWheel::Advance(uint32 diff)
+{
+    std::lock_guard<std::recursive_mutex> lock(_lock);
+    {
+        std::lock_guard<std::mutex> wakeLock(_wakeLock);
+        std::swap(_waking, _woken);
+        for (WheelProcessor* processor : _waking)
+            processor->_woken = false;
+    }
+
+    // like the per object Update, entries run when they are due by the end of the step
+    _time = _timers.GetTime() + diff;
+    _stepDiff = diff;
+
+    for (WheelProcessor* processor : _waking)
+        if (_bound.count(processor))                    // may have left while an earlier one woke up
+            processor->OnWake();
+
+    _waking.clear();
+    _timers.Advance(diff);
+}
+
+uint32 SharedTimerWheel::Size() const
+{
+    return _timers.Size();
+}
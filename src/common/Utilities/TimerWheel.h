@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2008-2017 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TIMER_WHEEL_H_
+#define _TIMER_WHEEL_H_
+
+#include "Define.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/// Move-only void() callable with inline storage.
+/// Callables up to InlineSize bytes (lambdas capturing a few pointers/guids) never touch the heap,
+/// bigger ones fall back to a single allocation.
+class TimerCallback
+{
+public:
+    static constexpr size_t InlineSize = 48;
+
+    TimerCallback() : _ops(nullptr) { }
+
+    template<typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, TimerCallback>::value>::type>
+    TimerCallback(F&& f) : _ops(nullptr)
+    {
+        typedef typename std::decay<F>::type Functor;
+        if constexpr (sizeof(Functor) <= InlineSize && alignof(Functor) <= alignof(Storage) && std::is_nothrow_move_constructible<Functor>::value)
+        {
+            new (&_storage) Functor(std::forward<F>(f));
+            _ops = &InlineOps<Functor>::Table;
+        }
+        else
+        {
+            *reinterpret_cast<Functor**>(&_storage) = new Functor(std::forward<F>(f));
+            _ops = &HeapOps<Functor>::Table;
+        }
+    }
+
+    TimerCallback(TimerCallback&& other) noexcept : _ops(other._ops)
+    {
+        if (_ops)
+        {
+            _ops->Move(&_storage, &other._storage);
+            other._ops = nullptr;
+        }
+    }
+
+    TimerCallback& operator=(TimerCallback&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            _ops = other._ops;
+            if (_ops)
+            {
+                _ops->Move(&_storage, &other._storage);
+                other._ops = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    TimerCallback(TimerCallback const&) = delete;
+    TimerCallback& operator=(TimerCallback const&) = delete;
+
+    ~TimerCallback() { Reset(); }
+
+    void operator()() { _ops->Invoke(&_storage); }
+    explicit operator bool() const { return _ops != nullptr; }
+
+    void Reset()
+    {
+        if (_ops)
+        {
+            _ops->Destroy(&_storage);
+            _ops = nullptr;
+        }
+    }
+
+private:
+    typedef typename std::aligned_storage<InlineSize, alignof(std::max_align_t)>::type Storage;
+
+    struct Ops
+    {
+        void(*Invoke)(void*);
+        void(*Move)(void* dst, void* src);
+        void(*Destroy)(void*);
+    };
+
+    template<typename Functor>
+    struct InlineOps
+    {
+        static void Invoke(void* p) { (*static_cast<Functor*>(p))(); }
+        static void Move(void* dst, void* src)
+        {
+            new (dst) Functor(std::move(*static_cast<Functor*>(src)));
+            static_cast<Functor*>(src)->~Functor();
+        }
+        static void Destroy(void* p) { static_cast<Functor*>(p)->~Functor(); }
+        static constexpr Ops Table = { &Invoke, &Move, &Destroy };
+    };
+
+    template<typename Functor>
+    struct HeapOps
+    {
+        static void Invoke(void* p) { (**static_cast<Functor**>(p))(); }
+        static void Move(void* dst, void* src) { *static_cast<Functor**>(dst) = *static_cast<Functor**>(src); }
+        static void Destroy(void* p) { delete *static_cast<Functor**>(p); }
+        static constexpr Ops Table = { &Invoke, &Move, &Destroy };
+    };
+
+    Storage _storage;
+    Ops const* _ops;
+};
+
+/// Identifies a scheduled timer, stays valid (and harmless) after the timer fired or was cancelled.
+struct TimerHandle
+{
+    TimerHandle() : Index(0), Generation(0) { }
+    TimerHandle(uint32 index, uint32 generation) : Index(index), Generation(generation) { }
+
+    bool IsEmpty() const { return Generation == 0; }
+
+    uint32 Index;
+    uint32 Generation;
+};
+
+/// Hierarchical timing wheel with 1 ms resolution.
+/// Schedule and Cancel are O(1), Advance costs O(expired timers + elapsed ms) and returns
+/// immediately when nothing is scheduled, so an owner with no pending timers pays nothing per tick.
+/// Timer nodes are pooled and reused, callbacks are stored inline (see TimerCallback),
+/// so the steady state is allocation-free.
+/// Not thread safe: schedule, cancel and advance from the owner's update thread only.
+class TimerWheel
+{
+public:
+    TimerWheel();
+    ~TimerWheel();
+
+    TimerWheel(TimerWheel const&) = delete;
+    TimerWheel& operator=(TimerWheel const&) = delete;
+
+    /// Schedules callback to run delay ms after the current wheel time.
+    TimerHandle Schedule(uint32 delay, TimerCallback&& callback);
+
+    /// Cancels a pending timer, returns false if it already fired or was cancelled.
+    bool Cancel(TimerHandle const& handle);
+    bool IsScheduled(TimerHandle const& handle) const;
+
+    /// Moves wheel time forward by diff ms and runs every callback that became due, in expiry order.
+    /// Callbacks may schedule and cancel timers.
+    void Advance(uint32 diff);
+
+    /// Drops all pending timers without running them.
+    void Clear();
+
+    uint64 GetTime() const { return _now; }
+    uint32 Size() const { return _count; }
+    bool Empty() const { return _count == 0; }
+
+    /// Time of the earliest pending timer, or the current wheel time if nothing is scheduled.
+    uint64 GetNextExpiry() const;
+
+private:
+    static constexpr uint32 SlotBits = 8;
+    static constexpr uint32 SlotCount = 1 << SlotBits;
+    static constexpr uint32 SlotMask = SlotCount - 1;
+    static constexpr uint32 LevelCount = 4;
+    static constexpr uint32 InvalidIndex = 0xFFFFFFFF;
+    static constexpr uint32 MaxDelay = 0x7FFFFFFF;
+    static constexpr uint16 RunningSlot = LevelCount * SlotCount;
+    static constexpr uint16 OverflowSlot = RunningSlot + 1;
+
+    struct Node
+    {
+        TimerCallback Callback;
+        uint64 Expiry = 0;
+        uint32 Prev = InvalidIndex;
+        uint32 Next = InvalidIndex;
+        uint32 Generation = 1;
+        uint16 Slot = 0;                // level * SlotCount + slot, valid while linked
+        bool Linked = false;
+    };
+
+    struct Level
+    {
+        std::array<uint32, SlotCount> Heads;
+        std::array<uint64, SlotCount / 64> Occupied;
+    };
+
+    uint32 AllocateNode();
+    void FreeNode(uint32 index);
+    void Link(uint32 index);
+    void Unlink(uint32 index);
+    uint32& Head(uint16 slot);
+    void Relink(uint16 slot);
+    void RunSlot(uint32 slot);
+
+    std::vector<Node> _nodes;
+    std::vector<uint32> _freeNodes;
+    std::array<Level, LevelCount> _levels;
+    uint32 _runningHead;                // timers due in the current Advance step
+    uint32 _overflowHead;               // timers beyond the top level range, relinked when it wraps
+    uint64 _now;
+    uint32 _count;
+};
+
+class SharedTimerWheel;
+
+/// Base of the processors (EventProcessor, FunctionProcessor) whose timing can be handed to a SharedTimerWheel.
+/// Unbound, the processor runs on its own clock advanced by its owner's Update.
+/// Bound, its clock follows the wheel and it keeps a single wheel timer for its earliest entry,
+/// so a processor with nothing due is never visited.
+class WheelProcessor
+{
+    friend class SharedTimerWheel;
+
+public:
+    /// Hands the timing to wheel, or back to the owner's Update with nullptr.
+    /// Pending entries keep their remaining delay, so they survive the owner moving to another map.
+    void SetTimerWheel(SharedTimerWheel* wheel);
+    bool IsOnTimerWheel() const { return _wheel != nullptr; }
+
+protected:
+    WheelProcessor();
+    virtual ~WheelProcessor();
+
+    /// Processor clock, the wheel clock shifted by the time the processor ran unbound.
+    uint64 GetProcessorTime() const;
+    void AdvanceLocalTime(uint32 diff) { _localTime += diff; }
+
+    /// Asks the wheel to call OnWake at the start of its next Advance, from any thread. Does nothing while unbound.
+    /// Callers hold m_queue_lock.
+    void RequestWake();
+    /// Arms the wheel timer for processor time e_time, or disarms it when e_time is 0. Wheel thread only.
+    void ArmTimer(uint64 e_time);
+
+    /// Moves the queued entries in and arms the timer for the earliest one.
+    virtual void OnWake() = 0;
+    /// Runs the entries due at GetProcessorTime() and arms the timer for the next one, diff is the wheel step.
+    virtual void OnTimer(uint32 diff) = 0;
+
+    std::recursive_mutex m_queue_lock;
+
+private:
+    std::atomic<SharedTimerWheel*> _wheel;
+    std::atomic<uint64> _localTime;
+    std::atomic<int64> _timeOffset;
+    TimerHandle _timer;
+    uint64 _timerTime;
+    bool _woken;                        // guarded by the wake lock of the wheel
+};
+
+/// Timer wheel owned by a map and shared by the processors of every object on it.
+/// Processors can be fed from any thread, they queue their entries and request a wake,
+/// Advance moves the queued entries of the woken processors onto the wheel before moving time.
+/// Advance, binds and unbinds are serialized by the wheel lock, due entries run with it held.
+class SharedTimerWheel
+{
+    friend class WheelProcessor;
+
+public:
+    SharedTimerWheel();
+    ~SharedTimerWheel();
+
+    SharedTimerWheel(SharedTimerWheel const&) = delete;
+    SharedTimerWheel& operator=(SharedTimerWheel const&) = delete;
+
+    void Advance(uint32 diff);
+
+    /// Time at the end of the current Advance step, readable from any thread.
+    uint64 GetTime() const { return _time; }
+    /// Processors currently holding a wheel timer.
+    uint32 Size() const;
+
+private:
+    TimerWheel _timers;
+    std::recursive_mutex _lock;
+    std::mutex _wakeLock;
+    std::vector<WheelProcessor*> _woken;
+    std::vector<WheelProcessor*> _waking;
+    std::unordered_set<WheelProcessor*> _bound;
+    std::atomic<uint64> _time;
+    uint32 _stepDiff;
+};
+
+#endif
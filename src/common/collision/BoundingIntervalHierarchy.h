@@ -31,7 +31,13 @@
 #include <limits>
 #include <cmath>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BIH_PACKET_SSE2
+#include <emmintrin.h>
+#endif
+
 #define MAX_STACK_SIZE 64
+#define BIH_PACKET_SIZE 4
 
 static inline uint32 floatToRawIntBits(float f)
 {
@@ -256,6 +262,175 @@ class BIH
             }
         }
 
+        /**
+        Traces up to BIH_PACKET_SIZE rays together, every node is tested for all lanes at once and visited
+        while at least one lane still needs it. laneMask selects the used lanes of rays/maxDists.
+        Each ray stops at its first hit, returns the mask of the lanes that hit something.
+        */
+        template<typename RayCallback>
+        uint32 intersectRayPacket(const G3D::Ray* rays, const float* maxDists, uint32 laneMask, RayCallback& intersectCallback) const
+        {
+            float org[3][BIH_PACKET_SIZE];
+            float invDir[3][BIH_PACKET_SIZE];
+            uint32 negDir[3][BIH_PACKET_SIZE];
+            float tmin[BIH_PACKET_SIZE];
+            float tmax[BIH_PACKET_SIZE];
+            for (uint32 lane = 0; lane < BIH_PACKET_SIZE; ++lane)
+            {
+                // unused lanes get an empty interval
+                tmin[lane] = 1.f;
+                tmax[lane] = 0.f;
+                for (int i = 0; i < 3; ++i)
+                {
+                    org[i][lane] = 0.f;
+                    invDir[i][lane] = 1.f;
+                    negDir[i][lane] = 0;
+                }
+
+                if (!(laneMask & (1 << lane)))
+                    continue;
+
+                // same clipping against the tree bounds as intersectRay
+                float maxDist = maxDists[lane];
+                float intervalMin = -1.f;
+                float intervalMax = -1.f;
+                G3D::Vector3 const& o = rays[lane].origin();
+                G3D::Vector3 const& dir = rays[lane].direction();
+                bool missed = false;
+                for (int i = 0; i < 3; ++i)
+                {
+                    org[i][lane] = o[i];
+                    invDir[i][lane] = 1.f / dir[i];
+                    negDir[i][lane] = floatToRawIntBits(dir[i]) >> 31 ? 0xFFFFFFFF : 0;
+                    if (G3D::fuzzyNe(dir[i], 0.0f))
+                    {
+                        float t1 = (bounds.low()[i]  - o[i]) * invDir[i][lane];
+                        float t2 = (bounds.high()[i] - o[i]) * invDir[i][lane];
+                        if (t1 > t2)
+                            std::swap(t1, t2);
+                        if (t1 > intervalMin)
+                            intervalMin = t1;
+                        if (t2 < intervalMax || intervalMax < 0.f)
+                            intervalMax = t2;
+                        if (intervalMax <= 0 || intervalMin >= maxDist)
+                            missed = true;
+                    }
+                }
+
+                if (missed || intervalMin > intervalMax)
+                {
+                    laneMask &= ~(1 << lane);
+                    continue;
+                }
+
+                tmin[lane] = std::max(intervalMin, 0.f);
+                tmax[lane] = std::min(intervalMax, maxDist);
+            }
+
+            PacketRays packet;
+            for (int i = 0; i < 3; ++i)
+            {
+                packet.org[i] = packetLoad(org[i]);
+                packet.invDir[i] = packetLoad(invDir[i]);
+                packet.negDir[i] = packetLoadMask(negDir[i]);
+            }
+
+            PacketStackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+            uint32 hitMask = 0;
+            uint32 active = laneMask & packetNonEmpty(packetLoad(tmin), packetLoad(tmax));
+            PacketInterval interval = { packetLoad(tmin), packetLoad(tmax) };
+
+            while (true) {
+                while (active)
+                {
+                    uint32 tn = tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    bool BVH2 = (tn & (1 << 29)) != 0;
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node, left child ends at the left clip plane, right child starts at the right one
+                            PacketInterval left, right;
+                            uint32 leftLanes = active & clipBelow(packet, axis, intBitsToFloat(tree[node + 1]), interval, left);
+                            uint32 rightLanes = active & clipAbove(packet, axis, intBitsToFloat(tree[node + 2]), interval, right);
+                            if (leftLanes && rightLanes)
+                            {
+                                stack[stackPos].node = offset + 3;
+                                stack[stackPos].lanes = rightLanes;
+                                stack[stackPos].interval = right;
+                                stackPos++;
+                            }
+
+                            if (leftLanes)
+                            {
+                                node = offset;
+                                interval = left;
+                                active = leftLanes;
+                            }
+                            else
+                            {
+                                node = offset + 3;
+                                interval = right;
+                                active = rightLanes;
+                            }
+                            continue;
+                        }
+                        else
+                        {
+                            // leaf - test some objects for every lane still looking for a hit
+                            int n = tree[node + 1];
+                            while (n > 0 && active) {
+                                for (uint32 lane = 0; lane < BIH_PACKET_SIZE; ++lane)
+                                {
+                                    if (!(active & (1 << lane)))
+                                        continue;
+
+                                    float maxDist = maxDists[lane];
+                                    if (intersectCallback(rays[lane], objects[offset], maxDist, true))
+                                    {
+                                        hitMask |= 1 << lane;
+                                        active &= ~(1 << lane);
+                                    }
+                                }
+                                --n;
+                                ++offset;
+                            }
+
+                            if (hitMask == laneMask)
+                                return hitMask;
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        if (axis > 2)
+                            return hitMask; // should not happen
+                        // BVH2 node, only the space between both planes is kept
+                        PacketInterval clipped;
+                        active &= clipAbove(packet, axis, intBitsToFloat(tree[node + 1]), interval, clipped);
+                        active &= clipBelow(packet, axis, intBitsToFloat(tree[node + 2]), clipped, interval);
+                        node = offset;
+                        continue;
+                    }
+                } // traversal loop
+                do
+                {
+                    // stack is empty?
+                    if (stackPos == 0)
+                        return hitMask;
+                    // move back up the stack, lanes that hit in the meantime are done
+                    stackPos--;
+                    active = stack[stackPos].lanes & ~hitMask;
+                } while (!active);
+                node = stack[stackPos].node;
+                interval = stack[stackPos].interval;
+            }
+        }
+
         template<typename IsectCallback>
         void intersectPoint(const G3D::Vector3 &p, IsectCallback& intersectCallback) const
         {
@@ -356,6 +531,77 @@ class BIH
             float tfar;
         };
 
+#ifdef BIH_PACKET_SSE2
+        typedef __m128 PacketFloat;
+
+        static PacketFloat packetLoad(const float* f) { return _mm_loadu_ps(f); }
+        static PacketFloat packetLoadMask(const uint32* m) { return _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(m))); }
+        static PacketFloat packetSplat(float f) { return _mm_set1_ps(f); }
+        static PacketFloat packetMin(PacketFloat a, PacketFloat b) { return _mm_min_ps(a, b); }
+        static PacketFloat packetMax(PacketFloat a, PacketFloat b) { return _mm_max_ps(a, b); }
+        static PacketFloat packetSub(PacketFloat a, PacketFloat b) { return _mm_sub_ps(a, b); }
+        static PacketFloat packetMul(PacketFloat a, PacketFloat b) { return _mm_mul_ps(a, b); }
+        // mask ? a : b
+        static PacketFloat packetSelect(PacketFloat mask, PacketFloat a, PacketFloat b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+        static PacketFloat packetNot(PacketFloat mask) { return _mm_xor_ps(mask, _mm_castsi128_ps(_mm_set1_epi32(-1))); }
+        static uint32 packetNonEmpty(PacketFloat lo, PacketFloat hi) { return uint32(_mm_movemask_ps(_mm_cmple_ps(lo, hi))); }
+#else
+        struct PacketFloat
+        {
+            float v[BIH_PACKET_SIZE];
+        };
+
+        static PacketFloat packetLoad(const float* f) { PacketFloat r; for (int i = 0; i < BIH_PACKET_SIZE; ++i) r.v[i] = f[i]; return r; }
+        static PacketFloat packetLoadMask(const uint32* m) { PacketFloat r; for (int i = 0; i < BIH_PACKET_SIZE; ++i) r.v[i] = intBitsToFloat(m[i]); return r; }
+        static PacketFloat packetSplat(float f) { PacketFloat r; for (int i = 0; i < BIH_PACKET_SIZE; ++i) r.v[i] = f; return r; }
+        static PacketFloat packetMin(PacketFloat a, PacketFloat b) { for (int i = 0; i < BIH_PACKET_SIZE; ++i) a.v[i] = b.v[i] < a.v[i] ? b.v[i] : a.v[i]; return a; }
+        static PacketFloat packetMax(PacketFloat a, PacketFloat b) { for (int i = 0; i < BIH_PACKET_SIZE; ++i) a.v[i] = b.v[i] > a.v[i] ? b.v[i] : a.v[i]; return a; }
+        static PacketFloat packetSub(PacketFloat a, PacketFloat b) { for (int i = 0; i < BIH_PACKET_SIZE; ++i) a.v[i] -= b.v[i]; return a; }
+        static PacketFloat packetMul(PacketFloat a, PacketFloat b) { for (int i = 0; i < BIH_PACKET_SIZE; ++i) a.v[i] *= b.v[i]; return a; }
+        // mask ? a : b
+        static PacketFloat packetSelect(PacketFloat mask, PacketFloat a, PacketFloat b) { for (int i = 0; i < BIH_PACKET_SIZE; ++i) if (floatToRawIntBits(mask.v[i])) b.v[i] = a.v[i]; return b; }
+        static PacketFloat packetNot(PacketFloat mask) { for (int i = 0; i < BIH_PACKET_SIZE; ++i) mask.v[i] = intBitsToFloat(~floatToRawIntBits(mask.v[i])); return mask; }
+        static uint32 packetNonEmpty(PacketFloat lo, PacketFloat hi) { uint32 r = 0; for (int i = 0; i < BIH_PACKET_SIZE; ++i) if (lo.v[i] <= hi.v[i]) r |= 1 << i; return r; }
+#endif
+
+        struct PacketRays
+        {
+            PacketFloat org[3];
+            PacketFloat invDir[3];
+            PacketFloat negDir[3];
+        };
+        struct PacketInterval
+        {
+            PacketFloat tmin;
+            PacketFloat tmax;
+        };
+        struct PacketStackNode
+        {
+            uint32 node;
+            uint32 lanes;
+            PacketInterval interval;
+        };
+
+        // part of each ray interval below the plane: [tmin, min(tmax, t)] for rays going up the axis, [max(tmin, t), tmax] for rays going down
+        static uint32 clipBelow(PacketRays const& packet, uint32 axis, float plane, PacketInterval const& in, PacketInterval& out)
+        {
+            return clipInterval(packet.negDir[axis], packet, axis, plane, in, out);
+        }
+
+        // part of each ray interval above the plane, mirror of clipBelow
+        static uint32 clipAbove(PacketRays const& packet, uint32 axis, float plane, PacketInterval const& in, PacketInterval& out)
+        {
+            return clipInterval(packetNot(packet.negDir[axis]), packet, axis, plane, in, out);
+        }
+
+        static uint32 clipInterval(PacketFloat raiseMin, PacketRays const& packet, uint32 axis, float plane, PacketInterval const& in, PacketInterval& out)
+        {
+            PacketFloat t = packetMul(packetSub(packetSplat(plane), packet.org[axis]), packet.invDir[axis]);
+            out.tmin = packetSelect(raiseMin, packetMax(in.tmin, t), in.tmin);
+            out.tmax = packetSelect(raiseMin, in.tmax, packetMin(in.tmax, t));
+            return packetNonEmpty(out.tmin, out.tmax);
+        }
+
         class BuildStats
         {
             private:
@@ -0,0 +1,438 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DYNAMIC_BVH_H
+#define _DYNAMIC_BVH_H
+
+#include "Define.h"
+#include <G3D/AABox.h>
+#include <G3D/Ray.h>
+#include <G3D/BoundsTrait.h>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+/** Bounding volume hierarchy that is updated in place instead of rebuilt.
+    Objects are inserted where they grow the surface area of the tree the least
+    and the path back to the root is rebalanced with rotations. Leaves keep their
+    bounds enlarged by DYNAMIC_BVH_MARGIN, an object moving inside them does not
+    touch the tree at all, one moving further is removed and inserted again.
+*/
+
+#define DYNAMIC_BVH_MARGIN 2.0f
+
+template<class T, class BoundsFunc = BoundsTrait<T> >
+class DynamicBVH
+{
+    static int32 const NULL_NODE = -1;
+
+    struct Node
+    {
+        G3D::AABox bounds;
+        const T* object;
+        int32 parent;       // next free node while on the free list
+        int32 left;
+        int32 right;
+        int32 height;       // leaves are 0
+
+        bool isLeaf() const { return left == NULL_NODE; }
+    };
+
+    std::vector<Node> m_nodes;
+    int32 m_root;
+    int32 m_freeList;
+    std::unordered_map<const T*, int32> m_leaves;
+
+public:
+    DynamicBVH() : m_root(NULL_NODE), m_freeList(NULL_NODE) { }
+
+    void insert(const T& obj)
+    {
+        if (m_leaves.count(&obj))
+            return;
+
+        int32 leaf = allocateNode();
+        m_nodes[leaf].object = &obj;
+        m_nodes[leaf].bounds = fatBounds(obj);
+        m_leaves[&obj] = leaf;
+        insertLeaf(leaf);
+    }
+
+    void remove(const T& obj)
+    {
+        auto itr = m_leaves.find(&obj);
+        if (itr == m_leaves.end())
+            return;
+
+        removeLeaf(itr->second);
+        freeNode(itr->second);
+        m_leaves.erase(itr);
+    }
+
+    /// Refits obj after it moved or changed size, returns false when its leaf still covered it
+    bool update(const T& obj)
+    {
+        auto itr = m_leaves.find(&obj);
+        if (itr == m_leaves.end())
+            return false;
+
+        G3D::AABox bounds;
+        BoundsFunc::getBounds(obj, bounds);
+        int32 leaf = itr->second;
+        if (contains(m_nodes[leaf].bounds, bounds))
+            return false;
+
+        removeLeaf(leaf);
+        m_nodes[leaf].bounds = fatBounds(obj);
+        insertLeaf(leaf);
+        return true;
+    }
+
+    // kept balanced by every insert and remove
+    void balance() { }
+
+    bool empty() const { return m_root == NULL_NODE; }
+    uint32 size() const { return uint32(m_leaves.size()); }
+    int32 height() const { return m_root == NULL_NODE ? 0 : m_nodes[m_root].height; }
+
+    /// Children are visited nearer first and every hit shrinks maxDist, so the callback ends up with the closest hit.
+    /// stopAtFirst returns on the first hit instead, enough for line of sight checks.
+    template<typename RayCallback>
+    void intersectRay(const G3D::Ray& ray, RayCallback& intersectCallback, float& maxDist, bool stopAtFirst = false)
+    {
+        if (m_root == NULL_NODE)
+            return;
+
+        G3D::Vector3 const& org = ray.origin();
+        G3D::Vector3 invDir(1.f / ray.direction().x, 1.f / ray.direction().y, 1.f / ray.direction().z);
+
+        struct StackEntry
+        {
+            int32 index;
+            float entry;
+        };
+
+        StackEntry stack[256];
+        int32 stackPos = 0;
+        float entry;
+        if (!intersects(m_nodes[m_root].bounds, org, invDir, maxDist, entry))
+            return;
+
+        stack[stackPos++] = { m_root, entry };
+        while (stackPos)
+        {
+            StackEntry top = stack[--stackPos];
+            // a hit found after this node was pushed may already be closer
+            if (top.entry > maxDist)
+                continue;
+
+            Node const& node = m_nodes[top.index];
+            if (node.isLeaf())
+            {
+                if (intersectCallback(ray, *node.object, maxDist) && stopAtFirst)
+                    return;
+                continue;
+            }
+
+            float leftEntry, rightEntry;
+            bool hitLeft = intersects(m_nodes[node.left].bounds, org, invDir, maxDist, leftEntry);
+            bool hitRight = intersects(m_nodes[node.right].bounds, org, invDir, maxDist, rightEntry);
+
+            // the rotations bound the height to about 1.44 log2(n), far below the stack size
+            if (hitLeft && hitRight)
+            {
+                // the nearer child goes on top
+                if (leftEntry < rightEntry)
+                {
+                    stack[stackPos++] = { node.right, rightEntry };
+                    stack[stackPos++] = { node.left, leftEntry };
+                }
+                else
+                {
+                    stack[stackPos++] = { node.left, leftEntry };
+                    stack[stackPos++] = { node.right, rightEntry };
+                }
+            }
+            else if (hitLeft)
+                stack[stackPos++] = { node.left, leftEntry };
+            else if (hitRight)
+                stack[stackPos++] = { node.right, rightEntry };
+        }
+    }
+
+    template<typename IsectCallback>
+    void intersectPoint(const G3D::Vector3& point, IsectCallback& intersectCallback)
+    {
+        if (m_root == NULL_NODE)
+            return;
+
+        int32 stack[256];
+        int32 stackPos = 0;
+        stack[stackPos++] = m_root;
+        while (stackPos)
+        {
+            Node const& node = m_nodes[stack[--stackPos]];
+            if (!node.bounds.contains(point))
+                continue;
+
+            if (node.isLeaf())
+            {
+                intersectCallback(point, *node.object);
+                continue;
+            }
+
+            stack[stackPos++] = node.left;
+            stack[stackPos++] = node.right;
+        }
+    }
+
+private:
+    static G3D::AABox fatBounds(const T& obj)
+    {
+        G3D::AABox bounds;
+        BoundsFunc::getBounds(obj, bounds);
+        G3D::Vector3 margin(DYNAMIC_BVH_MARGIN, DYNAMIC_BVH_MARGIN, DYNAMIC_BVH_MARGIN);
+        return G3D::AABox(bounds.low() - margin, bounds.high() + margin);
+    }
+
+    static G3D::AABox merge(G3D::AABox const& a, G3D::AABox const& b)
+    {
+        return G3D::AABox(a.low().min(b.low()), a.high().max(b.high()));
+    }
+
+    static float area(G3D::AABox const& box)
+    {
+        G3D::Vector3 extent = box.high() - box.low();
+        return 2.f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+    }
+
+    static bool contains(G3D::AABox const& outer, G3D::AABox const& inner)
+    {
+        return outer.low().x <= inner.low().x && outer.low().y <= inner.low().y && outer.low().z <= inner.low().z &&
+            outer.high().x >= inner.high().x && outer.high().y >= inner.high().y && outer.high().z >= inner.high().z;
+    }
+
+    static bool intersects(G3D::AABox const& box, G3D::Vector3 const& org, G3D::Vector3 const& invDir, float maxDist, float& entry)
+    {
+        float tmin = 0.f;
+        float tmax = maxDist;
+        for (int i = 0; i < 3; ++i)
+        {
+            float t1 = (box.low()[i] - org[i]) * invDir[i];
+            float t2 = (box.high()[i] - org[i]) * invDir[i];
+            if (t1 > t2)
+                std::swap(t1, t2);
+            // NaN from a ray lying in a slab plane leaves the interval as it is
+            tmin = std::max(tmin, t1);
+            tmax = std::min(tmax, t2);
+            if (tmin > tmax)
+                return false;
+        }
+        entry = tmin;
+        return true;
+    }
+
+    int32 allocateNode()
+    {
+        int32 index;
+        if (m_freeList != NULL_NODE)
+        {
+            index = m_freeList;
+            m_freeList = m_nodes[index].parent;
+        }
+        else
+        {
+            index = int32(m_nodes.size());
+            m_nodes.emplace_back();
+        }
+
+        Node& node = m_nodes[index];
+        node.object = nullptr;
+        node.parent = NULL_NODE;
+        node.left = NULL_NODE;
+        node.right = NULL_NODE;
+        node.height = 0;
+        return index;
+    }
+
+    void freeNode(int32 index)
+    {
+        m_nodes[index].parent = m_freeList;
+        m_nodes[index].height = -1;
+        m_freeList = index;
+    }
+
+    void insertLeaf(int32 leaf)
+    {
+        if (m_root == NULL_NODE)
+        {
+            m_root = leaf;
+            m_nodes[leaf].parent = NULL_NODE;
+            return;
+        }
+
+        // walk down to the sibling that costs the least surface area
+        G3D::AABox leafBounds = m_nodes[leaf].bounds;
+        int32 index = m_root;
+        while (!m_nodes[index].isLeaf())
+        {
+            Node const& node = m_nodes[index];
+            float nodeArea = area(node.bounds);
+            float combinedArea = area(merge(node.bounds, leafBounds));
+
+            // pairing with this node creates a parent covering both
+            float cost = 2.f * combinedArea;
+            // descending makes every box on the way grow to cover the leaf
+            float inheritedCost = 2.f * (combinedArea - nodeArea);
+
+            auto childCost = [&](int32 child)
+            {
+                float merged = area(merge(m_nodes[child].bounds, leafBounds));
+                if (m_nodes[child].isLeaf())
+                    return merged + inheritedCost;
+                return merged - area(m_nodes[child].bounds) + inheritedCost;
+            };
+
+            float leftCost = childCost(node.left);
+            float rightCost = childCost(node.right);
+            if (cost < leftCost && cost < rightCost)
+                break;
+
+            index = leftCost < rightCost ? node.left : node.right;
+        }
+
+        int32 sibling = index;
+        int32 oldParent = m_nodes[sibling].parent;
+        int32 newParent = allocateNode();
+        m_nodes[newParent].parent = oldParent;
+        m_nodes[newParent].bounds = merge(leafBounds, m_nodes[sibling].bounds);
+        m_nodes[newParent].height = m_nodes[sibling].height + 1;
+        m_nodes[newParent].left = sibling;
+        m_nodes[newParent].right = leaf;
+        m_nodes[sibling].parent = newParent;
+        m_nodes[leaf].parent = newParent;
+
+        if (oldParent == NULL_NODE)
+            m_root = newParent;
+        else if (m_nodes[oldParent].left == sibling)
+            m_nodes[oldParent].left = newParent;
+        else
+            m_nodes[oldParent].right = newParent;
+
+        refitAncestors(newParent);
+    }
+
+    void removeLeaf(int32 leaf)
+    {
+        if (leaf == m_root)
+        {
+            m_root = NULL_NODE;
+            return;
+        }
+
+        // the sibling takes the place of the parent
+        int32 parent = m_nodes[leaf].parent;
+        int32 grandParent = m_nodes[parent].parent;
+        int32 sibling = m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left;
+
+        if (grandParent == NULL_NODE)
+        {
+            m_root = sibling;
+            m_nodes[sibling].parent = NULL_NODE;
+        }
+        else
+        {
+            if (m_nodes[grandParent].left == parent)
+                m_nodes[grandParent].left = sibling;
+            else
+                m_nodes[grandParent].right = sibling;
+            m_nodes[sibling].parent = grandParent;
+            refitAncestors(grandParent);
+        }
+
+        freeNode(parent);
+        m_nodes[leaf].parent = NULL_NODE;
+    }
+
+    void refitAncestors(int32 index)
+    {
+        while (index != NULL_NODE)
+        {
+            index = rotate(index);
+
+            Node& node = m_nodes[index];
+            node.height = 1 + std::max(m_nodes[node.left].height, m_nodes[node.right].height);
+            node.bounds = merge(m_nodes[node.left].bounds, m_nodes[node.right].bounds);
+            index = node.parent;
+        }
+    }
+
+    /// Lifts the taller grandchild when the children of a differ in height by more than one, returns the new root of the subtree
+    int32 rotate(int32 a)
+    {
+        Node& nodeA = m_nodes[a];
+        if (nodeA.isLeaf() || nodeA.height < 2)
+            return a;
+
+        int32 b = nodeA.left;
+        int32 c = nodeA.right;
+        int32 balance = m_nodes[c].height - m_nodes[b].height;
+        if (balance > 1)
+            return rotateUp(a, c, b, true);
+        if (balance < -1)
+            return rotateUp(a, b, c, false);
+        return a;
+    }
+
+    // child is the taller child of a and takes its place, a keeps other and the shorter grandchild
+    int32 rotateUp(int32 a, int32 child, int32 other, bool childIsRight)
+    {
+        Node& nodeA = m_nodes[a];
+        Node& nodeChild = m_nodes[child];
+        int32 f = nodeChild.left;
+        int32 g = nodeChild.right;
+
+        nodeChild.left = a;
+        nodeChild.parent = nodeA.parent;
+        nodeA.parent = child;
+
+        if (nodeChild.parent == NULL_NODE)
+            m_root = child;
+        else if (m_nodes[nodeChild.parent].left == a)
+            m_nodes[nodeChild.parent].left = child;
+        else
+            m_nodes[nodeChild.parent].right = child;
+
+        // the taller grandchild stays under child, the other one replaces child under a
+        int32 keep = m_nodes[f].height > m_nodes[g].height ? f : g;
+        int32 give = keep == f ? g : f;
+        nodeChild.right = keep;
+        if (childIsRight)
+            nodeA.right = give;
+        else
+            nodeA.left = give;
+        m_nodes[give].parent = a;
+
+        nodeA.bounds = merge(m_nodes[other].bounds, m_nodes[give].bounds);
+        nodeA.height = 1 + std::max(m_nodes[other].height, m_nodes[give].height);
+        nodeChild.bounds = merge(nodeA.bounds, m_nodes[keep].bounds);
+        nodeChild.height = 1 + std::max(nodeA.height, m_nodes[keep].height);
+        return child;
+    }
+};
+
+#endif // _DYNAMIC_BVH_H
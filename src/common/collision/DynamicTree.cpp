@@ -17,25 +17,18 @@
  */
 
 #include "DynamicTree.h"
-#include "BoundingIntervalHierarchyWrapper.h"
+#include "DynamicBoundingVolumeHierarchy.h"
 #include "GameObjectModel.h"
 #include "Log.h"
 #include "MapTree.h"
 #include "ModelInstance.h"
 #include "RegularGrid.h"
-#include "Timer.h"
 #include <G3D/AABox.h>
 #include <G3D/Ray.h>
 #include <G3D/Vector3.h>
 
 using VMAP::ModelInstance;
 
-namespace {
-
-int CHECK_TREE_PERIOD = 200;
-
-} // namespace
-
 template<> struct HashTrait< GameObjectModel>{
     static size_t hashCode(const GameObjectModel& g) { return (size_t)(void*)&g; }
 };
@@ -55,56 +48,13 @@ static bool operator == (const GameObjectModel& mdl, const GameObjectModel& mdl2
 }
 */
 
-typedef RegularGrid2D<GameObjectModel, BIHWrap<GameObjectModel> > ParentTree;
+typedef RegularGrid2D<GameObjectModel, DynamicBVH<GameObjectModel> > ParentTree;
 
-struct DynTreeImpl : public ParentTree/*, public Intersectable*/
+struct DynTreeImpl : public ParentTree
 {
-    typedef GameObjectModel Model;
-    typedef ParentTree base;
-
-    DynTreeImpl() :
-        rebalance_timer(CHECK_TREE_PERIOD),
-        unbalanced_times(0)
-    {
-    }
-
-    void insert(const Model& mdl)
-    {
-        base::insert(mdl);
-        ++unbalanced_times;
-    }
-
-    void remove(const Model& mdl)
-    {
-        base::remove(mdl);
-        ++unbalanced_times;
-    }
-
-    void balance()
-    {
-        base::balance();
-        unbalanced_times = 0;
-    }
-
-    void update(uint32 difftime)
-    {
-        if (empty())
-            return;
-
-        rebalance_timer.Update(difftime);
-        if (rebalance_timer.Passed())
-        {
-            rebalance_timer.Reset(CHECK_TREE_PERIOD);
-            if (unbalanced_times > 0)
-                balance();
-        }
-    }
-
-    TimeTrackerSmall rebalance_timer;
-    int unbalanced_times;
 };
 
-DynamicMapTree::DynamicMapTree() : impl(new DynTreeImpl()) { }
+DynamicMapTree::DynamicMapTree() : impl(new DynTreeImpl()), _generation(0) { }
 
 DynamicMapTree::~DynamicMapTree()
 {
@@ -115,12 +65,14 @@ void DynamicMapTree::insert(const GameObjectModel& mdl)
 {
     RecursiveGuard guard(dynamic_lock);
     impl->insert(mdl);
+    markChanged();
 }
 
 void DynamicMapTree::remove(const GameObjectModel& mdl)
 {
     RecursiveGuard guard(dynamic_lock);
     impl->remove(mdl);
+    markChanged();
 }
 
 bool DynamicMapTree::contains(const GameObjectModel& mdl) const
@@ -134,9 +86,11 @@ void DynamicMapTree::balance()
     impl->balance();
 }
 
-void DynamicMapTree::update(uint32 t_diff)
+void DynamicMapTree::update(const GameObjectModel& mdl)
 {
-    impl->update(t_diff);
+    RecursiveGuard guard(dynamic_lock);
+    impl->update(mdl);
+    markChanged();
 }
 
 struct DynamicTreeIntersectionCallback
@@ -145,14 +99,15 @@ struct DynamicTreeIntersectionCallback
 
     bool operator()(G3D::Ray const& r, GameObjectModel const& obj, float& distance)
     {
-        _didHit = obj.intersectRay(r, distance, true, _phases, _otherUsePlayerPhasingRules);
-        if (_didHit)
-        {
-            if (obj.owner->IsDoor()) // Collision for door
-                distance = distance > 1.0f ? distance - 1.0f : 0.0f;
-            _go = const_cast<GameObject*>(obj.owner->GetOwner());
-        }
-        return _didHit;
+        // the tree keeps searching for a closer model, a miss must not clear an earlier hit
+        if (!obj.intersectRay(r, distance, true, _phases, _otherUsePlayerPhasingRules))
+            return false;
+
+        if (obj.owner->IsDoor()) // Collision for door
+            distance = distance > 1.0f ? distance - 1.0f : 0.0f;
+        _go = const_cast<GameObject*>(obj.owner->GetOwner());
+        _didHit = true;
+        return true;
     }
 
     bool didHit() const { return _didHit; }
@@ -170,10 +125,12 @@ struct DynamicTreeisInLineOfSightCallback
 
     bool operator()(G3D::Ray const& r, GameObjectModel const& obj, float& distance)
     {
-        _didHit = obj.intersectLine(r, distance, true, _phases, _otherUsePlayerPhasingRules);
-        if (_didHit)
-            _go = const_cast<GameObject*>(obj.owner->GetOwner());
-        return _didHit;
+        if (!obj.intersectLine(r, distance, true, _phases, _otherUsePlayerPhasingRules))
+            return false;
+
+        _go = const_cast<GameObject*>(obj.owner->GetOwner());
+        _didHit = true;
+        return true;
     }
 
     bool didHit() const { return _didHit; }
@@ -267,7 +224,8 @@ bool DynamicMapTree::isInLineOfSight(G3D::Vector3 const& startPos, G3D::Vector3
     G3D::Ray r(startPos, (endPos - startPos) / maxDist);
     DynamicTreeisInLineOfSightCallback callback(phases, otherUsePlayerPhasingRules);
     RecursiveGuard guard(dynamic_lock);
-    impl->intersectRay(r, callback, maxDist, endPos);
+    // any model in the way blocks the sight, the closest one is not needed
+    impl->intersectRay(r, callback, maxDist, endPos, true);
 
     if (callback.didHit())
         if (dCallback)
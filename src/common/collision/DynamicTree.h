@@ -21,6 +21,7 @@
 #define _DYNTREE_H
 
 #include "Define.h"
+#include <atomic>
 #include <set>
 ;
 namespace G3D
@@ -58,11 +59,20 @@ public:
 
     void insert(const GameObjectModel&);
     void remove(const GameObjectModel&);
+    // refits a model after it moved, only its own leaves change
+    void update(const GameObjectModel&);
     bool contains(const GameObjectModel&) const;
 
     void balance();
-    void update(uint32 diff);
+
+    // bumped whenever a model is added, removed, moved or toggled, answers computed under an older generation are stale
+    uint32 getGeneration() const { return _generation.load(std::memory_order_acquire); }
+    void markChanged() { _generation.fetch_add(1, std::memory_order_release); }
+
     mutable std::recursive_mutex dynamic_lock;
+
+private:
+    std::atomic<uint32> _generation;
 };
 
 #endif // _DYNTREE_H
@@ -22,6 +22,11 @@
 #include <string>
 #include "Define.h"
 
+namespace G3D
+{
+    class Vector3;
+}
+
 //===========================================================
 
 /**
@@ -40,6 +45,7 @@ namespace VMAP
 
     #define VMAP_INVALID_HEIGHT       -100000.0f            // for check
     #define VMAP_INVALID_HEIGHT_VALUE -200000.0f            // real assigned value in unknown height case
+    #define VMAP_MAX_LOS_BATCH        64                    // targets of one batched line of sight query
 
     //===========================================================
     class IVMapManager
@@ -61,6 +67,11 @@ namespace VMAP
             virtual void unloadMap(unsigned int pMapId) = 0;
 
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) = 0;
+            /**
+            test line of sight from origin to up to VMAP_MAX_LOS_BATCH targets at once
+            return a mask with bit i set if targets[i] is visible
+            */
+            virtual uint64 isInLineOfSight(unsigned int pMapId, G3D::Vector3 const& origin, G3D::Vector3 const* targets, uint32 count) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /**
             test if we hit an object. return true if we hit one. rx, ry, rz will hold the hit position or the dest position, if no intersection was found
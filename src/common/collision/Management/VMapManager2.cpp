@@ -211,6 +211,25 @@ namespace VMAP
         return true;
     }
 
+    uint64 VMapManager2::isInLineOfSight(unsigned int mapId, Vector3 const& origin, Vector3 const* targets, uint32 count)
+    {
+        ASSERT(count <= VMAP_MAX_LOS_BATCH);
+        uint64 allVisible = count < 64 ? (UI64LIT(1) << count) - 1 : ~UI64LIT(0);
+        if (!isLineOfSightCalcEnabled() || IsVMAPDisabledForPtr(mapId, VMAP_DISABLE_LOS))
+            return allVisible;
+
+        auto instanceTree = GetMapTree(mapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return allVisible;
+
+        Vector3 pos1 = convertPositionToInternalRep(origin.x, origin.y, origin.z);
+        Vector3 pos2[VMAP_MAX_LOS_BATCH];
+        for (uint32 i = 0; i < count; ++i)
+            pos2[i] = convertPositionToInternalRep(targets[i].x, targets[i].y, targets[i].z);
+
+        return instanceTree->second->isInLineOfSight(pos1, pos2, count);
+    }
+
     /**
     get the hit position and return true if we hit something
     otherwise the result pos will be the dest pos
@@ -112,6 +112,7 @@ namespace VMAP
             void unloadSingleMap(uint32 mapId);
 
             bool isInLineOfSight(unsigned int mapId, float x1, float y1, float z1, float x2, float y2, float z2) override ;
+            uint64 isInLineOfSight(unsigned int mapId, G3D::Vector3 const& origin, G3D::Vector3 const* targets, uint32 count) override;
             /**
             fill the hit pos and return true, if an object was hit
             */
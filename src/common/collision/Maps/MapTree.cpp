@@ -27,6 +27,7 @@
 #include <sstream>
 #include <iomanip>
 #include <limits>
+#include <algorithm>
 
 using G3D::Vector3;
 
@@ -203,6 +204,58 @@ namespace VMAP
 
         return true;
     }
+    /**
+    Same checks as above for every target, the rays are sorted by heading and traced in packets
+    so rays leaving in similar directions share the node visits
+    */
+    uint64 StaticMapTree::isInLineOfSight(const Vector3& origin, const Vector3* targets, uint32 count) const
+    {
+        uint64 visible = 0;
+        uint32 order[VMAP_MAX_LOS_BATCH];
+        float heading[VMAP_MAX_LOS_BATCH];
+        float maxDists[VMAP_MAX_LOS_BATCH];
+        uint32 rays = 0;
+        for (uint32 i = 0; i < count; ++i)
+        {
+            float maxDist = (targets[i] - origin).magnitude();
+            if (!G3D::fuzzyGt(maxDist, 0) || maxDist < 1e-10f)
+            {
+                visible |= UI64LIT(1) << i;
+                continue;
+            }
+
+            if (maxDist >= std::numeric_limits<float>::max() || !std::isfinite(maxDist))
+                continue;
+
+            maxDists[i] = maxDist;
+            heading[i] = std::atan2(targets[i].y - origin.y, targets[i].x - origin.x);
+            order[rays++] = i;
+        }
+
+        std::sort(order, order + rays, [&heading](uint32 left, uint32 right) { return heading[left] < heading[right]; });
+
+        MapRayLineCallback intersectionCallBack(iTreeValues);
+        G3D::Ray packet[BIH_PACKET_SIZE];
+        float packetDists[BIH_PACKET_SIZE];
+        for (uint32 first = 0; first < rays; first += BIH_PACKET_SIZE)
+        {
+            uint32 lanes = std::min<uint32>(rays - first, BIH_PACKET_SIZE);
+            for (uint32 lane = 0; lane < lanes; ++lane)
+            {
+                uint32 i = order[first + lane];
+                // direction with length of 1
+                packet[lane] = G3D::Ray::fromOriginAndDirection(origin, (targets[i] - origin) / maxDists[i]);
+                packetDists[lane] = maxDists[i];
+            }
+
+            uint32 hits = iTree.intersectRayPacket(packet, packetDists, (1 << lanes) - 1, intersectionCallBack);
+            for (uint32 lane = 0; lane < lanes; ++lane)
+                if (!(hits & (1 << lane)))
+                    visible |= UI64LIT(1) << order[first + lane];
+        }
+
+        return visible;
+    }
     //=========================================================
     /**
     When moving from pos1 to pos2 check if we hit an object. Return true and the position if we hit one
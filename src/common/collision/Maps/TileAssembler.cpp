@@ -22,9 +22,11 @@
 #include "StringFormat.h"
 #include "VMapDefinitions.h"
 #include <boost/filesystem.hpp>
+#include <atomic>
 #include <iomanip>
 #include <set>
 #include <sstream>
+#include <thread>
 
 using G3D::Vector3;
 using G3D::AABox;
@@ -36,6 +38,29 @@ template<> struct BoundsTrait<VMAP::ModelSpawn*>
     static void getBounds(const VMAP::ModelSpawn* const &obj, G3D::AABox& out) { out = obj->getBounds(); }
 };
 
+namespace
+{
+    // calls work(0..count-1) spread over up to threads threads, the calling thread takes part
+    template<class Work>
+    void RunParallel(uint32 threads, std::size_t count, Work&& work)
+    {
+        std::atomic<std::size_t> next(0);
+        auto worker = [&]()
+        {
+            for (std::size_t i = next++; i < count; i = next++)
+                work(i);
+        };
+
+        std::vector<std::thread> workers;
+        for (uint32 i = 1; i < threads && i < count; ++i)
+            workers.emplace_back(worker);
+
+        worker();
+        for (std::thread& thread : workers)
+            thread.join();
+    }
+}
+
 namespace VMAP
 {
     bool readChunk(FILE* rf, char *dest, const char *compare, uint32 len)
@@ -53,8 +78,8 @@ namespace VMAP
 
     //=================================================================
 
-    TileAssembler::TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName)
-        : iDestDir(pDestDirName), iSrcDir(pSrcDirName)
+    TileAssembler::TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName, uint32 threads)
+        : iDestDir(pDestDirName), iSrcDir(pSrcDirName), iThreads(std::max(threads, 1u))
     {
         boost::filesystem::create_directory(iDestDir);
     }
@@ -81,24 +106,38 @@ namespace VMAP
             std::vector<ModelSpawn*> mapSpawns;
             mapSpawns.reserve(data.UniqueEntries.size());
             printf("Calculating model bounds for map %u...\n", data.MapId);
+
+            // M2 models don't have a bound set in WDT/ADT placement data, i still think they're not used for LoS at all on retail
+            // every one of them reads its raw model file, spawns are spread over the worker threads
+            std::vector<ModelSpawn*> entries;
+            entries.reserve(data.UniqueEntries.size());
             for (auto entry = data.UniqueEntries.begin(); entry != data.UniqueEntries.end(); ++entry)
+                entries.push_back(&entry->second);
+
+            std::vector<uint8> hasBound(entries.size(), 1);
+            RunParallel(iThreads, entries.size(), [&](std::size_t i)
             {
-                // M2 models don't have a bound set in WDT/ADT placement data, i still think they're not used for LoS at all on retail
-                if (entry->second.flags & MOD_M2)
-                    if (!calculateTransformedBound(entry->second))
-                        continue;
+                if (entries[i]->flags & MOD_M2)
+                    hasBound[i] = calculateTransformedBound(*entries[i]);
+            });
 
-                mapSpawns.push_back(&entry->second);
-                spawnedModelFiles.insert(entry->second.name);
+            for (std::size_t i = 0; i < entries.size(); ++i)
+            {
+                if (!hasBound[i])
+                    continue;
+
+                ModelSpawn& spawn = *entries[i];
+                mapSpawns.push_back(&spawn);
+                spawnedModelFiles.insert(spawn.name);
 
-                std::map<uint32, std::set<TileSpawn>>& tileEntries = (entry->second.flags & MOD_PARENT_SPAWN) ? data.ParentTileEntries : data.TileEntries;
+                std::map<uint32, std::set<TileSpawn>>& tileEntries = (spawn.flags & MOD_PARENT_SPAWN) ? data.ParentTileEntries : data.TileEntries;
 
-                G3D::AABox const& bounds = entry->second.iBound;
+                G3D::AABox const& bounds = spawn.iBound;
                 G3D::Vector2int16 low(int16(bounds.low().x * invTileSize), int16(bounds.low().y * invTileSize));
                 G3D::Vector2int16 high(int16(bounds.high().x * invTileSize), int16(bounds.high().y * invTileSize));
                 for (int x = low.x; x <= high.x; ++x)
                     for (int y = low.y; y <= high.y; ++y)
-                        tileEntries[StaticMapTree::packTileID(x, y)].emplace(entry->second.ID, entry->second.flags);
+                        tileEntries[StaticMapTree::packTileID(x, y)].emplace(spawn.ID, spawn.flags);
             }
 
             printf("Creating map tree for map %u...\n", data.MapId);
@@ -148,49 +187,67 @@ namespace VMAP
             // <====
 
             // write map tile files, similar to ADT files, only with extra BIH tree node info
+            std::vector<std::map<uint32, std::set<TileSpawn>>::const_iterator> tiles;
+            tiles.reserve(data.TileEntries.size());
             for (auto tileItr = data.TileEntries.begin(); tileItr != data.TileEntries.end(); ++tileItr)
+                tiles.push_back(tileItr);
+
+            std::atomic<bool> tilesWritten(success);
+            RunParallel(iThreads, tiles.size(), [&](std::size_t i)
             {
+                auto tileItr = tiles[i];
                 uint32 x, y;
                 StaticMapTree::unpackTileID(tileItr->first, x, y);
                 std::string tileFileName = Trinity::StringFormat("%s/%04u_%02u_%02u.vmtile", iDestDir.c_str(), data.MapId, y, x);
                 if (FILE* tileFile = fopen(tileFileName.c_str(), "wb"))
                 {
-                    std::set<TileSpawn> const& parentTileEntries = data.ParentTileEntries[tileItr->first];
+                    static std::set<TileSpawn> const noParentTileEntries;
+                    auto parentItr = data.ParentTileEntries.find(tileItr->first);
+                    std::set<TileSpawn> const& parentTileEntries = parentItr != data.ParentTileEntries.end() ? parentItr->second : noParentTileEntries;
 
                     uint32 nSpawns = tileItr->second.size() + parentTileEntries.size();
 
+                    bool written = tilesWritten;
                     // file header
-                    if (success && fwrite(VMAP_MAGIC, 1, 8, tileFile) != 8) success = false;
+                    if (written && fwrite(VMAP_MAGIC, 1, 8, tileFile) != 8) written = false;
                     // write number of tile spawns
-                    if (success && fwrite(&nSpawns, sizeof(uint32), 1, tileFile) != 1) success = false;
+                    if (written && fwrite(&nSpawns, sizeof(uint32), 1, tileFile) != 1) written = false;
                     // write tile spawns
-                    for (auto spawnItr = tileItr->second.begin(); spawnItr != tileItr->second.end() && success; ++spawnItr)
-                        success = ModelSpawn::writeToFile(tileFile, data.UniqueEntries[spawnItr->Id]);
+                    for (auto spawnItr = tileItr->second.begin(); spawnItr != tileItr->second.end() && written; ++spawnItr)
+                        written = ModelSpawn::writeToFile(tileFile, data.UniqueEntries.at(spawnItr->Id));
 
-                    for (auto spawnItr = parentTileEntries.begin(); spawnItr != parentTileEntries.end() && success; ++spawnItr)
-                        success = ModelSpawn::writeToFile(tileFile, data.UniqueEntries[spawnItr->Id]);
+                    for (auto spawnItr = parentTileEntries.begin(); spawnItr != parentTileEntries.end() && written; ++spawnItr)
+                        written = ModelSpawn::writeToFile(tileFile, data.UniqueEntries.at(spawnItr->Id));
 
                     fclose(tileFile);
+                    if (!written)
+                        tilesWritten = false;
                 }
-            }
+            });
+
+            success = tilesWritten;
         }
 
         // add an object models, listed in temp_gameobject_models file
         exportGameobjectModels();
         // export objects
         std::cout << "\nConverting Model Files" << std::endl;
-        for (std::set<std::string>::iterator mfile = spawnedModelFiles.begin(); mfile != spawnedModelFiles.end(); ++mfile)
+        std::vector<std::string> modelFiles(spawnedModelFiles.begin(), spawnedModelFiles.end());
+        std::atomic<bool> modelsConverted(true);
+        RunParallel(iThreads, modelFiles.size(), [&](std::size_t i)
         {
-            std::cout << "Converting " << *mfile << std::endl;
-            if (!convertRawFile(*mfile))
+            if (!modelsConverted)
+                return;
+
+            printf("Converting %s\n", modelFiles[i].c_str());
+            if (!convertRawFile(modelFiles[i]))
             {
-                std::cout << "error converting " << *mfile << std::endl;
-                success = false;
-                break;
+                printf("error converting %s\n", modelFiles[i].c_str());
+                modelsConverted = false;
             }
-        }
+        });
 
-        return success;
+        return success && modelsConverted;
     }
 
     bool TileAssembler::readMapSpawns()
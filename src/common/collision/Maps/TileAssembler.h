@@ -109,11 +109,12 @@ namespace VMAP
         private:
             std::string iDestDir;
             std::string iSrcDir;
+            uint32 iThreads;
             MapData mapData;
             std::set<std::string> spawnedModelFiles;
 
         public:
-            TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName);
+            TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName, uint32 threads = 1);
             virtual ~TileAssembler();
 
             bool convertWorld2();
@@ -6,7 +6,10 @@
 #include <G3D/Ray.h>
 #include <G3D/BoundsTrait.h>
 #include <G3D/PositionTrait.h>
+#include <algorithm>
+#include <map>
 #include <unordered_map>
+#include <vector>
 
 template<class Node>
 struct NodeCreator{
@@ -72,6 +75,44 @@ public:
         memberTable.erase(&value);
     }
 
+    /// Refits value after it moved, nodes it stays in only update its leaf
+    void update(const T& value)
+    {
+        auto members = Trinity::Containers::MapEqualRange(memberTable, &value);
+        if (members.begin() == members.end())
+            return;
+
+        std::vector<Node*> oldNodes;
+        for (auto& p : members)
+            oldNodes.push_back(p.second);
+        memberTable.erase(&value);
+
+        G3D::AABox bounds;
+        BoundsFunc::getBounds(value, bounds);
+        Cell low = Cell::ComputeCell(bounds.low().x, bounds.low().y);
+        Cell high = Cell::ComputeCell(bounds.high().x, bounds.high().y);
+        for (int x = low.x; x <= high.x; ++x)
+        {
+            for (int y = low.y; y <= high.y; ++y)
+            {
+                Node& node = getGrid(x, y);
+                auto itr = std::find(oldNodes.begin(), oldNodes.end(), &node);
+                if (itr != oldNodes.end())
+                {
+                    node.update(value);
+                    oldNodes.erase(itr);
+                }
+                else
+                    node.insert(value);
+                memberTable.emplace(&value, &node);
+            }
+        }
+
+        // cells it left
+        for (Node* node : oldNodes)
+            node->remove(value);
+    }
+
     void balance()
     {
         for (int x = 0; x < CELL_NUMBER; ++x)
@@ -106,13 +147,13 @@ public:
     }
 
     template<typename RayCallback>
-    void intersectRay(const G3D::Ray& ray, RayCallback& intersectCallback, float max_dist)
+    void intersectRay(const G3D::Ray& ray, RayCallback& intersectCallback, float max_dist, bool stopAtFirst = false)
     {
-        intersectRay(ray, intersectCallback, max_dist, ray.origin() + ray.direction() * max_dist);
+        intersectRay(ray, intersectCallback, max_dist, ray.origin() + ray.direction() * max_dist, stopAtFirst);
     }
 
     template<typename RayCallback>
-    void intersectRay(const G3D::Ray& ray, RayCallback& intersectCallback, float& max_dist, const G3D::Vector3& end)
+    void intersectRay(const G3D::Ray& ray, RayCallback& intersectCallback, float& max_dist, const G3D::Vector3& end, bool stopAtFirst = false)
     {
         Cell cell = Cell::ComputeCell(ray.origin().x, ray.origin().y);
         if (!cell.isValid())
@@ -123,7 +164,7 @@ public:
         if (cell == last_cell)
         {
             if (Node* node = nodes[cell.x][cell.y])
-                node->intersectRay(ray, intersectCallback, max_dist);
+                node->intersectRay(ray, intersectCallback, max_dist, stopAtFirst);
             return;
         }
 
@@ -169,7 +210,7 @@ public:
             if (Node* node = nodes[cell.x][cell.y])
             {
                 //float enterdist = max_dist;
-                node->intersectRay(ray, intersectCallback, max_dist);
+                node->intersectRay(ray, intersectCallback, max_dist, stopAtFirst);
             }
             if (cell == last_cell)
                 break;
@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2008-2016 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LoginHttpSession.h"
+#include "JSON/ProtobufJSON.h"
+#include "LoginHttpSessionManager.h"
+#include "LoginRESTService.h"
+#include "StringFormat.h"
+#include "Timer.h"
+#include <boost/algorithm/string.hpp>
+#include <algorithm>
+
+namespace
+{
+    std::size_t const MaxHeaderSize = 8 * 1024;
+    std::size_t const MaxBodySize = 16 * 1024;
+
+    char const* GetStatusText(uint32 status)
+    {
+        switch (status)
+        {
+            case 200: return "OK";
+            case 400: return "Bad Request";
+            case 404: return "Not Found";
+            case 405: return "Method Not Allowed";
+            case 411: return "Length Required";
+            case 413: return "Payload Too Large";
+            case 415: return "Unsupported Media Type";
+            case 431: return "Request Header Fields Too Large";
+            case 500: return "Internal Server Error";
+            case 501: return "Not Implemented";
+            case 503: return "Service Unavailable";
+            default:  return "Unknown";
+        }
+    }
+}
+
+Battlenet::LoginHttpSession::LoginHttpSession(tcp::socket&& socket) : HttpSocket(std::move(socket)), _lastActivity(getMSTime()), _handledRequests(0),
+    _requestPending(false), _readPaused(false)
+{
+}
+
+void Battlenet::LoginHttpSession::Start()
+{
+    TC_LOG_TRACE(LOG_FILTER_BATTLENET, "REST %s Accepted connection", GetClientInfo().c_str());
+
+    underlying_stream().async_handshake(boost::asio::ssl::stream_base::server, std::bind(&LoginHttpSession::HandshakeHandler, shared_from_this(), std::placeholders::_1));
+}
+
+bool Battlenet::LoginHttpSession::Update()
+{
+    if (!HttpSocket::Update())
+        return false;
+
+    _queryProcessor.ProcessReadyQueries();
+
+    // idle keep-alive connections (and stalled handshakes) are dropped, a login waiting on the database is not idle
+    if (!_requestPending && GetMSTimeDiffToNow(_lastActivity) > sLoginHttpSessionMgr.GetKeepAliveTimeout())
+    {
+        TC_LOG_TRACE(LOG_FILTER_BATTLENET, "REST %s Keep-alive timeout", GetClientInfo().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void Battlenet::LoginHttpSession::HandshakeHandler(boost::system::error_code const& error)
+{
+    if (error)
+    {
+        TC_LOG_DEBUG(LOG_FILTER_BATTLENET, "REST %s SSL Handshake failed %s", GetClientInfo().c_str(), error.message().c_str());
+        CloseSocket();
+        return;
+    }
+
+    _lastActivity = getMSTime();
+    AsyncRead();
+}
+
+void Battlenet::LoginHttpSession::ReadHandler()
+{
+    if (!IsOpen())
+        return;
+
+    _lastActivity = getMSTime();
+
+    ProcessRequests();
+    if (!IsOpen())
+        return;
+
+    // a request is being handled, next one is read once it is answered
+    if (_requestPending)
+        _readPaused = true;
+    else
+        AsyncRead();
+}
+
+void Battlenet::LoginHttpSession::ResumeReading()
+{
+    if (!_readPaused || !IsOpen())
+        return;
+
+    _readPaused = false;
+
+    // pipelined requests may already be buffered
+    ProcessRequests();
+    if (!IsOpen())
+        return;
+
+    if (_requestPending)
+        _readPaused = true;
+    else
+        AsyncRead();
+}
+
+void Battlenet::LoginHttpSession::ProcessRequests()
+{
+    while (!_requestPending && IsOpen())
+    {
+        uint32 errorStatus = 0;
+        ParseStatus status = ParseRequest(errorStatus);
+        if (status == PARSE_INCOMPLETE)
+            break;
+
+        _requestPending = true;
+
+        if (status == PARSE_ERROR)
+        {
+            TC_LOG_DEBUG(LOG_FILTER_BATTLENET, "REST %s Malformed request, answering %u", GetClientInfo().c_str(), errorStatus);
+            _request.KeepAlive = false;
+            SendResponse(errorStatus, std::string());
+            break;
+        }
+
+        if (++_handledRequests >= sLoginHttpSessionMgr.GetMaxKeepAliveRequests())
+            _request.KeepAlive = false;
+
+        TC_LOG_DEBUG(LOG_FILTER_BATTLENET, "REST %s Handling %s request path=\"%s\"", GetClientInfo().c_str(), _request.Method.c_str(), _request.Path.c_str());
+
+        if (_request.Method == "GET")
+            sLoginService.HandleGet(*this, _request);
+        else if (_request.Method == "POST")
+            sLoginService.HandlePost(*this, _request);
+        else
+            SendResponse(405, std::string());
+    }
+}
+
+Battlenet::LoginHttpSession::ParseStatus Battlenet::LoginHttpSession::ParseRequest(uint32& errorStatus)
+{
+    MessageBuffer& buffer = GetReadBuffer();
+    char const* data = reinterpret_cast<char const*>(buffer.GetReadPointer());
+    std::size_t size = buffer.GetActiveSize();
+
+    static char const HeaderEnd[] = "\r\n\r\n";
+    char const* headerEnd = std::search(data, data + size, HeaderEnd, HeaderEnd + 4);
+    if (headerEnd == data + size)
+    {
+        if (size > MaxHeaderSize)
+        {
+            errorStatus = 431;
+            return PARSE_ERROR;
+        }
+
+        return PARSE_INCOMPLETE;
+    }
+
+    std::size_t headerSize = headerEnd - data + 4;
+    if (headerSize > MaxHeaderSize)
+    {
+        errorStatus = 431;
+        return PARSE_ERROR;
+    }
+
+    errorStatus = 400;
+
+    std::vector<std::string> lines;
+    for (char const* lineStart = data; lineStart < headerEnd;)
+    {
+        char const* lineEnd = std::search(lineStart, headerEnd, HeaderEnd, HeaderEnd + 2);
+        lines.emplace_back(lineStart, lineEnd);
+        lineStart = lineEnd + 2;
+    }
+
+    if (lines.empty())
+        return PARSE_ERROR;
+
+    // METHOD SP request-target SP HTTP-version
+    std::vector<std::string> requestLine;
+    boost::algorithm::split(requestLine, lines[0], boost::algorithm::is_any_of(" "), boost::algorithm::token_compress_on);
+    if (requestLine.size() != 3 || !boost::algorithm::starts_with(requestLine[2], "HTTP/1."))
+        return PARSE_ERROR;
+
+    _request.Method = requestLine[0];
+    _request.Path = requestLine[1];
+    _request.ContentType.clear();
+    _request.Body.clear();
+    _request.KeepAlive = requestLine[2] != "HTTP/1.0";
+
+    bool hasContentLength = false;
+    std::size_t contentLength = 0;
+    for (std::size_t i = 1; i < lines.size(); ++i)
+    {
+        std::string::size_type separator = lines[i].find(':');
+        if (separator == std::string::npos)
+            return PARSE_ERROR;
+
+        std::string name = boost::algorithm::trim_copy(lines[i].substr(0, separator));
+        std::string value = boost::algorithm::trim_copy(lines[i].substr(separator + 1));
+
+        if (boost::algorithm::iequals(name, "Content-Length"))
+        {
+            if (value.empty() || value.size() > 9 || value.find_first_not_of("0123456789") != std::string::npos)
+                return PARSE_ERROR;
+
+            hasContentLength = true;
+            contentLength = std::stoul(value);
+        }
+        else if (boost::algorithm::iequals(name, "Content-Type"))
+            _request.ContentType = value;
+        else if (boost::algorithm::iequals(name, "Connection"))
+        {
+            if (boost::algorithm::icontains(value, "close"))
+                _request.KeepAlive = false;
+            else if (boost::algorithm::icontains(value, "keep-alive"))
+                _request.KeepAlive = true;
+        }
+        else if (boost::algorithm::iequals(name, "Transfer-Encoding"))
+        {
+            // launchers always send a Content-Length
+            errorStatus = 501;
+            return PARSE_ERROR;
+        }
+    }
+
+    if (_request.Method == "POST" && !hasContentLength)
+    {
+        errorStatus = 411;
+        return PARSE_ERROR;
+    }
+
+    if (contentLength > MaxBodySize)
+    {
+        errorStatus = 413;
+        return PARSE_ERROR;
+    }
+
+    if (size < headerSize + contentLength)
+        return PARSE_INCOMPLETE;
+
+    _request.Body.assign(data + headerSize, contentLength);
+    buffer.ReadCompleted(headerSize + contentLength);
+    return PARSE_COMPLETE;
+}
+
+void Battlenet::LoginHttpSession::SendResponse(uint32 status, google::protobuf::Message const& response, uint32 retryAfter /*= 0*/)
+{
+    SendResponse(status, ::JSON::Serialize(response), retryAfter);
+}
+
+void Battlenet::LoginHttpSession::SendResponse(uint32 status, std::string const& body, uint32 retryAfter /*= 0*/)
+{
+    if (!IsOpen())
+        return;
+
+    std::string header = Trinity::StringFormat("HTTP/1.1 %u %s\r\n"
+        "Content-Type: application/json;charset=utf-8\r\n"
+        "Content-Length: %u\r\n"
+        "Connection: %s\r\n"
+        "%s"
+        "\r\n", status, GetStatusText(status), uint32(body.length()), _request.KeepAlive ? "keep-alive" : "close",
+        retryAfter ? Trinity::StringFormat("Retry-After: %u\r\n", retryAfter).c_str() : "");
+
+    MessageBuffer packet(header.length() + body.length());
+    packet.Write(header.data(), header.length());
+    packet.Write(body.data(), body.length());
+    QueuePacket(std::move(packet));
+
+    TC_LOG_DEBUG(LOG_FILTER_BATTLENET, "REST %s Answered %u", GetClientInfo().c_str(), status);
+
+    _requestPending = false;
+    _lastActivity = getMSTime();
+
+    if (!_request.KeepAlive)
+    {
+        DelayedCloseSocket();
+        return;
+    }
+
+    ResumeReading();
+}
+
+std::string Battlenet::LoginHttpSession::GetClientInfo() const
+{
+    return Trinity::StringFormat("[%s:%u]", GetRemoteIpAddress().to_string().c_str(), GetRemotePort());
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2008-2016 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LoginHttpSession_h__
+#define LoginHttpSession_h__
+
+#include "QueryCallback.h"
+#include "QueryCallbackProcessor.h"
+#include "Socket.h"
+#include "SslContext.h"
+#include "SslSocket.h"
+#include <google/protobuf/message.h>
+#include <string>
+
+using boost::asio::ip::tcp;
+
+namespace Battlenet
+{
+    struct HttpRequest
+    {
+        std::string Method;
+        std::string Path;
+        std::string ContentType;
+        std::string Body;
+        bool KeepAlive = true;
+    };
+
+    /// HTTPS connection of the launcher login (LoginRESTService).
+    /// Requests are handled one at a time, the connection stays open between them unless the client asks otherwise.
+    class LoginHttpSession : public Socket<LoginHttpSession, SslSocket<SslContext>>
+    {
+        typedef Socket<LoginHttpSession, SslSocket<SslContext>> HttpSocket;
+
+    public:
+        explicit LoginHttpSession(tcp::socket&& socket);
+
+        void Start() override;
+        bool Update() override;
+
+        // retryAfter (seconds) is sent as Retry-After header when not 0
+        void SendResponse(uint32 status, google::protobuf::Message const& response, uint32 retryAfter = 0);
+        void SendResponse(uint32 status, std::string const& body, uint32 retryAfter = 0);
+
+        void AddQueryCallback(QueryCallback&& callback) { _queryProcessor.AddQuery(std::move(callback)); }
+
+        std::string GetClientInfo() const;
+
+    protected:
+        void ReadHandler() override;
+
+    private:
+        enum ParseStatus
+        {
+            PARSE_INCOMPLETE,
+            PARSE_COMPLETE,
+            PARSE_ERROR
+        };
+
+        void HandshakeHandler(boost::system::error_code const& error);
+
+        ParseStatus ParseRequest(uint32& errorStatus);
+        void ProcessRequests();
+        void ResumeReading();
+
+        QueryCallbackProcessor _queryProcessor;
+        HttpRequest _request;
+        uint32 _lastActivity;
+        uint32 _handledRequests;
+        bool _requestPending;
+        bool _readPaused;
+    };
+}
+
+#endif // LoginHttpSession_h__
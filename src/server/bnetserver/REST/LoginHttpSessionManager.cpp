@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2008-2016 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LoginHttpSessionManager.h"
+#include "Common.h"
+#include "Configuration/Config.h"
+
+bool Battlenet::LoginHttpSessionManager::StartNetwork(boost::asio::io_context& service, std::string const& bindIp, uint16 port, int threadCount)
+{
+    _maxConnections = uint32(std::max(sConfigMgr->GetIntDefault("LoginREST.MaxConnections", 2000), 1));
+    _keepAliveTimeout = uint32(std::max(sConfigMgr->GetIntDefault("LoginREST.KeepAliveTimeout", 15), 1)) * IN_MILLISECONDS;
+    _maxKeepAliveRequests = uint32(std::max(sConfigMgr->GetIntDefault("LoginREST.MaxKeepAliveRequests", 100), 1));
+
+    if (!BaseSocketMgr::StartNetwork(service, bindIp, port, threadCount))
+        return false;
+
+    _acceptor->SetSocketFactory(std::bind(&BaseSocketMgr::GetSocketForAccept, this));
+    _acceptor->AsyncAcceptWithCallback<&OnSocketAccept>();
+    return true;
+}
+
+void Battlenet::LoginHttpSessionManager::OnSocketOpen(tcp::socket&& sock, uint32 threadIndex)
+{
+    // refuse before the TLS handshake, a reconnect storm must not turn into thousands of concurrent handshakes
+    if (uint32(GetConnectionCount()) >= _maxConnections)
+    {
+        boost::system::error_code error;
+        TC_LOG_DEBUG(LOG_FILTER_BATTLENET, "REST Refused connection from %s, %u connections open", sock.remote_endpoint(error).address().to_string().c_str(), _maxConnections);
+        sock.close(error);
+        return;
+    }
+
+    BaseSocketMgr::OnSocketOpen(std::forward<tcp::socket>(sock), threadIndex);
+}
+
+int32 Battlenet::LoginHttpSessionManager::GetConnectionCount() const
+{
+    int32 connections = 0;
+    for (int32 i = 0; i < _threadCount; ++i)
+        connections += _threads[i].GetConnectionCount();
+
+    return connections;
+}
+
+NetworkThread<Battlenet::LoginHttpSession>* Battlenet::LoginHttpSessionManager::CreateThreads() const
+{
+    return new NetworkThread<LoginHttpSession>[GetNetworkThreadCount()];
+}
+
+void Battlenet::LoginHttpSessionManager::OnSocketAccept(tcp::socket&& sock, uint32 threadIndex)
+{
+    sLoginHttpSessionMgr.OnSocketOpen(std::forward<tcp::socket>(sock), threadIndex);
+}
+
+Battlenet::LoginHttpSessionManager& Battlenet::LoginHttpSessionManager::Instance()
+{
+    static LoginHttpSessionManager instance;
+    return instance;
+}
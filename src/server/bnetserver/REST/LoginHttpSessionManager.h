@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2008-2016 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LoginHttpSessionManager_h__
+#define LoginHttpSessionManager_h__
+
+#include "SocketMgr.h"
+#include "LoginHttpSession.h"
+
+namespace Battlenet
+{
+    class LoginHttpSessionManager : public SocketMgr<LoginHttpSession>
+    {
+        typedef SocketMgr<LoginHttpSession> BaseSocketMgr;
+
+    public:
+        static LoginHttpSessionManager& Instance();
+
+        bool StartNetwork(boost::asio::io_context& service, std::string const& bindIp, uint16 port, int threadCount = 1) override;
+
+        void OnSocketOpen(tcp::socket&& sock, uint32 threadIndex) override;
+
+        int32 GetConnectionCount() const;
+
+        uint32 GetMaxConnections() const { return _maxConnections; }
+        uint32 GetKeepAliveTimeout() const { return _keepAliveTimeout; }
+        uint32 GetMaxKeepAliveRequests() const { return _maxKeepAliveRequests; }
+
+    protected:
+        LoginHttpSessionManager() : _maxConnections(0), _keepAliveTimeout(0), _maxKeepAliveRequests(0) { }
+
+        NetworkThread<LoginHttpSession>* CreateThreads() const override;
+
+    private:
+        static void OnSocketAccept(tcp::socket&& sock, uint32 threadIndex);
+
+        uint32 _maxConnections;
+        uint32 _keepAliveTimeout;
+        uint32 _maxKeepAliveRequests;
+    };
+}
+
+#define sLoginHttpSessionMgr Battlenet::LoginHttpSessionManager::Instance()
+
+#endif // LoginHttpSessionManager_h__
@@ -19,34 +19,23 @@
 #include "Configuration/Config.h"
 #include "DatabaseEnv.h"
 #include "JSON/ProtobufJSON.h"
+#include "LoginHttpSessionManager.h"
 #include "Realm.h"
-#include "SessionManager.h"
 #include "SHA1.h"
 #include "SHA256.h"
-#include "SslContext.h"
 #include "Util.h"
-#include "httpget.h"
-#include "httppost.h"
-#include "soapH.h"
 #include "IpNetwork.h"
 #include "Resolver.h"
-
-int ns1__executeCommand(soap*, char*, char**) { return SOAP_OK; }
-
-int32 handle_get_plugin(soap* soapClient)
-{
-    return sLoginService.HandleGet(soapClient);
-}
-
-int32 handle_post_plugin(soap* soapClient)
-{
-    return sLoginService.HandlePost(soapClient);
-}
+#include <boost/algorithm/string/predicate.hpp>
 
 bool LoginRESTService::Start(boost::asio::io_context& ioService)
 {
     _waitTime = sConfigMgr->GetIntDefault("RestWaitTime", 60);
 
+    _loginWithAccount = sConfigMgr->GetBoolDefault("Login.with.account", false);
+    _maxPendingLogins = uint32(std::max(sConfigMgr->GetIntDefault("LoginREST.MaxPendingLogins", 200), 1));
+    _busyRetryAfter = uint32(std::max(sConfigMgr->GetIntDefault("LoginREST.BusyRetryAfter", 5), 1));
+
     _bindIP = sConfigMgr->GetStringDefault("BindIP", "0.0.0.0");
     _port = sConfigMgr->GetIntDefault("LoginREST.Port", 8081);
     if (_port < 0 || _port > 0xFFFF)
@@ -102,15 +91,29 @@ bool LoginRESTService::Start(boost::asio::io_context& ioService)
     _loginTicketCleanupTimer->expires_from_now(boost::posix_time::seconds(10));
     _loginTicketCleanupTimer->async_wait(std::bind(&LoginRESTService::CleanupLoginTickets, this, std::placeholders::_1));
 
-    _thread = std::thread(std::bind(&LoginRESTService::Run, this));
+    int32 threadCount = sConfigMgr->GetIntDefault("LoginREST.Threads", 1);
+    if (threadCount <= 0)
+    {
+        TC_LOG_ERROR(LOG_FILTER_BATTLENET, "REST LoginREST.Threads must be greater than 0");
+        return false;
+    }
+
+    if (!sLoginHttpSessionMgr.StartNetwork(ioService, _bindIP, _port, threadCount))
+    {
+        TC_LOG_ERROR(LOG_FILTER_BATTLENET, "REST Couldn't bind to %s:%d", _bindIP.c_str(), _port);
+        return false;
+    }
+
+    TC_LOG_INFO(LOG_FILTER_BATTLENET, "REST Login service bound to https://%s:%d", _bindIP.c_str(), _port);
     return true;
 }
 
 void LoginRESTService::Stop()
 {
-    _stopped = true;
     _loginTicketCleanupTimer->cancel();
-    _thread.join();
+    sLoginHttpSessionMgr.StopNetwork();
+
+    TC_LOG_INFO(LOG_FILTER_BATTLENET, "REST Login service exiting...");
 }
 
 boost::asio::ip::tcp::endpoint const& LoginRESTService::GetAddressForClient(boost::asio::ip::address const& address) const
@@ -126,186 +129,142 @@ boost::asio::ip::tcp::endpoint const& LoginRESTService::GetAddressForClient(boos
     return _externalAddress;
 }
 
-void LoginRESTService::Run()
+void LoginRESTService::HandleGet(Battlenet::LoginHttpSession& session, Battlenet::HttpRequest const& request)
 {
-    soap soapServer(SOAP_C_UTFSTRING, SOAP_C_UTFSTRING);
-
-    // check every 3 seconds if world ended
-    soapServer.accept_timeout = 3;
-    soapServer.recv_timeout = 5;
-    soapServer.send_timeout = 5;
-    if (!soap_valid_socket(soap_bind(&soapServer, _bindIP.c_str(), _port, 100)))
+    static std::string const expectedPath = "/bnetserver/login/";
+    if (!boost::algorithm::starts_with(request.Path, expectedPath))
     {
-        TC_LOG_ERROR(LOG_FILTER_BATTLENET, "REST Couldn't bind to %s:%d", _bindIP.c_str(), _port);
+        TC_LOG_DEBUG(LOG_FILTER_BATTLENET, "REST %s Handling GET 404", session.GetClientInfo().c_str());
+        session.SendResponse(404, std::string());
         return;
     }
 
-    TC_LOG_INFO(LOG_FILTER_BATTLENET, "REST Login service bound to http://%s:%d", _bindIP.c_str(), _port);
-
-    http_post_handlers handlers[] =
-    {
-        { "application/json;charset=utf-8", handle_post_plugin },
-        { "application/json", handle_post_plugin },
-        { nullptr, nullptr }
-    };
-
-    soap_register_plugin_arg(&soapServer, &http_get, (void*)&handle_get_plugin);
-    soap_register_plugin_arg(&soapServer, &http_post, handlers);
-    soap_register_plugin_arg(&soapServer, &ContentTypePlugin::Init, (void*)"application/json;charset=utf-8");
-
-    // Use our already ready ssl context
-    soapServer.ctx = Battlenet::SslContext::instance().native_handle();
-    soapServer.ssl_flags = SOAP_SSL_RSA;
-
-    while (!_stopped)
-    {
-        if (!soap_valid_socket(soap_accept(&soapServer)))
-            continue;   // ran into an accept timeout
-
-        std::shared_ptr<soap> soapClient = std::make_shared<soap>(soapServer);
-        boost::asio::ip::address_v4 address(soapClient->ip);
-        if (soap_ssl_accept(soapClient.get()) != SOAP_OK)
-        {
-            TC_LOG_DEBUG(LOG_FILTER_BATTLENET, "REST Failed SSL handshake from IP=%s", address.to_string().c_str());
-            continue;
-        }
-
-        TC_LOG_DEBUG(LOG_FILTER_BATTLENET, "REST Accepted connection from IP=%s", address.to_string().c_str());
-
-        std::thread([soapClient]
-        {
-            soap_serve(soapClient.get());
-        }).detach();
-    }
-
-    // and release the context handle here - soap does not own it so it should not free it on exit
-    soapServer.ctx = nullptr;
-
-    TC_LOG_INFO(LOG_FILTER_BATTLENET, "REST Login service exiting...");
+    session.SendResponse(200, _formInputs);
 }
 
-int32 LoginRESTService::HandleGet(soap* soapClient)
+void LoginRESTService::HandlePost(Battlenet::LoginHttpSession& session, Battlenet::HttpRequest const& request)
 {
-    boost::asio::ip::address_v4 address(soapClient->ip);
-    std::string ip_address = address.to_string();
-
-    TC_LOG_DEBUG(LOG_FILTER_BATTLENET, "REST [%s:%d] Handling GET request path=\"%s\"", ip_address.c_str(), soapClient->port, soapClient->path);
-
     static std::string const expectedPath = "/bnetserver/login/";
-    if (strstr(soapClient->path, expectedPath.c_str()) != &soapClient->path[0])
+    if (!boost::algorithm::starts_with(request.Path, expectedPath))
     {
-        TC_LOG_DEBUG(LOG_FILTER_BATTLENET, "REST [%s:%d] Handling GET 404", ip_address.c_str(), soapClient->port);
-        return 404;
+        TC_LOG_DEBUG(LOG_FILTER_BATTLENET, "REST %s Handling POST 404", session.GetClientInfo().c_str());
+        session.SendResponse(404, std::string());
+        return;
     }
 
-    return SendResponse(soapClient, _formInputs);
-}
-
-int32 LoginRESTService::HandlePost(soap* soapClient)
-{
-    boost::asio::ip::address_v4 address(soapClient->ip);
-    std::string ip_address = address.to_string();
-
-    TC_LOG_DEBUG(LOG_FILTER_BATTLENET, "REST [%s:%d] Handling POST request path=\"%s\"", ip_address.c_str(), soapClient->port, soapClient->path);
-
-    static std::string const expectedPath = "/bnetserver/login/";
-    if (strstr(soapClient->path, expectedPath.c_str()) != &soapClient->path[0])
+    if (!boost::algorithm::istarts_with(request.ContentType, "application/json"))
     {
-        TC_LOG_DEBUG(LOG_FILTER_BATTLENET, "REST [%s:%d] Handling POST 404", ip_address.c_str(), soapClient->port);
-        return 404;
+        TC_LOG_DEBUG(LOG_FILTER_BATTLENET, "REST %s Handling POST 415", session.GetClientInfo().c_str());
+        session.SendResponse(415, std::string());
+        return;
     }
 
-    char* buf = nullptr;
-    size_t len = 0;
-    soap_http_body(soapClient, &buf, &len);
-
     Battlenet::JSON::Login::LoginForm loginForm;
     Battlenet::JSON::Login::LoginResult loginResult;
-    if (!buf || !JSON::Deserialize(buf, &loginForm))
+    if (!JSON::Deserialize(request.Body, &loginForm))
     {
-        if (soap_register_plugin_arg(soapClient, &ResponseCodePlugin::Init, nullptr) != SOAP_OK)
-        {
-            TC_LOG_DEBUG(LOG_FILTER_BATTLENET, "REST [%s:%d] Handling POST 500", ip_address.c_str(), soapClient->port);
-            return 500;
-        }
-
-        ResponseCodePlugin* responseCode = reinterpret_cast<ResponseCodePlugin*>(soap_lookup_plugin(soapClient, ResponseCodePlugin::PluginId));
-        ASSERT(responseCode);
-
-        responseCode->ErrorCode = 400;
-
+        TC_LOG_DEBUG(LOG_FILTER_BATTLENET, "REST %s Handling POST 400", session.GetClientInfo().c_str());
         loginResult.set_authentication_state(Battlenet::JSON::Login::LOGIN);
         loginResult.set_error_code("UNABLE_TO_DECODE");
         loginResult.set_error_message("There was an internal error while connecting to Battle.net. Please try again later.");
-        return SendResponse(soapClient, loginResult);
+        session.SendResponse(400, loginResult);
+        return;
     }
 
-    std::string login;
+    // bound the logins waiting on the database, launchers retry on their own
+    if (++_pendingLogins > _maxPendingLogins)
+    {
+        --_pendingLogins;
+        TC_LOG_DEBUG(LOG_FILTER_BATTLENET, "REST %s Handling POST 503, %u logins pending", session.GetClientInfo().c_str(), _maxPendingLogins);
+        loginResult.set_authentication_state(Battlenet::JSON::Login::LOGIN);
+        loginResult.set_error_code("SERVICE_BUSY");
+        loginResult.set_error_message("Battle.net is busy. Please try again later.");
+        session.SendResponse(503, loginResult, _busyRetryAfter);
+        return;
+    }
+
+    std::shared_ptr<PendingLogin> pendingLogin = std::make_shared<PendingLogin>(_pendingLogins);
     std::string password;
 
     for (int32 i = 0; i < loginForm.inputs_size(); ++i)
     {
         if (loginForm.inputs(i).input_id() == "account_name")
-            login = loginForm.inputs(i).value();
+            pendingLogin->Login = loginForm.inputs(i).value();
         else if (loginForm.inputs(i).input_id() == "password")
             password = loginForm.inputs(i).value();
     }
 
-    Utf8ToUpperOnlyLatin(login);
+    Utf8ToUpperOnlyLatin(pendingLogin->Login);
     Utf8ToUpperOnlyLatin(password);
-    
-    PreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_BNET_ACCOUNT_EMAIL_BY_ACC);
 
-    if (sConfigMgr->GetBoolDefault("Login.with.account", false))
+    // the callbacks are owned by the session and run in its Update, on the network thread of the connection
+    Battlenet::LoginHttpSession* sessionPtr = &session;
+    auto sendResult = [this, sessionPtr, pendingLogin]()
     {
-        const char* c_login = login.c_str();
-        if (c_login)
+        Battlenet::JSON::Login::LoginResult loginResult;
+        if (pendingLogin->Account)
         {
+            BigNumber ticket;
+            ticket.SetRand(20 * 8);
 
-            char* sobaka = strchr((char*)c_login, '@');
-            if (sobaka == NULL) // not email
-            {
-                stmt->setString(0, login);
-                if (PreparedQueryResult result = LoginDatabase.Query(stmt)) // select email for auth process
-                {
-                    Field* field = result->Fetch();
-                    login = field[0].GetString();
-                    Utf8ToUpperOnlyLatin(login);
-                }
-            }
+            loginResult.set_login_ticket("TC-" + ByteArrayToHexStr(ticket.AsByteArray(20).get(), 20));
 
+            AddLoginTicket(loginResult.login_ticket(), std::move(pendingLogin->Account));
         }
-    }
-    stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_BNET_ACCOUNT_INFO);
 
-    stmt->setString(0, login);
-    stmt->setString(1, CalculateShaPassHash(login, std::move(password)));
-    
-    if (PreparedQueryResult result = LoginDatabase.Query(stmt))
+        loginResult.set_authentication_state(Battlenet::JSON::Login::DONE);
+        sessionPtr->SendResponse(200, loginResult);
+    };
+
+    auto accountInfoQuery = [this, pendingLogin, password]()
     {
-        std::unique_ptr<Battlenet::Session::AccountInfo> accountInfo = Trinity::make_unique<Battlenet::Session::AccountInfo>();
-        accountInfo->LoadResult(result);
+        PreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_BNET_ACCOUNT_INFO);
+        stmt->setString(0, pendingLogin->Login);
+        stmt->setString(1, CalculateShaPassHash(pendingLogin->Login, password));
+        return LoginDatabase.AsyncQuery(stmt);
+    };
+
+    auto handleAccountInfo = [pendingLogin, sendResult](QueryCallback& callback, PreparedQueryResult result)
+    {
+        if (!result)
+        {
+            sendResult();
+            return;
+        }
+
+        pendingLogin->Account = Trinity::make_unique<Battlenet::Session::AccountInfo>();
+        pendingLogin->Account->LoadResult(result);
+
+        PreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_BNET_CHARACTER_COUNTS_BY_BNET_ID);
+        stmt->setUInt32(0, pendingLogin->Account->Id);
+        callback.SetNextQuery(LoginDatabase.AsyncQuery(stmt));
+    };
 
-        stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_BNET_CHARACTER_COUNTS_BY_BNET_ID);
-        stmt->setUInt32(0, accountInfo->Id);
-        if (PreparedQueryResult characterCountsResult = LoginDatabase.Query(stmt))
+    auto handleCharacterCounts = [pendingLogin](QueryCallback& callback, PreparedQueryResult characterCountsResult)
+    {
+        if (characterCountsResult)
         {
             do
             {
                 Field* fields = characterCountsResult->Fetch();
-                accountInfo->GameAccounts[fields[0].GetUInt32()]
+                pendingLogin->Account->GameAccounts[fields[0].GetUInt32()]
                     .CharacterCounts[Battlenet::RealmHandle{ fields[3].GetUInt8(), fields[4].GetUInt8(), fields[2].GetUInt32() }.GetAddress()] = fields[1].GetUInt8();
 
             } while (characterCountsResult->NextRow());
         }
 
-        stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_BNET_LAST_PLAYER_CHARACTERS);
-        stmt->setUInt32(0, accountInfo->Id);
-        if (PreparedQueryResult lastPlayerCharactersResult = LoginDatabase.Query(stmt))
+        PreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_BNET_LAST_PLAYER_CHARACTERS);
+        stmt->setUInt32(0, pendingLogin->Account->Id);
+        callback.SetNextQuery(LoginDatabase.AsyncQuery(stmt));
+    };
+
+    auto handleLastPlayedCharacters = [pendingLogin, sendResult](PreparedQueryResult lastPlayerCharactersResult)
+    {
+        if (lastPlayerCharactersResult)
         {
             Field* fields = lastPlayerCharactersResult->Fetch();
             Battlenet::RealmHandle realmId{ fields[1].GetUInt8(), fields[2].GetUInt8(), fields[3].GetUInt32() };
-            Battlenet::Session::LastPlayedCharacterInfo& lastPlayedCharacter = accountInfo->GameAccounts[fields[0].GetUInt32()]
+            Battlenet::Session::LastPlayedCharacterInfo& lastPlayedCharacter = pendingLogin->Account->GameAccounts[fields[0].GetUInt32()]
                 .LastPlayedCharacters[realmId.GetSubRegionAddress()];
 
             lastPlayedCharacter.RealmId = realmId;
@@ -314,25 +273,35 @@ int32 LoginRESTService::HandlePost(soap* soapClient)
             lastPlayedCharacter.LastPlayedTime = fields[6].GetUInt32();
         }
 
-        BigNumber ticket;
-        ticket.SetRand(20 * 8);
+        sendResult();
+    };
 
-        loginResult.set_login_ticket("TC-" + ByteArrayToHexStr(ticket.AsByteArray(20).get(), 20));
+    if (_loginWithAccount && pendingLogin->Login.find('@') == std::string::npos)
+    {
+        // not an email, select the email of the account for the auth process
+        PreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_BNET_ACCOUNT_EMAIL_BY_ACC);
+        stmt->setString(0, pendingLogin->Login);
+        session.AddQueryCallback(LoginDatabase.AsyncQuery(stmt)
+            .WithChainingPreparedCallback([pendingLogin, accountInfoQuery](QueryCallback& callback, PreparedQueryResult result)
+        {
+            if (result)
+            {
+                pendingLogin->Login = result->Fetch()[0].GetString();
+                Utf8ToUpperOnlyLatin(pendingLogin->Login);
+            }
 
-        AddLoginTicket(loginResult.login_ticket(), std::move(accountInfo));
+            callback.SetNextQuery(accountInfoQuery());
+        })
+            .WithChainingPreparedCallback(handleAccountInfo)
+            .WithChainingPreparedCallback(handleCharacterCounts)
+            .WithPreparedCallback(handleLastPlayedCharacters));
+        return;
     }
 
-    loginResult.set_authentication_state(Battlenet::JSON::Login::DONE);
-    return SendResponse(soapClient, loginResult);
-}
-
-int32 LoginRESTService::SendResponse(soap* soapClient, google::protobuf::Message const& response)
-{
-    std::string jsonResponse = JSON::Serialize(response);
-
-    soap_response(soapClient, SOAP_FILE);
-    soap_send_raw(soapClient, jsonResponse.c_str(), jsonResponse.length());
-    return soap_end_send(soapClient);
+    session.AddQueryCallback(accountInfoQuery()
+        .WithChainingPreparedCallback(handleAccountInfo)
+        .WithChainingPreparedCallback(handleCharacterCounts)
+        .WithPreparedCallback(handleLastPlayedCharacters));
 }
 
 std::string LoginRESTService::CalculateShaPassHash(std::string const& name, std::string const& password)
@@ -352,37 +321,33 @@ std::string LoginRESTService::CalculateShaPassHash(std::string const& name, std:
 
 std::unique_ptr<Battlenet::Session::AccountInfo> LoginRESTService::VerifyLoginTicket(std::string const& id)
 {
-    std::unique_lock<std::mutex> lock(_loginTicketMutex);
+    LoginTicketBucket& bucket = GetLoginTicketBucket(id);
+    std::unique_ptr<Battlenet::Session::AccountInfo> accountInfo;
 
-    auto itr = _validLoginTickets.find(id);
-    if (itr != _validLoginTickets.end())
     {
+        std::lock_guard<std::mutex> lock(bucket.Lock);
+
+        auto itr = bucket.Tickets.find(id);
+        if (itr == bucket.Tickets.end())
+            return nullptr;
+
         if (itr->second.ExpiryTime > time(nullptr))
-        {
-            std::unique_ptr<Battlenet::Session::AccountInfo> accountInfo = std::move(itr->second.Account);
-            _validLoginTickets.erase(itr);
-            return accountInfo;
-        }
+            accountInfo = std::move(itr->second.Account);
+
+        bucket.Tickets.erase(itr);
     }
 
-    return std::unique_ptr<Battlenet::Session::AccountInfo>();
+    return accountInfo;
 }
 
 void LoginRESTService::AddLoginTicket(std::string const& id, std::unique_ptr<Battlenet::Session::AccountInfo> accountInfo)
 {
-    std::unique_lock<std::mutex> lock(_loginTicketMutex);
+    LoginTicketBucket& bucket = GetLoginTicketBucket(id);
 
-    auto itr = _validLoginTickets.find(id);
-    if (itr != _validLoginTickets.end())
-    {
-        itr->second.Id = std::move(id);
-        itr->second.Account = std::move(accountInfo);
-        itr->second.ExpiryTime = time(nullptr) + _waitTime;
-        return;
-    }
+    std::lock_guard<std::mutex> lock(bucket.Lock);
 
-    LoginTicket& ticket = _validLoginTickets[id];
-    ticket.Id = std::move(id);
+    LoginTicket& ticket = bucket.Tickets[id];
+    ticket.Id = id;
     ticket.Account = std::move(accountInfo);
     ticket.ExpiryTime = time(nullptr) + _waitTime;
 }
@@ -397,12 +362,13 @@ void LoginRESTService::CleanupLoginTickets(boost::system::error_code const& erro
 
     time_t now = time(nullptr);
 
+    for (LoginTicketBucket& bucket : _loginTickets)
     {
-        std::unique_lock<std::mutex> lock(_loginTicketMutex);
-        for (auto itr = _validLoginTickets.begin(); itr != _validLoginTickets.end();)
+        std::lock_guard<std::mutex> lock(bucket.Lock);
+        for (auto itr = bucket.Tickets.begin(); itr != bucket.Tickets.end();)
         {
             if (itr->second.ExpiryTime < now)
-                itr = _validLoginTickets.erase(itr);
+                itr = bucket.Tickets.erase(itr);
             else
                 ++itr;
         }
@@ -412,73 +378,8 @@ void LoginRESTService::CleanupLoginTickets(boost::system::error_code const& erro
     _loginTicketCleanupTimer->async_wait(std::bind(&LoginRESTService::CleanupLoginTickets, this, std::placeholders::_1));
 }
 
-Namespace namespaces[] =
-{
-    { nullptr, nullptr, nullptr, nullptr }
-};
-
 LoginRESTService& LoginRESTService::Instance()
 {
     static LoginRESTService instance;
     return instance;
 }
-
-char const* const LoginRESTService::ResponseCodePlugin::PluginId = "bnet-error-code";
-
-int32 LoginRESTService::ResponseCodePlugin::Init(soap* s, soap_plugin* p, void* /*arg*/)
-{
-    ResponseCodePlugin* data = new ResponseCodePlugin();
-    data->fresponse = s->fresponse;
-
-    p->id = PluginId;
-    p->fdelete = &Destroy;
-    p->data = data;
-
-    s->fresponse = &ChangeResponse;
-    return SOAP_OK;
-}
-
-void LoginRESTService::ResponseCodePlugin::Destroy(soap* s, soap_plugin* p)
-{
-    ResponseCodePlugin* data = reinterpret_cast<ResponseCodePlugin*>(p->data);
-    s->fresponse = data->fresponse;
-    delete data;
-}
-
-int32 LoginRESTService::ResponseCodePlugin::ChangeResponse(soap* s, int32 originalResponse, size_t contentLength)
-{
-    ResponseCodePlugin* self = reinterpret_cast<ResponseCodePlugin*>(soap_lookup_plugin(s, PluginId));
-    return self->fresponse(s, self->ErrorCode && originalResponse == SOAP_FILE ? self->ErrorCode : originalResponse, contentLength);
-}
-
-char const* const LoginRESTService::ContentTypePlugin::PluginId = "bnet-content-type";
-
-int32 LoginRESTService::ContentTypePlugin::Init(soap* s, soap_plugin* p, void* arg)
-{
-    ContentTypePlugin* data = new ContentTypePlugin();
-    data->fposthdr = s->fposthdr;
-    data->ContentType = reinterpret_cast<char const*>(arg);
-
-    p->id = PluginId;
-    p->fdelete = &Destroy;
-    p->data = data;
-
-    s->fposthdr = &OnSetHeader;
-    return SOAP_OK;
-}
-
-void LoginRESTService::ContentTypePlugin::Destroy(soap* s, soap_plugin* p)
-{
-    ContentTypePlugin* data = reinterpret_cast<ContentTypePlugin*>(p->data);
-    s->fposthdr = data->fposthdr;
-    delete data;
-}
-
-int32 LoginRESTService::ContentTypePlugin::OnSetHeader(soap* s, char const* key, char const* value)
-{
-    ContentTypePlugin* self = reinterpret_cast<ContentTypePlugin*>(soap_lookup_plugin(s, PluginId));
-    if (key && !strcmp("Content-Type", key))
-        value = self->ContentType;
-
-    return self->fposthdr(s, key, value);
-}
@@ -25,17 +25,20 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ip/address.hpp>
 #include <boost/asio/deadline_timer.hpp>
+#include <array>
 #include <atomic>
 #include <mutex>
-#include <thread>
 
-struct soap;
-struct soap_plugin;
+namespace Battlenet
+{
+    class LoginHttpSession;
+    struct HttpRequest;
+}
 
 class LoginRESTService
 {
 public:
-    LoginRESTService() : _stopped(false), _port(0), _loginTicketCleanupTimer(nullptr) { }
+    LoginRESTService() : _port(0), _waitTime(0), _loginWithAccount(false), _maxPendingLogins(0), _pendingLogins(0), _busyRetryAfter(0), _loginTicketCleanupTimer(nullptr) { }
 
     static LoginRESTService& Instance();
 
@@ -46,16 +49,20 @@ public:
 
     std::unique_ptr<Battlenet::Session::AccountInfo> VerifyLoginTicket(std::string const& id);
 
-private:
-    void Run();
-
-    friend int32 handle_get_plugin(soap* soapClient);
-    int32 HandleGet(soap* soapClient);
+    void HandleGet(Battlenet::LoginHttpSession& session, Battlenet::HttpRequest const& request);
+    void HandlePost(Battlenet::LoginHttpSession& session, Battlenet::HttpRequest const& request);
 
-    friend int32 handle_post_plugin(soap* soapClient);
-    int32 HandlePost(soap* soapClient);
+private:
+    /// Held by the query callbacks of a login, releases the slot once the chain completes or the connection is gone.
+    struct PendingLogin
+    {
+        explicit PendingLogin(std::atomic<uint32>& counter) : Counter(counter) { }
+        ~PendingLogin() { --Counter; }
 
-    int32 SendResponse(soap* soapClient, google::protobuf::Message const& response);
+        std::atomic<uint32>& Counter;
+        std::string Login;
+        std::unique_ptr<Battlenet::Session::AccountInfo> Account;
+    };
 
     std::string CalculateShaPassHash(std::string const& name, std::string const& password);
 
@@ -64,51 +71,34 @@ private:
 
     struct LoginTicket
     {
-        // LoginTicket(std::string const& _id, std::unique_ptr<Battlenet::Session::AccountInfo> _accountInfo, std::time_t _ExpiryTime)
-        // {
-            // Id = std::move(_id);
-            // Account = std::move(_accountInfo);
-            // ExpiryTime = _ExpiryTime;
-        // }
-
         std::string Id;
         std::unique_ptr<Battlenet::Session::AccountInfo> Account;
         std::time_t ExpiryTime;
     };
 
-    struct ResponseCodePlugin
-    {
-        static char const* const PluginId;
-        static int32 Init(soap* s, soap_plugin*, void*);
-        static void Destroy(soap* s, soap_plugin* p);
-        static int32 ChangeResponse(soap* s, int32 originalResponse, size_t contentLength);
-
-        int32(*fresponse)(soap* s, int32 status, size_t length);
-        int32 ErrorCode;
-    };
+    // tickets are spread over independently locked buckets, launchers verifying tickets do not wait on logins creating them
+    static std::size_t const LoginTicketBucketCount = 16;
 
-    struct ContentTypePlugin
+    struct LoginTicketBucket
     {
-        static char const* const PluginId;
-        static int32 Init(soap* s, soap_plugin* p, void*);
-        static void Destroy(soap* s, soap_plugin* p);
-        static int32 OnSetHeader(soap* s, char const* key, char const* value);
-
-        int32(*fposthdr)(soap* s, char const* key, char const* value);
-        char const* ContentType;
+        std::mutex Lock;
+        std::unordered_map<std::string, LoginTicket> Tickets;
     };
 
-    std::thread _thread;
-    std::atomic<bool> _stopped;
+    LoginTicketBucket& GetLoginTicketBucket(std::string const& id) { return _loginTickets[std::hash<std::string>()(id) % LoginTicketBucketCount]; }
+
     Battlenet::JSON::Login::FormInputs _formInputs;
     std::string _bindIP;
     int32 _port;
     int32 _waitTime;
+    bool _loginWithAccount;
+    uint32 _maxPendingLogins;
+    std::atomic<uint32> _pendingLogins;
+    uint32 _busyRetryAfter;
     boost::asio::ip::tcp::endpoint _externalAddress;
     boost::asio::ip::tcp::endpoint _localAddress;
 	boost::asio::ip::address_v4 _localNetmask;
-    std::mutex _loginTicketMutex;
-    std::unordered_map<std::string, LoginTicket> _validLoginTickets;
+    std::array<LoginTicketBucket, LoginTicketBucketCount> _loginTickets;
     boost::asio::deadline_timer* _loginTicketCleanupTimer;
 };
 
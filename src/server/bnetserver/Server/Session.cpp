@@ -523,14 +523,14 @@ uint32 Battlenet::Session::GetLastCharPlayed(std::unordered_map<std::string, Var
         auto lastPlayerChar = _gameAccountInfo->LastPlayedCharacters.find(subRegion->string_value());
         if (lastPlayerChar != _gameAccountInfo->LastPlayedCharacters.end())
         {
-            std::vector<uint8> compressed = sRealmList->GetRealmEntryJSON(lastPlayerChar->second.RealmId, _build);
+            RealmList::CompressedPayload realmEntry = sRealmList->GetRealmEntryJSON(lastPlayerChar->second.RealmId, _build);
 
-            if (compressed.empty())
+            if (!realmEntry)
                 return ERROR_UTIL_SERVER_FAILED_TO_SERIALIZE_RESPONSE;
 
             Attribute* attribute = response->add_attribute();
             attribute->set_name("Param_RealmEntry");
-            attribute->mutable_value()->set_blob_value(compressed.data(), compressed.size());
+            attribute->mutable_value()->set_blob_value(realmEntry->data(), realmEntry->size());
 
             attribute = response->add_attribute();
             attribute->set_name("Param_CharacterName");
@@ -560,14 +560,14 @@ uint32 Battlenet::Session::GetRealmList(std::unordered_map<std::string, Variant
     if (Variant const* subRegion = GetParam(params, "Command_RealmListRequest_v1_b9"))
         subRegionId = subRegion->string_value();
 
-    std::vector<uint8> compressed = sRealmList->GetRealmList(_build, subRegionId, sConfigMgr->GetIntDefault("Battlegroup", 1));
+    RealmList::CompressedPayload realmList = sRealmList->GetRealmList(_build, subRegionId, sConfigMgr->GetIntDefault("Battlegroup", 1));
 
-    if (compressed.empty())
+    if (!realmList)
         return ERROR_UTIL_SERVER_FAILED_TO_SERIALIZE_RESPONSE;
 
     Attribute* attribute = response->add_attribute();
     attribute->set_name("Param_RealmList");
-    attribute->mutable_value()->set_blob_value(compressed.data(), compressed.size());
+    attribute->mutable_value()->set_blob_value(realmList->data(), realmList->size());
 
     ::JSON::RealmList::RealmCharacterCountList realmCharacterCounts;
     for (auto const& characterCount : _gameAccountInfo->CharacterCounts)
@@ -580,6 +580,7 @@ uint32 Battlenet::Session::GetRealmList(std::unordered_map<std::string, Variant
     std::string json = "JSONRealmCharacterCountList:" + ::JSON::Serialize(realmCharacterCounts);
 
     uLongf compressedLength = compressBound(json.length());
+    std::vector<uint8> compressed;
     compressed.resize(4 + compressedLength);
     *reinterpret_cast<uint32*>(compressed.data()) = json.length() + 1;
 
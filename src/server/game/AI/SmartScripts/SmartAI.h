@@ -68,7 +68,7 @@ class SmartAI : public CreatureAI
 
         InstanceScript* instance;
 
-        void SetScript9(SmartScriptHolder& e, uint32 entry, Unit* invoker);
+        void SetScript9(SmartScriptHolder const& e, uint32 entry, Unit* invoker);
         SmartScript* GetScript();
         bool IsEscortInvokerInRange();
 
@@ -260,7 +260,7 @@ class SmartGameObjectAI : public GameObjectAI
         uint32 GetDialogStatus(Player* /*player*/) override;
         void Destroyed(Player* player, uint32 eventId) override;
         void SetData(uint32 id, uint32 value) override;
-        void SetScript9(SmartScriptHolder& e, uint32 entry, Unit* invoker);
+        void SetScript9(SmartScriptHolder const& e, uint32 entry, Unit* invoker);
         void OnStateChanged(uint32 state, Unit* unit) override;
         void EventInform(uint32 eventId) override;
 
@@ -73,12 +73,12 @@ void SmartScript::OnReset()
 {
     SetPhase(0);
     ResetBaseObject();
-    for (auto& itr : mEvents)
+    for (SmartScriptEvent& ev : mEvents)
     {
-        if (!(itr.event.event_flags & SMART_EVENT_FLAG_DONT_RESET))
+        if (!(ev.Holder->event.event_flags & SMART_EVENT_FLAG_DONT_RESET))
         {
-            InitTimer(itr);
-            itr.runOnce = false;
+            InitTimer(ev);
+            ev.runOnce = false;
         }
     }
     ProcessEventsFor(SMART_EVENT_RESET);
@@ -110,19 +110,32 @@ void SmartScript::ResetBaseObject()
 
 void SmartScript::ProcessEventsFor(SMART_EVENT e, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob)
 {
-    for (auto& mEvent : mEvents)
-    {
-        auto eventType = SMART_EVENT(mEvent.GetEventType());
-        if (eventType == SMART_EVENT_LINK)//special handling
-            continue;
+    if (e == SMART_EVENT_LINK)//special handling
+        return;
 
-        if (eventType == e/* && (!(*i).event.event_phase_mask || IsInPhase((*i).event.event_phase_mask)) && !((*i).event.event_flags & SMART_EVENT_FLAG_NOT_REPEATABLE && (*i).runOnce)*/)
-            ProcessEvent(mEvent, unit, var0, var1, bvar, spell, gob);
+    if (mScript)
+    {
+        if (SmartAIScript::TypeRange const* range = mScript->GetEventsOfType(e))
+        {
+            for (uint32 i = range->Begin; i < range->End; ++i)
+            {
+                SmartScriptEvent& ev = mEvents[mScript->EventsByType[i]];
+                if (ev.enabled)
+                    ProcessEvent(ev, unit, var0, var1, bvar, spell, gob);
+            }
+        }
     }
+
+    // installed by AI templates, not part of the shared script
+    for (uint32 i = GetScriptEventCount(); i < mEvents.size(); ++i)
+        if (mEvents[i].Holder->GetEventType() == uint32(e))
+            ProcessEvent(mEvents[i], unit, var0, var1, bvar, spell, gob);
 }
 
-void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob)
+void SmartScript::ProcessAction(SmartScriptEvent& ev, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob)
 {
+    SmartScriptHolder const& e = *ev.Holder;
+
     //calc random
     if (e.GetEventType() != SMART_EVENT_LINK && e.event.event_chance < 100 && e.event.event_chance)
     {
@@ -130,7 +143,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
         if (e.event.event_chance <= rnd)
             return;
     }
-    e.runOnce = true;//used for repeat check
+    ev.runOnce = true;//used for repeat check
 
     if (unit)
         mLastInvoker = unit->GetGUID();
@@ -1805,13 +1818,13 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
             ac.type = static_cast<SMART_ACTION>(SMART_ACTION_TRIGGER_TIMED_EVENT);
             ac.timeEvent.id = e.action.timeEvent.id;
 
-            SmartScriptHolder ev;
-            ev.event = ne;
-            ev.event_id = e.action.timeEvent.id;
-            ev.target = e.target;
-            ev.action = ac;
-            InitTimer(ev);
-            mStoredEvents.push_back(ev);
+            SmartScriptHolder holder;
+            holder.event = ne;
+            holder.event_id = e.action.timeEvent.id;
+            holder.target = e.target;
+            holder.action = ac;
+            mStoredEvents.emplace_back(holder);
+            InitTimer(mStoredEvents.back().State);
             break;
         }
         case SMART_ACTION_TRIGGER_TIMED_EVENT:
@@ -3042,9 +3055,13 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
 
     if (e.link && e.link != e.event_id)
     {
-        SmartScriptHolder linked = FindLinkedEvent(e.link);
-        if (linked.GetActionType() && linked.GetEventType() == SMART_EVENT_LINK)
+        SmartScriptEvent const* linkedEvent = FindLinkedEvent(e.link);
+        if (linkedEvent && linkedEvent->Holder->GetActionType() && linkedEvent->Holder->GetEventType() == SMART_EVENT_LINK)
+        {
+            // processed on a copy, linked events keep no state of their own
+            SmartScriptEvent linked = *linkedEvent;
             ProcessEvent(linked, unit, var0, var1, bvar, spell, gob);
+        }
         else
             TC_LOG_DEBUG(LOG_FILTER_SQL, "SmartScript::ProcessAction: Entry %d SourceType %u, Event %u, Link Event %u not found or invalid, skipped.", e.entryOrGuid, e.GetScriptType(), e.event_id, e.link);
     }
@@ -3200,7 +3217,6 @@ SmartScriptHolder SmartScript::CreateEvent(SMART_EVENT e, uint32 event_flags, ui
     script.target.raw.param3 = target_param3;
 
     script.source_type = SMART_SCRIPT_TYPE_CREATURE;
-    InitTimer(script);
     return script;
 }
 
@@ -3524,15 +3540,17 @@ ObjectList* SmartScript::GetWorldObjectsInDist(float dist)
     return targets;
 }
 
-void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob)
+void SmartScript::ProcessEvent(SmartScriptEvent& ev, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob)
 {
-    if (!e.active && e.GetEventType() != SMART_EVENT_LINK)
+    SmartScriptHolder const& e = *ev.Holder;
+
+    if (!ev.active && e.GetEventType() != SMART_EVENT_LINK)
         return;
 
     if (me && (me->isInCombat() && (e.event.event_flags & SMART_EVENT_FLAG_EVENT_NON_COMBAT)))
         return;
 
-    if ((e.event.event_phase_mask && !IsInPhase(e.event.event_phase_mask)) || ((e.event.event_flags & SMART_EVENT_FLAG_NOT_REPEATABLE) && e.runOnce))
+    if ((e.event.event_phase_mask && !IsInPhase(e.event.event_phase_mask)) || ((e.event.event_flags & SMART_EVENT_FLAG_NOT_REPEATABLE) && ev.runOnce))
         return;
 
     ConditionList conds = sConditionMgr->GetConditionsForSmartEvent(e.entryOrGuid, e.event_id, e.source_type);
@@ -3543,24 +3561,24 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
     switch (e.GetEventType())
     {
         case SMART_EVENT_LINK: //special handling
-            ProcessAction(e, unit, var0, var1, bvar, spell, gob);
+            ProcessAction(ev, unit, var0, var1, bvar, spell, gob);
             break;
         //called from Update tick
         case SMART_EVENT_UPDATE:
-            RecalcTimer(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
-            ProcessAction(e);
+            RecalcTimer(ev, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessAction(ev);
             break;
         case SMART_EVENT_UPDATE_OOC:
             if (me && me->isInCombat())
                 return;
-            RecalcTimer(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
-            ProcessAction(e);
+            RecalcTimer(ev, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessAction(ev);
             break;
         case SMART_EVENT_UPDATE_IC:
             if (!me || !me->isInCombat())
                 return;
-            RecalcTimer(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
-            ProcessAction(e);
+            RecalcTimer(ev, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessAction(ev);
             break;
         case SMART_EVENT_HEALT_PCT:
         {
@@ -3569,8 +3587,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             auto perc = static_cast<uint32>(me->GetHealthPct());
             if (perc > e.event.minMaxRepeat.max || perc < e.event.minMaxRepeat.min)
                 return;
-            RecalcTimer(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
-            ProcessAction(e);
+            RecalcTimer(ev, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessAction(ev);
             break;
         }
         case SMART_EVENT_TARGET_HEALTH_PCT:
@@ -3580,8 +3598,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             auto perc = static_cast<uint32>(me->getVictim()->GetHealthPct());
             if (perc > e.event.minMaxRepeat.max || perc < e.event.minMaxRepeat.min)
                 return;
-            RecalcTimer(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
-            ProcessAction(e, me->getVictim());
+            RecalcTimer(ev, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessAction(ev, me->getVictim());
             break;
         }
         case SMART_EVENT_MANA_PCT:
@@ -3591,8 +3609,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             auto perc = uint32(100.0f * me->GetPower(me->getPowerType()) / me->GetMaxPower(me->getPowerType()));
             if (perc > e.event.minMaxRepeat.max || perc < e.event.minMaxRepeat.min)
                 return;
-            RecalcTimer(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
-            ProcessAction(e);
+            RecalcTimer(ev, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessAction(ev);
             break;
         }
         case SMART_EVENT_TARGET_MANA_PCT:
@@ -3602,8 +3620,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             auto perc = uint32(100.0f * me->getVictim()->GetPower(me->getPowerType()) / me->getVictim()->GetMaxPower(me->getPowerType()));
             if (perc > e.event.minMaxRepeat.max || perc < e.event.minMaxRepeat.min)
                 return;
-            RecalcTimer(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
-            ProcessAction(e, me->getVictim());
+            RecalcTimer(ev, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessAction(ev, me->getVictim());
             break;
         }
         case SMART_EVENT_RANGE:
@@ -3613,8 +3631,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
 
             if (me->IsInRange(me->getVictim(), static_cast<float>(e.event.minMaxRepeat.min), static_cast<float>(e.event.minMaxRepeat.max)))
             {
-                ProcessAction(e, me->getVictim());
-                RecalcTimer(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+                ProcessAction(ev, me->getVictim());
+                RecalcTimer(ev, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
             }
             break;
         }
@@ -3622,8 +3640,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (!me || !me->isInCombat() || !me->getVictim() || !me->getVictim()->IsNonMeleeSpellCast(false, false, true))
                 return;
-            ProcessAction(e, me->getVictim());
-            RecalcTimer(e, e.event.minMax.repeatMin, e.event.minMax.repeatMax);
+            ProcessAction(ev, me->getVictim());
+            RecalcTimer(ev, e.event.minMax.repeatMin, e.event.minMax.repeatMax);
         }
         case SMART_EVENT_FRIENDLY_HEALTH:
         {
@@ -3633,8 +3651,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             Unit* target = DoSelectLowestHpFriendly(static_cast<float>(e.event.friendlyHealt.radius), e.event.friendlyHealt.hpDeficit);
             if (!target)
                 return;
-            ProcessAction(e, target);
-            RecalcTimer(e, e.event.friendlyHealt.repeatMin, e.event.friendlyHealt.repeatMax);
+            ProcessAction(ev, target);
+            RecalcTimer(ev, e.event.friendlyHealt.repeatMin, e.event.friendlyHealt.repeatMax);
             break;
         }
         case SMART_EVENT_FRIENDLY_IS_CC:
@@ -3646,8 +3664,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             DoFindFriendlyCC(pList, static_cast<float>(e.event.friendlyCC.radius));
             if (pList.empty())
                 return;
-            ProcessAction(e, *(pList.begin()));
-            RecalcTimer(e, e.event.friendlyCC.repeatMin, e.event.friendlyCC.repeatMax);
+            ProcessAction(ev, *(pList.begin()));
+            RecalcTimer(ev, e.event.friendlyCC.repeatMin, e.event.friendlyCC.repeatMax);
             break;
         }
         case SMART_EVENT_FRIENDLY_MISSING_BUFF:
@@ -3657,8 +3675,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
 
             if (pList.empty())
                 return;
-            ProcessAction(e, *(pList.begin()));
-            RecalcTimer(e, e.event.missingBuff.repeatMin, e.event.missingBuff.repeatMax);
+            ProcessAction(ev, *(pList.begin()));
+            RecalcTimer(ev, e.event.missingBuff.repeatMin, e.event.missingBuff.repeatMax);
             break;
         }
         case SMART_EVENT_HAS_AURA:
@@ -3668,8 +3686,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             uint32 count = me->GetAuraCount(e.event.aura.spell);
             if ((!e.event.aura.count && !count) || (e.event.aura.count && count >= e.event.aura.count))
             {
-                ProcessAction(e);
-                RecalcTimer(e, e.event.aura.repeatMin, e.event.aura.repeatMax);
+                ProcessAction(ev);
+                RecalcTimer(ev, e.event.aura.repeatMin, e.event.aura.repeatMax);
             }
             break;
         }
@@ -3680,8 +3698,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             uint32 count = me->getVictim()->GetAuraCount(e.event.aura.spell);
             if (count < e.event.aura.count)
                 return;
-            ProcessAction(e);
-            RecalcTimer(e, e.event.aura.repeatMin, e.event.aura.repeatMax);
+            ProcessAction(ev);
+            RecalcTimer(ev, e.event.aura.repeatMin, e.event.aura.repeatMax);
             break;
         }
         case SMART_EVENT_QUEST_ACCEPTED:
@@ -3689,7 +3707,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (!me || var0 != e.event.raw.param1)
                 return;
-            ProcessAction(e, unit, var0, var1, bvar, spell, gob);
+            ProcessAction(ev, unit, var0, var1, bvar, spell, gob);
             break;
         }
         //no params
@@ -3711,7 +3729,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         case SMART_EVENT_JUST_CREATED:
         case SMART_EVENT_GOSSIP_HELLO:
         case SMART_EVENT_FOLLOW_COMPLETED:
-            ProcessAction(e, unit, var0, var1, bvar, spell, gob);
+            ProcessAction(ev, unit, var0, var1, bvar, spell, gob);
             break;
         case SMART_EVENT_IS_BEHIND_TARGET:
             {
@@ -3722,21 +3740,21 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 {
                     if (!victim->HasInArc(static_cast<float>(M_PI), me))
                     {
-                        ProcessAction(e, victim);
-                        RecalcTimer(e, e.event.behindTarget.cooldownMin, e.event.behindTarget.cooldownMax);
+                        ProcessAction(ev, victim);
+                        RecalcTimer(ev, e.event.behindTarget.cooldownMin, e.event.behindTarget.cooldownMax);
                     }
                 }
                 break;
             }
         case SMART_EVENT_ON_SPELLCLICK:
-            ProcessAction(e, unit, var0, var1, bvar, spell, gob);
-            RecalcTimer(e, e.event.spellclick.cooldownMin, e.event.spellclick.cooldownMax);
+            ProcessAction(ev, unit, var0, var1, bvar, spell, gob);
+            RecalcTimer(ev, e.event.spellclick.cooldownMin, e.event.spellclick.cooldownMax);
             break;
         case SMART_EVENT_RECEIVE_EMOTE:
             if (e.event.emote.emote == var0)
             {
-                ProcessAction(e, unit);
-                RecalcTimer(e, e.event.emote.cooldownMin, e.event.emote.cooldownMax);
+                ProcessAction(ev, unit);
+                RecalcTimer(ev, e.event.emote.cooldownMin, e.event.emote.cooldownMax);
             }
             break;
         case SMART_EVENT_KILL:
@@ -3747,8 +3765,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 return;
             if (e.event.kill.creature && unit->GetEntry() != e.event.kill.creature)
                 return;
-            ProcessAction(e, unit);
-            RecalcTimer(e, e.event.kill.cooldownMin, e.event.kill.cooldownMax);
+            ProcessAction(ev, unit);
+            RecalcTimer(ev, e.event.kill.cooldownMin, e.event.kill.cooldownMax);
             break;
         }
         case SMART_EVENT_SPELLHIT_TARGET:
@@ -3759,8 +3777,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             if ((!e.event.spellHit.spell || spell->Id == e.event.spellHit.spell) &&
                 (!e.event.spellHit.school || (spell->GetMisc()->MiscData.SchoolMask & e.event.spellHit.school)))
                 {
-                    ProcessAction(e, unit, 0, 0, bvar, spell);
-                    RecalcTimer(e, e.event.spellHit.cooldownMin, e.event.spellHit.cooldownMax);
+                    ProcessAction(ev, unit, 0, 0, bvar, spell);
+                    RecalcTimer(ev, e.event.spellHit.cooldownMin, e.event.spellHit.cooldownMax);
                 }
             break;
         }
@@ -3778,8 +3796,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 if ((e.event.los.noHostile && !me->IsHostileTo(unit)) ||
                     (!e.event.los.noHostile && me->IsHostileTo(unit)))
                 {
-                    ProcessAction(e, unit);
-                    RecalcTimer(e, e.event.los.cooldownMin, e.event.los.cooldownMax);
+                    ProcessAction(ev, unit);
+                    RecalcTimer(ev, e.event.los.cooldownMin, e.event.los.cooldownMax);
                 }
             }
             break;
@@ -3798,8 +3816,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 if ((e.event.los.noHostile && !me->IsHostileTo(unit)) ||
                     (!e.event.los.noHostile && me->IsHostileTo(unit)))
                 {
-                    ProcessAction(e, unit);
-                    RecalcTimer(e, e.event.los.cooldownMin, e.event.los.cooldownMax);
+                    ProcessAction(ev, unit);
+                    RecalcTimer(ev, e.event.los.cooldownMin, e.event.los.cooldownMax);
                 }
             }
             break;
@@ -3812,7 +3830,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 return;
             if (e.event.respawn.type == SMART_SCRIPT_RESPAWN_CONDITION_AREA && GetBaseObject()->GetCurrentZoneID() != e.event.respawn.area)
                 return;
-            ProcessAction(e);
+            ProcessAction(ev);
             break;
         }
         case SMART_EVENT_SUMMONED_UNIT:
@@ -3821,8 +3839,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
                 return;
             if (e.event.summoned.creature && unit->GetEntry() != e.event.summoned.creature)
                 return;
-            ProcessAction(e, unit);
-            RecalcTimer(e, e.event.summoned.cooldownMin, e.event.summoned.cooldownMax);
+            ProcessAction(ev, unit);
+            RecalcTimer(ev, e.event.summoned.cooldownMin, e.event.summoned.cooldownMax);
             break;
         }
         case SMART_EVENT_RECEIVE_HEAL:
@@ -3831,15 +3849,15 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (var0 > e.event.minMaxRepeat.max || var0 < e.event.minMaxRepeat.min)
                 return;
-            ProcessAction(e, unit);
-            RecalcTimer(e, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
+            ProcessAction(ev, unit);
+            RecalcTimer(ev, e.event.minMaxRepeat.repeatMin, e.event.minMaxRepeat.repeatMax);
             break;
         }
         case SMART_EVENT_MOVEMENTINFORM:
         {
             if ((e.event.movementInform.type && var0 != e.event.movementInform.type) || (e.event.movementInform.id && var1 != e.event.movementInform.id))
                 return;
-            ProcessAction(e, unit, var0, var1);
+            ProcessAction(ev, unit, var0, var1);
             break;
         }
         case SMART_EVENT_TRANSPORT_RELOCATE:
@@ -3847,7 +3865,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (e.event.waypoint.pathID && var0 != e.event.waypoint.pathID)
                 return;
-            ProcessAction(e, unit, var0);
+            ProcessAction(ev, unit, var0);
             break;
         }
         case SMART_EVENT_WAYPOINT_REACHED:
@@ -3858,7 +3876,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (!me || (e.event.waypoint.pointID && var0 != e.event.waypoint.pointID) || (e.event.waypoint.pathID && GetPathId() != e.event.waypoint.pathID))
                 return;
-            ProcessAction(e, unit);
+            ProcessAction(ev, unit);
             break;
         }
         case SMART_EVENT_SUMMON_DESPAWNED:
@@ -3866,8 +3884,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (e.event.instancePlayerEnter.team && var0 != e.event.instancePlayerEnter.team)
                 return;
-            ProcessAction(e, unit, var0);
-            RecalcTimer(e, e.event.instancePlayerEnter.cooldownMin, e.event.instancePlayerEnter.cooldownMax);
+            ProcessAction(ev, unit, var0);
+            RecalcTimer(ev, e.event.instancePlayerEnter.cooldownMin, e.event.instancePlayerEnter.cooldownMax);
             break;
         }
         case SMART_EVENT_ACCEPTED_QUEST:
@@ -3875,38 +3893,38 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (e.event.quest.quest && var0 != e.event.quest.quest)
                 return;
-            ProcessAction(e, unit, var0);
-            RecalcTimer(e, e.event.quest.cooldownMin, e.event.quest.cooldownMax);
+            ProcessAction(ev, unit, var0);
+            RecalcTimer(ev, e.event.quest.cooldownMin, e.event.quest.cooldownMax);
             break;
         }
         case SMART_EVENT_TRANSPORT_ADDCREATURE:
         {
             if (e.event.transportAddCreature.creature && var0 != e.event.transportAddCreature.creature)
                 return;
-            ProcessAction(e, unit, var0);
+            ProcessAction(ev, unit, var0);
             break;
         }
         case SMART_EVENT_AREATRIGGER_ONTRIGGER:
         {
             if (e.event.areatrigger.id && var0 != e.event.areatrigger.id)
                 return;
-            ProcessAction(e, unit, var0);
-            RecalcTimer(e, e.event.areatrigger.cooldownMin, e.event.areatrigger.cooldownMax);
+            ProcessAction(ev, unit, var0);
+            RecalcTimer(ev, e.event.areatrigger.cooldownMin, e.event.areatrigger.cooldownMax);
             break;
         }
         case SMART_EVENT_TEXT_OVER:
         {
             if (var0 != e.event.textOver.textGroupID || (e.event.textOver.creatureEntry && e.event.textOver.creatureEntry != var1))
                 return;
-            ProcessAction(e, unit, var0);
+            ProcessAction(ev, unit, var0);
             break;
         }
         case SMART_EVENT_DATA_SET:
         {
             if (e.event.dataSet.id != var0 || e.event.dataSet.value != var1)
                 return;
-            ProcessAction(e, unit, var0, var1);
-            RecalcTimer(e, e.event.dataSet.cooldownMin, e.event.dataSet.cooldownMax);
+            ProcessAction(ev, unit, var0, var1);
+            RecalcTimer(ev, e.event.dataSet.cooldownMin, e.event.dataSet.cooldownMax);
             break;
         }
         case SMART_EVENT_PASSENGER_REMOVED:
@@ -3914,14 +3932,14 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (!unit)
                 return;
-            ProcessAction(e, unit);
-            RecalcTimer(e, e.event.minMax.repeatMin, e.event.minMax.repeatMax);
+            ProcessAction(ev, unit);
+            RecalcTimer(ev, e.event.minMax.repeatMin, e.event.minMax.repeatMax);
             break;
         }
         case SMART_EVENT_TIMED_EVENT_TRIGGERED:
         {
             if (e.event.timedEvent.id == var0)
-                ProcessAction(e, unit);
+                ProcessAction(ev, unit);
             break;
         }
         case SMART_EVENT_GOSSIP_SELECT:
@@ -3929,15 +3947,15 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             TC_LOG_DEBUG(LOG_FILTER_DATABASE_AI, "SmartScript: Gossip Select:  menu %u action %u", var0, var1);//little help for scripters
             if (e.event.gossip.sender != var0 || e.event.gossip.action != var1)
                 return;
-            ProcessAction(e, unit, var0, var1);
-            RecalcTimer(e, e.event.gossip.cooldownMin, e.event.gossip.cooldownMax);
+            ProcessAction(ev, unit, var0, var1);
+            RecalcTimer(ev, e.event.gossip.cooldownMin, e.event.gossip.cooldownMax);
             break;
         }
         case SMART_EVENT_DUMMY_EFFECT:
         {
             if (e.event.dummy.spell != var0 || e.event.dummy.effIndex != var1)
                 return;
-            ProcessAction(e, unit, var0, var1);
+            ProcessAction(ev, unit, var0, var1);
             break;
         }
         case SMART_EVENT_GAME_EVENT_START:
@@ -3945,28 +3963,28 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (e.event.gameEvent.gameEventId != var0)
                 return;
-            ProcessAction(e, nullptr, var0);
+            ProcessAction(ev, nullptr, var0);
             break;
         }
         case SMART_EVENT_GO_STATE_CHANGED:
         {
             if (e.event.goStateChanged.state != var0)
                 return;
-            ProcessAction(e, unit, var0, var1);
+            ProcessAction(ev, unit, var0, var1);
             break;
         }
         case SMART_EVENT_GO_EVENT_INFORM:
         {
             if (e.event.eventInform.eventId != var0)
                 return;
-            ProcessAction(e, nullptr, var0);
+            ProcessAction(ev, nullptr, var0);
             break;
         }
         case SMART_EVENT_ACTION_DONE:
         {
             if (e.event.doAction.eventId != var0)
                 return;
-            ProcessAction(e, unit, var0);
+            ProcessAction(ev, unit, var0);
             break;
         }
         case SMART_EVENT_CHECK_DIST_TO_HOME:
@@ -3977,8 +3995,8 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
             Position const& _homePosition = me->GetHomePosition();
             if (me->GetDistance2d(_homePosition.GetPositionX(), _homePosition.GetPositionY()) > static_cast<float>(e.event.dist.maxDist))
             {
-                ProcessAction(e, me->getVictim());
-                RecalcTimer(e, e.event.dist.repeatMin, e.event.dist.repeatMax);
+                ProcessAction(ev, me->getVictim());
+                RecalcTimer(ev, e.event.dist.repeatMin, e.event.dist.repeatMax);
             }
             break;
         }
@@ -3987,21 +4005,21 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (e.event.areatrigger.id && var0 != e.event.areatrigger.id)
                 return;
-            ProcessAction(e, unit, var0);
-            RecalcTimer(e, e.event.areatrigger.cooldownMin, e.event.areatrigger.cooldownMax);
+            ProcessAction(ev, unit, var0);
+            RecalcTimer(ev, e.event.areatrigger.cooldownMin, e.event.areatrigger.cooldownMax);
             break;
         }
         case SMART_EVENT_ON_APPLY_OR_REMOVE_AURA:
         {
             if (e.event.applyorremoveaura.spellId && var0 == e.event.applyorremoveaura.spellId && e.event.applyorremoveaura.apply && bvar)
             {
-                ProcessAction(e, unit, var0);
-                RecalcTimer(e, e.event.applyorremoveaura.cooldown, e.event.applyorremoveaura.cooldown);
+                ProcessAction(ev, unit, var0);
+                RecalcTimer(ev, e.event.applyorremoveaura.cooldown, e.event.applyorremoveaura.cooldown);
             }
             else if (e.event.applyorremoveaura.spellId && var0 == e.event.applyorremoveaura.spellId && !e.event.applyorremoveaura.apply && !bvar)
             {
-                ProcessAction(e, unit, var0);
-                RecalcTimer(e, e.event.applyorremoveaura.cooldown, e.event.applyorremoveaura.cooldown);
+                ProcessAction(ev, unit, var0);
+                RecalcTimer(ev, e.event.applyorremoveaura.cooldown, e.event.applyorremoveaura.cooldown);
             }
             break;
         }
@@ -4009,7 +4027,7 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
         {
             if (e.event.taxipathto.id && var0 != e.event.taxipathto.id)
                 return;
-            ProcessAction(e, unit, var0);
+            ProcessAction(ev, unit, var0);
             break;
         }
 		case SMART_EVENT_DISTANCE_CREATURE:
@@ -4038,14 +4056,14 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
 			}
 
 			if (creature)
-				ProcessAction(e);
-                RecalcTimer(e, e.event.distance.repeat, e.event.distance.repeat);
+				ProcessAction(ev);
+                RecalcTimer(ev, e.event.distance.repeat, e.event.distance.repeat);
 
 			break;
 		}
         case SMART_EVENT_COUNTER_SET:
             if (GetCounterId(e.event.counter.id) != 0 && GetCounterValue(e.event.counter.id) == e.event.counter.value)
-                ProcessTimedAction(e, e.event.counter.cooldownMin, e.event.counter.cooldownMax);
+                ProcessTimedAction(ev, e.event.counter.cooldownMin, e.event.counter.cooldownMax);
             break;
         default:
             TC_LOG_ERROR(LOG_FILTER_SQL, "SmartScript::ProcessEvent: Unhandled Event type %u", e.GetEventType());
@@ -4053,47 +4071,62 @@ void SmartScript::ProcessEvent(SmartScriptHolder& e, Unit* unit, uint32 var0, ui
     }
 }
 
-void SmartScript::ProcessTimedAction(SmartScriptHolder& e, uint32 const& min, uint32 const& max, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob, std::string const& varString)
+void SmartScript::ProcessTimedAction(SmartScriptEvent& ev, uint32 const& min, uint32 const& max, Unit* unit, uint32 var0, uint32 var1, bool bvar, const SpellInfo* spell, GameObject* gob, std::string const& varString)
 {
+	SmartScriptHolder const& e = *ev.Holder;
+
 	// We may want to execute action rarely and because of this if condition is not fulfilled the action will be rechecked in a long time
 	if (sConditionMgr->IsObjectMeetingSmartEventConditions(e.entryOrGuid, e.event_id, e.source_type, unit, GetBaseObject()))
 	{
-		ProcessAction(e, unit, var0, var1, bvar, spell, gob);
-		RecalcTimer(e, min, max);
+		ProcessAction(ev, unit, var0, var1, bvar, spell, gob);
+		RecalcTimer(ev, min, max);
 	}
 	else
-		RecalcTimer(e, std::min<uint32>(min, 5000), std::min<uint32>(min, 5000));
+		RecalcTimer(ev, std::min<uint32>(min, 5000), std::min<uint32>(min, 5000));
 }
 
 
-void SmartScript::InitTimer(SmartScriptHolder& e)
+void SmartScript::InitTimer(SmartScriptEvent& ev)
 {
-    switch (e.GetEventType())
+    switch (ev.Holder->GetEventType())
     {
         //set only events which have initial timers
         case SMART_EVENT_UPDATE:
         case SMART_EVENT_UPDATE_IC:
         case SMART_EVENT_UPDATE_OOC:
-            RecalcTimer(e, e.event.minMaxRepeat.min, e.event.minMaxRepeat.max);
+            RecalcTimer(ev, ev.Holder->event.minMaxRepeat.min, ev.Holder->event.minMaxRepeat.max);
             break;
 		case SMART_EVENT_DISTANCE_CREATURE:
         default:
-            e.active = true;
+            ev.active = true;
             break;
     }
 }
-void SmartScript::RecalcTimer(SmartScriptHolder& e, uint32 min, uint32 max)
+void SmartScript::RecalcTimer(SmartScriptEvent& ev, uint32 min, uint32 max)
 {
     // min/max was checked at loading!
     if (uint32(min) > uint32(max))
-        e.timer = urand(uint32(max), uint32(min));
+        ev.timer = urand(uint32(max), uint32(min));
     else
-        e.timer = urand(uint32(min), uint32(max));
-    e.active = e.timer ? false : true;
+        ev.timer = urand(uint32(min), uint32(max));
+    ev.active = ev.timer ? false : true;
+
+    // timed events of the script are counted down anyway, the others only while they cool down
+    if (ev.timer && !ev.cooldown && !SmartAIScript::IsTimedEvent(ev.Holder->GetEventType()))
+    {
+        SmartScriptEvent const* first = mEvents.data();
+        if (&ev >= first && &ev < first + GetScriptEventCount())
+        {
+            ev.cooldown = true;
+            mCooldownEvents.push_back(uint32(&ev - first));
+        }
+    }
 }
 
-void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
+void SmartScript::UpdateTimer(SmartScriptEvent& ev, uint32 const diff)
 {
+    SmartScriptHolder const& e = *ev.Holder;
+
     if (e.GetEventType() == SMART_EVENT_LINK)
         return;
 
@@ -4106,7 +4139,7 @@ void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
     if (e.GetEventType() == SMART_EVENT_UPDATE_OOC && (me && me->isInCombat()))//can be used with me=NULL (go script)
         return;
 
-    if (e.timer < diff)
+    if (ev.timer < diff)
     {
         // delay spell cast event if another spell is being casted
         if (e.GetActionType() == SMART_ACTION_CAST || e.GetActionType() == SMART_ACTION_CAST_CUSTOM)
@@ -4115,70 +4148,52 @@ void SmartScript::UpdateTimer(SmartScriptHolder& e, uint32 const diff)
             {
                 if (me && me->HasUnitState(UNIT_STATE_CASTING) && !(e.action.cast.flags & SMARTCAST_TRIGGERED))
                 {
-                    e.timer = 1;
+                    ev.timer = 1;
                     return;
                 }
             }
         }
 
-        e.active = true;//activate events with cooldown
-        switch (e.GetEventType())//process ONLY timed events
-        {
-            case SMART_EVENT_UPDATE:
-            case SMART_EVENT_UPDATE_OOC:
-            case SMART_EVENT_UPDATE_IC:
-            case SMART_EVENT_HEALT_PCT:
-            case SMART_EVENT_TARGET_HEALTH_PCT:
-            case SMART_EVENT_MANA_PCT:
-            case SMART_EVENT_TARGET_MANA_PCT:
-            case SMART_EVENT_RANGE:
-            case SMART_EVENT_TARGET_CASTING:
-            case SMART_EVENT_FRIENDLY_HEALTH:
-            case SMART_EVENT_FRIENDLY_IS_CC:
-            case SMART_EVENT_FRIENDLY_MISSING_BUFF:
-            case SMART_EVENT_HAS_AURA:
-            case SMART_EVENT_TARGET_BUFFED:
-            case SMART_EVENT_IS_BEHIND_TARGET:
-            case SMART_EVENT_CHECK_DIST_TO_HOME:
-            case SMART_EVENT_DISTANCE_CREATURE:
+        ev.active = true;//activate events with cooldown
+        if (SmartAIScript::IsTimedEvent(e.GetEventType()))//process ONLY timed events
+        {
+            ProcessEvent(ev);
+            if (e.GetScriptType() == SMART_SCRIPT_TYPE_TIMED_ACTIONLIST)
             {
-                ProcessEvent(e);
-                if (e.GetScriptType() == SMART_SCRIPT_TYPE_TIMED_ACTIONLIST)
+                ev.enableTimed = false; //disable event if it is in an ActionList and was processed once
+                for (auto& i : mTimedActionList)
                 {
-                    e.enableTimed = false; //disable event if it is in an ActionList and was processed once
-                    for (auto& i : mTimedActionList)
+                    //find the first event which is not the current one and enable it
+                    if (e.entryOrGuid == i.Holder.entryOrGuid && i.Holder.event_id > e.event_id)
                     {
-                        //find the first event which is not the current one and enable it
-                        if (e.entryOrGuid == i.entryOrGuid && i.event_id > e.event_id)
-                        {
-                            i.enableTimed = true;
-                            break;
-                        }
+                        i.State.enableTimed = true;
+                        break;
                     }
                 }
-                break;
             }
-            default:
-                break;
         }
     }
     else
-        e.timer -= diff;
+        ev.timer -= diff;
 }
 
-bool SmartScript::CheckTimer(SmartScriptHolder const& e) const
+bool SmartScript::CheckTimer(SmartScriptEvent const& ev) const
 {
-    return e.active;
+    return ev.active;
 }
 
 void SmartScript::InstallEvents()
 {
     if (!mInstallEvents.empty())
     {
-        for (auto& mInstallEvent : mInstallEvents)
-            mEvents.push_back(mInstallEvent);//must be before UpdateTimers
+        for (SmartScriptHolder const& holder : mInstallEvents)
+        {
+            mEvents.emplace_back(&holder);//must be before UpdateTimers
+            InitTimer(mEvents.back());
+        }
 
-        mInstallEvents.clear();
+        // list nodes keep their address, the events point at them
+        mInstalledEvents.splice(mInstalledEvents.end(), mInstallEvents);
     }
 }
 
@@ -4188,7 +4203,7 @@ void SmartScript::RemoveStoredEvent(uint32 id)
     {
         for (auto i = mStoredEvents.begin(); i != mStoredEvents.end(); ++i)
         {
-            if (i->event_id == id)
+            if (i->Holder.event_id == id)
             {
                 mStoredEvents.erase(i);
                 return;
@@ -4197,15 +4212,13 @@ void SmartScript::RemoveStoredEvent(uint32 id)
     }
 }
 
-SmartScriptHolder SmartScript::FindLinkedEvent(uint32 link)
+SmartScriptEvent const* SmartScript::FindLinkedEvent(uint32 link) const
 {
-    if (!mEvents.empty())
-        for (auto& mEvent : mEvents)
-            if (mEvent.event_id == link)
-                return mEvent;
+    for (SmartScriptEvent const& ev : mEvents)
+        if (ev.enabled && ev.Holder->event_id == link)
+            return &ev;
 
-    SmartScriptHolder s;
-    return s;
+    return nullptr;
 }
 
 void SmartScript::OnUpdate(uint32 const diff)
@@ -4218,21 +4231,44 @@ void SmartScript::OnUpdate(uint32 const diff)
 
     InstallEvents();//before UpdateTimers
 
-    for (auto& mEvent : mEvents)
-        UpdateTimer(mEvent, diff);
+    // scripts without timed events, cooldowns or runtime events have nothing to count down
+    if (mScript)
+    {
+        for (uint32 index : mScript->TimedEvents)
+            if (mEvents[index].enabled)
+                UpdateTimer(mEvents[index], diff);
+
+        for (uint32 i = 0; i < mCooldownEvents.size();)
+        {
+            SmartScriptEvent& ev = mEvents[mCooldownEvents[i]];
+            UpdateTimer(ev, diff);
+            if (!ev.active)
+            {
+                ++i;
+                continue;
+            }
+
+            ev.cooldown = false;
+            mCooldownEvents[i] = mCooldownEvents.back();
+            mCooldownEvents.pop_back();
+        }
+    }
+
+    for (uint32 i = GetScriptEventCount(); i < mEvents.size(); ++i)
+        UpdateTimer(mEvents[i], diff);
 
     if (!mStoredEvents.empty())
         for (auto& mStoredEvent : mStoredEvents)
-            UpdateTimer(mStoredEvent, diff);
+            UpdateTimer(mStoredEvent.State, diff);
 
     bool needCleanup = true;
     if (!mTimedActionList.empty())
     {
         for (auto& i : mTimedActionList)
         {
-            if (i.enableTimed)
+            if (i.State.enableTimed)
             {
-                UpdateTimer(i, diff);
+                UpdateTimer(i.State, diff);
                 needCleanup = false;
             }
         }
@@ -4259,9 +4295,9 @@ void SmartScript::OnUpdate(uint32 const diff)
     }
 }
 
-void SmartScript::FillScript(SmartAIEventList e, WorldObject* obj, AreaTriggerEntry const* at)
+void SmartScript::FillScript(SmartAIScriptPtr script, WorldObject* obj, AreaTriggerEntry const* at)
 {
-    if (e.empty())
+    if (!script)
     {
         if (obj)
             TC_LOG_DEBUG(LOG_FILTER_DATABASE_AI, "SmartScript: EventMap for Entry %u is empty but is using SmartScript.", obj->GetEntry());
@@ -4269,61 +4305,67 @@ void SmartScript::FillScript(SmartAIEventList e, WorldObject* obj, AreaTriggerEn
             TC_LOG_DEBUG(LOG_FILTER_DATABASE_AI, "SmartScript: EventMap for AreaTrigger %u is empty but is using SmartScript.", at->ID);
         return;
     }
-    for (auto& i : e)
+
+    // one state per event of the script, events of other difficulties stay disabled so indexes match the script
+    mScript = script;
+    mEvents.clear();
+    mCooldownEvents.clear();
+    mEvents.reserve(script->Events.size());
+    bool hasEvents = false;
+    for (SmartScriptHolder const& holder : script->Events)
     {
+        mEvents.emplace_back(&holder);
+        SmartScriptEvent& ev = mEvents.back();
+
         #ifndef TRINITY_DEBUG
-            if (i.event.event_flags & SMART_EVENT_FLAG_DEBUG_ONLY)
+            if (holder.event.event_flags & SMART_EVENT_FLAG_DEBUG_ONLY)
+            {
+                ev.enabled = false;
                 continue;
+            }
         #endif
 
-        if (i.event.event_flags & SMART_EVENT_FLAG_DIFFICULTY_ALL)//if has instance flag add only if in it
-        {
-            if (obj && obj->GetMap()->IsDungeon())
-            {
-                if ((1 << (CreatureTemplate::GetDiffFromSpawn(obj->GetMap()->GetSpawnMode()))) & i.event.event_flags)
-                {
-                    mEvents.push_back(i);
-                }
-            }
-            continue;
-        }
-        mEvents.push_back(i);//NOTE: 'world(0)' events still get processed in ANY instance mode
+        if (holder.event.event_flags & SMART_EVENT_FLAG_DIFFICULTY_ALL)//if has instance flag add only if in it
+            ev.enabled = obj && obj->GetMap()->IsDungeon() && ((1 << (CreatureTemplate::GetDiffFromSpawn(obj->GetMap()->GetSpawnMode()))) & holder.event.event_flags);
+        //NOTE: 'world(0)' events still get processed in ANY instance mode
+
+        hasEvents |= ev.enabled;
     }
-    if (mEvents.empty() && obj)
+    if (!hasEvents && obj)
         TC_LOG_ERROR(LOG_FILTER_SQL, "SmartScript: Entry %u has events but no events added to list because of instance flags.", obj->GetEntry());
-    if (mEvents.empty() && at)
+    if (!hasEvents && at)
         TC_LOG_ERROR(LOG_FILTER_SQL, "SmartScript: AreaTrigger %u has events but no events added to list because of instance flags. NOTE: triggers can not handle any instance flags.", at->ID);
 }
 
 void SmartScript::GetScript()
 {
-    SmartAIEventList e;
+    SmartAIScriptPtr script;
     if (me)
     {
         if(me->GetDBTableGUIDLow())
-            e = sSmartScriptMgr->GetScript(-static_cast<int32>(me->GetDBTableGUIDLow()), mScriptType);
-        if (e.empty())
-            e = sSmartScriptMgr->GetScript(static_cast<int32>(me->GetEntry()), mScriptType);
-        FillScript(e, me, nullptr);
+            script = sSmartScriptMgr->GetScript(-static_cast<int32>(me->GetDBTableGUIDLow()), mScriptType);
+        if (!script)
+            script = sSmartScriptMgr->GetScript(static_cast<int32>(me->GetEntry()), mScriptType);
+        FillScript(script, me, nullptr);
     }
     else if (go)
     {
-        e = sSmartScriptMgr->GetScript(-static_cast<int32>(go->GetDBTableGUIDLow()), mScriptType);
-        if (e.empty())
-            e = sSmartScriptMgr->GetScript(static_cast<int32>(go->GetEntry()), mScriptType);
-        FillScript(e, go, nullptr);
+        script = sSmartScriptMgr->GetScript(-static_cast<int32>(go->GetDBTableGUIDLow()), mScriptType);
+        if (!script)
+            script = sSmartScriptMgr->GetScript(static_cast<int32>(go->GetEntry()), mScriptType);
+        FillScript(script, go, nullptr);
     }
     else if (event)
     {
-        e = sSmartScriptMgr->GetScript(-static_cast<int32>(event->GetDBTableGUIDLow()), mScriptType);
-        if (e.empty())
-            e = sSmartScriptMgr->GetScript(static_cast<int32>(event->GetEntry()), mScriptType);
-        FillScript(e, event, nullptr);
+        script = sSmartScriptMgr->GetScript(-static_cast<int32>(event->GetDBTableGUIDLow()), mScriptType);
+        if (!script)
+            script = sSmartScriptMgr->GetScript(static_cast<int32>(event->GetEntry()), mScriptType);
+        FillScript(script, event, nullptr);
     }
     else if (trigger)
     {
-        e = sSmartScriptMgr->GetScript(static_cast<int32>(trigger->ID), mScriptType);
-        FillScript(e, nullptr, trigger);
+        script = sSmartScriptMgr->GetScript(static_cast<int32>(trigger->ID), mScriptType);
+        FillScript(script, nullptr, trigger);
     }
 }
 
@@ -4364,10 +4406,10 @@ void SmartScript::OnInitialize(WorldObject* obj, AreaTriggerEntry const* at)
         return;
     }
 
-    GetScript();//load copy of script
+    GetScript();//load shared script
 
-    for (auto& mEvent : mEvents)
-        InitTimer(mEvent);//calculate timers for first time use
+    for (SmartScriptEvent& ev : mEvents)
+        InitTimer(ev);//calculate timers for first time use
 
     ProcessEventsFor(SMART_EVENT_AI_INIT);
     InstallEvents();
@@ -4561,23 +4603,24 @@ Creature* SmartScript::FindCreatureNear(WorldObject* searchObject, ObjectGuid::L
     return creature;
 }
 
-void SmartScript::SetScript9(SmartScriptHolder& e, uint32 entry)
+void SmartScript::SetScript9(SmartScriptHolder const& e, uint32 entry)
 {
-    SmartAIEventList val = sSmartScriptMgr->GetScript(entry, SMART_SCRIPT_TYPE_TIMED_ACTIONLIST);
-    if (val.empty())
+    SmartAIScriptPtr script = sSmartScriptMgr->GetScript(entry, SMART_SCRIPT_TYPE_TIMED_ACTIONLIST);
+    if (!script)
         return;
 
-    for (auto i = val.begin(); i != val.end(); ++i)
+    // copied, the timer type of the caller changes the event type
+    for (SmartScriptHolder const& holder : script->Events)
     {
-        i->enableTimed = i == val.begin();
+        mTimedActionList.emplace_back(holder);
+        SmartScriptOwnedEvent& timed = mTimedActionList.back();
+        timed.State.enableTimed = &holder == &script->Events.front();
 
         if (e.action.timedActionList.timerType == 1)
-            i->event.type = SMART_EVENT_UPDATE_IC;
+            timed.Holder.event.type = SMART_EVENT_UPDATE_IC;
         else if (e.action.timedActionList.timerType > 1)
-            i->event.type = SMART_EVENT_UPDATE;
-        InitTimer((*i));
-        
-        mTimedActionList.push_back(*i);
+            timed.Holder.event.type = SMART_EVENT_UPDATE;
+        InitTimer(timed.State);
     }
 }
 
@@ -23,6 +23,33 @@
 #include "Unit.h"
 #include "SmartScriptMgr.h"
 
+// state of one event for the object running it, the event itself is shared
+struct SmartScriptEvent
+{
+    explicit SmartScriptEvent(SmartScriptHolder const* holder = nullptr) : Holder(holder), timer(0), active(false), runOnce(false), enableTimed(false),
+        enabled(true), cooldown(false) { }
+
+    SmartScriptHolder const* Holder;
+    uint32 timer;
+    bool active;
+    bool runOnce;
+    bool enableTimed;
+    bool enabled;       // false for events of other difficulties
+    bool cooldown;      // untimed event waiting in mCooldownEvents
+};
+
+// events created at runtime (timed events, action lists) keep their holder with them
+struct SmartScriptOwnedEvent
+{
+    explicit SmartScriptOwnedEvent(SmartScriptHolder const& holder) : Holder(holder), State(&Holder) { }
+    SmartScriptOwnedEvent(SmartScriptOwnedEvent const&) = delete;
+
+    SmartScriptHolder Holder;
+    SmartScriptEvent State;
+};
+
+typedef std::list<SmartScriptOwnedEvent> SmartScriptOwnedEventList;
+
 class SmartScript
 {
     public:
@@ -31,16 +58,16 @@ class SmartScript
 
         void OnInitialize(WorldObject* obj, AreaTriggerEntry const* at = nullptr);
         void GetScript();
-        void FillScript(SmartAIEventList e, WorldObject* obj, AreaTriggerEntry const* at);
+        void FillScript(SmartAIScriptPtr script, WorldObject* obj, AreaTriggerEntry const* at);
 
         void ProcessEventsFor(SMART_EVENT e, Unit* unit = nullptr, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, const SpellInfo* spell = nullptr, GameObject* gob = nullptr);
-        void ProcessEvent(SmartScriptHolder& e, Unit* unit = nullptr, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, const SpellInfo* spell = nullptr, GameObject* gob = nullptr);
-        bool CheckTimer(SmartScriptHolder const& e) const;
-        void RecalcTimer(SmartScriptHolder& e, uint32 min, uint32 max);
-        void UpdateTimer(SmartScriptHolder& e, uint32 const diff);
-        void InitTimer(SmartScriptHolder& e);
-        void ProcessAction(SmartScriptHolder& e, Unit* unit = nullptr, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, const SpellInfo* spell = nullptr, GameObject* gob = nullptr);
-		void ProcessTimedAction(SmartScriptHolder& e, uint32 const& min, uint32 const& max, Unit* unit = nullptr, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, const SpellInfo* spell = nullptr, GameObject* gob = nullptr, std::string const& varString = "");
+        void ProcessEvent(SmartScriptEvent& ev, Unit* unit = nullptr, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, const SpellInfo* spell = nullptr, GameObject* gob = nullptr);
+        bool CheckTimer(SmartScriptEvent const& ev) const;
+        void RecalcTimer(SmartScriptEvent& ev, uint32 min, uint32 max);
+        void UpdateTimer(SmartScriptEvent& ev, uint32 const diff);
+        void InitTimer(SmartScriptEvent& ev);
+        void ProcessAction(SmartScriptEvent& ev, Unit* unit = nullptr, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, const SpellInfo* spell = nullptr, GameObject* gob = nullptr);
+		void ProcessTimedAction(SmartScriptEvent& ev, uint32 const& min, uint32 const& max, Unit* unit = nullptr, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, const SpellInfo* spell = nullptr, GameObject* gob = nullptr, std::string const& varString = "");
         ObjectList* GetTargets(SmartScriptHolder const& e, Unit* invoker = nullptr);
         ObjectList* GetWorldObjectsInDist(float dist);
         void InstallTemplate(SmartScriptHolder const& e);
@@ -109,7 +136,7 @@ class SmartScript
         void ResetBaseObject();
 
         //TIMED_ACTIONLIST (script type 9 aka script9)
-        void SetScript9(SmartScriptHolder& e, uint32 entry);
+        void SetScript9(SmartScriptHolder const& e, uint32 entry);
         Unit* GetLastInvoker();
         ObjectGuid mLastInvoker;
         typedef std::unordered_map<uint32, uint32> CounterMap;
@@ -121,9 +148,12 @@ class SmartScript
         bool IsInPhase(uint32 p) const;
         void SetPhase(uint32 p = 0);
 
-        SmartAIEventList mEvents;
+        SmartAIScriptPtr mScript;
+        std::vector<SmartScriptEvent> mEvents;      // events of mScript by index, then installed events
+        std::vector<uint32> mCooldownEvents;        // untimed events of mScript with a running timer
         SmartAIEventList mInstallEvents;
-        SmartAIEventList mTimedActionList;
+        SmartAIEventList mInstalledEvents;
+        SmartScriptOwnedEventList mTimedActionList;
         Creature* me;
         ObjectGuid meOrigGUID;
         GameObject* go;
@@ -135,7 +165,7 @@ class SmartScript
 
         std::unordered_map<int32, int32> mStoredDecimals;
         uint32 mPathId;
-        SmartAIEventList mStoredEvents;
+        SmartScriptOwnedEventList mStoredEvents;
         std::list<uint32>mRemIDs;
 
         uint32 mTextTimer;
@@ -148,7 +178,8 @@ class SmartScript
         void InstallEvents();
 
         void RemoveStoredEvent(uint32 id);
-        SmartScriptHolder FindLinkedEvent(uint32 link);
+        SmartScriptEvent const* FindLinkedEvent(uint32 link) const;
+        uint32 GetScriptEventCount() const { return mScript ? uint32(mScript->Events.size()) : 0; }
 };
 
 #endif
@@ -32,6 +32,7 @@
 #include "SmartScriptMgr.h"
 #include "EventObjectData.h"
 #include "QuestData.h"
+#include <algorithm>
 
 void SmartWaypointMgr::LoadFromDB()
 {
@@ -116,10 +117,72 @@ SmartTarget::SmartTarget(SMARTAI_TARGETS t, uint32 p1, uint32 p2, uint32 p3): x(
     raw.param3 = p3;
 }
 
-SmartScriptHolder::SmartScriptHolder(): entryOrGuid(0), source_type(SMART_SCRIPT_TYPE_CREATURE), event_id(0), link(0), event{}, action{}, timer(0), active(false), runOnce(false), enableTimed(false)
+SmartScriptHolder::SmartScriptHolder(): entryOrGuid(0), source_type(SMART_SCRIPT_TYPE_CREATURE), event_id(0), link(0), event{}, action{}
 {
 }
 
+SmartAIScript::SmartAIScript(SmartAIEventList const& events) : Events(events.begin(), events.end())
+{
+    EventsByType.resize(Events.size());
+    for (uint32 i = 0; i < Events.size(); ++i)
+    {
+        EventsByType[i] = i;
+        if (IsTimedEvent(Events[i].GetEventType()))
+            TimedEvents.push_back(i);
+    }
+
+    std::stable_sort(EventsByType.begin(), EventsByType.end(), [this](uint32 left, uint32 right)
+    {
+        return Events[left].GetEventType() < Events[right].GetEventType();
+    });
+
+    for (uint32 i = 0; i < EventsByType.size(); ++i)
+    {
+        uint32 type = Events[EventsByType[i]].GetEventType();
+        if (Types.empty() || Types.back().Type != type)
+            Types.push_back({ type, i, i });
+
+        Types.back().End = i + 1;
+    }
+}
+
+SmartAIScript::TypeRange const* SmartAIScript::GetEventsOfType(uint32 type) const
+{
+    auto itr = std::lower_bound(Types.begin(), Types.end(), type, [](TypeRange const& range, uint32 type)
+    {
+        return range.Type < type;
+    });
+
+    return itr != Types.end() && itr->Type == type ? &*itr : nullptr;
+}
+
+bool SmartAIScript::IsTimedEvent(uint32 type)
+{
+    switch (type)
+    {
+        case SMART_EVENT_UPDATE:
+        case SMART_EVENT_UPDATE_OOC:
+        case SMART_EVENT_UPDATE_IC:
+        case SMART_EVENT_HEALT_PCT:
+        case SMART_EVENT_TARGET_HEALTH_PCT:
+        case SMART_EVENT_MANA_PCT:
+        case SMART_EVENT_TARGET_MANA_PCT:
+        case SMART_EVENT_RANGE:
+        case SMART_EVENT_TARGET_CASTING:
+        case SMART_EVENT_FRIENDLY_HEALTH:
+        case SMART_EVENT_FRIENDLY_IS_CC:
+        case SMART_EVENT_FRIENDLY_MISSING_BUFF:
+        case SMART_EVENT_HAS_AURA:
+        case SMART_EVENT_TARGET_BUFFED:
+        case SMART_EVENT_IS_BEHIND_TARGET:
+        case SMART_EVENT_CHECK_DIST_TO_HOME:
+        case SMART_EVENT_DISTANCE_CREATURE:
+            return true;
+        default:
+            return false;
+    }
+}
+
 SmartWaypointMgr::~SmartWaypointMgr()
 {
     for (std::unordered_map<uint32, WPPath*>::iterator itr = waypoint_map.begin(); itr != waypoint_map.end(); ++itr)
@@ -149,14 +212,16 @@ void SmartAIMgr::LoadSmartAIFromDB()
 {
     uint32 oldMSTime = getMSTime();
 
-    for (uint8 i = 0; i < SMART_SCRIPT_TYPE_MAX; i++)
-        mEventMap[i].clear();  //Drop Existing SmartAI List
+    SmartAIEventMap eventMap[SMART_SCRIPT_TYPE_MAX];
 
     PreparedStatement* stmt = WorldDatabase.GetPreparedStatement(WORLD_SEL_SMART_SCRIPTS);
     PreparedQueryResult result = WorldDatabase.Query(stmt);
 
     if (!result)
     {
+        for (uint8 i = 0; i < SMART_SCRIPT_TYPE_MAX; i++)
+            mScriptMap[i].clear();  //Drop Existing SmartAI List
+
         TC_LOG_INFO(LOG_FILTER_SERVER_LOADING, ">> Loaded 0 SmartAI scripts. DB table `smartai_scripts` is empty.");
 
         return;
@@ -278,30 +343,38 @@ void SmartAIMgr::LoadSmartAIFromDB()
             continue;
 
         // creature entry / guid not found in storage, create empty event list for it and increase counters
-        if (mEventMap[source_type].find(temp.entryOrGuid) == mEventMap[source_type].end())
+        if (eventMap[source_type].find(temp.entryOrGuid) == eventMap[source_type].end())
         {
             ++count;
             SmartAIEventList eventList;
-            mEventMap[source_type][temp.entryOrGuid] = eventList;
+            eventMap[source_type][temp.entryOrGuid] = eventList;
         }
         // store the new event
-        mEventMap[source_type][temp.entryOrGuid].push_back(temp);
+        eventMap[source_type][temp.entryOrGuid].push_back(temp);
     }
     while (result->NextRow());
 
+    // objects still running a replaced script keep their copy until they despawn
+    for (uint8 i = 0; i < SMART_SCRIPT_TYPE_MAX; i++)
+    {
+        mScriptMap[i].clear();  //Drop Existing SmartAI List
+        for (auto const& events : eventMap[i])
+            mScriptMap[i][events.first] = std::make_shared<SmartAIScript const>(events.second);
+    }
+
     TC_LOG_INFO(LOG_FILTER_SERVER_LOADING, ">> Loaded %u SmartAI scripts in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
 
 }
 
-SmartAIEventList SmartAIMgr::GetScript(int32 entry, SmartScriptType type)
+SmartAIScriptPtr SmartAIMgr::GetScript(int32 entry, SmartScriptType type)
 {
-    SmartAIEventList temp;
     uint32 _type = type;
-    if (mEventMap[_type].find(entry) != mEventMap[_type].end())
-        return mEventMap[_type][entry];
+    SmartAIScriptMap::const_iterator itr = mScriptMap[_type].find(entry);
+    if (itr != mScriptMap[_type].end())
+        return itr->second;
     if (entry > 0)//first search is for guid (negative), do not drop error if not found
     TC_LOG_DEBUG(LOG_FILTER_DATABASE_AI, "SmartAIMgr::GetScript: Could not load Script for Entry %d ScriptType %u.", entry, uint32(type));
-    return temp;
+    return SmartAIScriptPtr();
 }
 
 bool SmartAIMgr::IsTargetValid(SmartScriptHolder const& e)
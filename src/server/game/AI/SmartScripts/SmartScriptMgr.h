@@ -1666,11 +1666,6 @@ struct SmartScriptHolder
         uint32 GetEventType() const { return (uint32)event.type; }
         uint32 GetActionType() const { return (uint32)action.type; }
         uint32 GetTargetType() const { return (uint32)target.type; }
-
-    uint32 timer;
-    bool active;
-    bool runOnce;
-    bool enableTimed;
 };
 
 typedef std::unordered_map<uint32, WayPoint*> WPPath;
@@ -1700,6 +1695,33 @@ typedef std::list<SmartScriptHolder> SmartAIEventList;
 // all events for all entries / guids
 typedef std::unordered_map<int64, SmartAIEventList> SmartAIEventMap;
 
+// events of one entry / guid as loaded, shared by every object running them; the state of
+// the events (timers, phase, run once) is kept by each SmartScript
+struct SmartAIScript
+{
+    struct TypeRange
+    {
+        uint32 Type;
+        uint32 Begin;
+        uint32 End;
+    };
+
+    std::vector<SmartScriptHolder> Events;      // load order
+    std::vector<uint32> EventsByType;           // indexes of Events grouped by event type, load order within a type
+    std::vector<TypeRange> Types;               // ranges of EventsByType, sorted by type
+    std::vector<uint32> TimedEvents;            // indexes of Events counting down in SmartScript::OnUpdate
+
+    explicit SmartAIScript(SmartAIEventList const& events);
+
+    TypeRange const* GetEventsOfType(uint32 type) const;
+
+    // events whose timer triggers them, other events only use it as cooldown
+    static bool IsTimedEvent(uint32 type);
+};
+
+typedef std::shared_ptr<SmartAIScript const> SmartAIScriptPtr;
+typedef std::unordered_map<int64, SmartAIScriptPtr> SmartAIScriptMap;
+
 class SmartAIMgr
 {
         SmartAIMgr() { }
@@ -1710,11 +1732,11 @@ class SmartAIMgr
 
         void LoadSmartAIFromDB();
 
-        SmartAIEventList GetScript(int32 entry, SmartScriptType type);
+        SmartAIScriptPtr GetScript(int32 entry, SmartScriptType type);
 
     private:
         //event stores
-        SmartAIEventMap mEventMap[SMART_SCRIPT_TYPE_MAX];
+        SmartAIScriptMap mScriptMap[SMART_SCRIPT_TYPE_MAX];
 
         bool IsEventValid(SmartScriptHolder& e);
         bool IsTargetValid(SmartScriptHolder const& e);
@@ -0,0 +1,623 @@
+#include "Common.h"
+#include "AnticheatMovementChecks.h"
+#include "GridDefines.h"
+#include "Log.h"
+#include "MovementTypedefs.h"
+#include "Opcodes.h"
+#include "Timer.h"
+#include <algorithm>
+#include <cmath>
+
+const char* GetCheatTypeNameFromFlag(CheatType flagId)
+{
+    switch (flagId)
+    {
+        case CHEAT_TYPE_WALL_CLIMB:
+            return "WallClimb";
+        case CHEAT_TYPE_WATER_WALK:
+            return "WaterWalk";
+        case CHEAT_TYPE_FORBIDDEN:
+            return "AccessForbidden";
+        case CHEAT_TYPE_BG_NOT_STARTED:
+            return "BgNotStarted";
+        case CHEAT_TYPE_MULTIJUMP:
+            return "MultiJump";
+        case CHEAT_TYPE_FALL_UP:
+            return "FakeFall";
+        case CHEAT_TYPE_UNREACHABLE:
+            return "Unreachable";
+        case CHEAT_TYPE_TIME_BACK:
+            return "ReverseTime";
+        case CHEAT_TYPE_OVERSPEED_JUMP:
+            return "OverspeedJump";
+        case CHEAT_TYPE_JUMP_SPEED_CHANGE:
+            return "JumpSpeedChange";
+        case CHEAT_TYPE_FLY_HACK_SWIM:
+            return "FlyHackSwim";
+        case CHEAT_TYPE_ROOT_MOVE:
+            return "MovementRooted";
+        case CHEAT_TYPE_ROOT_IGNORED:
+            return "Unstunnable";
+        case CHEAT_TYPE_TELEPORT_HACK:
+            return "TeleportHack";
+        case CHEAT_TYPE_DESYNC_TIME:
+            return "DesyncTime";
+        case CHEAT_TYPE_EXPLORE:
+            return "Exploration";
+        case CHEAT_TYPE_EXPLORE_HIGH_LEVEL:
+            return "ExploreHighLevelArea";
+        case CHEAT_TYPE_OVERSPEED_Z:
+            return "OverspeedZ";
+        case CHEAT_TYPE_SKIPPED_HEARTBEATS:
+            return "SkippedHeartbeats";
+        case CHEAT_TYPE_NUM_DESYNC:
+            return "NumDesyncs";
+        case CHEAT_TYPE_FAKE_TRANSPORT:
+            return "FakeTransport";
+        case CHEAT_TYPE_TELE_TO_TRANSPORT:
+            return "TeleToTransport";
+        case CHEAT_TYPE_SPEED_HACK_ALERTS:
+            return "SpeedHackAlerts";
+        case CHEAT_TYPE_FLY_HACK:
+            return "FlyHack";
+        case CHEAT_TYPE_SUPERJUMP:
+            return "SuperJump";
+        case CHEAT_TYPE_DISABLE_GRAVITY:
+            return "DisableGravity";
+        default:
+            return "UnknownCheat";
+    }
+}
+
+const char* GetAnticheatDetectorName(AnticheatDetector detector)
+{
+    switch (detector)
+    {
+        case ANTICHEAT_DETECTOR_JUMP:
+            return "Jump";
+        case ANTICHEAT_DETECTOR_TIME:
+            return "Time";
+        case ANTICHEAT_DETECTOR_ROOT:
+            return "Root";
+        case ANTICHEAT_DETECTOR_BATTLEGROUND:
+            return "Battleground";
+        case ANTICHEAT_DETECTOR_MOVE_FLAGS:
+            return "MoveFlags";
+        case ANTICHEAT_DETECTOR_TRANSPORT:
+            return "Transport";
+        case ANTICHEAT_DETECTOR_SPEED:
+            return "Speed";
+        default:
+            return "Unknown";
+    }
+}
+
+AnticheatMovementChecks::AnticheatMovementChecks() : _jumpCount(0), _clientDesynchro(0), _jumpInitialSpeed(0.0f), _jumpInitialVelocity(0.0f),
+_overspeedDistance(0.0f), _inKnockBack(false)
+{
+    for (auto& clientSpeed : _clientSpeeds)
+        clientSpeed = 0.0f;
+}
+
+void AnticheatMovementChecks::Init()
+{
+    _overspeedDistance = 0.f;
+    _clientDesynchro = 0;
+
+    _jumpInitialSpeed = 0.0f;
+    _jumpInitialVelocity = 0.0f;
+
+    _jumpCount = 0;
+    _inKnockBack = false;
+
+    _orders =
+    {
+        { SMSG_MOVE_SET_WALK_SPEED, CMSG_MOVE_FORCE_WALK_SPEED_CHANGE_ACK },
+        { SMSG_MOVE_SET_RUN_SPEED, CMSG_MOVE_FORCE_RUN_SPEED_CHANGE_ACK },
+        { SMSG_MOVE_SET_RUN_BACK_SPEED, CMSG_MOVE_FORCE_RUN_BACK_SPEED_CHANGE_ACK },
+        { SMSG_MOVE_SET_SWIM_SPEED, CMSG_MOVE_FORCE_SWIM_SPEED_CHANGE_ACK },
+        { SMSG_MOVE_SET_SWIM_BACK_SPEED, CMSG_MOVE_FORCE_SWIM_BACK_SPEED_CHANGE_ACK },
+        { SMSG_MOVE_SET_TURN_RATE, CMSG_MOVE_FORCE_TURN_RATE_CHANGE_ACK },
+        { SMSG_MOVE_ROOT, CMSG_MOVE_FORCE_ROOT_ACK },
+        { SMSG_MOVE_UNROOT, CMSG_MOVE_FORCE_UNROOT_ACK },
+        { SMSG_MOVE_SET_FEATHER_FALL, SMSG_MOVE_SET_NORMAL_FALL, CMSG_MOVE_FEATHER_FALL_ACK },
+        { SMSG_MOVE_SET_HOVERING, SMSG_MOVE_UNSET_HOVERING, CMSG_MOVE_HOVER_ACK },
+        { SMSG_MOVE_SET_CAN_FLY, SMSG_MOVE_UNSET_CAN_FLY, CMSG_MOVE_SET_CAN_FLY_ACK },
+        { SMSG_MOVE_SET_WATER_WALK, SMSG_MOVE_SET_LAND_WALK, CMSG_MOVE_WATER_WALK_ACK },
+        { SMSG_MOVE_ENABLE_GRAVITY, SMSG_MOVE_DISABLE_GRAVITY, CMSG_MOVE_GRAVITY_ENABLE_ACK }
+    };
+}
+
+void AnticheatMovementChecks::OrderSent(uint32 opcode, uint32 now)
+{
+    for (auto &order : _orders)
+    {
+        if (order.serverOpcode1 == opcode || order.serverOpcode2 == opcode)
+        {
+            order.lastSent = now;
+            ++order.counter;
+            break;
+        }
+    }
+}
+
+void AnticheatMovementChecks::CheckForOrderAck(uint32 opcode)
+{
+    for (auto &order : _orders)
+    {
+        if (order.clientResp == opcode)
+        {
+            --order.counter;
+            break;
+        }
+    }
+}
+
+bool AnticheatMovementChecks::HasPendingOrder(uint32 clientResp) const
+{
+    for (auto const &order : _orders)
+        if (order.clientResp == clientResp)
+            return order.counter != 0;
+
+    // unknown order, never blame the client for it
+    return true;
+}
+
+void AnticheatMovementChecks::OnKnockBack(float speedZ)
+{
+    _jumpInitialSpeed = speedZ;
+    _inKnockBack = true;
+}
+
+void AnticheatMovementChecks::Check(AnticheatMovementContext const& context, AnticheatCheckConfig const& config, AnticheatMovementResult& result)
+{
+    MovementSample const& movementInfo = *context.Current;
+    MovementSample const& last = *context.Last;
+    uint32 const opcode = context.Opcode;
+
+    uint32 cheatType = 0x0;
+#define APPEND_CHEAT(t) cheatType |= (1 << t)
+#define DETECTOR_ENABLED(d) (config.Detectors & (1 << d))
+
+    // check ACK responses
+    CheckForOrderAck(opcode);
+
+    if (opcode == CMSG_MOVE_FEATHER_FALL_ACK)
+        _jumpInitialSpeed = std::max(_jumpInitialSpeed, 7.0f);
+
+    if (DETECTOR_ENABLED(ANTICHEAT_DETECTOR_JUMP))
+    {
+        if (opcode == CMSG_MOVE_JUMP && movementInfo.FallHorizontalSpeed > (GetClientSpeed(MOVE_RUN) + 0.0001f))
+            APPEND_CHEAT(CHEAT_TYPE_OVERSPEED_JUMP);
+
+        // Not allowed to change jump speed while jumping
+        if ((movementInfo.MoveFlags & (MOVEMENTFLAG_FALLING | MOVEMENTFLAG_FALLING_FAR)) && (last.MoveFlags & (MOVEMENTFLAG_FALLING | MOVEMENTFLAG_FALLING_FAR)))
+            if (fabs(movementInfo.FallHorizontalSpeed - last.FallHorizontalSpeed) > 0.0001f)
+                if (fabs(movementInfo.FallHorizontalSpeed - std::min(GetClientSpeed(MOVE_RUN), 2.5f)) > 0.0001f)
+                    APPEND_CHEAT(CHEAT_TYPE_JUMP_SPEED_CHANGE);
+    }
+
+    if (DETECTOR_ENABLED(ANTICHEAT_DETECTOR_ROOT))
+        if ((movementInfo.MoveFlags & MOVEMENTFLAG_ROOT) && (movementInfo.MoveFlags & MOVEMENTFLAG_MASK_MOVING_OR_TURN))
+            APPEND_CHEAT(CHEAT_TYPE_ROOT_MOVE);
+
+    if (DETECTOR_ENABLED(ANTICHEAT_DETECTOR_JUMP) && config.AntiMultiJump)
+    {
+        if (opcode == CMSG_MOVE_HEARTBEAT)
+        {
+            if (_jumpCount && movementInfo.FallJumpVelocity < _jumpInitialVelocity)
+                APPEND_CHEAT(CHEAT_TYPE_SUPERJUMP);
+        }
+        if (opcode == CMSG_MOVE_DOUBLE_JUMP)
+            _jumpInitialVelocity = movementInfo.FallJumpVelocity;
+
+        if (opcode == CMSG_MOVE_KNOCK_BACK_ACK)
+            _jumpInitialVelocity = movementInfo.FallJumpVelocity;
+
+        if (opcode == CMSG_MOVE_JUMP)
+        {
+            _jumpInitialVelocity = movementInfo.FallJumpVelocity;
+            _jumpCount++;
+            if (_jumpCount > 2 && !(context.State & MOVER_STATE_DOUBLE_JUMP))
+                APPEND_CHEAT(CHEAT_TYPE_MULTIJUMP);
+        }
+        else if (opcode == CMSG_MOVE_FALL_LAND || opcode == CMSG_MOVE_START_SWIM)
+            _jumpCount = 0;
+    }
+
+    if (DETECTOR_ENABLED(ANTICHEAT_DETECTOR_TIME) && movementInfo.ClientMoveTime == 0)
+        APPEND_CHEAT(CHEAT_TYPE_NULL_CLIENT_TIME);
+
+    // Dont accept movement packets while movement is controlled by server (fear, charge, etc..)
+    if (context.State & MOVER_STATE_SPLINE_ACTIVE)
+    {
+        result.Accepted = false;
+        return;
+    }
+
+    // Timing checks
+    if (DETECTOR_ENABLED(ANTICHEAT_DETECTOR_TIME) && last.ClientMoveTime)
+    {
+        if (last.MoveFlags & MOVEMENTFLAG_MASK_MOVING)
+        {
+            int32 currentDesync = static_cast<int32>(getMSTimeDiff(last.ClientMoveTime, movementInfo.ClientMoveTime)) - getMSTimeDiff(last.MoveTime, movementInfo.MoveTime);
+            _clientDesynchro += currentDesync;
+            if (currentDesync > 1000)
+                APPEND_CHEAT(CHEAT_TYPE_NUM_DESYNC);
+        }
+
+        // Client going back in time ... ?!
+        if (movementInfo.ClientMoveTime < last.ClientMoveTime)
+            APPEND_CHEAT(CHEAT_TYPE_TIME_BACK);
+    }
+
+    // Warsong Battleground - specific checks
+    if (DETECTOR_ENABLED(ANTICHEAT_DETECTOR_BATTLEGROUND) && context.MapId == 489)
+    {
+        // Too high - not allowed (but possible with some engineering items malfunction)
+        if (!(movementInfo.MoveFlags & (MOVEMENTFLAG_FALLING_FAR | MOVEMENTFLAG_FALLING)) && movementInfo.PositionZ > 380.0f)
+            APPEND_CHEAT(CHEAT_TYPE_FORBIDDEN);
+        if (context.State & MOVER_STATE_BG_WAIT_JOIN)
+        {
+            // Battleground not started. Players should be in their starting areas.
+            if ((context.State & MOVER_STATE_TEAM_ALLIANCE) && movementInfo.PositionX < 1490.0f)
+                APPEND_CHEAT(CHEAT_TYPE_BG_NOT_STARTED);
+            if ((context.State & MOVER_STATE_TEAM_HORDE) && movementInfo.PositionX > 957.0f)
+                APPEND_CHEAT(CHEAT_TYPE_BG_NOT_STARTED);
+        }
+    }
+
+    // Movement states checks
+    if (DETECTOR_ENABLED(ANTICHEAT_DETECTOR_MOVE_FLAGS) && !(context.State & MOVER_STATE_LAUNCHED_OR_FALLING))
+        result.FlagCheats = CheckMoveFlags(context, config);
+
+    // Minimal checks on transports
+    if (DETECTOR_ENABLED(ANTICHEAT_DETECTOR_TRANSPORT) && movementInfo.OnTransport)
+    {
+        // To transport tele hack detection
+        if (last.ClientMoveTime && !last.OnTransport)
+        {
+            float dist2d = (movementInfo.PositionX - last.PositionX) * (movementInfo.PositionX - last.PositionX);
+            dist2d += (movementInfo.PositionY - last.PositionY) * (movementInfo.PositionY - last.PositionY);
+            if (dist2d > 100 * 100)
+                APPEND_CHEAT(CHEAT_TYPE_TELE_TO_TRANSPORT);
+        }
+    }
+
+    // Distance computation related
+    if (DETECTOR_ENABLED(ANTICHEAT_DETECTOR_SPEED) && !(context.State & (MOVER_STATE_IN_FLIGHT | MOVER_STATE_ON_TRANSPORT)) && !movementInfo.OnTransport && config.AntiSpeedHack)
+    {
+        CheckSpeed(context, config, result);
+        if (result.SpeedHack)
+            APPEND_CHEAT(CHEAT_TYPE_SPEED_HACK_ALERTS);
+    }
+
+    // This is required for proper movement interpolation
+    if (opcode == CMSG_MOVE_JUMP)
+        _jumpInitialSpeed = 7.95797334f;
+    else if (opcode == CMSG_MOVE_FALL_LAND)
+    {
+        _jumpInitialSpeed = -9.645f;
+        _inKnockBack = false;
+    }
+
+    result.Cheats |= cheatType;
+#undef DETECTOR_ENABLED
+#undef APPEND_CHEAT
+}
+
+uint32 AnticheatMovementChecks::CheckMoveFlags(AnticheatMovementContext const& context, AnticheatCheckConfig const& config) const
+{
+    uint32 const moveFlags = context.Current->MoveFlags;
+    uint32 const state = context.State;
+    uint32 cheats = 0;
+
+    if ((moveFlags & MOVEMENTFLAG_WALKING)/* && (moveFlags & MOVEMENTFLAG_FIXED_Z)*/ && (moveFlags & MOVEMENTFLAG_SWIMMING) && (moveFlags & MOVEMENTFLAG_HOVER)
+        && (moveFlags & MOVEMENTFLAG_FALLING_FAR) && (moveFlags & MOVEMENTFLAG_FLYING))
+    {
+        cheats |= 1 << CHEAT_TYPE_FLY_HACK_SWIM;
+        if (config.DetailsLog)
+            sLog->outAnticheat("Anticheat (MovementFlags hack): player %s (security: %u) had old flyhack moveFlags mask", context.MoverName, context.Security);
+    }
+
+    // no need to check pending orders for this.  players should never levitate.
+    if ((moveFlags & MOVEMENTFLAG_DISABLE_GRAVITY) && !(state & MOVER_STATE_DISABLE_GRAVITY_AURA) && !HasPendingOrder(CMSG_MOVE_GRAVITY_ENABLE_ACK))
+    {
+        cheats |= 1 << CHEAT_TYPE_DISABLE_GRAVITY;
+        if (config.DetailsLog)
+            sLog->outAnticheat("Anticheat (MovementFlags hack): player %s (security: %u) had not find fly aura and MOVEMENTFLAG_DISABLE_GRAVITY", context.MoverName, context.Security);
+    }
+
+    // detect new flyhack (these two flags should never happen at the same time)
+    if ((moveFlags & MOVEMENTFLAG_SWIMMING) && (moveFlags & MOVEMENTFLAG_FLYING))
+    {
+        cheats |= 1 << CHEAT_TYPE_FLY_HACK_SWIM;
+        if (config.DetailsLog)
+            sLog->outAnticheat("Anticheat (MovementFlags hack): player %s (security: %u) had MOVEMENTFLAG_SWIMMING and MOVEMENTFLAG_FLYING", context.MoverName, context.Security);
+    }
+
+    // detect new flyhack (these two flags should never happen at the same time)
+    if ((moveFlags & MOVEMENTFLAG_FLYING) && !(state & MOVER_STATE_FLY_AURA) && !HasPendingOrder(CMSG_MOVE_SET_CAN_FLY_ACK))
+    {
+        cheats |= 1 << CHEAT_TYPE_FLY_HACK;
+        if (config.DetailsLog)
+            sLog->outAnticheat("Anticheat (MovementFlags hack): player %s (security: %u) had not find fly aura and MOVEMENTFLAG_FLYING", context.MoverName, context.Security);
+    }
+
+    if (context.Opcode == CMSG_MOVE_STOP_SWIM && (moveFlags & MOVEMENTFLAG_SWIMMING))
+    {
+        cheats |= 1 << CHEAT_TYPE_FLY_HACK_SWIM;
+        if (config.DetailsLog)
+            sLog->outAnticheat("Anticheat (MovementFlags hack): player %s (security: %u) received opcode CMSG_MOVE_STOP_SWIM, but had MOVEMENTFLAG_SWIMMING", context.MoverName, context.Security);
+    }
+
+    // if water walking with no aura and no pending removal order, cheater
+    if ((moveFlags & MOVEMENTFLAG_WATERWALKING) && !(state & MOVER_STATE_WATER_WALK_AURA) && !HasPendingOrder(CMSG_MOVE_WATER_WALK_ACK))
+    {
+        cheats |= 1 << CHEAT_TYPE_WATER_WALK;
+        if (config.DetailsLog)
+            sLog->outAnticheat("Anticheat (MovementFlags hack): player %s (security: %u) had MOVEMENTFLAG_WATERWALKING with no water walk aura and no pending orders", context.MoverName, context.Security);
+    }
+
+    // if safe falling with no aura and no pending removal order, cheater
+    if ((moveFlags & MOVEMENTFLAG_FEATHER_FALL) && !(state & MOVER_STATE_FEATHER_FALL_AURA) && !HasPendingOrder(CMSG_MOVE_FEATHER_FALL_ACK))
+    {
+        cheats |= 1 << CHEAT_TYPE_SLOW_FALL;
+        if (config.DetailsLog)
+            sLog->outAnticheat("Anticheat (MovementFlags hack): player %s (security: %u) had MOVEMENTFLAG_FEATHER_FALL with no slow fall aura and no pending orders", context.MoverName, context.Security);
+    }
+
+    // if hover with no aura and no pending removal order, cheater
+    if ((moveFlags & MOVEMENTFLAG_HOVER) && !(state & MOVER_STATE_HOVER_AURA) && !HasPendingOrder(CMSG_MOVE_HOVER_ACK))
+    {
+        cheats |= 1 << CHEAT_TYPE_HOVER;
+        if (config.DetailsLog)
+            sLog->outAnticheat("Anticheat (MovementFlags hack): player %s (security: %u) had MOVEMENTFLAG_HOVER with no hover aura and no pending orders", context.MoverName, context.Security);
+    }
+
+    return cheats;
+}
+
+void AnticheatMovementChecks::CheckSpeed(AnticheatMovementContext const& context, AnticheatCheckConfig const& config, AnticheatMovementResult& result)
+{
+    MovementSample const& movementInfo = *context.Current;
+    MovementSample const& last = *context.Last;
+
+    float allowedDXY = 0.0f;
+    float allowedDZ = 0.0f;
+    float realDistance2D_sq = 0.0f;
+
+    int32 dt = movementInfo.ClientMoveTime - last.ClientMoveTime;
+    if (config.MaxAllowedDesync && dt > config.MaxAllowedDesync)
+        dt = config.MaxAllowedDesync;
+
+    // Check vs interpolation
+    float speed = 0.0f;
+    if (config.Interpolation)
+    {
+        float intX, intY, intZ, intO;
+
+        if (InterpolateMovement(last, context.State, context.Terrain, dt, intX, intY, intZ, intO, speed))
+        {
+            auto const intDX = intX - movementInfo.PositionX;
+            auto const intDY = intY - movementInfo.PositionY;
+            auto const intDZ = intZ - movementInfo.PositionZ;
+
+            auto interpolDist = pow(intDX, 2) + pow(intDY, 2);
+            if ((movementInfo.MoveFlags | last.MoveFlags) & MOVEMENTFLAG_FALLING)
+                interpolDist += pow(intDZ, 2);
+            interpolDist = sqrt(interpolDist);
+
+            float allowedDX = pow(intX - last.PositionX, 2);
+            float allowedDY = pow(intY - last.PositionY, 2);
+            allowedDXY = sqrt(allowedDX + allowedDY);
+
+            realDistance2D_sq = pow(movementInfo.PositionX - last.PositionX, 2) + pow(movementInfo.PositionY - last.PositionY, 2);
+
+            if (realDistance2D_sq > (allowedDY + allowedDX) * 1.1f)
+            {
+                _overspeedDistance += sqrt(realDistance2D_sq) - sqrt(allowedDY + allowedDX);
+                result.SpeedHack = true;
+                if (config.DetailsLog)
+                    sLog->outAnticheat("Anticheat (SpeedHackAlerts): [Opcode:%s] Flags 0x%x [ClientMoveTime=%u] dist %f allowed %f real %f speed %f",
+                        context.OpcodeName, movementInfo.MoveFlags, movementInfo.ClientMoveTime, _overspeedDistance, allowedDXY, realDistance2D_sq, speed);
+            }
+
+            if (config.DetailsLog)
+                sLog->outAnticheat("[Opcode:%s] Flags 0x%x [DT=%u:DR=%.2f] dist %f speed %f",
+                    context.OpcodeName, movementInfo.MoveFlags, movementInfo.ClientMoveTime - last.ClientMoveTime, interpolDist, _overspeedDistance, speed);
+        }
+    }
+    else if (GetMaxAllowedDist(last, context.State, dt, allowedDXY, allowedDZ, speed))
+    {
+        // Allow some margin
+        allowedDXY += 0.5f;
+        allowedDZ += 0.5f;
+        realDistance2D_sq = pow(movementInfo.PositionX - last.PositionX, 2) + pow(movementInfo.PositionY - last.PositionY, 2);
+
+        float allowedD = allowedDXY * allowedDXY * 1.1f;
+        if (realDistance2D_sq > allowedD)
+        {
+            _overspeedDistance += sqrt(realDistance2D_sq) - allowedDXY;
+            result.SpeedHack = true;
+            if (config.DetailsLog)
+                sLog->outAnticheat("Anticheat (SpeedHackAlerts): [Opcode:%s] Flags 0x%x [DT=%u:ClientMoveTime=%u] dist %f allowed %f real %f speed %f",
+                    context.OpcodeName, movementInfo.MoveFlags, dt, movementInfo.ClientMoveTime, _overspeedDistance, allowedD, realDistance2D_sq, speed);
+        }
+
+        if (fabs(movementInfo.PositionZ - last.PositionZ) > allowedDZ)
+            result.Cheats |= 1 << CHEAT_TYPE_OVERSPEED_Z;
+
+        if (config.DetailsLog)
+            sLog->outAnticheat("[Opcode:%s] Flags 0x%x [DT=%u:ClientMoveTime=%u] dist %f allowed %f real %f speed %f",
+                context.OpcodeName, movementInfo.MoveFlags, dt, movementInfo.ClientMoveTime, _overspeedDistance, allowedD, realDistance2D_sq, speed);
+    }
+
+    // Client should send heartbeats every 500ms
+    // if (dt > 1000 && last.ClientMoveTime && last.MoveFlags & MOVEMENTFLAG_MASK_MOVING)
+        // APPEND_CHEAT(CHEAT_TYPE_SKIPPED_HEARTBEATS);
+
+    result.RealDistance2DSq = realDistance2D_sq;
+}
+
+bool AnticheatMovementChecks::InterpolateMovement(MovementSample const& mi, uint32 state, AnticheatTerrain const* terrain, uint32 diffMs, float &x, float &y, float &z, float &outOrientation, float &speed) const
+{
+    // TODO: These cases are not handled in mvt interpolationo
+    // - Transports
+    if (mi.MoveFlags & (MOVEMENTFLAG_PITCH_UP | MOVEMENTFLAG_PITCH_DOWN) || mi.OnTransport)
+        return false;
+    // - Not correctly handled yet (issues regarding feather fall auras)
+    if (mi.MoveFlags & MOVEMENTFLAG_FALLING_FAR)
+        return false;
+    // - Server side movement (should be easy to interpolate actually)
+    if (state & MOVER_STATE_SPLINE_ACTIVE)
+        return false;
+    // Dernier paquet pas a jour (connexion, TP autre map ...)
+    if (mi.ClientMoveTime == 0)
+        return false;
+    x = mi.PositionX;
+    y = mi.PositionY;
+    z = mi.PositionZ;
+    outOrientation = mi.Orientation;
+    float o = outOrientation;
+    // Not allowed to move
+    if (mi.MoveFlags & MOVEMENTFLAG_ROOT)
+        return true;
+
+    if (mi.MoveFlags & MOVEMENTFLAG_MASK_MOVING_FLY)
+        speed = mi.MoveFlags & (MOVEMENTFLAG_BACKWARD) ? GetClientSpeed(MOVE_FLIGHT_BACK) : GetClientSpeed(MOVE_FLIGHT);
+    else if (mi.MoveFlags & MOVEMENTFLAG_SWIMMING)
+        speed = mi.MoveFlags & (MOVEMENTFLAG_BACKWARD) ? GetClientSpeed(MOVE_SWIM_BACK) : GetClientSpeed(MOVE_SWIM);
+    else if (mi.MoveFlags & MOVEMENTFLAG_WALKING)
+        speed = GetClientSpeed(MOVE_WALK);
+    else if (mi.MoveFlags & MOVEMENTFLAG_MASK_MOVING)
+        speed = mi.MoveFlags & (MOVEMENTFLAG_BACKWARD) ? GetClientSpeed(MOVE_RUN_BACK) : GetClientSpeed(MOVE_RUN);
+    else if (mi.MoveFlags & (MOVEMENTFLAG_PITCH_UP | MOVEMENTFLAG_PITCH_DOWN))
+        speed = GetClientSpeed(MOVE_PITCH_RATE);
+    if (mi.MoveFlags & MOVEMENTFLAG_BACKWARD)
+        o += M_PI_F;
+    else if (mi.MoveFlags & MOVEMENTFLAG_STRAFE_LEFT)
+    {
+        if (mi.MoveFlags & MOVEMENTFLAG_FORWARD)
+            o += M_PI_F / 4;
+        else
+            o += M_PI_F / 2;
+    }
+    else if (mi.MoveFlags & MOVEMENTFLAG_STRAFE_RIGHT)
+    {
+        if (mi.MoveFlags & MOVEMENTFLAG_FORWARD)
+            o -= M_PI_F / 4;
+        else
+            o -= M_PI_F / 2;
+    }
+    if (mi.MoveFlags & MOVEMENTFLAG_FALLING)
+    {
+        float diffT = getMSTimeDiff(mi.FallStartClientTime, diffMs + mi.ClientMoveTime) / 1000.0f;
+        x = mi.FallStartX;
+        y = mi.FallStartY;
+        z = mi.FallStartZ;
+        // Fatal error. Avoid crashing here ...
+        if (!x || !y || !z || diffT > 10000.0f)
+            return false;
+        x += mi.FallDirectionX * mi.FallHorizontalSpeed * diffT;
+        y += mi.FallDirectionY * mi.FallHorizontalSpeed * diffT;
+        z -= Movement::computeFallElevation(diffT, mi.MoveFlags & MOVEMENTFLAG_FEATHER_FALL, -_jumpInitialSpeed);
+    }
+    else if (mi.MoveFlags & (MOVEMENTFLAG_LEFT | MOVEMENTFLAG_RIGHT))
+    {
+        if (mi.MoveFlags & MOVEMENTFLAG_MASK_MOVING)
+        {
+            // Every 2 sec
+            float T = 0.75f * (GetClientSpeed(MOVE_TURN_RATE)) * (diffMs / 1000.0f);
+            float R = 1.295f * speed / M_PI * cos(mi.Pitch);
+            z += diffMs * speed / 1000.0f * sin(mi.Pitch);
+            // Find the center of the circle we are moving on
+            if (mi.MoveFlags & MOVEMENTFLAG_LEFT)
+            {
+                x += R * cos(o + M_PI / 2);
+                y += R * sin(o + M_PI / 2);
+                outOrientation += T;
+                T = T - M_PI / 2.0f;
+            }
+            else
+            {
+                x += R * cos(o - M_PI / 2);
+                y += R * sin(o - M_PI / 2);
+                outOrientation -= T;
+                T = -T + M_PI / 2.0f;
+            }
+            x += R * cos(o + T);
+            y += R * sin(o + T);
+        }
+        else
+        {
+            float diffO = GetClientSpeed(MOVE_TURN_RATE) * diffMs / 1000.0f;
+            if (mi.MoveFlags & MOVEMENTFLAG_LEFT)
+                outOrientation += diffO;
+            else
+                outOrientation -= diffO;
+            return true;
+        }
+    }
+    else if (mi.MoveFlags & MOVEMENTFLAG_MASK_MOVING)
+    {
+        float dist = speed * diffMs / 1000.0f;
+        x += dist * cos(o) * cos(mi.Pitch);
+        y += dist * sin(o) * cos(mi.Pitch);
+        z += dist * sin(mi.Pitch);
+    }
+    else // If we reach here, we did not move
+        return true;
+
+    if (!Trinity::IsValidMapCoord(x, y, z, o))
+        return false;
+
+    if (!terrain)
+        return true;
+
+    if (!(mi.MoveFlags & (MOVEMENTFLAG_FALLING | MOVEMENTFLAG_FALLING_FAR | MOVEMENTFLAG_SWIMMING)))
+        z = terrain->GetHeight(x, y, z);
+    return terrain->IsInLineOfSight(mi.PositionX, mi.PositionY, mi.PositionZ + 0.5f, x, y, z + 0.5f);
+}
+
+bool AnticheatMovementChecks::GetMaxAllowedDist(MovementSample const& mi, uint32 state, uint32 diffMs, float &dxy, float &dz, float &speed) const
+{
+    dxy = dz = 0.001f; // Epsilon
+    speed = mi.MoveFlags & (MOVEMENTFLAG_BACKWARD) ? GetClientSpeed(MOVE_RUN_BACK) : GetClientSpeed(MOVE_RUN);
+    if (mi.OnTransport)
+        return false;
+    if (state & MOVER_STATE_SPLINE_ACTIVE)
+        return false;
+    // Dernier paquet pas a jour (connexion, TP autre map ...)
+    if (!mi.ClientMoveTime)
+        return false;
+
+    // No mvt allowed
+    if ((mi.MoveFlags & MOVEMENTFLAG_ROOT) || !(mi.MoveFlags & MOVEMENTFLAG_MASK_MOVING))
+        return true;
+
+    if (mi.MoveFlags & MOVEMENTFLAG_MASK_MOVING_FLY)
+        speed = mi.MoveFlags & (MOVEMENTFLAG_BACKWARD) ? GetClientSpeed(MOVE_FLIGHT_BACK) : GetClientSpeed(MOVE_FLIGHT);
+    else if (mi.MoveFlags & MOVEMENTFLAG_SWIMMING)
+        speed = mi.MoveFlags & (MOVEMENTFLAG_BACKWARD) ? GetClientSpeed(MOVE_SWIM_BACK) : GetClientSpeed(MOVE_SWIM);
+    else if (mi.MoveFlags & MOVEMENTFLAG_WALKING)
+        speed = GetClientSpeed(MOVE_WALK);
+    else if (mi.MoveFlags & MOVEMENTFLAG_MASK_MOVING)
+        speed = mi.MoveFlags & (MOVEMENTFLAG_BACKWARD) ? GetClientSpeed(MOVE_RUN_BACK) : GetClientSpeed(MOVE_RUN);
+    else if (mi.MoveFlags & (MOVEMENTFLAG_PITCH_UP | MOVEMENTFLAG_PITCH_DOWN))
+        speed = GetClientSpeed(MOVE_PITCH_RATE);
+
+    if (mi.MoveFlags & (MOVEMENTFLAG_FALLING | MOVEMENTFLAG_FALLING_FAR))
+    {
+        dxy = mi.FallHorizontalSpeed / 1000 * diffMs;
+        static const float terminalVelocity = 60.148003f;
+        static const float terminalSavefallVelocity = 7.f;
+        dz = (mi.MoveFlags & MOVEMENTFLAG_FEATHER_FALL) ? terminalSavefallVelocity : terminalVelocity;
+        dz = dz / 1000 * diffMs;
+        return true;
+    }
+    // TODO: Maximum dyx/dz (max climb angle) if not swimming.
+    dxy = speed / 1000 * diffMs;
+    dz = speed / 1000 * diffMs;
+    return true;
+}
@@ -0,0 +1,180 @@
+#ifndef _ANTICHEAT_MOVEMENT_CHECKS_H
+#define _ANTICHEAT_MOVEMENT_CHECKS_H
+
+#include "Define.h"
+#include "UnitDefines.h"
+#include "MovementCapture.h"
+#include <vector>
+
+// Player independent part of the movement anticheat.
+// Everything it needs from the mover is passed in as a MovementSample pair and a state mask,
+// so the same checks run in worldserver and on recorded captures (see tools/anticheat_replay).
+
+enum CheatType
+{
+    CHEAT_TYPE_WALL_CLIMB           = 0,
+    CHEAT_TYPE_WATER_WALK           = 1,
+    CHEAT_TYPE_FORBIDDEN            = 2,
+    CHEAT_TYPE_BG_NOT_STARTED       = 3,
+    CHEAT_TYPE_MULTIJUMP            = 4,
+    CHEAT_TYPE_FALL_UP              = 5,
+    CHEAT_TYPE_UNREACHABLE          = 6,
+    CHEAT_TYPE_TIME_BACK            = 7,
+    CHEAT_TYPE_OVERSPEED_JUMP       = 8,
+    CHEAT_TYPE_JUMP_SPEED_CHANGE    = 9,
+    CHEAT_TYPE_FLY_HACK_SWIM        = 10,
+    CHEAT_TYPE_NULL_CLIENT_TIME     = 11,
+    CHEAT_TYPE_ROOT_MOVE            = 12,
+    CHEAT_TYPE_ROOT_IGNORED         = 13,
+    CHEAT_TYPE_TELEPORT_HACK        = 14,
+    CHEAT_TYPE_DESYNC_TIME          = 15,
+    CHEAT_TYPE_MOVE_STOP            = 16,
+    CHEAT_TYPE_EXPLORE              = 17,
+    CHEAT_TYPE_EXPLORE_HIGH_LEVEL   = 18,
+    CHEAT_TYPE_OVERSPEED_Z          = 19,
+    CHEAT_TYPE_SKIPPED_HEARTBEATS   = 20,
+    CHEAT_TYPE_NUM_DESYNC           = 21,
+    CHEAT_TYPE_FAKE_TRANSPORT       = 22,
+    CHEAT_TYPE_TELE_TO_TRANSPORT    = 23,
+    CHEAT_TYPE_SLOW_FALL            = 24,
+    CHEAT_TYPE_HOVER                = 25,
+    CHEAT_TYPE_SPEED_HACK_ALERTS    = 26,
+    CHEAT_TYPE_NO_FALLTIME          = 27,
+    CHEAT_TYPE_FLY_HACK             = 28,
+    CHEAT_TYPE_SUPERJUMP            = 29,
+    CHEAT_TYPE_DISABLE_GRAVITY      = 30,
+    CHEATS_COUNT
+};
+
+const char* GetCheatTypeNameFromFlag(CheatType type);
+
+/// Mover state the checks consult, sampled from the Player for every movement packet.
+enum AnticheatMoverState
+{
+    MOVER_STATE_SPLINE_ACTIVE           = 0x0001,   // server controlled movement (charge, fear, ...)
+    MOVER_STATE_LAUNCHED_OR_FALLING     = 0x0002,
+    MOVER_STATE_IN_FLIGHT               = 0x0004,   // taxi
+    MOVER_STATE_ON_TRANSPORT            = 0x0008,   // boarded server side
+    MOVER_STATE_DOUBLE_JUMP             = 0x0010,
+    MOVER_STATE_FLY_AURA                = 0x0020,
+    MOVER_STATE_DISABLE_GRAVITY_AURA    = 0x0040,
+    MOVER_STATE_WATER_WALK_AURA         = 0x0080,   // water walk or ghost
+    MOVER_STATE_FEATHER_FALL_AURA       = 0x0100,
+    MOVER_STATE_HOVER_AURA              = 0x0200,
+    MOVER_STATE_BG_WAIT_JOIN            = 0x0400,
+    MOVER_STATE_TEAM_ALLIANCE           = 0x0800,
+    MOVER_STATE_TEAM_HORDE              = 0x1000,
+    MOVER_STATE_GAMEMASTER              = 0x2000,   // detections are not stored
+};
+
+/// Groups of checks that can be switched on separately, a replay times each group on its own.
+enum AnticheatDetector
+{
+    ANTICHEAT_DETECTOR_JUMP             = 0,    // OverspeedJump, JumpSpeedChange, MultiJump, SuperJump
+    ANTICHEAT_DETECTOR_TIME             = 1,    // NullClientTime, NumDesyncs, ReverseTime
+    ANTICHEAT_DETECTOR_ROOT             = 2,    // MovementRooted
+    ANTICHEAT_DETECTOR_BATTLEGROUND     = 3,    // AccessForbidden, BgNotStarted
+    ANTICHEAT_DETECTOR_MOVE_FLAGS       = 4,    // FlyHack, FlyHackSwim, WaterWalk, SlowFall, Hover, DisableGravity
+    ANTICHEAT_DETECTOR_TRANSPORT        = 5,    // TeleToTransport
+    ANTICHEAT_DETECTOR_SPEED            = 6,    // SpeedHackAlerts, OverspeedZ, far teleports
+    ANTICHEAT_DETECTOR_COUNT
+};
+
+#define ANTICHEAT_DETECTORS_ALL ((1 << ANTICHEAT_DETECTOR_COUNT) - 1)
+
+const char* GetAnticheatDetectorName(AnticheatDetector detector);
+
+struct AnticheatCheckConfig
+{
+    bool AntiMultiJump = false;
+    bool AntiSpeedHack = false;
+    bool Interpolation = false;
+    int32 MaxAllowedDesync = 0;
+    bool DetailsLog = false;
+    uint32 Detectors = ANTICHEAT_DETECTORS_ALL;
+};
+
+/// Terrain queries of the movement interpolation.
+class AnticheatTerrain
+{
+    public:
+        virtual ~AnticheatTerrain() { }
+
+        virtual float GetHeight(float x, float y, float z) const = 0;
+        virtual bool IsInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2) const = 0;
+};
+
+struct AnticheatMovementContext
+{
+    uint32 Opcode = 0;
+    uint32 MapId = 0;
+    uint32 State = 0;                           // AnticheatMoverState
+    MovementSample const* Last = nullptr;
+    MovementSample const* Current = nullptr;
+    AnticheatTerrain const* Terrain = nullptr;  // optional, interpolation skips ground and LOS checks without it
+
+    // detail logs only
+    char const* MoverName = "";
+    uint32 Security = 0;
+    char const* OpcodeName = "";
+};
+
+struct AnticheatMovementResult
+{
+    uint32 Cheats = 0;              // stored once the packet is accepted
+    uint32 FlagCheats = 0;          // movement flag cheats, stored one by one
+    float RealDistance2DSq = 0.0f;
+    bool Accepted = true;           // false: server controls the movement, drop the packet
+    bool SpeedHack = false;         // caller decides if this is a far teleport
+};
+
+class ServerOrderData
+{
+    public:
+        ServerOrderData(uint32 serv, uint32 resp) : serverOpcode1(serv), serverOpcode2(0), clientResp(resp), lastSent(0), lastRcvd(0), counter(0) {}
+        ServerOrderData(uint32 serv1, uint32 serv2, uint32 resp) : serverOpcode1(serv1), serverOpcode2(serv2), clientResp(resp), lastSent(0), lastRcvd(0), counter(0) {}
+
+        uint32 serverOpcode1;
+        uint32 serverOpcode2;
+        uint32 clientResp;
+
+        uint32 lastSent;
+        uint32 lastRcvd;
+        int32 counter;
+};
+
+class AnticheatMovementChecks
+{
+    public:
+        AnticheatMovementChecks();
+
+        void Init();
+
+        /// Runs the enabled detectors on one client movement packet.
+        void Check(AnticheatMovementContext const& context, AnticheatCheckConfig const& config, AnticheatMovementResult& result);
+
+        void OrderSent(uint32 opcode, uint32 now);
+        void CheckForOrderAck(uint32 opcode);
+        void OnKnockBack(float speedZ);
+        bool HasPendingOrder(uint32 clientResp) const;
+
+        float GetClientSpeed(UnitMoveType m) const { return _clientSpeeds[m]; }
+
+        bool InterpolateMovement(MovementSample const& mi, uint32 state, AnticheatTerrain const* terrain, uint32 diffMs, float &x, float &y, float &z, float &o, float &speed) const;
+        bool GetMaxAllowedDist(MovementSample const& mi, uint32 state, uint32 diffMs, float &dxy, float &dz, float &speed) const;
+
+        uint32 _jumpCount;
+        int32 _clientDesynchro;
+        float _jumpInitialSpeed;
+        float _jumpInitialVelocity;
+        float _overspeedDistance;
+        bool _inKnockBack;
+        float  _clientSpeeds[MAX_MOVE_TYPE];
+        std::vector<ServerOrderData> _orders; // Packets sent by server, triggering *_ACK from client
+
+    private:
+        uint32 CheckMoveFlags(AnticheatMovementContext const& context, AnticheatCheckConfig const& config) const;
+        void CheckSpeed(AnticheatMovementContext const& context, AnticheatCheckConfig const& config, AnticheatMovementResult& result);
+};
+
+#endif
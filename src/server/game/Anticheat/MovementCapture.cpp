@@ -0,0 +1,161 @@
+#include "MovementCapture.h"
+#include <cstring>
+#include <ctime>
+
+MovementCaptureWriter::MovementCaptureWriter() : _file(nullptr), _lastWritten(), _hasLastWritten(false)
+{
+}
+
+MovementCaptureWriter::~MovementCaptureWriter()
+{
+    Close();
+}
+
+bool MovementCaptureWriter::Open(std::string const& fileName, uint64 guid)
+{
+    Close();
+
+    _file = fopen(fileName.c_str(), "wb");
+    if (!_file)
+        return false;
+
+    Write(uint32(MOVEMENT_CAPTURE_MAGIC));
+    Write(uint32(MOVEMENT_CAPTURE_VERSION));
+    Write(guid);
+    Write(uint32(time(nullptr)));
+    _hasLastWritten = false;
+    return true;
+}
+
+void MovementCaptureWriter::Close()
+{
+    if (!_file)
+        return;
+
+    fclose(_file);
+    _file = nullptr;
+}
+
+void MovementCaptureWriter::WriteRecordHeader(uint8 type, uint32 serverTime)
+{
+    Write(type);
+    Write(serverTime);
+}
+
+void MovementCaptureWriter::WriteMovement(uint32 serverTime, uint32 opcode, uint32 mapId, uint32 state, MovementSample const& last, MovementSample const& current)
+{
+    if (!_file)
+        return;
+
+    if (!_hasLastWritten || memcmp(&last, &_lastWritten, sizeof(MovementSample)) != 0)
+    {
+        WriteRecordHeader(CAPTURE_RECORD_LAST_MOVEMENT, serverTime);
+        Write(last);
+    }
+
+    WriteRecordHeader(CAPTURE_RECORD_MOVEMENT, serverTime);
+    Write(opcode);
+    Write(mapId);
+    Write(state);
+    Write(current);
+
+    _lastWritten = current;
+    _hasLastWritten = true;
+}
+
+void MovementCaptureWriter::WriteOrderSent(uint32 serverTime, uint32 opcode)
+{
+    if (!_file)
+        return;
+
+    WriteRecordHeader(CAPTURE_RECORD_ORDER_SENT, serverTime);
+    Write(opcode);
+}
+
+void MovementCaptureWriter::WriteSpeedAck(uint32 serverTime, uint8 moveType, float speed)
+{
+    if (!_file)
+        return;
+
+    WriteRecordHeader(CAPTURE_RECORD_SPEED_ACK, serverTime);
+    Write(moveType);
+    Write(speed);
+}
+
+void MovementCaptureWriter::WriteSpeeds(uint32 serverTime, float const* speeds)
+{
+    if (!_file)
+        return;
+
+    WriteRecordHeader(CAPTURE_RECORD_SPEEDS, serverTime);
+    fwrite(speeds, sizeof(float), MOVEMENT_CAPTURE_SPEEDS, _file);
+}
+
+void MovementCaptureWriter::WriteKnockBack(uint32 serverTime, float speedZ)
+{
+    if (!_file)
+        return;
+
+    WriteRecordHeader(CAPTURE_RECORD_KNOCK_BACK, serverTime);
+    Write(speedZ);
+}
+
+bool MovementCaptureReader::Load(std::string const& fileName)
+{
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (!file)
+        return false;
+
+    auto read = [file](void* dest, size_t size) { return fread(dest, size, 1, file) == 1; };
+
+    uint32 magic = 0;
+    uint32 version = 0;
+    if (!read(&magic, sizeof(magic)) || magic != MOVEMENT_CAPTURE_MAGIC || !read(&version, sizeof(version)) || version != MOVEMENT_CAPTURE_VERSION
+        || !read(&_guid, sizeof(_guid)) || !read(&_startTime, sizeof(_startTime)))
+    {
+        fclose(file);
+        return false;
+    }
+
+    _records.clear();
+
+    // a capture of a crashed or still running server may end with a truncated record, keep everything before it
+    MovementCaptureRecord record;
+    while (read(&record.Type, sizeof(record.Type)) && read(&record.ServerTime, sizeof(record.ServerTime)))
+    {
+        bool valid = true;
+        switch (record.Type)
+        {
+            case CAPTURE_RECORD_MOVEMENT:
+                valid = read(&record.Opcode, sizeof(record.Opcode)) && read(&record.MapId, sizeof(record.MapId)) && read(&record.State, sizeof(record.State))
+                    && read(&record.Sample, sizeof(record.Sample));
+                break;
+            case CAPTURE_RECORD_LAST_MOVEMENT:
+                valid = read(&record.Sample, sizeof(record.Sample));
+                break;
+            case CAPTURE_RECORD_ORDER_SENT:
+                valid = read(&record.Opcode, sizeof(record.Opcode));
+                break;
+            case CAPTURE_RECORD_SPEED_ACK:
+                valid = read(&record.MoveType, sizeof(record.MoveType)) && read(&record.Speed, sizeof(record.Speed)) && record.MoveType < MOVEMENT_CAPTURE_SPEEDS;
+                break;
+            case CAPTURE_RECORD_SPEEDS:
+                valid = read(record.Speeds, sizeof(record.Speeds));
+                break;
+            case CAPTURE_RECORD_KNOCK_BACK:
+                valid = read(&record.Speed, sizeof(record.Speed));
+                break;
+            default:
+                valid = false;
+                break;
+        }
+
+        if (!valid)
+            break;
+
+        _records.push_back(record);
+    }
+
+    fclose(file);
+    return true;
+}
@@ -0,0 +1,107 @@
+#ifndef _MOVEMENT_CAPTURE_H
+#define _MOVEMENT_CAPTURE_H
+
+#include "Define.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#define MOVEMENT_CAPTURE_MAGIC      0x5043564D  // "MVCP"
+#define MOVEMENT_CAPTURE_VERSION    1
+#define MOVEMENT_CAPTURE_SPEEDS     9           // MAX_MOVE_TYPE
+
+/// The part of MovementInfo the movement anticheat looks at.
+/// Written as is into capture files, so it must stay trivially copyable and free of padding.
+struct MovementSample
+{
+    float PositionX;
+    float PositionY;
+    float PositionZ;
+    float Orientation;
+    float Pitch;
+    uint32 MoveFlags;
+    uint32 ClientMoveTime;
+    uint32 MoveTime;                    // server time the packet was received
+    float FallStartX;
+    float FallStartY;
+    float FallStartZ;
+    float FallDirectionX;
+    float FallDirectionY;
+    float FallHorizontalSpeed;
+    float FallJumpVelocity;
+    uint32 FallStartClientTime;
+    uint8 OnTransport;
+    uint8 Padding[3];
+};
+
+static_assert(sizeof(MovementSample) == 68, "MovementSample is part of the capture file format");
+
+enum MovementCaptureRecordType : uint8
+{
+    CAPTURE_RECORD_MOVEMENT         = 1,    // opcode, map, mover state, sample
+    CAPTURE_RECORD_LAST_MOVEMENT    = 2,    // sample - last known movement changed server side (teleport, knockback, rejected packet)
+    CAPTURE_RECORD_ORDER_SENT       = 3,    // opcode of a server order expecting an ack
+    CAPTURE_RECORD_SPEED_ACK        = 4,    // move type, new client speed
+    CAPTURE_RECORD_SPEEDS           = 5,    // all client speeds
+    CAPTURE_RECORD_KNOCK_BACK       = 6,    // vertical speed
+};
+
+/// One decoded capture record, only the fields of its type are meaningful.
+struct MovementCaptureRecord
+{
+    uint8 Type;
+    uint32 ServerTime;
+    uint32 Opcode;
+    uint32 MapId;
+    uint32 State;
+    uint8 MoveType;
+    float Speed;
+    float Speeds[MOVEMENT_CAPTURE_SPEEDS];
+    MovementSample Sample;
+};
+
+/// Streams the movement packets of one session into a capture file.
+/// File layout: magic, version, mover guid, start time, then tagged records (type, server time, payload).
+class MovementCaptureWriter
+{
+    public:
+        MovementCaptureWriter();
+        ~MovementCaptureWriter();
+
+        bool Open(std::string const& fileName, uint64 guid);
+        void Close();
+        bool IsOpen() const { return _file != nullptr; }
+
+        /// last is only written when it differs from the previously written current sample.
+        void WriteMovement(uint32 serverTime, uint32 opcode, uint32 mapId, uint32 state, MovementSample const& last, MovementSample const& current);
+        void WriteOrderSent(uint32 serverTime, uint32 opcode);
+        void WriteSpeedAck(uint32 serverTime, uint8 moveType, float speed);
+        void WriteSpeeds(uint32 serverTime, float const* speeds);
+        void WriteKnockBack(uint32 serverTime, float speedZ);
+
+    private:
+        void WriteRecordHeader(uint8 type, uint32 serverTime);
+        template<typename T> void Write(T const& value) { fwrite(&value, sizeof(T), 1, _file); }
+
+        FILE* _file;
+        MovementSample _lastWritten;
+        bool _hasLastWritten;
+};
+
+/// Reads a whole capture file back, see MovementCaptureWriter.
+class MovementCaptureReader
+{
+    public:
+        bool Load(std::string const& fileName);
+
+        uint64 GetGuid() const { return _guid; }
+        uint32 GetStartTime() const { return _startTime; }
+        std::vector<MovementCaptureRecord> const& GetRecords() const { return _records; }
+
+    private:
+        uint64 _guid = 0;
+        uint32 _startTime = 0;
+        std::vector<MovementCaptureRecord> _records;
+};
+
+#endif
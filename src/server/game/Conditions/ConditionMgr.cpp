@@ -34,6 +34,22 @@
 #include "QuestData.h"
 #include "GlobalFunctional.h"
 #include "GossipData.h"
+#include <chrono>
+#include <tuple>
+
+namespace
+{
+    // longest chain of references copied into a program, deeper chains are interpreted
+    uint32 const MaxConditionReferenceDepth = 8;
+
+    template<class Store>
+    void CollectTypeContainers(Store const& store, std::vector<ConditionList>& lists)
+    {
+        for (auto const& typeContainer : store)
+            for (auto const& conditions : typeContainer.second)
+                lists.push_back(conditions.second);
+    }
+}
 
 ConditionSourceInfo::ConditionSourceInfo(WorldObject* target0, WorldObject* target1, WorldObject* target2)
 {
@@ -59,6 +75,7 @@ Condition::Condition()
     ScriptId = 0;
     SourceId = 0;
     NegativeCondition = false;
+    Program = nullptr;
 }
 
 // Checks if object meets the condition
@@ -1086,6 +1103,42 @@ uint32 ConditionMgr::GetSearcherTypeMaskForConditionList(ConditionList const& co
 }
 
 bool ConditionMgr::IsObjectMeetToConditionList(ConditionSourceInfo& sourceInfo, ConditionList const& conditions)
+{
+    if (ConditionProgram const* program = conditions.front()->Program)
+        if (program->Size == conditions.size())
+            return RunConditionProgram(sourceInfo, program->Begin, program->End);
+
+    return InterpretConditionList(sourceInfo, conditions);
+}
+
+bool ConditionMgr::RunConditionProgram(ConditionSourceInfo& sourceInfo, uint32 begin, uint32 end) const
+{
+    ConditionProgramOp const* ops = ProgramOpStore.data();
+    for (uint32 group = begin; group < end; group = ops[group].End)
+    {
+        bool meets = true;
+        for (uint32 i = group + 1; meets && i < ops[group].End;)
+        {
+            if (ops[i].Type == CONDITION_PROGRAM_TEST)
+            {
+                meets = ops[i].Cond->Meets(sourceInfo);
+                ++i;
+            }
+            else
+            {
+                meets = RunConditionProgram(sourceInfo, i + 1, ops[i].End);
+                i = ops[i].End;
+            }
+        }
+
+        if (meets)
+            return true;
+    }
+
+    return false;
+}
+
+bool ConditionMgr::InterpretConditionList(ConditionSourceInfo& sourceInfo, ConditionList const& conditions)
 {
     //     groupId, groupCheckPassed
     std::map<uint32, bool> ElseGroupStore;
@@ -1107,7 +1160,7 @@ bool ConditionMgr::IsObjectMeetToConditionList(ConditionSourceInfo& sourceInfo,
                 ConditionReferenceContainer::const_iterator ref = ConditionReferenceStore.find((*i)->ReferenceId);
                 if (ref != ConditionReferenceStore.end())
                 {
-                    if (!IsObjectMeetToConditionList(sourceInfo, (*ref).second))
+                    if (!InterpretConditionList(sourceInfo, (*ref).second))
                         ElseGroupStore[(*i)->ElseGroup] = false;
                 }
                 else
@@ -1604,10 +1657,177 @@ void ConditionMgr::LoadConditions(bool isReload)
     }
     while (result->NextRow());
 
+    CompileConditions();
+
     TC_LOG_INFO(LOG_FILTER_SERVER_LOADING, ">> Loaded %u conditions in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
 
 }
 
+void ConditionMgr::CollectConditionLists(std::vector<ConditionList>& lists) const
+{
+    CollectTypeContainers(ConditionStore, lists);
+    CollectTypeContainers(VehicleSpellConditionStore, lists);
+    CollectTypeContainers(SpellClickEventConditionStore, lists);
+    CollectTypeContainers(NpcVendorConditionContainerStore, lists);
+    CollectTypeContainers(SmartEventConditionStore, lists);
+    CollectTypeContainers(PhaseDefinitionsConditionStore, lists);
+    CollectTypeContainers(AreaTriggerConditionStore, lists);
+    CollectTypeContainers(ItemLootConditionStore, lists);
+
+    // loot, gossip and spell target conditions live in their owners, every source group and entry is one list there
+    std::map<std::tuple<uint32, uint32, int32>, ConditionList> ownedLists;
+    for (Condition* cond : AllocatedMemoryStore)
+        ownedLists[std::make_tuple(uint32(cond->SourceType), cond->SourceGroup, cond->SourceEntry)].push_back(cond);
+
+    for (auto const& conditions : ownedLists)
+        lists.push_back(conditions.second);
+}
+
+void ConditionMgr::CompileConditions()
+{
+    uint32 oldMSTime = getMSTime();
+
+    ProgramOpStore.clear();
+    ProgramStore.clear();
+
+    std::vector<ConditionList> lists;
+    CollectConditionLists(lists);
+
+    // conditions point into ProgramStore, it must not grow past this
+    ProgramStore.reserve(lists.size());
+
+    for (ConditionList const& conditions : lists)
+    {
+        ConditionProgram program;
+        program.Begin = ProgramOpStore.size();
+        if (!CompileConditionList(conditions, ProgramOpStore, 0))
+        {
+            ProgramOpStore.resize(program.Begin);
+            continue;
+        }
+
+        program.End = ProgramOpStore.size();
+        program.Size = conditions.size();
+        ProgramStore.push_back(program);
+
+        for (Condition* cond : conditions)
+            cond->Program = &ProgramStore.back();
+    }
+
+    ProgramOpStore.shrink_to_fit();
+
+    TC_LOG_INFO(LOG_FILTER_SERVER_LOADING, ">> Compiled %u of %u condition lists into %u ops in %u ms", uint32(ProgramStore.size()), uint32(lists.size()),
+        uint32(ProgramOpStore.size()), GetMSTimeDiffToNow(oldMSTime));
+}
+
+bool ConditionMgr::CompileConditionList(ConditionList const& conditions, std::vector<ConditionProgramOp>& ops, uint32 depth) const
+{
+    if (depth > MaxConditionReferenceDepth)
+    {
+        TC_LOG_ERROR(LOG_FILTER_SQL, "Condition references of %u type %u entry %u are nested deeper than %u, list is not compiled",
+            conditions.front()->SourceGroup, uint32(conditions.front()->SourceType), conditions.front()->SourceEntry, MaxConditionReferenceDepth);
+        return false;
+    }
+
+    // groups in the order the interpreter checks them, conditions in load order
+    std::map<uint32, std::vector<Condition*>> elseGroups;
+    for (Condition* cond : conditions)
+        if (cond->isLoaded())
+            elseGroups[cond->ElseGroup].push_back(cond);
+
+    for (auto const& elseGroup : elseGroups)
+    {
+        uint32 groupIndex = ops.size();
+        ops.push_back({ CONDITION_PROGRAM_GROUP, 0, nullptr });
+
+        for (Condition* cond : elseGroup.second)
+        {
+            if (!cond->ReferenceId)
+            {
+                ops.push_back({ CONDITION_PROGRAM_TEST, 0, cond });
+                continue;
+            }
+
+            // a missing reference does not fail the group, same as in InterpretConditionList
+            ConditionReferenceContainer::const_iterator ref = ConditionReferenceStore.find(cond->ReferenceId);
+            if (ref == ConditionReferenceStore.end())
+                continue;
+
+            std::vector<ConditionProgramOp> reference;
+            if (!CompileConditionList(ref->second, reference, depth + 1))
+                return false;
+
+            // a reference with a single else group is just more tests of this group
+            uint32 base = ops.size();
+            if (!reference.empty() && reference.front().End == reference.size())
+            {
+                for (std::size_t i = 1; i < reference.size(); ++i)
+                {
+                    ConditionProgramOp op = reference[i];
+                    if (op.Type != CONDITION_PROGRAM_TEST)
+                        op.End += base - 1;
+                    ops.push_back(op);
+                }
+                continue;
+            }
+
+            ops.push_back({ CONDITION_PROGRAM_BLOCK, uint32(base + 1 + reference.size()), nullptr });
+            for (ConditionProgramOp op : reference)
+            {
+                if (op.Type != CONDITION_PROGRAM_TEST)
+                    op.End += base + 1;
+                ops.push_back(op);
+            }
+        }
+
+        ops[groupIndex].End = ops.size();
+    }
+
+    return true;
+}
+
+ConditionMgr::BenchmarkResult ConditionMgr::BenchmarkConditions(WorldObject* target, uint32 iterations)
+{
+    std::vector<ConditionList> lists;
+    CollectConditionLists(lists);
+
+    BenchmarkResult result;
+    result.Lists = lists.size();
+    result.CompiledLists = ProgramStore.size();
+    result.Ops = ProgramOpStore.size();
+    result.Met = 0;
+    result.Mismatches = 0;
+
+    // the target stands in for every condition target, so conditions on a second object are checked too
+    ConditionSourceInfo sourceInfo(target, target, target);
+
+    for (ConditionList const& conditions : lists)
+    {
+        bool met = IsObjectMeetToConditionList(sourceInfo, conditions);
+        if (met)
+            ++result.Met;
+        if (met != InterpretConditionList(sourceInfo, conditions))
+            ++result.Mismatches;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32 i = 0; i < iterations; ++i)
+        for (ConditionList const& conditions : lists)
+            InterpretConditionList(sourceInfo, conditions);
+
+    auto middle = std::chrono::steady_clock::now();
+    for (uint32 i = 0; i < iterations; ++i)
+        for (ConditionList const& conditions : lists)
+            IsObjectMeetToConditionList(sourceInfo, conditions);
+
+    auto end = std::chrono::steady_clock::now();
+
+    result.InterpretedMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(middle - start).count();
+    result.CompiledMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count();
+
+    return result;
+}
+
 bool ConditionMgr::addToLootTemplate(Condition* cond, LootTemplate* loot)
 {
     if (!loot)
@@ -2984,6 +3204,9 @@ void ConditionMgr::Clean()
         delete *itr;
 
     AllocatedMemoryStore.clear();
+
+    ProgramOpStore.clear();
+    ProgramStore.clear();
 }
 
 inline bool PlayerConditionCompare(int32 comparisonType, int32 value1, int32 value2)
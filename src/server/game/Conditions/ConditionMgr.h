@@ -21,6 +21,9 @@
 
 #include "LootMgr.h"
 #include "Errors.h"
+#include "Hash.h"
+#include <unordered_map>
+#include <vector>
 
 struct PlayerConditionEntry;
 class Player;
@@ -28,6 +31,7 @@ class Unit;
 class WorldObject;
 class LootTemplate;
 struct Condition;
+struct ConditionProgram;
 
 enum ConditionTypes
 {                                                           // value1           value2         value3
@@ -237,6 +241,7 @@ struct Condition
     uint32                  ScriptId;
     uint8                   ConditionTarget;
     bool                    NegativeCondition;
+    ConditionProgram const* Program;           // compiled form of the list this condition was loaded into
 
     Condition();
 
@@ -247,16 +252,42 @@ struct Condition
 };
 
 typedef std::list<Condition*> ConditionList;
-typedef std::map<uint32, ConditionList> ConditionTypeContainer;
-typedef std::map<ConditionSourceType, ConditionTypeContainer> ConditionContainer;
-typedef std::map<uint32, ConditionTypeContainer> CreatureSpellConditionContainer;
-typedef std::map<uint32, ConditionTypeContainer> NpcVendorConditionContainer;
-typedef std::map<std::pair<int32, uint32 /*SAI source_type*/>, ConditionTypeContainer> SmartEventConditionContainer;
-typedef std::map<int32 /*zoneId*/, ConditionTypeContainer> PhaseDefinitionConditionContainer;
-typedef std::map<uint32 /*areatrigger id*/, ConditionTypeContainer> AreaTriggerConditionContainer;
-typedef std::map<uint32 /*itemId*/, ConditionTypeContainer> ItemLootConditionContainer;
+typedef std::unordered_map<uint32, ConditionList> ConditionTypeContainer;
+typedef std::unordered_map<uint32 /*ConditionSourceType*/, ConditionTypeContainer> ConditionContainer;
+typedef std::unordered_map<uint32, ConditionTypeContainer> CreatureSpellConditionContainer;
+typedef std::unordered_map<uint32, ConditionTypeContainer> NpcVendorConditionContainer;
+typedef std::unordered_map<std::pair<int32, uint32 /*SAI source_type*/>, ConditionTypeContainer> SmartEventConditionContainer;
+typedef std::unordered_map<int32 /*zoneId*/, ConditionTypeContainer> PhaseDefinitionConditionContainer;
+typedef std::unordered_map<uint32 /*areatrigger id*/, ConditionTypeContainer> AreaTriggerConditionContainer;
+typedef std::unordered_map<uint32 /*itemId*/, ConditionTypeContainer> ItemLootConditionContainer;
+
+typedef std::unordered_map<uint32, ConditionList> ConditionReferenceContainer;//only used for references
+
+enum ConditionProgramOpType : uint8
+{
+    CONDITION_PROGRAM_GROUP,    // else group, End is the index of the next group
+    CONDITION_PROGRAM_TEST,     // single condition
+    CONDITION_PROGRAM_BLOCK     // reference with several else groups, its groups follow up to End
+};
 
-typedef std::map<uint32, ConditionList> ConditionReferenceContainer;//only used for references
+struct ConditionProgramOp
+{
+    ConditionProgramOpType Type;
+    uint32 End;
+    Condition* Cond;
+};
+
+/*
+ * A condition list flattened at load (ConditionMgr::CompileConditions). The else groups are
+ * stored one after another, a group passes when all of its tests pass and the list passes with
+ * the first passing group. References are copied into the groups using them.
+ */
+struct ConditionProgram
+{
+    uint32 Begin;
+    uint32 End;
+    uint32 Size;    // conditions of the source list, lists not matching it are interpreted
+};
 
 class ConditionMgr
 {
@@ -290,6 +321,20 @@ class ConditionMgr
         static bool IsPlayerMeetingCondition(Unit* unit, int32 conditionID, bool send = false);
         static bool IsPlayerMeetingCondition(Unit* unit, PlayerConditionEntry const* condition);
 
+        struct BenchmarkResult
+        {
+            uint32 Lists;
+            uint32 CompiledLists;
+            uint32 Ops;
+            uint32 Met;
+            uint32 Mismatches;      // lists the compiled program and the interpreter disagree on
+            uint64 InterpretedMicroseconds;
+            uint64 CompiledMicroseconds;
+        };
+
+        /// evaluates every loaded condition list against the target, interpreted and compiled
+        BenchmarkResult BenchmarkConditions(WorldObject* target, uint32 iterations);
+
     private:
         bool isSourceTypeValid(Condition* cond);
         bool addToLootTemplate(Condition* cond, LootTemplate* loot);
@@ -297,6 +342,12 @@ class ConditionMgr
         bool addToGossipMenuItems(Condition* cond);
         bool addToSpellImplicitTargetConditions(Condition* cond);
         bool IsObjectMeetToConditionList(ConditionSourceInfo& sourceInfo, ConditionList const& conditions);
+        bool InterpretConditionList(ConditionSourceInfo& sourceInfo, ConditionList const& conditions);
+
+        void CollectConditionLists(std::vector<ConditionList>& lists) const;
+        void CompileConditions();
+        bool CompileConditionList(ConditionList const& conditions, std::vector<ConditionProgramOp>& ops, uint32 depth) const;
+        bool RunConditionProgram(ConditionSourceInfo& sourceInfo, uint32 begin, uint32 end) const;
 
         void Clean(); // free up resources
         std::list<Condition*> AllocatedMemoryStore; // some garbage collection :)
@@ -310,6 +361,9 @@ class ConditionMgr
         PhaseDefinitionConditionContainer PhaseDefinitionsConditionStore;
         AreaTriggerConditionContainer     AreaTriggerConditionStore;
         ItemLootConditionContainer        ItemLootConditionStore;
+
+        std::vector<ConditionProgramOp>   ProgramOpStore;
+        std::vector<ConditionProgram>     ProgramStore;
 };
 
 template <class T>
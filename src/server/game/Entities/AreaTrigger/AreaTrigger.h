@@ -20,6 +20,7 @@
 
 #include "GridObject.h"
 #include "MapObject.h"
+#include "MapObjectPool.h"
 #include "Object.h"
 
 class Unit;
@@ -318,6 +319,9 @@ class AreaTrigger : public WorldObject, public GridObject<AreaTrigger>, public M
 
     public:
 
+        static void* operator new(std::size_t size) { return MapObjectPools::Allocate(MAP_OBJECT_POOL_AREATRIGGER, size); }
+        static void operator delete(void* block) { MapObjectPools::Free(block); }
+
         AreaTrigger();
         ~AreaTrigger();
 
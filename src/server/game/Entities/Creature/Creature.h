@@ -23,6 +23,7 @@
 #include "GridObject.h"
 #include "LootMgr.h"
 #include "MapObject.h"
+#include "MapObjectPool.h"
 #include "Unit.h"
 
 class BattlePetInstance;
@@ -564,6 +565,9 @@ class Creature : public Unit, public GridObject<Creature>, public MapObject
 {
     public:
 
+        static void* operator new(std::size_t size) { return MapObjectPools::Allocate(MAP_OBJECT_POOL_CREATURE, size); }
+        static void operator delete(void* block) { MapObjectPools::Free(block); }
+
         explicit Creature(bool isWorldObject = false);
         virtual ~Creature();
 
@@ -22,6 +22,7 @@
 #include "Object.h"
 #include "GridObject.h"
 #include "MapObject.h"
+#include "MapObjectPool.h"
 
 class Unit;
 class Aura;
@@ -37,6 +38,9 @@ enum DynamicObjectType
 class DynamicObject : public WorldObject, public GridObject<DynamicObject>, public MapObject
 {
     public:
+        static void* operator new(std::size_t size) { return MapObjectPools::Allocate(MAP_OBJECT_POOL_DYNAMICOBJECT, size); }
+        static void operator delete(void* block) { MapObjectPools::Free(block); }
+
         DynamicObject(bool isWorldObject);
         ~DynamicObject();
 
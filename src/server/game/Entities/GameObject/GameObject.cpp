@@ -221,6 +221,11 @@ void GameObject::RemoveFromWorld()
     }
 }
 
+void GameObject::BindTimerWheel(SharedTimerWheel* wheel)
+{
+    m_Functions.SetTimerWheel(wheel);
+}
+
 bool GameObject::Create(ObjectGuid::LowType guidlow, uint32 name_id, Map* map, uint32 phaseMask, Position const& pos, G3D::Quat const& rotation, uint32 animprogress, GOState go_state, uint32 artKit, uint32 aid, GameObjectData const* data)
 {
     ASSERT(map);
@@ -2827,7 +2832,12 @@ void GameObject::EnableCollision(bool enable)
     /*if (enable && !GetMap()->ContainsGameObjectModel(*m_model))
         GetMap()->InsertGameObjectModel(*m_model);*/
 
+    if (m_model->isCollisionEnabled() == enable)
+        return;
+
     m_model->enableCollision(enable);
+    if (IsInWorld())
+        GetMap()->OnGameObjectModelChanged();
 }
 
 void GameObject::UpdateModel()
@@ -3073,18 +3083,15 @@ float GameObject::GetInteractionDistance() const
     }
 }
 
-void GameObject::UpdateModelPosition(bool full)
+void GameObject::UpdateModelPosition()
 {
     if (!m_model)
         return;
 
     if (GetMap()->ContainsGameObjectModel(*m_model))
     {
-        if (full)
-            GetMap()->RemoveGameObjectModel(*m_model);
         m_model->UpdatePosition();
-        if (full)
-            GetMap()->InsertGameObjectModel(*m_model);
+        GetMap()->UpdateGameObjectModel(*m_model);
     }
 }
 
@@ -26,6 +26,7 @@
 #include "GridObject.h"
 #include "GameObjectData.h"
 #include "MapObject.h"
+#include "MapObjectPool.h"
 
 class Unit;
 class GameObjectAI;
@@ -100,6 +101,9 @@ class GameObjectModel;
 class GameObject : public WorldObject, public GridObject<GameObject>, public MapObject
 {
     public:
+        static void* operator new(std::size_t size) { return MapObjectPools::Allocate(MAP_OBJECT_POOL_GAMEOBJECT, size); }
+        static void operator delete(void* block) { MapObjectPools::Free(block); }
+
         explicit GameObject();
         ~GameObject();
 
@@ -108,6 +112,7 @@ class GameObject : public WorldObject, public GridObject<GameObject>, public Map
         void AddToWorld() override;
         Battleground* GetBattleground();
         void RemoveFromWorld() override;
+        void BindTimerWheel(SharedTimerWheel* wheel) override;
         void CleanupsBeforeDelete(bool finalCleanup = true) override;
 
         virtual bool Create(ObjectGuid::LowType guidlow, uint32 name_id, Map* map, uint32 phaseMask, Position const& pos, G3D::Quat const& rotation, uint32 animprogress, GOState go_state, uint32 artKit = 0, uint32 aid = 0, GameObjectData const* data = nullptr);
@@ -273,7 +278,7 @@ class GameObject : public WorldObject, public GridObject<GameObject>, public Map
 
         float GetInteractionDistance() const;
 
-        void UpdateModelPosition(bool full = true);
+        void UpdateModelPosition();
 
         void EnableOrDisableGo(bool activate, bool alternative = false);
 
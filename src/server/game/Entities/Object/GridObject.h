@@ -1,6 +1,8 @@
 #ifndef GridObject_h__
 #define GridObject_h__
 
+#include "Dynamic/TypeContainer.h"
+
 template <typename ObjectType>
 class GridObject
 {
@@ -8,7 +10,7 @@ class GridObject
     typedef std::vector<ObjectType*> ObjectTypeStorage;
 
 public:
-    GridObject() : _storage(), _offset(0) { }
+    GridObject() : _storage(), _positions(), _offset(0) { }
 
     virtual ~GridObject() { }
 
@@ -17,14 +19,18 @@ public:
         return _storage != nullptr;
     }
 
-    void AddToGrid(ObjectTypeStorage& storage)
+    void AddToGrid(ObjectTypeStorage& storage, Trinity::ContainerPositions& positions)
     {
         if (IsInGrid())
             return;
 
+        ObjectType* object = static_cast<ObjectType*>(this);
         _storage = &storage;
+        _positions = &positions;
         _offset = _storage->size();
-        _storage->emplace_back(static_cast<ObjectType*>(this));
+        _storage->emplace_back(object);
+        _positions->add(object->GetPositionX(), object->GetPositionY(), object->GetPositionZ(), object->GetObjectSize());
+        object->SetGridPositions(_positions, _offset);
     }
 
     void RemoveFromGrid()
@@ -43,14 +49,19 @@ public:
         {
             std::swap(atOffset, _storage->back());
             static_cast<SelfType*>(atOffset)->_offset = _offset;
+            atOffset->SetGridPositions(_positions, _offset);
         }
 
         _storage->pop_back();
+        _positions->remove(_offset);
+        static_cast<ObjectType*>(this)->SetGridPositions(nullptr, 0);
         _storage = nullptr;
+        _positions = nullptr;
     }
 
 private:
     ObjectTypeStorage* _storage;
+    Trinity::ContainerPositions* _positions;
     std::size_t _offset;
 };
 
@@ -1109,6 +1109,9 @@ void Object::SetFloatValue(uint16 index, float value)
         m_floatValues[index] = value;
         _changesMask[index] = 1;
 
+        if (index == UNIT_FIELD_COMBAT_REACH && IsUnit())
+            ToUnit()->UpdateGridPositions();
+
         AddToObjectUpdateIfNeeded();
     }
 }
@@ -1576,7 +1579,8 @@ void Object::ResetMap()
     m_currMap = nullptr;
 }
 
-WorldObject::WorldObject(bool isWorldObject): LastUsedScriptID(0), m_transport(nullptr), m_name(""), m_isActive(false), m_isWorldObject(isWorldObject), m_zoneScript(nullptr), m_InstanceId(0), m_phaseMask(PHASEMASK_NORMAL), m_ignorePhaseIdCheck(false)
+WorldObject::WorldObject(bool isWorldObject): LastUsedScriptID(0), m_transport(nullptr), m_name(""), m_isActive(false), m_isWorldObject(isWorldObject), m_zoneScript(nullptr), m_InstanceId(0), m_phaseMask(PHASEMASK_NORMAL), m_ignorePhaseIdCheck(false),
+    m_gridPositions(nullptr), m_gridPositionsOffset(0)
 {
     m_serverSideVisibility.SetValue(SERVERSIDE_VISIBILITY_GHOST, GHOST_VISIBILITY_ALIVE | GHOST_VISIBILITY_GHOST);
     m_serverSideVisibilityDetect.SetValue(SERVERSIDE_VISIBILITY_GHOST, GHOST_VISIBILITY_ALIVE);
@@ -1699,6 +1703,7 @@ void WorldObject::Relocate(float x, float y, float z, float orientation)
 
     m_movementInfo.ChangePosition(x, y, z, orientation);
     m_movementInfo.UpdateTime(getMSTime());
+    UpdateGridPositions();
     /*if (Transport* t = GetTransport())
     {
         t->CalculatePassengerOffset(x, y, z);
@@ -1708,6 +1713,12 @@ void WorldObject::Relocate(float x, float y, float z, float orientation)
     }*/
 }
 
+void WorldObject::UpdateGridPositions()
+{
+    if (m_gridPositions)
+        m_gridPositions->set(m_gridPositionsOffset, m_positionX, m_positionY, m_positionZ, GetObjectSize());
+}
+
 void WorldObject::Relocate(float x, float y, float z)
 {
     Relocate(x, y, z, GetOrientation());
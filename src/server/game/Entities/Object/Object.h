@@ -75,6 +75,12 @@ class CreatureAI;
 class ZoneScript;
 class Unit;
 class Transport;
+class SharedTimerWheel;
+
+namespace Trinity
+{
+    struct ContainerPositions;
+}
 
 /// Key for AccessRequirement
 struct AccessRequirementKey
@@ -368,6 +374,9 @@ class Object
         Map* FindMap() const { return m_currMap; }
         //used to check all object's GetMap() calls when object is not in world!
 
+        // hands the event and function processors to the map timer wheel, nullptr gives them back on leaving the map
+        virtual void BindTimerWheel(SharedTimerWheel* /*wheel*/) { }
+
         void SetDelete() { m_delete = true; }
         void SetPreDelete() { m_preDelete = true; }
         void SetObjectUpdated(bool update = false) { m_objectUpdated = update; }
@@ -457,6 +466,10 @@ class WorldObject : public Object, public WorldLocation
 
         void SetOrientation(float orientation);
 
+        // mirror of position and reach kept in the grid container, see GridObject::AddToGrid
+        void SetGridPositions(Trinity::ContainerPositions* positions, std::size_t offset) { m_gridPositions = positions; m_gridPositionsOffset = offset; }
+        void UpdateGridPositions();
+
         virtual void RemoveFromWorld() override;
 
         void GetNearPoint2D(float &x, float &y, float distance, float absAngle, bool allowObjectSize = true) const;
@@ -765,6 +778,8 @@ class WorldObject : public Object, public WorldLocation
         std::set<uint32> m_phaseId;                         // special phase. It's new generation phase, when we should check id.
         std::vector<bool> m_phaseBit;
         bool m_ignorePhaseIdCheck;                          // like gm mode.
+        Trinity::ContainerPositions* m_gridPositions;       // positions of the grid container this object is stored in
+        std::size_t m_gridPositionsOffset;
         std::set<uint32> _terrainSwaps;
         std::set<uint32> _worldMapAreaSwaps;
 
@@ -220,6 +220,7 @@ m_achievementMgr(sf::safe_ptr<AchievementMgr<Player>>(this))
     NeedUpdateVisibility = false;
 
     m_nextSave = sWorld->getIntConfig(CONFIG_INTERVAL_SAVE);
+    m_savedAurasSynced = false;
 
     _resurrectionData = NULL;
 
@@ -2231,6 +2232,10 @@ bool Player::SafeTeleport(uint32 mapid, float x, float y, float z, float orienta
     }
     TC_LOG_DEBUG(LOG_FILTER_MAPS, "Player %s is being teleported to map %u", GetName(), mapid);
 
+    // binds reset by a daily or weekly reset must be gone before the instance to enter is looked up
+    if (mEntry->Instanceable())
+        PurgeExpiredBinds();
+
     if (m_vehicle)
         ExitVehicle();
 
@@ -8745,6 +8750,12 @@ void Player::SendDirectMessage(WorldPacket const* data) const
         m_session->SendPacket(data);
 }
 
+void Player::SendDirectMessage(SharedWorldPacket const& data) const
+{
+    if (!IsDelete() && m_session)
+        m_session->SendPacket(data);
+}
+
 void Player::SendCinematicStart(uint32 CinematicSequenceId)
 {
     WorldPackets::Misc::TriggerCinematic packet;
@@ -11774,6 +11785,8 @@ void Player::SendLoot(ObjectGuid guid, LootType loot_type, bool AoeLoot, uint8 p
     PermissionTypes permission = ALL_PERMISSION;
     ItemQualities groupThreshold = ITEM_QUALITY_POOR;
 
+    ++World::LootOpenCount;
+
     // TC_LOG_DEBUG(LOG_FILTER_LOOT, "Player::SendLoot guid %u, loot_type %u", guid, loot_type);
     if (guid.IsGameObject())
     {
@@ -12039,6 +12052,9 @@ void Player::SendLoot(ObjectGuid guid, LootType loot_type, bool AoeLoot, uint8 p
         lootPesonal = &personalLoot[guid];
         loot = &creature->loot;
 
+        // corpse loot of a solo kill is rolled when first opened
+        loot->FillPendingLoot(this, creature);
+
         if (loot_type == LOOT_PICKPOCKETING)
         {
             if (!creature->lootForPickPocketed)
@@ -21991,6 +22007,7 @@ bool Player::LoadFromDB(ObjectGuid guid, SQLQueryHolder *holder)
     SetUInt16Value(PLAYER_FIELD_YESTERDAY_HONORABLE_KILLS, 1, fields[f_yesterdayKills].GetUInt16());
 
     _LoadBoundInstances(holder->GetPreparedResult(PLAYER_LOGIN_QUERY_LOADBOUNDINSTANCES));
+    PurgeExpiredBinds();
     _LoadBGData(holder->GetPreparedResult(PLAYER_LOGIN_QUERY_LOADBGDATA));
 
     _LoadPetData(holder->GetPreparedResult(PLAYER_LOGIN_QUERY_PETS));
@@ -22256,9 +22273,9 @@ bool Player::LoadFromDB(ObjectGuid guid, SQLQueryHolder *holder)
 
     SetMap(map);
 
-    // randomize first save time in range [CONFIG_INTERVAL_SAVE] around [CONFIG_INTERVAL_SAVE]
+    // place first save in range [CONFIG_INTERVAL_SAVE] around [CONFIG_INTERVAL_SAVE]
     // this must help in case next save after mass player load after server startup
-    m_nextSave = urand(m_nextSave/2, m_nextSave*3/2);
+    m_nextSave = CalculateNextSaveTimer();
 
     SaveRecallPosition();
 
@@ -24440,7 +24457,30 @@ InstancePlayerBind* Player::GetBoundInstance(uint32 mapid, Difficulty difficulty
     if (!mapDiff)
         return nullptr;
 
-    return Trinity::Containers::MapGetValuePtr(m_boundInstances[sObjectMgr->GetboundTypeFromDifficulty(difficulty)], mapid);
+    BoundInstancesMap& binds = m_boundInstances[sObjectMgr->GetboundTypeFromDifficulty(difficulty)];
+    BoundInstancesMap::iterator itr = binds.find(mapid);
+    if (itr == binds.end())
+        return nullptr;
+
+    // reset by a daily or weekly reset, see InstanceSaveManager::_ExpireSave; PurgeExpiredBinds drops the bind
+    if (itr->second.save->IsExpired())
+        return nullptr;
+
+    return &itr->second;
+}
+
+void Player::PurgeExpiredBinds()
+{
+    for (uint8 boundType = 0; boundType < MAX_BOUND; ++boundType)
+    {
+        for (BoundInstancesMap::iterator itr = m_boundInstances[boundType].begin(); itr != m_boundInstances[boundType].end();)
+        {
+            if (itr->second.save->IsExpired())
+                UnbindInstance(itr, itr->second.save->GetDifficultyID(), true);
+            else
+                ++itr;
+        }
+    }
 }
 
 InstanceSave* Player::GetInstanceSave(uint32 mapid)
@@ -24835,10 +24875,26 @@ bool Player::_LoadHomeBind(PreparedQueryResult result)
 /***                   SAVE SYSTEM                     ***/
 /*********************************************************/
 
+uint32 Player::CalculateNextSaveTimer() const
+{
+    uint32 interval = sWorld->getIntConfig(CONFIG_INTERVAL_SAVE);
+    if (!interval)
+        return 0;
+
+    // every character owns a fixed phase inside the save interval, so autosaves stay spread over
+    // the whole interval instead of clustering after mass saves or mass logins
+    uint32 phase = uint32((GetGUIDLow() * UI64LIT(2654435761)) % interval);
+    uint32 timer = interval - (getMSTime() % interval + interval - phase) % interval;
+    if (timer < interval / 2)
+        timer += interval;
+
+    return timer;
+}
+
 void Player::SaveToDB(bool create /*=false*/)
 {
     // delay auto save at any saves (manual, in code, or autosave)
-    m_nextSave = sWorld->getIntConfig(CONFIG_INTERVAL_SAVE);
+    m_nextSave = CalculateNextSaveTimer();
 
     //lets allow only players in world to be saved
     if (IsBeingTeleportedFar())
@@ -25190,7 +25246,17 @@ void Player::SaveToDB(bool create /*=false*/)
     _SaveArmyTrainingInfo(trans);
     _SaveAccountProgress(trans);
 
-    CharacterDatabase.CommitTransaction(trans);
+    uint32 statements = trans->GetSize();
+    ++World::PlayerSaveCount;
+    World::PlayerSaveStatements += statements;
+    TC_LOG_DEBUG(LOG_FILTER_PLAYER, "Player::SaveToDB: player %s (GUID: %u) queued %u character statements", GetName(), GetGUIDLow(), statements);
+
+    std::shared_ptr<std::atomic<bool>> aurasCommitted = m_savedAurasCommitted;
+    CharacterDatabase.CommitTransaction(trans, [aurasCommitted]() -> void
+    {
+        if (aurasCommitted)
+            *aurasCommitted = true;
+    });
 
     // TODO: Move this out
     trans = LoginDatabase.BeginTransaction();
@@ -25504,12 +25570,86 @@ void Player::_SaveActions(SQLTransaction& trans)
 
 void Player::_SaveAuras(SQLTransaction& trans)
 {
-    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_AURA);
-    stmt->setUInt64(0, GetGUIDLow());
-    trans->Append(stmt);
-    stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_AURA_EFFECT);
-    stmt->setUInt64(0, GetGUIDLow());
-    trans->Append(stmt);
+    PreparedStatement* stmt = nullptr;
+
+    // rows of the previous save are only known to be stored once its transaction went through
+    if (m_savedAurasCommitted)
+    {
+        if (*m_savedAurasCommitted)
+            m_savedAuras.swap(m_pendingSavedAuras);
+        else
+            m_savedAurasSynced = false;
+
+        m_pendingSavedAuras.clear();
+        m_savedAurasCommitted.reset();
+    }
+
+    // first save after login (or after a failed save) does not know which slots are stored, so rewrite everything once
+    if (!m_savedAurasSynced)
+    {
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_AURA);
+        stmt->setUInt64(0, GetGUIDLow());
+        trans->Append(stmt);
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_AURA_EFFECT);
+        stmt->setUInt64(0, GetGUIDLow());
+        trans->Append(stmt);
+
+        m_savedAuras.clear();
+        m_savedAurasSynced = true;
+    }
+
+    uint8 index = 0;
+    auto insertAuraEffect = [&](uint8 slot, uint8 effect, int32 baseAmount, int32 amount)
+    {
+        index = 0;
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_AURA_EFFECT);
+        stmt->setUInt64(index++, GetGUIDLow());
+        stmt->setUInt8(index++, slot);
+        stmt->setUInt8(index++, effect);
+        stmt->setInt32(index++, baseAmount);
+        stmt->setInt32(index++, amount);
+        trans->Append(stmt);
+    };
+
+    // effect rows of slotless auras are written separately, see SavedAuras::SlotlessEffects
+    auto insertAura = [&](uint8 slot, SavedAuraState const& state)
+    {
+        if (slot < MAX_AURAS)
+        {
+            uint8 amountIndex = 0;
+            for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
+            {
+                if (!(state.EffectMask & (1 << i)))
+                    continue;
+
+                insertAuraEffect(slot, i, state.Amounts[amountIndex].first, state.Amounts[amountIndex].second);
+                ++amountIndex;
+            }
+        }
+
+        index = 0;
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_AURA);
+        stmt->setUInt64(index++, GetGUIDLow());
+        stmt->setUInt8(index++, slot);
+        stmt->setBinary(index++, state.CasterGuid.GetRawValue());
+        stmt->setBinary(index++, state.CastItemGuid.GetRawValue());
+        stmt->setUInt32(index++, state.SpellId);
+        stmt->setUInt16(index++, state.EffectMask);
+        stmt->setUInt8(index++, state.RecalculateMask);
+        stmt->setUInt8(index++, state.StackAmount);
+        stmt->setInt32(index++, state.MaxDuration);
+        stmt->setInt32(index++, state.Duration);
+        stmt->setUInt8(index, state.Charges);
+        trans->Append(stmt);
+    };
+
+    auto auraRowChanged = [](SavedAuraState const& old, SavedAuraState const& state)
+    {
+        return old.RecalculateMask != state.RecalculateMask || old.StackAmount != state.StackAmount || old.MaxDuration != state.MaxDuration ||
+            old.Duration != state.Duration || old.Charges != state.Charges;
+    };
+
+    SavedAuras currentAuras;
 
     for (AuraMap::const_iterator itr = m_ownedAuras.begin(); itr != m_ownedAuras.end(); ++itr)
     {
@@ -25521,44 +25661,201 @@ void Player::_SaveAuras(SQLTransaction& trans)
         if(!foundAura)
             continue;
 
-        uint8 index = 0;
-        uint32 effMask = 0;
-        uint32 recalculateMask = 0;
+        SavedAuraState state;
+        state.SpellId = aura->GetId();
+        state.CasterGuid = aura->GetCasterGUID();
+        state.CastItemGuid = aura->GetCastItemGUID();
+        state.StackAmount = aura->GetStackAmount();
+        state.MaxDuration = aura->GetMaxDuration();
+        state.Duration = aura->GetDuration();
+        state.Charges = aura->GetCharges();
+
         for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
         {
             if (AuraEffect const* effect = aura->GetEffect(i))
+            {
+                state.Amounts.emplace_back(effect->GetBaseAmount(), effect->GetAmount());
+                state.EffectMask |= 1 << i;
+                if (effect->CanBeRecalculated())
+                    state.RecalculateMask |= 1 << i;
+            }
+        }
+
+        if (foundAura->GetSlot() >= MAX_AURAS)
+        {
+            uint8 amountIndex = 0;
+            for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
+            {
+                if (!(state.EffectMask & (1 << i)))
+                    continue;
+
+                currentAuras.SlotlessEffects.emplace_back(i, state.Amounts[amountIndex].first, state.Amounts[amountIndex].second);
+                ++amountIndex;
+            }
+
+            currentAuras.Slotless[SlotlessAuraKey(state.CasterGuid, state.SpellId, state.EffectMask)].push_back(std::move(state));
+        }
+        else
+            currentAuras.Slots[foundAura->GetSlot()] = std::move(state);
+    }
+
+    // slots that no longer hold a saveable aura
+    for (SavedAuraStateMap::const_iterator itr = m_savedAuras.Slots.begin(); itr != m_savedAuras.Slots.end(); ++itr)
+    {
+        if (currentAuras.Slots.find(itr->first) != currentAuras.Slots.end())
+            continue;
+
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_AURA_BY_SLOT);
+        stmt->setUInt64(0, GetGUIDLow());
+        stmt->setUInt8(1, itr->first);
+        trans->Append(stmt);
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_AURA_EFFECT_BY_SLOT);
+        stmt->setUInt64(0, GetGUIDLow());
+        stmt->setUInt8(1, itr->first);
+        trans->Append(stmt);
+    }
+
+    for (SavedAuraStateMap::const_iterator itr = currentAuras.Slots.begin(); itr != currentAuras.Slots.end(); ++itr)
+    {
+        uint8 slot = itr->first;
+        SavedAuraState const& state = itr->second;
+        SavedAuraStateMap::const_iterator saved = m_savedAuras.Slots.find(slot);
+
+        // same aura stays in the slot - write only the values that changed
+        if (saved != m_savedAuras.Slots.end() && saved->second.SpellId == state.SpellId && saved->second.CasterGuid == state.CasterGuid &&
+            saved->second.CastItemGuid == state.CastItemGuid && saved->second.EffectMask == state.EffectMask)
+        {
+            SavedAuraState const& old = saved->second;
+            if (auraRowChanged(old, state))
             {
                 index = 0;
-                stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_AURA_EFFECT);
+                stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_AURA);
+                stmt->setUInt8(index++, state.RecalculateMask);
+                stmt->setUInt8(index++, state.StackAmount);
+                stmt->setInt32(index++, state.MaxDuration);
+                stmt->setInt32(index++, state.Duration);
+                stmt->setUInt8(index++, state.Charges);
                 stmt->setUInt64(index++, GetGUIDLow());
-                stmt->setUInt8(index++, foundAura->GetSlot());
-                stmt->setUInt8(index++, i);
-                stmt->setInt32(index++, effect->GetBaseAmount());
-                stmt->setInt32(index++, effect->GetAmount());
-
+                stmt->setUInt8(index, slot);
                 trans->Append(stmt);
+            }
 
-                effMask |= 1 << i;
-                if (effect->CanBeRecalculated())
-                    recalculateMask |= 1 << i;
+            uint8 amountIndex = 0;
+            for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
+            {
+                if (!(state.EffectMask & (1 << i)))
+                    continue;
+
+                std::pair<int32, int32> const& amount = state.Amounts[amountIndex];
+                if (amount != old.Amounts[amountIndex++])
+                {
+                    index = 0;
+                    stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_AURA_EFFECT);
+                    stmt->setInt32(index++, amount.first);
+                    stmt->setInt32(index++, amount.second);
+                    stmt->setUInt64(index++, GetGUIDLow());
+                    stmt->setUInt8(index++, slot);
+                    stmt->setUInt8(index, i);
+                    trans->Append(stmt);
+                }
             }
+            continue;
+        }
+
+        // slot is new or was taken over by another aura
+        if (saved != m_savedAuras.Slots.end())
+        {
+            stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_AURA_BY_SLOT);
+            stmt->setUInt64(0, GetGUIDLow());
+            stmt->setUInt8(1, slot);
+            trans->Append(stmt);
+            stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_AURA_EFFECT_BY_SLOT);
+            stmt->setUInt64(0, GetGUIDLow());
+            stmt->setUInt8(1, slot);
+            trans->Append(stmt);
         }
 
+        insertAura(slot, state);
+    }
+
+    // slotless auras that are gone
+    for (SavedSlotlessAuraMap::const_iterator itr = m_savedAuras.Slotless.begin(); itr != m_savedAuras.Slotless.end(); ++itr)
+    {
+        if (currentAuras.Slotless.find(itr->first) != currentAuras.Slotless.end())
+            continue;
+
         index = 0;
-        stmt = CharacterDatabase.GetPreparedStatement(CHAR_INS_AURA);
+        stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_SLOTLESS_AURA);
         stmt->setUInt64(index++, GetGUIDLow());
-        stmt->setUInt8(index++, foundAura->GetSlot());
-        stmt->setBinary(index++, itr->second->GetCasterGUID().GetRawValue());
-        stmt->setBinary(index++, itr->second->GetCastItemGUID().GetRawValue());
-        stmt->setUInt32(index++, itr->second->GetId());
-        stmt->setUInt16(index++, effMask);
-        stmt->setUInt8(index++, recalculateMask);
-        stmt->setUInt8(index++, itr->second->GetStackAmount());
-        stmt->setInt32(index++, itr->second->GetMaxDuration());
-        stmt->setInt32(index++, itr->second->GetDuration());
-        stmt->setUInt8(index, itr->second->GetCharges());
+        stmt->setUInt8(index++, MAX_AURAS);
+        stmt->setBinary(index++, std::get<0>(itr->first).GetRawValue());
+        stmt->setUInt32(index++, std::get<1>(itr->first));
+        stmt->setUInt16(index, std::get<2>(itr->first));
         trans->Append(stmt);
     }
+
+    for (SavedSlotlessAuraMap::const_iterator itr = currentAuras.Slotless.begin(); itr != currentAuras.Slotless.end(); ++itr)
+    {
+        std::vector<SavedAuraState> const& states = itr->second;
+        SavedSlotlessAuraMap::const_iterator saved = m_savedAuras.Slotless.find(itr->first);
+
+        // same single aura as in the previous save - update its row if needed
+        if (saved != m_savedAuras.Slotless.end() && states.size() == 1 && saved->second.size() == 1 && saved->second.front().CastItemGuid == states.front().CastItemGuid)
+        {
+            SavedAuraState const& state = states.front();
+            if (auraRowChanged(saved->second.front(), state))
+            {
+                index = 0;
+                stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_SLOTLESS_AURA);
+                stmt->setUInt8(index++, state.RecalculateMask);
+                stmt->setUInt8(index++, state.StackAmount);
+                stmt->setInt32(index++, state.MaxDuration);
+                stmt->setInt32(index++, state.Duration);
+                stmt->setUInt8(index++, state.Charges);
+                stmt->setUInt64(index++, GetGUIDLow());
+                stmt->setUInt8(index++, MAX_AURAS);
+                stmt->setBinary(index++, state.CasterGuid.GetRawValue());
+                stmt->setUInt32(index++, state.SpellId);
+                stmt->setUInt16(index, state.EffectMask);
+                trans->Append(stmt);
+            }
+            continue;
+        }
+
+        // new, or several auras share the key (different cast items) - rewrite the rows of that key
+        if (saved != m_savedAuras.Slotless.end())
+        {
+            index = 0;
+            stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_SLOTLESS_AURA);
+            stmt->setUInt64(index++, GetGUIDLow());
+            stmt->setUInt8(index++, MAX_AURAS);
+            stmt->setBinary(index++, std::get<0>(itr->first).GetRawValue());
+            stmt->setUInt32(index++, std::get<1>(itr->first));
+            stmt->setUInt16(index, std::get<2>(itr->first));
+            trans->Append(stmt);
+        }
+
+        for (SavedAuraState const& state : states)
+            insertAura(MAX_AURAS, state);
+    }
+
+    if (currentAuras.SlotlessEffects != m_savedAuras.SlotlessEffects)
+    {
+        if (!m_savedAuras.SlotlessEffects.empty())
+        {
+            stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_AURA_EFFECT_BY_SLOT);
+            stmt->setUInt64(0, GetGUIDLow());
+            stmt->setUInt8(1, MAX_AURAS);
+            trans->Append(stmt);
+        }
+
+        for (auto const& effect : currentAuras.SlotlessEffects)
+            insertAuraEffect(MAX_AURAS, std::get<0>(effect), std::get<1>(effect), std::get<2>(effect));
+    }
+
+    // becomes m_savedAuras once SaveToDB's transaction is committed
+    m_pendingSavedAuras.swap(currentAuras);
+    m_savedAurasCommitted = std::make_shared<std::atomic<bool>>(false);
 }
 
 void Player::_SaveInventory(SQLTransaction& trans)
@@ -204,6 +204,49 @@ struct PlayerCurrency
     CurrencyTypesEntry const * currencyEntry;
 };
 
+// Last character_aura row written for an aura, lets _SaveAuras skip rows that did not change since the previous save
+struct SavedAuraState
+{
+    uint32 SpellId = 0;
+    ObjectGuid CasterGuid;
+    ObjectGuid CastItemGuid;
+    uint32 EffectMask = 0;
+    uint32 RecalculateMask = 0;
+    uint16 StackAmount = 0;
+    int32 MaxDuration = 0;
+    int32 Duration = 0;
+    uint8 Charges = 0;
+    std::vector<std::pair<int32, int32>> Amounts;   // base/current amount for each effect set in EffectMask, ascending index order
+};
+
+typedef std::unordered_map<uint8 /*slot*/, SavedAuraState> SavedAuraStateMap;
+// auras without a visible slot are all stored with slot MAX_AURAS, their rows are told apart by caster, spell and effect mask
+typedef std::tuple<ObjectGuid /*caster*/, uint32 /*spell*/, uint32 /*effectMask*/> SlotlessAuraKey;
+typedef std::map<SlotlessAuraKey, std::vector<SavedAuraState>> SavedSlotlessAuraMap;
+
+// character_aura and character_aura_effect content written by a save
+struct SavedAuras
+{
+    SavedAuraStateMap Slots;
+    SavedSlotlessAuraMap Slotless;
+    // effect rows of the slotless auras only have the slot as key, they are compared and rewritten as a whole
+    std::vector<std::tuple<uint8 /*effect*/, int32 /*baseAmount*/, int32 /*amount*/>> SlotlessEffects;
+
+    void clear()
+    {
+        Slots.clear();
+        Slotless.clear();
+        SlotlessEffects.clear();
+    }
+
+    void swap(SavedAuras& other)
+    {
+        Slots.swap(other.Slots);
+        Slotless.swap(other.Slotless);
+        SlotlessEffects.swap(other.SlotlessEffects);
+    }
+};
+
 
 
 struct SpellInQueue
@@ -1555,6 +1598,7 @@ class Player : public Unit, public GridObject<Player>
         bool isTaxiCheater() const { return (m_ExtraFlags & PLAYER_EXTRA_TAXICHEAT) != 0; }
         void SetTaxiCheater(bool on) { if (on) m_ExtraFlags |= PLAYER_EXTRA_TAXICHEAT; else m_ExtraFlags &= ~PLAYER_EXTRA_TAXICHEAT; }
         bool isGMVisible() const { return !(m_ExtraFlags & PLAYER_EXTRA_GM_INVISIBLE); }
+        bool HasInvisibleStatus() const { return (m_ExtraFlags & PLAYER_EXTRA_INVISIBLE_STATUS) != 0; }
         void SetGMVisible(bool on);
         void SetPvPDeath(bool on) { if (on) m_ExtraFlags |= PLAYER_EXTRA_PVP_DEATH; else m_ExtraFlags &= ~PLAYER_EXTRA_PVP_DEATH; }
         bool HasPlayerExtraFlag(uint32 flag);
@@ -2753,6 +2797,7 @@ class Player : public Unit, public GridObject<Player>
         void SetLastWorldStateUpdateTime(time_t _time) { m_lastWSUpdateTime = _time; };
         
         void SendDirectMessage(WorldPacket const* data) const;
+        void SendDirectMessage(SharedWorldPacket const& data) const;
 
         void SendAurasForTarget(Unit* target);
         void SendSpellHistoryData();
@@ -2908,6 +2953,7 @@ class Player : public Unit, public GridObject<Player>
 
         uint32 GetSaveTimer() const { return m_nextSave; }
         void   SetSaveTimer(uint32 timer) { m_nextSave = timer; }
+        uint32 CalculateNextSaveTimer() const;
 
         // Recall position
         WorldLocation m_recallLoc;
@@ -3029,6 +3075,7 @@ class Player : public Unit, public GridObject<Player>
         InstanceSave* GetInstanceSave(uint32 mapid);
         void UnbindInstance(uint32 mapid, Difficulty difficulty, bool unload = false);
         void UnbindInstance(BoundInstancesMap::iterator &itr, Difficulty difficulty, bool unload = false);
+        void PurgeExpiredBinds();                           // drops the binds to saves expired by a daily or weekly reset
         InstancePlayerBind* BindToInstance(InstanceSave* save, bool permanent, bool load = false);
         void BindToInstance();
         void SetPendingBind(uint32 instanceId, uint32 bindTimer) { _pendingBindId = instanceId; _pendingBindTimer = bindTimer; }
@@ -3452,6 +3499,10 @@ class Player : public Unit, public GridObject<Player>
 
         uint32 m_team;
         uint32 m_nextSave;
+        SavedAuras m_savedAuras;
+        bool m_savedAurasSynced;                            // m_savedAuras mirrors character_aura, differential aura save is possible
+        SavedAuras m_pendingSavedAuras;                     // written by the last save, not known to be committed yet
+        std::shared_ptr<std::atomic<bool>> m_savedAurasCommitted;   // set from the database thread once that save is committed
         time_t m_speakTime;
         uint32 m_speakCount;
         Difficulty m_dungeonDifficulty;
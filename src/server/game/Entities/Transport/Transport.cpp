@@ -504,7 +504,7 @@ void Transport::UpdatePosition(float x, float y, float z, float o)
     {
         Relocate(x, y, z, o);
 		m_stationaryPosition.SetOrientation(o);
-        UpdateModelPosition(oldCell.DiffGrid(Cell(GetPositionX(), GetPositionY())));
+        UpdateModelPosition();
     }
 
     UpdatePassengerPositions(_passengers);
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ProcAuraBuckets_h__
+#define ProcAuraBuckets_h__
+
+#include "Define.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// disjoint groups of proc flags, proc capable auras are kept in one bucket per group they can react to
+enum ProcAuraClass
+{
+    PROC_AURA_CLASS_MELEE         = 0,                      // MELEE_PROC_FLAG_MASK
+    PROC_AURA_CLASS_RANGED        = 1,                      // RANGED_PROC_FLAG_MASK
+    PROC_AURA_CLASS_SPELL         = 2,                      // SPELL_PROC_FLAG_MASK without melee and ranged damage class
+    PROC_AURA_CLASS_PERIODIC      = 3,                      // PERIODIC_PROC_FLAG_MASK
+    PROC_AURA_CLASS_TAKEN_DAMAGE  = 4,                      // PROC_FLAG_TAKEN_DAMAGE
+    PROC_AURA_CLASS_OTHER         = 5,                      // kill, death, trap, jump, combat...
+    MAX_PROC_AURA_CLASS
+};
+
+/** Proc capable aura applications of a unit, one bucket per ProcAuraClass they can react to.
+    Buckets are sorted like Unit::m_appliedAuras (spell id, then apply order) so a proc event
+    only walks the auras of its own classes and still sees them in the usual order.
+    Application is the shared pointer type of the applications, it has no game dependency
+    so proc_bench can build it on its own.
+*/
+template<class Application>
+class ProcAuraBuckets
+{
+public:
+    struct Entry
+    {
+        uint32 SpellId;
+        uint32 Sequence;
+        uint32 ProcFlags;
+        Application AurApp;
+    };
+
+    typedef std::vector<Entry const*> CandidateList;
+    typedef std::vector<std::pair<uint32, Application>> AuraList;
+
+    /// classMasks holds the proc flags of every ProcAuraClass
+    explicit ProcAuraBuckets(uint32 const* classMasks) : _classMasks(classMasks), _sequence(0) { }
+
+    void Add(uint32 spellId, uint32 procFlags, Application const& aurApp)
+    {
+        Entry entry{ spellId, ++_sequence, procFlags, aurApp };
+        for (uint8 procClass = 0; procClass < MAX_PROC_AURA_CLASS; ++procClass)
+        {
+            if (!(procFlags & _classMasks[procClass]))
+                continue;
+
+            // new applications go after the ones with the same spell id, like in the multimap
+            std::vector<Entry>& bucket = _buckets[procClass];
+            auto itr = std::upper_bound(bucket.begin(), bucket.end(), spellId, [](uint32 id, Entry const& other) { return id < other.SpellId; });
+            bucket.insert(itr, entry);
+        }
+    }
+
+    void Remove(uint32 spellId, typename Application::element_type const* aurApp)
+    {
+        for (std::vector<Entry>& bucket : _buckets)
+        {
+            auto itr = std::lower_bound(bucket.begin(), bucket.end(), spellId, [](Entry const& other, uint32 id) { return other.SpellId < id; });
+            for (; itr != bucket.end() && itr->SpellId == spellId; ++itr)
+            {
+                if (itr->AurApp.get() == aurApp)
+                {
+                    bucket.erase(itr);
+                    break;
+                }
+            }
+        }
+    }
+
+    void Clear()
+    {
+        for (std::vector<Entry>& bucket : _buckets)
+            bucket.clear();
+
+        _sequence = 0;
+    }
+
+    /// Fills auras with every application that has one of the procFlag flags, in m_appliedAuras order.
+    /// candidates is scratch space, both lists are only appended to so callers can keep their capacity.
+    void Collect(uint32 procFlag, CandidateList& candidates, AuraList& auras) const
+    {
+        for (uint8 procClass = 0; procClass < MAX_PROC_AURA_CLASS; ++procClass)
+        {
+            if (!(procFlag & _classMasks[procClass]))
+                continue;
+
+            for (Entry const& entry : _buckets[procClass])
+                if (entry.ProcFlags & procFlag)
+                    candidates.push_back(&entry);
+        }
+
+        if (candidates.empty())
+            return;
+
+        std::sort(candidates.begin(), candidates.end(), [](Entry const* left, Entry const* right)
+        {
+            return left->SpellId != right->SpellId ? left->SpellId < right->SpellId : left->Sequence < right->Sequence;
+        });
+
+        // an aura reacting to several classes is in several buckets
+        std::size_t first = auras.size();
+        for (Entry const* entry : candidates)
+            if (auras.size() == first || auras.back().second != entry->AurApp)
+                auras.emplace_back(entry->SpellId, entry->AurApp);
+    }
+
+private:
+    uint32 const* _classMasks;
+    std::vector<Entry> _buckets[MAX_PROC_AURA_CLASS];
+    uint32 _sequence;
+};
+
+#endif // ProcAuraBuckets_h__
@@ -211,13 +211,24 @@ SpellNonMeleeDamage::SpellNonMeleeDamage(Unit* _attacker, Unit* _target, uint32
     SpellXSpellVisualID = spellXSpellVisualID;
 }
 
+// proc flags of every ProcAuraClass, Unit::m_procAuras splits the proc capable auras by them
+uint32 const ProcAuraClassMask[MAX_PROC_AURA_CLASS] =
+{
+    MELEE_PROC_FLAG_MASK,
+    RANGED_PROC_FLAG_MASK,
+    SPELL_PROC_FLAG_MASK & ~(MELEE_PROC_FLAG_MASK | RANGED_PROC_FLAG_MASK),
+    PERIODIC_PROC_FLAG_MASK,
+    PROC_FLAG_TAKEN_DAMAGE,
+    ~(MELEE_PROC_FLAG_MASK | RANGED_PROC_FLAG_MASK | SPELL_PROC_FLAG_MASK | PERIODIC_PROC_FLAG_MASK | PROC_FLAG_TAKEN_DAMAGE)
+};
+
 // we can disable this warning for this since it only
 // causes undefined behavior when passed to the base class constructor
 #ifdef _MSC_VER
 #pragma warning(disable:4355)
 #endif
 Unit::Unit(bool isWorldObject): WorldObject(isWorldObject), m_movedPlayer(nullptr), m_lastSanctuaryTime(0), IsAIEnabled(false), NeedChangeAI(false), m_ControlledByPlayer(false),
-movespline(new Movement::MoveSpline()), i_AI(nullptr), i_disabledAI(nullptr), m_AutoRepeatFirstCast(false), m_procDeep(0), m_castCounter(0), m_removedAurasCount(0), i_motionMaster(this),
+movespline(new Movement::MoveSpline()), i_AI(nullptr), i_disabledAI(nullptr), m_AutoRepeatFirstCast(false), m_procDeep(0), m_castCounter(0), m_removedAurasCount(0), m_procAuras(ProcAuraClassMask), m_procAuraVersion(0), m_procAuraSpawnMode(0), i_motionMaster(this),
 m_regenTimer{0}, isCasterPet{false}, m_ThreatManager(this), m_vehicle(nullptr), m_vehicleKit(nullptr), m_unitTypeMask(UNIT_MASK_NONE), m_rootTimes{0}, m_HostileRefManager(this), _delayInterruptFlag(0), _lastDamagedTime(0), damageTrackingTimer_(),
 playerDamageTaken_(), npcDamageTaken_()
 {
@@ -448,6 +459,7 @@ void Unit::Update(uint32 p_time)
     // WARNING! Order of execution here is important, do not change.
     // Spells must be processed with event system BEFORE they go to _UpdateSpells.
     // Or else we may have some SPELL_STATE_FINISHED spells stalled in pointers, that is bad.
+    // On a map the processors are bound to the map timer wheel, which runs them at the start of Map::Update.
     if (!m_cleanupDone) // May be crashed
     {
         _eventCount = m_Events.Size();
@@ -4546,8 +4558,7 @@ AuraApplication * Unit::_CreateAuraApplication(Aura* aura, uint32 effMask)
     AuraApplicationPtr aurApp = std::make_shared<AuraApplication>(this, caster, aura, effMask);
     m_appliedAuras.insert(std::make_pair(aurId, aurApp));
 
-    if (aurSpellInfo->GetAuraOptions(GetSpawnMode())->IsProcAura)
-        m_procAuras.insert(std::make_pair(aurId, aurApp));
+    _AddProcAura(aurId, aurApp);
     m_aura_lock.unlock();
 
     if (aurSpellInfo->HasAnyAuraInterruptFlag())
@@ -4647,7 +4658,7 @@ void Unit::_UnapplyAura(AuraApplicationMap::iterator &i, AuraRemoveMode removeMo
     Unit* caster = aura->GetCaster();
 
     // Remove all pointers from lists here to prevent possible pointer invalidation on spellcast/auraapply/auraremove
-    m_procAuras.erase(aura->GetId());
+    _RemoveProcAura(aura->GetId(), aurApp.get());
     m_appliedAuras.erase(i);
 
     if (spellInfo->HasAnyAuraInterruptFlag())
@@ -4905,6 +4916,7 @@ void Unit::RemoveOwnedAuraAll()
 
     AuraApplicationMap _ownedAuraApplications;
     std::swap(_ownedAuraApplications, m_appliedAuras);
+    m_procAuras.Clear();
 
     for (AuraApplicationMap::iterator iter = _ownedAuraApplications.begin(); iter != _ownedAuraApplications.end(); ++iter)
     {
@@ -13295,7 +13307,7 @@ int32 Unit::GetSpellPowerHealing()
     return 0;
 }
 
-bool Unit::isSpellCrit(Unit* victim, SpellInfo const* spellProto, SpellSchoolMask schoolMask, WeaponAttackType attackType, float &critChance, Spell* spell) const
+bool Unit::isSpellCrit(Unit* victim, SpellInfo const* spellProto, SpellSchoolMask schoolMask, WeaponAttackType attackType, float &critChance, Spell* spell, double critRoll) const
 {
     Unit* owner = GetAnyOwner();
     //! Mobs can't crit with spells. Players, Pets, Totems can
@@ -13610,7 +13622,7 @@ bool Unit::isSpellCrit(Unit* victim, SpellInfo const* spellProto, SpellSchoolMas
     if (countCrit)
         crit_chance = countCrit;
 
-    if (roll_chance_f(crit_chance))
+    if (critRoll < 0.0 ? roll_chance_f(crit_chance) : crit_chance > critRoll)
         return true;
     return false;
 }
@@ -17513,6 +17525,13 @@ void Unit::RemoveFromWorld()
     }
 }
 
+void Unit::BindTimerWheel(SharedTimerWheel* wheel)
+{
+    m_Events.SetTimerWheel(wheel);
+    m_Functions.SetTimerWheel(wheel);
+    m_CombatFunctions.SetTimerWheel(wheel);
+}
+
 void Unit::CleanupBeforeRemoveFromMap(bool finalCleanup)
 {
     // if (finalCleanup)
@@ -17717,6 +17736,81 @@ struct ProcTriggeredData
 
 typedef std::list< ProcTriggeredData > ProcTriggeredList;
 
+// Candidate lists of ProcDamageAndSpellFor, kept per thread so a proc does not allocate them again.
+// Script proc handlers can start a nested proc while the outer call still walks its list, so every
+// nesting level takes its own buffers.
+struct ProcCandidateBuffers
+{
+    Unit::ProcAuraMap::CandidateList Candidates;
+    Unit::ProcAuraMap::AuraList Auras;
+};
+
+class ProcCandidateBuffersGuard
+{
+public:
+    ProcCandidateBuffersGuard()
+    {
+        if (_depth == _buffers.size())
+            _buffers.emplace_back(new ProcCandidateBuffers());
+        _current = _buffers[_depth++].get();
+    }
+
+    ~ProcCandidateBuffersGuard()
+    {
+        // keep the capacity but do not hold on to the applications
+        _current->Candidates.clear();
+        _current->Auras.clear();
+        --_depth;
+    }
+
+    ProcCandidateBuffers* operator->() const { return _current; }
+
+private:
+    ProcCandidateBuffers* _current;
+
+    static thread_local std::vector<std::unique_ptr<ProcCandidateBuffers>> _buffers;
+    static thread_local std::size_t _depth;
+};
+
+thread_local std::vector<std::unique_ptr<ProcCandidateBuffers>> ProcCandidateBuffersGuard::_buffers;
+thread_local std::size_t ProcCandidateBuffersGuard::_depth = 0;
+
+// Every flag EventProcFlag can take in IsTriggeredAtSpellProcEvent for any effect of the spell
+uint32 Unit::GetAuraProcFlags(SpellInfo const* spellInfo) const
+{
+    uint32 procFlags = spellInfo->GetAuraOptions(GetSpawnMode())->ProcTypeMask;
+    if (std::vector<SpellProcEventEntry> const* spellProcEvents = sSpellMgr->GetSpellProcEvent(spellInfo->Id))
+        for (SpellProcEventEntry const& spellProcEvent : *spellProcEvents)
+            procFlags |= spellProcEvent.procFlags;
+
+    return procFlags;
+}
+
+void Unit::_AddProcAura(uint32 spellId, AuraApplicationPtr const& aurApp)
+{
+    SpellInfo const* spellInfo = aurApp->GetBase()->GetSpellInfo();
+    if (!spellInfo->GetAuraOptions(GetSpawnMode())->IsProcAura)
+        return;
+
+    m_procAuras.Add(spellId, GetAuraProcFlags(spellInfo), aurApp);
+}
+
+void Unit::_RemoveProcAura(uint32 spellId, AuraApplication const* aurApp)
+{
+    m_procAuras.Remove(spellId, aurApp);
+}
+
+void Unit::_RebuildProcAuras()
+{
+    m_procAuras.Clear();
+    m_procAuraVersion = sSpellMgr->GetSpellProcEventVersion();
+    m_procAuraSpawnMode = GetSpawnMode();
+
+    for (AuraApplicationMap::const_iterator itr = m_appliedAuras.begin(); itr != m_appliedAuras.end(); ++itr)
+        if (itr->second && !itr->second->GetRemoveMode())
+            _AddProcAura(itr->first, itr->second);
+}
+
 // List of auras that CAN be trigger but may not exist in spell_proc_event
 // in most case need for drop charges
 // in some types of aura need do additional check
@@ -17918,14 +18012,25 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* target, uint32 procFlag, u
     HealInfo healInfo = HealInfo(actor, actionTarget, dmgInfoProc->GetDamage(), procSpell, procSpell ? SpellSchoolMask(procSpell->GetMisc(m_spawnMode)->MiscData.SchoolMask) : SPELL_SCHOOL_MASK_NORMAL);
     ProcEventInfo eventInfo = ProcEventInfo(actor, actionTarget, target, procFlag, 0, 0, procExtra, spell, dmgInfoProc, &healInfo);
 
+    if (m_procAuraVersion != sSpellMgr->GetSpellProcEventVersion() || m_procAuraSpawnMode != GetSpawnMode())
+        _RebuildProcAuras();
+
+    // Only auras that have at least one of the event flags can pass IsTriggeredAtSpellProcEvent,
+    // collect them from the buckets of the event flag classes keeping the m_appliedAuras order
+    ProcCandidateBuffersGuard buffers;
+    ProcAuraMap::AuraList& procAuras = buffers->Auras;
+    m_procAuras.Collect(procFlag, buffers->Candidates, procAuras);
+    if (procAuras.empty())
+        return;
+
     std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
     ProcTriggeredList procTriggered;
     // Fill procTriggered list
-    for (AuraApplicationMap::const_iterator itr = GetAppliedAuras().begin(); itr!= GetAppliedAuras().end(); ++itr)
+    for (auto itr = procAuras.begin(); itr != procAuras.end(); ++itr)
     {
         AuraApplicationPtr auraApp = itr->second;
         // Do not allow auras to proc from effect triggered by itself
-        if (procAura && procAura->Id == itr->first || !auraApp || !auraApp->GetBase()->GetSpellInfo()->GetAuraOptions(GetSpawnMode())->IsProcAura)
+        if (procAura && procAura->Id == itr->first || !auraApp || auraApp->GetRemoveMode() || !auraApp->GetBase()->GetSpellInfo()->GetAuraOptions(GetSpawnMode())->IsProcAura)
             continue;
         ProcTriggeredData triggerData(auraApp->GetBase());
 
@@ -26684,7 +26789,12 @@ void Unit::GenerateLoot(Creature* creature, Player* anyLooter)
     loot->clear();
     loot->objType = 1;
     loot->isOnlyQuest = isPersonalGroup;
-    loot->FillLoot(lootid, LootTemplates_Creature, anyLooter, false, false, creature);
+
+    // only the killer can open the corpse of a solo kill, rolling it waits until someone does
+    if (sWorld->getBoolConfig(CONFIG_LOOT_DEFER_CORPSE) && !anyLooter->GetGroup() && !creature->CanShared() && !creature->isWorldBoss())
+        loot->SetPendingLoot(lootid, LootTemplates_Creature, anyLooter->GetGUID());
+    else
+        loot->FillLoot(lootid, LootTemplates_Creature, anyLooter, false, false, creature);
 }
 
 void Unit::TargetsWhoHasMyAuras(std::list<Unit*>& targetList, std::vector<uint32>& auraList)
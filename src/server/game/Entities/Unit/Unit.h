@@ -28,6 +28,7 @@
 #include "HostileRefManager.h"
 #include "MotionMaster.h"
 #include "Object.h"
+#include "ProcAuraBuckets.h"
 #include "SharedDefines.h"
 #include "SpellAuraDefines.h"
 #include "SpellInfo.h"
@@ -540,21 +541,6 @@ enum UnitState
     UNIT_STATE_ALL_STATE       = 0xffffffff                      //(UNIT_STATE_STOPPED | UNIT_STATE_MOVING | UNIT_STATE_IN_COMBAT | UNIT_STATE_IN_FLIGHT)
 };
 
-enum UnitMoveType
-{
-    MOVE_WALK           = 0,
-    MOVE_RUN            = 1,
-    MOVE_RUN_BACK       = 2,
-    MOVE_SWIM           = 3,
-    MOVE_SWIM_BACK      = 4,
-    MOVE_TURN_RATE      = 5,
-    MOVE_FLIGHT         = 6,
-    MOVE_FLIGHT_BACK    = 7,
-    MOVE_PITCH_RATE     = 8,
-
-    MAX_MOVE_TYPE
-};
-
 extern float baseMoveSpeed[MAX_MOVE_TYPE];
 extern float playerBaseMoveSpeed[MAX_MOVE_TYPE];
 
@@ -1110,6 +1096,7 @@ class Unit : public WorldObject
         typedef std::set<ObjectGuid> ControlList;
         typedef std::multimap<uint32, Aura*> AuraMap;
         typedef std::multimap<uint32, AuraApplicationPtr> AuraApplicationMap;
+        typedef ProcAuraBuckets<AuraApplicationPtr> ProcAuraMap;
         typedef std::multimap<AuraStateType,  AuraApplication*> AuraStateAurasMap;
         typedef cds::container::IterableList< cds::gc::HP, AuraEffect*,
                                               cds::container::iterable_list::make_traits<
@@ -1139,6 +1126,7 @@ class Unit : public WorldObject
 
         void AddToWorld() override;
         void RemoveFromWorld() override;
+        void BindTimerWheel(SharedTimerWheel* wheel) override;
 
         void CleanupBeforeRemoveFromMap(bool finalCleanup);
         void CleanupsBeforeDelete(bool finalCleanup = true) override;                        // used in ~Creature/~Player (or before mass creature delete to remove cross-references to already deleted units)
@@ -1674,6 +1662,10 @@ class Unit : public WorldObject
         void _UnapplyAura(AuraApplication * aurApp, AuraRemoveMode removeMode);
         void _RemoveNoStackAurasDueToAura(Aura* aura);
         void _RegisterAuraEffect(AuraEffect* aurEff, bool apply);
+        void _AddProcAura(uint32 spellId, AuraApplicationPtr const& aurApp);
+        void _RemoveProcAura(uint32 spellId, AuraApplication const* aurApp);
+        void _RebuildProcAuras();
+        uint32 GetAuraProcFlags(SpellInfo const* spellInfo) const;
 
         // m_ownedAuras container management
         AuraMap      & GetOwnedAuras()       { return m_ownedAuras; }
@@ -2136,7 +2128,8 @@ class Unit : public WorldObject
 
         bool isSpellBlocked(Unit* victim, SpellInfo const* spellProto, WeaponAttackType attType = BASE_ATTACK);
         bool isBlockCritical();
-        bool isSpellCrit(Unit* victim, SpellInfo const* spellProto, SpellSchoolMask schoolMask, WeaponAttackType attackType, float &critChance, Spell* spell = nullptr) const;
+        // critRoll is a rand_chance() drawn by the caller, negative to roll here
+        bool isSpellCrit(Unit* victim, SpellInfo const* spellProto, SpellSchoolMask schoolMask, WeaponAttackType attackType, float &critChance, Spell* spell = nullptr, double critRoll = -1.0) const;
         uint32 SpellCriticalHealingBonus(SpellInfo const* spellProto, uint32 damage);
         float SpellCriticalDamageBonus(SpellInfo const* spellProto, Unit* victim);
 
@@ -2513,7 +2506,9 @@ class Unit : public WorldObject
 
         AuraMap m_ownedAuras;
         AuraApplicationMap m_appliedAuras;
-        AuraApplicationMap m_procAuras;
+        ProcAuraMap m_procAuras;
+        uint32 m_procAuraVersion;                  // spell_proc_event version the buckets were built with
+        uint8 m_procAuraSpawnMode;                 // spawn mode the buckets were built with, aura options depend on it
         AuraList m_removedAuras;
         AuraMap::iterator m_auraUpdateIterator;
         uint32 m_removedAurasCount;
@@ -263,6 +263,21 @@ enum NPCFlags2
     UNIT_NPC_FLAG2_CONTRIBUTION_NPC     = 0x00000400,
 };
 
+enum UnitMoveType
+{
+    MOVE_WALK           = 0,
+    MOVE_RUN            = 1,
+    MOVE_RUN_BACK       = 2,
+    MOVE_SWIM           = 3,
+    MOVE_SWIM_BACK      = 4,
+    MOVE_TURN_RATE      = 5,
+    MOVE_FLIGHT         = 6,
+    MOVE_FLIGHT_BACK    = 7,
+    MOVE_PITCH_RATE     = 8,
+
+    MAX_MOVE_TYPE
+};
+
 enum MovementFlags : uint32
 {
     MOVEMENTFLAG_NONE                  = 0x00000000,
@@ -300,7 +300,7 @@ void AIRelocationNotifier::Visit(EventObjectMapType &m)
 }
 
 MessageDistDeliverer::MessageDistDeliverer(WorldObject* src, WorldPacket const* msg, float dist, bool own_team_only, Player const* skipped, GuidUnorderedSet ignoredSet) :
-    i_source(src), i_message(msg), i_phaseMask(src->GetPhaseMask()), i_distSq(dist * dist), team((own_team_only && src->IsPlayer()) ? src->ToPlayer()->GetTeam() : 0), skipped_receiver(skipped), m_IgnoredGUIDs(ignoredSet)
+    i_source(src), i_message(msg), i_sharedMessage(msg), i_phaseMask(src->GetPhaseMask()), i_distSq(dist * dist), team((own_team_only && src->IsPlayer()) ? src->ToPlayer()->GetTeam() : 0), skipped_receiver(skipped), m_IgnoredGUIDs(ignoredSet)
 {
 }
 
@@ -382,7 +382,7 @@ void MessageDistDeliverer::SendPacket(Player* player)
     if (i_message->GetOpcode() == SMSG_CHAT && player->GetSocial()->HasIgnore(i_source->GetGUID()))
         return;
 
-    player->SendDirectMessage(i_message);
+    player->SendDirectMessage(i_sharedMessage.Share());
 }
 
 UnfriendlyMessageDistDeliverer::UnfriendlyMessageDistDeliverer(Unit const* src, WorldPacket* msg, float dist) : i_source(src), i_message(msg), i_phaseMask(src->GetPhaseMask()), i_distSq(dist * dist)
@@ -28,6 +28,7 @@
 #include "GameObject.h"
 #include "Player.h"
 #include "SocialMgr.h"
+#include "SpatialFilter.h"
 #include "Spell.h"
 #include "UpdateData.h"
 
@@ -88,6 +89,7 @@ namespace Trinity
     {
         WorldObject* i_source;
         WorldPacket const* i_message;
+        BroadcastPacket i_sharedMessage;
         uint32 i_phaseMask;
         float i_distSq;
         uint32 team;
@@ -198,6 +200,36 @@ namespace Trinity
         void Visit(NotInterested &) {}
     };
 
+    // same as WorldObjectListSearcher, but Check::GetSpatialFilter() is run over the position mirror of each container first
+    template<class Check>
+    struct WorldObjectSpatialListSearcher
+    {
+        uint32 i_mapTypeMask;
+        std::list<WorldObject*> &i_objects;
+        Check& i_check;
+        SpatialFilter i_filter;
+        SpatialFilterResult i_survivors;
+
+        WorldObjectSpatialListSearcher(WorldObject const* /*searcher*/, std::list<WorldObject*> &objects, Check & check, uint32 mapTypeMask = GRID_MAP_TYPE_MASK_ALL)
+            : i_mapTypeMask(mapTypeMask), i_objects(objects), i_check(check), i_filter(check.GetSpatialFilter()) {}
+
+        void Visit(PlayerMapType &m, ContainerPositions const& positions) { VisitFiltered(m, positions, GRID_MAP_TYPE_MASK_PLAYER); }
+        void Visit(CreatureMapType &m, ContainerPositions const& positions) { VisitFiltered(m, positions, GRID_MAP_TYPE_MASK_CREATURE); }
+        void Visit(CorpseMapType &m, ContainerPositions const& positions) { VisitFiltered(m, positions, GRID_MAP_TYPE_MASK_CORPSE); }
+        void Visit(GameObjectMapType &m, ContainerPositions const& positions) { VisitFiltered(m, positions, GRID_MAP_TYPE_MASK_GAMEOBJECT); }
+        void Visit(DynamicObjectMapType &m, ContainerPositions const& positions) { VisitFiltered(m, positions, GRID_MAP_TYPE_MASK_DYNAMICOBJECT); }
+        void Visit(AreaTriggerMapType &m, ContainerPositions const& positions) { VisitFiltered(m, positions, GRID_MAP_TYPE_MASK_AREATRIGGER); }
+        void Visit(ConversationMapType &m, ContainerPositions const& positions) { VisitFiltered(m, positions, GRID_MAP_TYPE_MASK_CONVERSATION); }
+        void Visit(EventObjectMapType &m, ContainerPositions const& positions) { VisitFiltered(m, positions, GRID_MAP_TYPE_MASK_EVENTOBJECT); }
+
+        template <typename NotInterested>
+        void Visit(NotInterested &, ContainerPositions const&) {}
+
+    private:
+        template<class T>
+        void VisitFiltered(std::vector<T*> &m, ContainerPositions const& positions, uint32 typeMask);
+    };
+
     template<class Do>
     struct WorldObjectWorker
     {
@@ -1229,6 +1261,7 @@ namespace Trinity
     private:
         Builder& _builder;
         std::vector<WorldPackets::Packet*> _dataCache;         // 0 = default, i => i-1 locale index
+        std::vector<BroadcastPacket> _sharedCache;             // same index, payload queued on every recipient
     };
 
     template<class Builder>
@@ -1250,6 +1283,7 @@ namespace Trinity
         Builder& _builder;
         std::vector<WorldPacketList> _dataCache;
         // 0 = default, i => i-1 locale index
+        std::vector<std::vector<BroadcastPacket>> _sharedCache;
     };
 
     class SummonTimerOrderPred
@@ -383,6 +383,28 @@ void Trinity::WorldObjectListSearcher<Check>::Visit(EventObjectMapType &m)
             i_objects.push_back(event);
 }
 
+template<class Check>
+template<class T>
+void Trinity::WorldObjectSpatialListSearcher<Check>::VisitFiltered(std::vector<T*> &m, ContainerPositions const& positions, uint32 typeMask)
+{
+    if (!(i_mapTypeMask & typeMask))
+        return;
+
+    // mirror out of sync would mean an element not added through GridObject::AddToGrid
+    if (positions.size() != m.size())
+    {
+        for (auto &obj : m)
+            if (i_check(obj))
+                i_objects.push_back(obj);
+        return;
+    }
+
+    i_filter.Filter(positions, i_survivors);
+    for (uint32 offset : i_survivors)
+        if (i_check(m[offset]))
+            i_objects.push_back(m[offset]);
+}
+
 // Gameobject searchers
 
 template<class Check>
@@ -567,26 +589,27 @@ void Trinity::LocalizedPacketDo<Builder>::operator()(Player* p)
 {
     LocaleConstant localeConstant = p->GetSession()->GetSessionDbLocaleIndex();
     uint32 cache_idx = localeConstant + 1;
-    WorldPackets::Packet* data;
 
     // create if not cached yet
     if (_dataCache.size() < cache_idx + 1 || !_dataCache[cache_idx])
     {
         if (_dataCache.size() < cache_idx + 1)
+        {
             _dataCache.resize(cache_idx + 1);
+            _sharedCache.resize(cache_idx + 1);
+        }
 
-        data = _builder(localeConstant);
+        WorldPackets::Packet* data = _builder(localeConstant);
 
         ASSERT(data->GetSize() == 0);
 
         data->Write();
 
         _dataCache[cache_idx] = data;
+        _sharedCache[cache_idx] = BroadcastPacket(data->GetRawPacket());
     }
-    else
-        data = _dataCache[cache_idx];
 
-    p->SendDirectMessage(data->GetRawPacket());
+    p->SendDirectMessage(_sharedCache[cache_idx].Share());
 }
 
 template<class Builder>
@@ -594,23 +617,27 @@ void Trinity::LocalizedPacketListDo<Builder>::operator()(Player* p)
 {
     LocaleConstant localeConstant = p->GetSession()->GetSessionDbLocaleIndex();
     uint32 cache_idx = localeConstant + 1;
-    WorldPacketList* data;
 
     // create if not cached yet
     if (_dataCache.size() < cache_idx + 1 || _dataCache[cache_idx].empty())
     {
         if (_dataCache.size() < cache_idx + 1)
+        {
             _dataCache.resize(cache_idx + 1);
+            _sharedCache.resize(cache_idx + 1);
+        }
+
+        WorldPacketList& data = _dataCache[cache_idx];
 
-        data = &_dataCache[cache_idx];
+        _builder(data, localeConstant);
 
-        _builder(*data, localeConstant);
+        _sharedCache[cache_idx].clear();
+        for (WorldPackets::Packet* packet : data)
+            _sharedCache[cache_idx].emplace_back(packet->GetRawPacket());
     }
-    else
-        data = &_dataCache[cache_idx];
 
-    for (size_t i = 0; i < data->size(); ++i)
-        p->SendDirectMessage((*data)[i]->GetRawPacket());
+    for (BroadcastPacket& packet : _sharedCache[cache_idx])
+        p->SendDirectMessage(packet.Share());
 }
 
 #endif                                                      // TRINITY_GRIDNOTIFIERSIMPL_H
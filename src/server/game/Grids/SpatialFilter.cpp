@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2008-2016 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SpatialFilter.h"
+#include "Dynamic/TypeContainer.h"
+#include "Position.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRINITY_SPATIALFILTER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // the exact checks work on doubles converted from the same floats, keep some slack
+    float const RadiusTolerance = 1.0001f;
+    float const DistanceTolerance = 0.01f;
+    float const ArcTolerance = 0.01f;
+}
+
+Trinity::SpatialFilter::SpatialFilter() : _enabled(false), _x(0.0f), _y(0.0f), _z(0.0f), _radius(0.0f), _reachFactor(0.0f),
+    _hasArc(false), _arcX(0.0f), _arcY(0.0f), _facingX(0.0f), _facingY(0.0f), _arcCos(-1.0f)
+{
+}
+
+Trinity::SpatialFilter::SpatialFilter(float x, float y, float z, float radius, bool allowObjectSize) : _enabled(true), _x(x), _y(y), _z(z),
+    _radius(std::max(radius, 0.0f)), _reachFactor(allowObjectSize ? 1.0f : 0.0f),
+    _hasArc(false), _arcX(0.0f), _arcY(0.0f), _facingX(0.0f), _facingY(0.0f), _arcCos(-1.0f)
+{
+}
+
+void Trinity::SpatialFilter::SetFrontArc(float x, float y, float orientation, float arc)
+{
+    // same normalization as Position::HasInArc
+    arc = Position::NormalizeOrientation(arc);
+
+    float halfArc = arc / 2.0f + ArcTolerance;
+    if (halfArc >= float(M_PI))
+        return;
+
+    _hasArc = true;
+    _arcX = x;
+    _arcY = y;
+    _facingX = std::cos(orientation);
+    _facingY = std::sin(orientation);
+    _arcCos = std::cos(halfArc);
+}
+
+bool Trinity::SpatialFilter::Passes(float x, float y, float z, float reach) const
+{
+    float dx = x - _x;
+    float dy = y - _y;
+    float dz = z - _z;
+    float maxDist = _radius + reach * _reachFactor;
+    if (dx * dx + dy * dy + dz * dz > maxDist * maxDist * RadiusTolerance + DistanceTolerance)
+        return false;
+
+    if (!_hasArc)
+        return true;
+
+    float ax = x - _arcX;
+    float ay = y - _arcY;
+    return ax * _facingX + ay * _facingY >= std::sqrt(ax * ax + ay * ay) * _arcCos - DistanceTolerance;
+}
+
+void Trinity::SpatialFilter::Filter(ContainerPositions const& positions, SpatialFilterResult& survivors) const
+{
+    survivors.clear();
+
+    uint32 count = uint32(positions.size());
+    if (!_enabled)
+    {
+        for (uint32 i = 0; i < count; ++i)
+            survivors.push_back(i);
+        return;
+    }
+
+    float const* xs = positions.x.data();
+    float const* ys = positions.y.data();
+    float const* zs = positions.z.data();
+    float const* reaches = positions.reach.data();
+
+    uint32 i = 0;
+#ifdef TRINITY_SPATIALFILTER_SSE2
+    __m128 const cx = _mm_set1_ps(_x);
+    __m128 const cy = _mm_set1_ps(_y);
+    __m128 const cz = _mm_set1_ps(_z);
+    __m128 const radius = _mm_set1_ps(_radius);
+    __m128 const reachFactor = _mm_set1_ps(_reachFactor);
+    __m128 const radiusTolerance = _mm_set1_ps(RadiusTolerance);
+    __m128 const distanceTolerance = _mm_set1_ps(DistanceTolerance);
+    __m128 const ax = _mm_set1_ps(_arcX);
+    __m128 const ay = _mm_set1_ps(_arcY);
+    __m128 const facingX = _mm_set1_ps(_facingX);
+    __m128 const facingY = _mm_set1_ps(_facingY);
+    __m128 const arcCos = _mm_set1_ps(_arcCos);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(xs + i);
+        __m128 y = _mm_loadu_ps(ys + i);
+        __m128 dx = _mm_sub_ps(x, cx);
+        __m128 dy = _mm_sub_ps(y, cy);
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(zs + i), cz);
+        __m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        __m128 maxDist = _mm_add_ps(radius, _mm_mul_ps(_mm_loadu_ps(reaches + i), reachFactor));
+        __m128 maxDistSq = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(maxDist, maxDist), radiusTolerance), distanceTolerance);
+        __m128 pass = _mm_cmple_ps(distSq, maxDistSq);
+
+        if (_hasArc)
+        {
+            __m128 arcDx = _mm_sub_ps(x, ax);
+            __m128 arcDy = _mm_sub_ps(y, ay);
+            __m128 dot = _mm_add_ps(_mm_mul_ps(arcDx, facingX), _mm_mul_ps(arcDy, facingY));
+            __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(arcDx, arcDx), _mm_mul_ps(arcDy, arcDy)));
+            __m128 minDot = _mm_sub_ps(_mm_mul_ps(length, arcCos), distanceTolerance);
+            pass = _mm_and_ps(pass, _mm_cmpge_ps(dot, minDot));
+        }
+
+        int mask = _mm_movemask_ps(pass);
+        while (mask)
+        {
+            int lane = 0;
+            while (!(mask & (1 << lane)))
+                ++lane;
+
+            survivors.push_back(i + lane);
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+        if (Passes(xs[i], ys[i], zs[i], reaches[i]))
+            survivors.push_back(i);
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2008-2016 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_SPATIALFILTER_H
+#define TRINITY_SPATIALFILTER_H
+
+#include "Define.h"
+#include <vector>
+
+namespace Trinity
+{
+    struct ContainerPositions;
+
+    typedef std::vector<uint32> SpatialFilterResult;
+
+    /*
+     * Coarse test run over the position mirror of a grid container before the
+     * exact checks. It only rejects what the exact check would reject as well,
+     * so survivors still go through the check functor.
+     */
+    class SpatialFilter
+    {
+    public:
+        // everything passes
+        SpatialFilter();
+        // sphere around x, y, z, the reach of each object is added to the radius if allowObjectSize
+        SpatialFilter(float x, float y, float z, float radius, bool allowObjectSize);
+
+        // only keep objects inside the arc in front of x, y facing orientation
+        void SetFrontArc(float x, float y, float orientation, float arc);
+
+        void Filter(ContainerPositions const& positions, SpatialFilterResult& survivors) const;
+
+    private:
+        bool Passes(float x, float y, float z, float reach) const;
+
+        bool _enabled;
+        float _x, _y, _z;
+        float _radius;
+        float _reachFactor;
+
+        bool _hasArc;
+        float _arcX, _arcY;
+        float _facingX, _facingY;
+        float _arcCos;
+    };
+}
+
+#endif
@@ -1867,6 +1867,7 @@ void Group::BroadcastAddonMessagePacket(WorldPacket const* packet, std::string c
 
 void Group::BroadcastPacket(const WorldPacket* packet, bool ignorePlayersInBGRaid, int group, ObjectGuid ignore)
 {
+    ::BroadcastPacket shared(packet);
     for (GroupReference* itr = GetFirstMember(); itr != nullptr; itr = itr->next())
     {
         Player* player = itr->getSource();
@@ -1874,7 +1875,7 @@ void Group::BroadcastPacket(const WorldPacket* packet, bool ignorePlayersInBGRai
             continue;
 
         if (group == -1 || itr->getSubGroup() == group)
-            player->SendDirectMessage(packet);
+            player->SendDirectMessage(shared.Share());
     }
 }
 
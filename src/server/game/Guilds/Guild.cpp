@@ -2974,25 +2974,28 @@ void Guild::BroadcastAddonToGuild(WorldSession* session, bool officerOnly, std::
 
 void Guild::BroadcastPacketToRank(WorldPacket const* packet, uint8 rankId) const
 {
+    ::BroadcastPacket shared(packet);
     for (const auto& member : m_members)
         if (member.second->IsRank(rankId))
             if (Player* player = member.second->FindPlayer())
-                player->SendDirectMessage(packet);
+                player->SendDirectMessage(shared.Share());
 }
 
 void Guild::BroadcastPacket(WorldPacket const* packet) const
 {
+    ::BroadcastPacket shared(packet);
     for (const auto& member : m_members)
         if (Player* player = member.second->FindPlayer())
-            player->SendDirectMessage(packet);
+            player->SendDirectMessage(shared.Share());
 }
 
 void Guild::BroadcastPacketIfTrackingAchievement(WorldPacket const* packet, uint32 criteriaId) const
 {
+    ::BroadcastPacket shared(packet);
     for (auto const& v : m_members)
         if (v.second->IsTrackingCriteriaId(criteriaId))
             if (Player* player = v.second->FindPlayer())
-                player->SendDirectMessage(packet);
+                player->SendDirectMessage(shared.Share());
 }
 
 void Guild::MassInviteToEvent(WorldSession* session, uint32 minLevel, uint32 maxLevel, uint32 minRank)
@@ -27,6 +27,7 @@
 #include "ObjectMgr.h"
 #include "GlobalFunctional.h"
 #include "ScriptMgr.h"
+#include "WhoListStorage.h"
 
 void WorldSession::HandleWhoOpcode(WorldPackets::Who::WhoRequestPkt& whoRequest)
 {
@@ -65,72 +66,70 @@ void WorldSession::HandleWhoOpcode(WorldPackets::Who::WhoRequestPkt& whoRequest)
     bool allowTwoSideWhoList = sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_WHO_LIST);
     uint32 gmLevelInWhoList  = sWorld->getIntConfig(CONFIG_GM_LEVEL_IN_WHO_LIST);
     uint8 displaycount = 0;
-    Player* target = nullptr;
 
     WorldPackets::Who::WhoResponsePkt response;
 
     std::set<ObjectGuid> playerGuids{};
-    HashMapHolder<Player>::GetLock().lock_shared();
 
-    HashMapHolder<Player>::MapType const& m = sObjectAccessor->GetPlayers();
-    for (HashMapHolder<Player>::MapType::const_iterator itr = m.begin(); itr != m.end(); ++itr)
+    // filtered against the periodically rebuilt snapshot, /who never takes the player storage lock
+    std::shared_ptr<WhoListSnapshot const> snapshot = sWhoListStorageMgr->GetSnapshot();
+    if (!snapshot)
     {
-        target = itr->second;
+        SendPacket(response.Write());
+        return;
+    }
+
+    WhoListSnapshot::RowList const* candidates = snapshot->FindCandidates(snapshot->NameIndex, wPlayerName);
+    if (!candidates)
+        candidates = snapshot->FindCandidates(snapshot->GuildIndex, wGuildName);
+
+    uint32 candidateCount = candidates ? uint32(candidates->size()) : snapshot->GetRowCount();
+    for (uint32 i = 0; i < candidateCount; ++i)
+    {
+        uint32 row = candidates ? (*candidates)[i] : i;
         if (AccountMgr::IsPlayerAccount(security))
         {
-            if (target->GetTeam() != team && !allowTwoSideWhoList)
+            if (snapshot->Teams[row] != team && !allowTwoSideWhoList)
                 continue;
 
-            if (target->GetSession()->GetSecurity() > AccountTypes(gmLevelInWhoList))
+            if (snapshot->Security[row] > gmLevelInWhoList)
                 continue;
         }
 
-        if (!target || !target->IsInWorld())
-            continue;
-
-        if (!target->IsVisibleGloballyFor(_player))
+        if (!snapshot->IsVisibleGloballyFor(row, _player->GetGUID(), uint8(security)))
             continue;
 
-        uint8 lvl = target->getLevel();
+        uint8 lvl = snapshot->Levels[row];
         if (lvl < request.MinLevel || lvl > request.MaxLevel)
             continue;
 
-        if (request.ClassFilter >= 0 && !(request.ClassFilter & (1 << target->getClass())))
+        if (request.ClassFilter >= 0 && !(request.ClassFilter & (1 << snapshot->Classes[row])))
             continue;
 
-        if (request.RaceFilter >= 0 && !(request.RaceFilter & (SI64LIT(1) << target->getRace())))
+        if (request.RaceFilter >= 0 && !(request.RaceFilter & (SI64LIT(1) << snapshot->Races[row])))
             continue;
 
+        int32 zoneId = snapshot->Zones[row];
         if (!whoRequest.Areas.empty())
         {
-            if (std::find(whoRequest.Areas.begin(), whoRequest.Areas.end(), target->GetCurrentZoneID()) == whoRequest.Areas.end())
+            if (std::find(whoRequest.Areas.begin(), whoRequest.Areas.end(), zoneId) == whoRequest.Areas.end())
                 continue;
         }
 
-        std::wstring wTargetName;
-
-        if (!Utf8toWStr(target->GetName(), wTargetName))
-            continue;
-
-        wstrToLower(wTargetName);
-
+        std::wstring const& wTargetName = snapshot->Names[row];
         if (!wPlayerName.empty() && wTargetName.find(wPlayerName) == std::wstring::npos)
             continue;
 
-        std::string gname = target->GetGuildName();
-        std::wstring wTargetGuildName;
-        if (!Utf8toWStr(gname, wTargetGuildName))
-            continue;
-
-        wstrToLower(wTargetGuildName);
+        std::wstring const& wTargetGuildName = snapshot->GuildNames[row];
         if (!wGuildName.empty() && wTargetGuildName.find(wGuildName) == std::wstring::npos)
             continue;
 
         if (!wWords.empty())
         {
-            std::string aName;
-            if (AreaTableEntry const* areaEntry = sAreaTableStore.LookupEntry(target->GetCurrentZoneID()))
-                aName = areaEntry->AreaName->Str[sObjectMgr->GetDBCLocaleIndex()];
+            std::wstring const* wAreaName = nullptr;
+            auto areaName = snapshot->ZoneNames.find(zoneId);
+            if (areaName != snapshot->ZoneNames.end())
+                wAreaName = &areaName->second;
 
             bool show = false;
             for (size_t i = 0; i < wWords.size(); ++i)
@@ -139,7 +138,7 @@ void WorldSession::HandleWhoOpcode(WorldPackets::Who::WhoRequestPkt& whoRequest)
                 {
                     if (wTargetName.find(wWords[i]) != std::wstring::npos ||
                         wTargetGuildName.find(wWords[i]) != std::wstring::npos ||
-                        Utf8FitTo(aName, wWords[i]))
+                        (wAreaName && wAreaName->find(wWords[i]) != std::wstring::npos))
                     {
                         show = true;
                         break;
@@ -152,21 +151,20 @@ void WorldSession::HandleWhoOpcode(WorldPackets::Who::WhoRequestPkt& whoRequest)
         }
 
         WorldPackets::Who::WhoEntry whoEntry;
-        if (!whoEntry.PlayerData.Initialize(target->GetGUID(), target))
-            continue;
+        whoEntry.PlayerData = snapshot->PlayerData[row];
 
-        if (Guild* targetGuild = target->GetGuild())
+        if (!snapshot->GuildGuids[row].IsEmpty())
         {
-            whoEntry.GuildGUID = targetGuild->GetGUID();
+            whoEntry.GuildGUID = snapshot->GuildGuids[row];
             whoEntry.GuildVirtualRealmAddress = GetVirtualRealmAddress();
-            whoEntry.GuildName = targetGuild->GetName();
+            whoEntry.GuildName = snapshot->GuildDisplayNames[row];
         }
 
-        whoEntry.AreaID = target->GetCurrentZoneID();
-        whoEntry.IsGM = target->isGameMaster();
+        whoEntry.AreaID = zoneId;
+        whoEntry.IsGM = (snapshot->Flags[row] & WHO_ROW_FLAG_GAMEMASTER) != 0;
 
         response.Response.Entries.push_back(whoEntry);
-        playerGuids.insert(target->GetGUID());
+        playerGuids.insert(snapshot->Guids[row]);
 
         if ((displaycount++) >= sWorld->getIntConfig(CONFIG_MAX_WHO))
         {
@@ -175,7 +173,6 @@ void WorldSession::HandleWhoOpcode(WorldPackets::Who::WhoRequestPkt& whoRequest)
             continue;
         }
     }
-    HashMapHolder<Player>::GetLock().unlock_shared();
 
     sScriptMgr->OnPlayerWhoListCall(_player, playerGuids);
     SendPacket(response.Write());
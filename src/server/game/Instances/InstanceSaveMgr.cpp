@@ -34,6 +34,16 @@
 #include "Group.h"
 #include "InstanceScript.h"
 #include "ScenarioMgr.h"
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+    // (map, difficulty) pairs per set based DELETE/UPDATE of a global reset
+    std::size_t const GlobalResetMapsPerStatement = 100;
+    // saves looked at between two checks of the time budget
+    uint32 const GlobalResetSavesPerSlice = 32;
+}
 
 InstanceSaveManager::InstanceSaveManager(): lock_instLists(false)
 {
@@ -192,7 +202,7 @@ void InstanceSaveManager::UnloadInstanceSave(uint32 InstanceId)
 
 InstanceSave::InstanceSave(uint16 MapId, uint32 InstanceId, Difficulty difficulty, uint32 completedEncounter, std::string data, time_t resetTime, bool canReset)
 : m_instanceid(InstanceId), m_mapid(MapId), m_difficulty(difficulty), m_canReset(canReset), m_toDelete(false),
-m_perm(false), m_extended(false), m_completedEncounter(completedEncounter), m_data(std::move(data)), m_resetTime(resetTime)
+m_perm(false), m_extended(false), m_expired(false), m_completedEncounter(completedEncounter), m_data(std::move(data)), m_resetTime(resetTime)
 {
     m_canBeSave = difficulty != DIFFICULTY_LFR && difficulty != DIFFICULTY_HC_SCENARIO && difficulty != DIFFICULTY_N_SCENARIO && difficulty != DIFFICULTY_LFR_RAID;
 }
@@ -243,10 +253,11 @@ bool InstanceSave::RemovePlayer(Player* player)
     _playerListLock.lock();
     m_playerList.remove(player);
     bool isStillValid = UnloadIfEmpty();
+    bool deleteSave = m_toDelete;
     _playerListLock.unlock();
 
     //delete here if needed, after releasing the lock
-    if (m_toDelete)
+    if (deleteSave)
         delete this;
 
     return isStillValid;
@@ -277,6 +288,10 @@ bool InstanceSave::UnloadIfEmpty()
 {
     if (m_playerList.empty() && m_groupList.empty())
     {
+        // expired saves are no longer in the manager, it deletes them on the world thread once unbound
+        if (m_expired)
+            return false;
+
         // don't remove the save if there are still players inside the map
         if (Map* map = sMapMgr->FindMap(GetMapId(), GetInstanceId()))
             if (map->HavePlayers())
@@ -349,6 +364,7 @@ void InstanceSaveManager::ScheduleReset(bool add, time_t time, InstResetEvent ev
             if (itr->second == event)
             {
                 m_resetTimeQueue.erase(itr);
+                _resetTimeLock.unlock();
                 return;
             }
         }
@@ -361,6 +377,7 @@ void InstanceSaveManager::ScheduleReset(bool add, time_t time, InstResetEvent ev
                 if (itr->second == event)
                 {
                     m_resetTimeQueue.erase(itr);
+                    _resetTimeLock.unlock();
                     return;
                 }
             }
@@ -374,10 +391,35 @@ void InstanceSaveManager::ScheduleReset(bool add, time_t time, InstResetEvent ev
     _resetTimeLock.unlock();
 }
 
+void InstanceSaveManager::_DeleteExpiredSaves()
+{
+    for (std::vector<InstanceSave*>::iterator itr = m_expiredSaves.begin(); itr != m_expiredSaves.end();)
+    {
+        InstanceSave* save = *itr;
+
+        save->_playerListLock.lock();
+        save->_groupListLock.lock();
+        bool unbound = save->m_playerList.empty() && save->m_groupList.empty();
+        save->_groupListLock.unlock();
+        save->_playerListLock.unlock();
+
+        // nothing can bind an expired save again, so once unbound nobody else touches it
+        if (unbound)
+        {
+            delete save;
+            itr = m_expiredSaves.erase(itr);
+        }
+        else
+            ++itr;
+    }
+}
+
 void InstanceSaveManager::Update()
 {
     time_t now = time(nullptr);
 
+    _DeleteExpiredSaves();
+
     _resetTimeLock.lock();
     while (!m_resetTimeQueue.empty())
     {
@@ -394,6 +436,8 @@ void InstanceSaveManager::Update()
         }
     }
     _resetTimeLock.unlock();
+
+    _UpdateGlobalResets();
 }
 
 void InstanceSaveManager::_ResetSave(InstanceSaveHashMap::iterator &itr)
@@ -426,6 +470,49 @@ void InstanceSaveManager::_ResetSave(InstanceSaveHashMap::iterator &itr)
     lock_instLists = false;
 }
 
+void InstanceSaveManager::_ExpireSave(InstanceSaveHashMap::iterator &itr, GlobalReset& reset)
+{
+    InstanceSave* save = itr->second;
+    uint32 mapId = save->GetMapId();
+    Difficulty difficulty = save->GetDifficultyID();
+
+    // groups are cheap to unbind, do not allow UnbindInstance to unload the save meanwhile
+    lock_instLists = true;
+    while (!save->m_groupList.empty())
+        save->m_groupList.front()->UnbindInstance(mapId, difficulty, true);
+    lock_instLists = false;
+
+    _instanceSaveLock.lock();
+    m_instanceSaveById.erase(itr++);
+    _instanceSaveLock.unlock();
+
+    ++reset.SavesReset;
+
+    save->_playerListLock.lock();
+    save->m_expired = true;
+    InstanceSave::PlayerListType players = save->m_playerList;
+    save->_playerListLock.unlock();
+
+    if (players.empty())
+    {
+        delete save;
+        return;
+    }
+
+    // online players drop the bind on their own map thread, _DeleteExpiredSaves picks the save up afterwards
+    m_expiredSaves.push_back(save);
+    for (Player* player : players)
+    {
+        player->AddDelayedEvent(100, [player, mapId, difficulty]() -> void
+        {
+            // looking the bind up unbinds expired saves
+            player->GetBoundInstance(mapId, difficulty);
+        });
+    }
+
+    reset.PlayersNotified += uint32(players.size());
+}
+
 void InstanceSaveManager::_ResetInstance(uint32 mapid, uint32 instanceId)
 {
     // TC_LOG_DEBUG(LOG_FILTER_SERVER_LOADING, "InstanceSaveMgr::_ResetInstance mapid %u, instanceId %u", mapid, instanceId);
@@ -451,70 +538,176 @@ void InstanceSaveManager::_ResetInstance(uint32 mapid, uint32 instanceId)
         Map::DeleteRespawnTimesInDB(mapid, instanceId);
 }
 
-void InstanceSaveManager::ResetOrWarnAll(uint32 mapid, Difficulty difficulty, SQLTransaction& trans)
+void InstanceSaveManager::QueueGlobalReset(std::string const& name, std::vector<MapDifficultyKey> const& maps)
+{
+    GlobalReset reset;
+    reset.Name = name;
+    reset.Time = time(nullptr);
+    reset.StartTime = getMSTime();
+
+    for (MapDifficultyKey const& key : maps)
+    {
+        MapEntry const* mapEntry = sMapStore.LookupEntry(key.first);
+        if (!mapEntry || !mapEntry->Instanceable() || key.second == DIFFICULTY_LFR || key.second == DIFFICULTY_HC_SCENARIO || key.second == DIFFICULTY_N_SCENARIO || key.second == DIFFICULTY_LFR_RAID)
+            continue;
+
+        if (reset.Maps.insert(key).second && (reset.MapIds.empty() || reset.MapIds.back() != key.first))
+            reset.MapIds.push_back(key.first);
+    }
+
+    if (reset.Maps.empty())
+        return;
+
+    // maps come grouped from the difficulty store, drop what grouping missed
+    std::sort(reset.MapIds.begin(), reset.MapIds.end());
+    reset.MapIds.erase(std::unique(reset.MapIds.begin(), reset.MapIds.end()), reset.MapIds.end());
+
+    TC_LOG_INFO(LOG_FILTER_GENERAL, "InstanceSaveManager: %s reset of %u maps queued", name.c_str(), uint32(reset.Maps.size()));
+
+    std::lock_guard<std::mutex> lock(_globalResetLock);
+    _globalResets.push_back(std::move(reset));
+}
+
+bool InstanceSaveManager::GetGlobalResetProgress(GlobalReset& current, GlobalReset& last)
 {
-    // global reset for all instances of the given map
-    MapEntry const* mapEntry = sMapStore.LookupEntry(mapid);
-    if (!mapEntry || !mapEntry->Instanceable() || difficulty == DIFFICULTY_LFR || difficulty == DIFFICULTY_HC_SCENARIO || difficulty == DIFFICULTY_N_SCENARIO || difficulty == DIFFICULTY_LFR_RAID)
+    std::lock_guard<std::mutex> lock(_globalResetLock);
+    last = _lastGlobalReset;
+    if (_globalResets.empty())
+        return false;
+
+    current = _globalResets.front();
+    current.Duration = GetMSTimeDiffToNow(current.StartTime);
+    return true;
+}
+
+void InstanceSaveManager::_UpdateGlobalResets()
+{
+    std::lock_guard<std::mutex> lock(_globalResetLock);
+    if (_globalResets.empty())
         return;
 
-    // remove all binds to instances of the given map
-    for (InstanceSaveHashMap::iterator itr = m_instanceSaveById.begin(); itr != m_instanceSaveById.end();)
+    uint32 start = getMSTime();
+    uint32 budget = sWorld->getIntConfig(CONFIG_INSTANCE_RESET_UPDATE_BUDGET);
+
+    GlobalReset& reset = _globalResets.front();
+    ++reset.Ticks;
+    do
+        _AdvanceGlobalReset(reset);
+    while (reset.CurrentStage != GlobalReset::STAGE_DONE && GetMSTimeDiffToNow(start) < budget);
+
+    reset.BusyTime += GetMSTimeDiffToNow(start);
+    if (reset.CurrentStage != GlobalReset::STAGE_DONE)
+        return;
+
+    reset.Duration = GetMSTimeDiffToNow(reset.StartTime);
+    TC_LOG_INFO(LOG_FILTER_GENERAL, "InstanceSaveManager: %s reset done in %u ms (%u ms busy over %u updates), %u saves scanned, %u reset, %u extensions ended, %u players notified, %u maps",
+        reset.Name.c_str(), reset.Duration, reset.BusyTime, reset.Ticks, reset.SavesScanned, reset.SavesReset, reset.SavesExtended, reset.PlayersNotified, reset.MapsReset);
+
+    _lastGlobalReset = std::move(reset);
+    _globalResets.pop_front();
+}
+
+void InstanceSaveManager::_AdvanceGlobalReset(GlobalReset& reset)
+{
+    switch (reset.CurrentStage)
     {
-        if (itr->second && itr->second->GetMapId() == mapid && itr->second->GetDifficultyID() == difficulty)
+        case GlobalReset::STAGE_DATABASE:
+            // delete them from the DB first, even if not loaded
+            _DeleteGlobalResetBinds(reset);
+            reset.CurrentStage = GlobalReset::STAGE_SAVES;
+            break;
+        case GlobalReset::STAGE_SAVES:
         {
-            if (itr->second->GetExtended())
+            InstanceSaveHashMap::iterator itr = m_instanceSaveById.lower_bound(reset.NextInstanceId);
+            for (uint32 i = 0; i < GlobalResetSavesPerSlice && itr != m_instanceSaveById.end(); ++i)
             {
-                itr->second->SetExtended(false);
-                ++itr;
+                InstanceSave* save = itr->second;
+                reset.NextInstanceId = itr->first + 1;
+                ++reset.SavesScanned;
+
+                if (!save || !reset.Maps.count(MapDifficultyKey(save->GetMapId(), save->GetDifficultyID())))
+                {
+                    ++itr;
+                    continue;
+                }
+
+                if (save->GetExtended())
+                {
+                    save->SetExtended(false);
+                    ++reset.SavesExtended;
+                    ++itr;
+                }
+                else if ((save->GetResetTime() + MONTH) <= reset.Time)
+                    _ExpireSave(itr, reset);
+                else
+                    ++itr;
             }
-            else if ((itr->second->GetResetTime() + MONTH) <= time(nullptr))
-                _ResetSave(itr);
-            else
-                ++itr;
 
-            // TC_LOG_DEBUG(LOG_FILTER_SERVER_LOADING, "InstanceSaveMgr::ResetOrWarnAll mapid %u, difficulty %u time %u GetResetTime %u", mapid, difficulty, time(NULL), (itr->second->GetResetTime() + MONTH));
+            if (itr == m_instanceSaveById.end())
+                reset.CurrentStage = GlobalReset::STAGE_MAPS;
+            break;
         }
-        else
-            ++itr;
+        case GlobalReset::STAGE_MAPS:
+        {
+            // one base map per step, the instances of the map are only flagged for reset
+            if (reset.NextMap < reset.MapIds.size())
+            {
+                if (MapInstanced* map = dynamic_cast<MapInstanced*>(sMapMgr->FindBaseMap(reset.MapIds[reset.NextMap])))
+                {
+                    for (auto& instMap : map->GetInstancedMaps())
+                    {
+                        if (!instMap.second->IsDungeon())
+                            continue;
+
+                        dynamic_cast<InstanceMap*>(instMap.second)->Reset(INSTANCE_RESET_GLOBAL);
+                        ++reset.MapsReset;
+                    }
+                }
+
+                ++reset.NextMap;
+            }
+
+            if (reset.NextMap >= reset.MapIds.size())
+                reset.CurrentStage = GlobalReset::STAGE_DONE;
+            break;
+        }
+        default:
+            break;
     }
 
-    // delete them from the DB, even if not loaded
-    PreparedStatement* stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_CHAR_INSTANCE_BY_MAP_DIFF);
-    stmt->setUInt16(0, uint16(mapid));
-    stmt->setUInt8(1, uint8(difficulty));
-    stmt->setUInt32(2, time(nullptr));
-    trans->Append(stmt);
-
-    stmt = CharacterDatabase.GetPreparedStatement(CHAR_DEL_GROUP_INSTANCE_BY_MAP_DIFF);
-    stmt->setUInt16(0, uint16(mapid));
-    stmt->setUInt8(1, uint8(difficulty));
-    trans->Append(stmt);
-
-    uint32 resetTime = 0;
-    if (MapDifficultyEntry const* mapDiff = sDB2Manager.GetMapDifficultyData(mapid, difficulty))
-        resetTime = sWorld->getInstanceResetTime(mapDiff->GetRaidDuration());
-
-    stmt = CharacterDatabase.GetPreparedStatement(CHAR_UPD_CHAR_INSTANCE_EXTENDED);
-    stmt->setUInt32(0, resetTime);
-    stmt->setUInt16(1, uint16(mapid));
-    stmt->setUInt8(2, uint8(difficulty));
-    trans->Append(stmt);
-
-    // note: this isn't fast but it's meant to be executed very rarely
-    Map const* map = sMapMgr->CreateBaseMap(mapid);          // _not_ include difficulty
-    InstancedMaps &instMaps = ((MapInstanced*)map)->GetInstancedMaps();
-
-    for (auto & instMap : instMaps)
+    // TODO: delete creature/gameobject respawn times even if the maps are not loaded
+}
+
+void InstanceSaveManager::_DeleteGlobalResetBinds(GlobalReset const& reset)
+{
+    // extended binds get the reset time of their map, group the maps by it so every
+    // statement below covers many maps instead of one statement per map and difficulty
+    std::map<uint32, std::vector<MapDifficultyKey>> mapsByResetTime;
+    for (MapDifficultyKey const& key : reset.Maps)
     {
-        Map* map2 = instMap.second;
-        if (!map2->IsDungeon())
-            continue;
+        uint32 resetTime = 0;
+        if (MapDifficultyEntry const* mapDiff = sDB2Manager.GetMapDifficultyData(key.first, key.second))
+            resetTime = sWorld->getInstanceResetTime(mapDiff->GetRaidDuration());
 
-        dynamic_cast<InstanceMap*>(map2)->Reset(INSTANCE_RESET_GLOBAL);
+        mapsByResetTime[resetTime].push_back(key);
     }
 
-    // TODO: delete creature/gameobject respawn times even if the maps are not loaded
+    SQLTransaction trans = CharacterDatabase.BeginTransaction();
+    for (auto const& group : mapsByResetTime)
+    {
+        for (std::size_t first = 0; first < group.second.size(); first += GlobalResetMapsPerStatement)
+        {
+            std::ostringstream maps;
+            for (std::size_t i = first; i < group.second.size() && i < first + GlobalResetMapsPerStatement; ++i)
+                maps << (i != first ? "," : "") << '(' << group.second[i].first << ',' << uint32(group.second[i].second) << ')';
+
+            std::string mapList = maps.str();
+            trans->PAppend("DELETE FROM character_instance WHERE (map, difficulty) IN (%s) AND Extended = 0 AND (resetTime + %u) <= %u", mapList.c_str(), uint32(MONTH), uint32(reset.Time));
+            trans->PAppend("DELETE FROM group_instance WHERE (map, difficulty) IN (%s)", mapList.c_str());
+            trans->PAppend("UPDATE character_instance SET Extended = 0, resetTime = %u WHERE (map, difficulty) IN (%s) AND Extended = 1", group.first, mapList.c_str());
+        }
+    }
+    CharacterDatabase.CommitTransaction(trans);
 }
 
 uint32 InstanceSaveManager::GetNumBoundPlayersTotal()
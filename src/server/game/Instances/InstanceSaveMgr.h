@@ -22,6 +22,10 @@
 #include "DBCEnums.h"
 #include "ObjectDefines.h"
 #include <safe_ptr.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <set>
 
 struct InstanceTemplate;
 struct MapEntry;
@@ -100,6 +104,10 @@ class InstanceSave
 
         bool SaveIsOld() const { return m_resetTime && m_resetTime <= time(nullptr); }
 
+        /* reset by a daily or weekly reset while players were still bound,
+           their binds are dropped the next time they are looked up */
+        bool IsExpired() const { return m_expired.load(std::memory_order_acquire); }
+
         /* currently it is possible to omit this information from this structure
            but that would depend on a lot of things that can easily change in future */
         Difficulty GetDifficultyID() const { return m_difficulty; }
@@ -125,6 +133,7 @@ class InstanceSave
         bool m_canBeSave;
         bool m_perm;
         bool m_extended;
+        std::atomic<bool> m_expired;                // set on the world thread, read by the map threads of bound players
         uint32 m_completedEncounter;
         std::string m_data;
         time_t m_resetTime;
@@ -160,6 +169,39 @@ class InstanceSaveManager
         };
         typedef std::multimap<time_t /*resetTime*/, InstResetEvent> ResetTimeQueue;
 
+        typedef std::pair<uint32 /*mapId*/, Difficulty> MapDifficultyKey;
+
+        /* daily and weekly resets of every instance of the given maps, worked off
+           a slice per Update (Instance.ResetUpdateBudget) */
+        struct GlobalReset
+        {
+            enum Stage
+            {
+                STAGE_DATABASE,
+                STAGE_SAVES,
+                STAGE_MAPS,
+                STAGE_DONE
+            };
+
+            std::string Name;
+            std::set<MapDifficultyKey> Maps;
+            time_t Time = 0;
+            Stage CurrentStage = STAGE_DATABASE;
+            uint32 NextInstanceId = 0;                      // saves are walked in instance id order
+            std::vector<uint32> MapIds;
+            uint32 NextMap = 0;
+
+            uint32 SavesScanned = 0;
+            uint32 SavesReset = 0;
+            uint32 SavesExtended = 0;
+            uint32 PlayersNotified = 0;
+            uint32 MapsReset = 0;
+            uint32 StartTime = 0;
+            uint32 Duration = 0;
+            uint32 BusyTime = 0;
+            uint32 Ticks = 0;
+        };
+
         void LoadInstances();
 
         void ScheduleReset(bool add, time_t time, InstResetEvent event);
@@ -177,18 +219,29 @@ class InstanceSaveManager
         uint32 GetNumInstanceSaves() { return m_instanceSaveById.size(); }
         uint32 GetNumBoundPlayersTotal();
         uint32 GetNumBoundGroupsTotal();
-        void ResetOrWarnAll(uint32 mapid, Difficulty difficulty, SQLTransaction& trans);
+        void QueueGlobalReset(std::string const& name, std::vector<MapDifficultyKey> const& maps);
+        /* false when no reset is running, last is the previous finished one (empty Name if none) */
+        bool GetGlobalResetProgress(GlobalReset& current, GlobalReset& last);
 
         void UnloadAll();
 
     private:
         void _ResetInstance(uint32 mapid, uint32 instanceId);
         void _ResetSave(InstanceSaveHashMap::iterator &itr);
+        void _ExpireSave(InstanceSaveHashMap::iterator &itr, GlobalReset& reset);
+        void _UpdateGlobalResets();
+        void _AdvanceGlobalReset(GlobalReset& reset);
+        void _DeleteGlobalResetBinds(GlobalReset const& reset);
+        void _DeleteExpiredSaves();
         bool lock_instLists;
         InstanceSaveHashMap m_instanceSaveById;
+        std::vector<InstanceSave*> m_expiredSaves;      // out of m_instanceSaveById, deleted once their last player unbound
         ResetTimeQueue m_resetTimeQueue;
         sf::contention_free_shared_mutex< > _resetTimeLock;
         sf::contention_free_shared_mutex< > _instanceSaveLock;
+        std::deque<GlobalReset> _globalResets;
+        GlobalReset _lastGlobalReset;
+        std::mutex _globalResetLock;
 };
 
 #define sInstanceSaveMgr InstanceSaveManager::instance()
@@ -84,11 +84,19 @@ class LootTemplate::LootGroup                               // A set of loot def
         LootStoreItemList* GetExplicitlyChancedItemList() { return &ExplicitlyChanced; }
         LootStoreItemList* GetEqualChancedItemList() { return &EqualChanced; }
         void CopyConditions(ConditionList conditions);
+        void Compile();                                     // Builds the alias table of the explicitly chanced entries (after loading)
         LootStoreItemList ExplicitlyChanced;                // Entries with chances defined in DB
         LootStoreItemList EqualChanced;                     // Zero chances - every entry takes the same chance
 
     private:
         LootStoreItem const* Roll() const;                 // Rolls an item from the group, returns NULL if all miss their chances
+        uint32 RollExplicitIndex() const;                   // Index of the rolled explicitly chanced entry, ExplicitlyChanced.size() if all miss
+        bool AddRolledItem(Loot& loot, LootTemplate const* tab, LootStoreItem const& item) const; // False if the rolled entry may not drop
+
+        // Alias table over the explicitly chanced entries and a last slot for "all miss", one uniform roll picks an entry
+        // with the same odds as walking the entries and subtracting their chances from a 0-100 roll
+        std::vector<float> _aliasChance;
+        std::vector<uint32> _alias;
 };
 
 //Remove all data and free all memory
@@ -187,6 +195,9 @@ uint32 LootStore::LoadLootTable()
     }
     while (result->NextRow());
 
+    for (LootTemplateMap::const_iterator tab = m_LootTemplates.begin(); tab != m_LootTemplates.end(); ++tab)
+        tab->second->Compile();
+
     Verify();                                           // Checks validity of the loot store
 
     return count;
@@ -273,15 +284,20 @@ type(_type), group(_group), needs_quest(_chanceOrQuestChance < 0)
 }
 // Checks if the entry (quest, non-quest, reference) takes it's chance (at loot generation)
 // RATE_DROP_ITEMS is no longer used for all types of entries
-bool LootStoreItem::Roll(bool rate, bool isDungeon /* = false*/, bool isZoneLoot) const
+bool LootStoreItem::Roll(bool rate, bool isDungeon /* = false*/, bool isZoneLoot, double roll) const
 {
     // TC_LOG_DEBUG(LOG_FILTER_LOOT, "LootStoreItem::Roll chance %f rate %u mincountOrRef %i type %i itemid %u", chance, rate, mincountOrRef, type, itemid);
 
     if (chance >= 100.0f)
         return true;
 
+    auto takesChance = [roll](float value) -> bool
+    {
+        return roll < 0.0 ? roll_chance_f(value) : value > roll;
+    };
+
     if (mincountOrRef < 0)                                   // reference case
-        return roll_chance_f(chance * (rate ? sWorld->getRate(RATE_DROP_ITEM_REFERENCED) : 1.0f));
+        return takesChance(chance * (rate ? sWorld->getRate(RATE_DROP_ITEM_REFERENCED) : 1.0f));
 
     if (type == LOOT_ITEM_TYPE_ITEM)
     {
@@ -294,14 +310,14 @@ bool LootStoreItem::Roll(bool rate, bool isDungeon /* = false*/, bool isZoneLoot
         if (isDungeon && sWorld->getBoolConfig(CONFIG_DROP_DUNGEON_ONLY_X1))
             qualityModifier = 1.0f;
 
-        return roll_chance_f(chance * qualityModifier);
+        return takesChance(chance * qualityModifier);
     }
     if (type == LOOT_ITEM_TYPE_CURRENCY)
     {
         if (isDungeon && sWorld->getBoolConfig(CONFIG_DROP_DUNGEON_ONLY_X1))
-            return roll_chance_f(chance * 1.0f);
+            return takesChance(chance * 1.0f);
         else
-            return roll_chance_f(chance * (rate ? sWorld->getRate(RATE_DROP_CURRENCY) : 1.0f));
+            return takesChance(chance * (rate ? sWorld->getRate(RATE_DROP_CURRENCY) : 1.0f));
     }
 
     return false;
@@ -734,6 +750,8 @@ bool Loot::FillLoot(uint32 lootId, LootStore const& store, Player* lootOwner, bo
     if (!lootOwner || !lootOwner->CanContact())
         return false;
 
+    ++World::LootFillCount;
+
     Creature* creature = nullptr;
     GameObject* go = nullptr;
     if (lootFrom)
@@ -989,6 +1007,36 @@ void Loot::FillNotNormalLootFor(Player* player, bool presentAtLooting)
         }
 }
 
+void Loot::SetPendingLoot(uint32 lootId, LootStore const& store, ObjectGuid const& lootOwner)
+{
+    _pendingStore = &store;
+    _pendingLootId = lootId;
+    _pendingOwner = lootOwner;
+    isClear = false;
+
+    ++World::LootDeferredCount;
+}
+
+void Loot::FillPendingLoot(Player* accessor, WorldObject const* lootFrom)
+{
+    if (!_pendingStore)
+        return;
+
+    // the killer rolls only while near the corpse, by the same distance rule as group loot
+    Player* lootOwner = ObjectAccessor::GetPlayer(*lootFrom, _pendingOwner);
+    if (!lootOwner || !lootOwner->IsAtGroupRewardDistance(lootFrom))
+        lootOwner = accessor;
+
+    // FillLoot would refuse this owner without rolling, keep the loot pending for the next access
+    if (!lootOwner || !lootOwner->CanContact())
+        return;
+
+    LootStore const& store = *_pendingStore;
+    _pendingStore = nullptr;
+
+    FillLoot(_pendingLootId, store, lootOwner, false, false, lootFrom);
+}
+
 void Loot::clear()
 {
     //If loot not generate or already clear
@@ -997,6 +1045,12 @@ void Loot::clear()
 
     isClear = true;
 
+    if (_pendingStore)
+    {
+        _pendingStore = nullptr;
+        ++World::LootDeferredDropCount;
+    }
+
     if(!PlayerCurrencies.empty())
     {
         for (QuestItemMap::const_iterator itr = PlayerCurrencies.begin(); itr != PlayerCurrencies.end(); ++itr)
@@ -1863,23 +1917,71 @@ void LootTemplate::LootGroup::AddEntry(LootStoreItem& item)
         EqualChanced.push_back(item);
 }
 
-// Rolls an item from the group, returns NULL if all miss their chances
-LootStoreItem const* LootTemplate::LootGroup::Roll() const
+void LootTemplate::LootGroup::Compile()
 {
-    if (!ExplicitlyChanced.empty())                             // First explicitly chanced entries are checked
+    _aliasChance.clear();
+    _alias.clear();
+
+    if (ExplicitlyChanced.empty())
+        return;
+
+    // part of the 0-100 roll each entry takes, entries after one with 100% chance are never reached
+    uint32 slots = uint32(ExplicitlyChanced.size()) + 1;
+    std::vector<double> scaled(slots, 0.0);
+    double rolled = 0.0;
+    for (uint32 i = 0; i < ExplicitlyChanced.size() && rolled < 100.0; ++i)
     {
-        float Roll = (float)rand_chance();
+        double end = ExplicitlyChanced[i].chance >= 100.0f ? 100.0 : std::min(rolled + ExplicitlyChanced[i].chance, 100.0);
+        scaled[i] = end - rolled;
+        rolled = end;
+    }
+    scaled[slots - 1] = 100.0 - rolled;
 
-        for (size_t i = 0; i < ExplicitlyChanced.size(); ++i)   // check each explicitly chanced entry in the template and modify its chance based on quality.
-        {
-            if (ExplicitlyChanced[i].chance >= 100.0f)
-                return &ExplicitlyChanced[i];
+    std::vector<uint32> small;
+    std::vector<uint32> large;
+    for (uint32 i = 0; i < slots; ++i)
+    {
+        scaled[i] = scaled[i] * slots / 100.0;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
 
-            Roll -= ExplicitlyChanced[i].chance;
-            if (Roll < 0)
-                return &ExplicitlyChanced[i];
-        }
+    _aliasChance.assign(slots, 1.0f);
+    _alias.resize(slots);
+    for (uint32 i = 0; i < slots; ++i)
+        _alias[i] = i;
+
+    while (!small.empty() && !large.empty())
+    {
+        uint32 less = small.back();
+        small.pop_back();
+        uint32 more = large.back();
+        large.pop_back();
+
+        _aliasChance[less] = float(scaled[less]);
+        _alias[less] = more;
+
+        scaled[more] -= 1.0 - scaled[less];
+        (scaled[more] < 1.0 ? small : large).push_back(more);
     }
+}
+
+uint32 LootTemplate::LootGroup::RollExplicitIndex() const
+{
+    if (_alias.empty())
+        return uint32(ExplicitlyChanced.size());
+
+    double roll = rand_norm() * _alias.size();
+    uint32 slot = std::min(uint32(roll), uint32(_alias.size() - 1));
+    return roll - slot < _aliasChance[slot] ? slot : _alias[slot];
+}
+
+// Rolls an item from the group, returns NULL if all miss their chances
+LootStoreItem const* LootTemplate::LootGroup::Roll() const
+{
+    uint32 index = RollExplicitIndex();
+    if (index < ExplicitlyChanced.size())                   // First explicitly chanced entries are checked
+        return &ExplicitlyChanced[index];
+
     if (!EqualChanced.empty())                              // If nothing selected yet - an item is taken from equal-chanced part
         return &EqualChanced[irand(0, EqualChanced.size()-1)];
 
@@ -1922,16 +2024,76 @@ void LootTemplate::LootGroup::CopyConditions(ConditionList /*conditions*/)
     }
 }
 
+bool LootTemplate::LootGroup::AddRolledItem(Loot& loot, LootTemplate const* tab, LootStoreItem const& item) const
+{
+    if (item.lootmode && !(item.lootmode & loot._DifficultyMask)) // Do not add if instance mode mismatch
+        return false;
+
+    if (item.ClassificationMask && !(item.ClassificationMask & loot._ClassificationMask))
+        return false;
+
+    Player const* lootOwner = loot.GetLootOwner();
+    if (!tab->CheckItemCondition(lootOwner, item.itemid, item.type))
+        return false;
+
+    if (ItemTemplate const* _proto = sObjectMgr->GetItemTemplate(item.itemid))
+    {
+        if (tab->_isZoneLoot)
+            if(!lootOwner->CanGetItemForLoot(_proto, loot._specCheck))
+                return false;
+
+        uint8 _item_counter = 0;
+        for (LootItemList::const_iterator _item = loot.items.begin(); _item != loot.items.end(); ++_item)
+            if (_item->item.ItemID == item.itemid)                              // search through the items that have already dropped
+            {
+                ++_item_counter;
+                if (_proto->GetInventoryType() == 0 && _item_counter == 3)      // Non-equippable items are limited to 3 drops
+                    return false;
+                else if (_proto->GetInventoryType() != 0 && _item_counter == 1) // Equippable item are limited to 1 drop
+                    return false;
+            }
+    }
+
+    if(item.shared) //shared very low chance to and one item
+        if(!roll_chance_f(0.5f))
+            return false;
+
+    loot.AddItem(item);
+    return true;
+}
+
 // Rolls an item from the group (if any takes its chance) and adds the item to the loot
 void LootTemplate::LootGroup::Process(Loot& loot, LootTemplate const* tab) const
 {
-    // build up list of possible drops
+    const uint8 uiMaxAttempts = ExplicitlyChanced.size() + EqualChanced.size();
+    if (!uiMaxAttempts)
+        return;
+
+    // first roll straight from the compiled table, the possible drops are only copied when the rolled entry is refused
+    uint32 explicitIndex = RollExplicitIndex();
+    uint32 equalIndex = 0;
+    LootStoreItem const* rolled = nullptr;
+    if (explicitIndex < ExplicitlyChanced.size())
+        rolled = &ExplicitlyChanced[explicitIndex];
+    else if (!EqualChanced.empty())
+    {
+        equalIndex = irand(0, EqualChanced.size()-1);
+        rolled = &EqualChanced[equalIndex];
+    }
+
+    if (!rolled || AddRolledItem(loot, tab, *rolled))
+        return;
+
+    // continue with what a roll walking the entries would have left: the explicitly chanced entries after the rolled one,
+    // or none of them and the equal chanced entries but the rolled one
+    LootStoreItemList ExplicitPossibleDrops;
     LootStoreItemList EqualPossibleDrops = EqualChanced;
-    LootStoreItemList ExplicitPossibleDrops = ExplicitlyChanced;
+    if (explicitIndex < ExplicitlyChanced.size())
+        ExplicitPossibleDrops.assign(ExplicitlyChanced.begin() + explicitIndex + 1, ExplicitlyChanced.end());
+    else
+        EqualPossibleDrops.erase(EqualPossibleDrops.begin() + equalIndex);
 
-    uint8 uiAttemptCount = 0;
-    Player const* lootOwner = loot.GetLootOwner();
-    const uint8 uiMaxAttempts = ExplicitlyChanced.size() + EqualChanced.size();
+    uint8 uiAttemptCount = 1;
 
     // TC_LOG_DEBUG(LOG_FILTER_LOOT, "LootGroup::Process EqualPossibleDrops %i ExplicitPossibleDrops %i", EqualPossibleDrops.size(), ExplicitPossibleDrops.size());
 
@@ -1977,81 +2139,20 @@ void LootTemplate::LootGroup::Process(Loot& loot, LootTemplate const* tab) const
 
         ++uiAttemptCount;
 
-        if (item != nullptr)   // only add this item if roll succeeds and the mode matches
-        {
-            bool needErase = false;
-            if (item->lootmode && !(item->lootmode & loot._DifficultyMask)) // Do not add if instance mode mismatch
-                needErase = true;
-
-            if (item->ClassificationMask && !(item->ClassificationMask & loot._ClassificationMask))
-                needErase = true;
-
-            if (needErase)
-            {
-                switch (itemSource)
-                {
-                    case 1: // item came from ExplicitPossibleDrops
-                        ExplicitPossibleDrops.erase(itr);
-                        break;
-                    case 2: // item came from EqualPossibleDrops
-                        EqualPossibleDrops.erase(itr);
-                        break;
-                }
-                continue;
-            }
-
-            bool duplicate = false;
-            if (!tab->CheckItemCondition(lootOwner, item->itemid, item->type))
-                duplicate = true;
+        if (item == nullptr)
+            continue;
 
-            if (ItemTemplate const* _proto = sObjectMgr->GetItemTemplate(item->itemid))
-            {
-                if (tab->_isZoneLoot)
-                    if(!lootOwner->CanGetItemForLoot(_proto, loot._specCheck))
-                        duplicate = true;
+        if (AddRolledItem(loot, tab, *item))
+            return;
 
-                uint8 _item_counter = 0;
-                for (LootItemList::const_iterator _item = loot.items.begin(); _item != loot.items.end(); ++_item)
-                    if (_item->item.ItemID == item->itemid)                             // search through the items that have already dropped
-                    {
-                        ++_item_counter;
-                        if (_proto->GetInventoryType() == 0 && _item_counter == 3)      // Non-equippable items are limited to 3 drops
-                            duplicate = true;
-                        else if (_proto->GetInventoryType() != 0 && _item_counter == 1) // Equippable item are limited to 1 drop
-                            duplicate = true;
-                    }
-            }
-            if (duplicate) // if item->itemid is a duplicate, remove it
-                switch (itemSource)
-                {
-                    case 1: // item came from ExplicitPossibleDrops
-                        ExplicitPossibleDrops.erase(itr);
-                        break;
-                    case 2: // item came from EqualPossibleDrops
-                        EqualPossibleDrops.erase(itr);
-                        break;
-                }
-            else           // otherwise, add the item and exit the function
-            {
-                if(item->shared) //shared very low chance to and one item
-                {
-                    if(!roll_chance_f(0.5f))
-                    {
-                        switch (itemSource)
-                        {
-                            case 1: // item came from ExplicitPossibleDrops
-                                ExplicitPossibleDrops.erase(itr);
-                                break;
-                            case 2: // item came from EqualPossibleDrops
-                                EqualPossibleDrops.erase(itr);
-                                break;
-                        }
-                        continue;
-                    }
-                }
-                loot.AddItem(*item);
-                return;
-            }
+        switch (itemSource)
+        {
+            case 1: // item came from ExplicitPossibleDrops
+                ExplicitPossibleDrops.erase(itr);
+                break;
+            case 2: // item came from EqualPossibleDrops
+                EqualPossibleDrops.erase(itr);
+                break;
         }
     }
 }
@@ -2563,6 +2664,12 @@ void LootTemplate::CopyConditions(ConditionList conditions)
         i->CopyConditions(conditions);
 }
 
+void LootTemplate::Compile()
+{
+    for (LootGroups::iterator i = Groups.begin(); i != Groups.end(); ++i)
+        i->Compile();
+}
+
 // Rolls for every item in the template and adds the rolled items the the loot
 void LootTemplate::Process(Loot& loot, bool rate, uint8 groupId) const
 {
@@ -2579,16 +2686,26 @@ void LootTemplate::Process(Loot& loot, bool rate, uint8 groupId) const
 
     // TC_LOG_DEBUG(LOG_FILTER_LOOT, "LootTemplate::Process isBoss %i _DifficultyMask %i loot.chance %u bonusLoot %i Entries %u AutoGroups %u Groups %u", loot.isBoss, loot._DifficultyMask, loot.chance, loot.bonusLoot, Entries.size(), AutoGroups.size(), Groups.size());
 
-    // Rolling non-grouped items
-    for (LootStoreItemList::const_iterator i = Entries.begin(); i != Entries.end(); ++i)
+    // Rolling non-grouped items, the rolls are drawn in blocks
+    double rolls[64];
+    size_t rollIndex = 0;
+    for (LootStoreItemList::const_iterator i = Entries.begin(); i != Entries.end(); ++i, ++rollIndex)
     {
+        if (rollIndex % 64 == 0)
+        {
+            size_t count = std::min<size_t>(64, Entries.size() - rollIndex);
+            rand_norm_fill(rolls, count);
+            for (size_t r = 0; r < count; ++r)
+                rolls[r] *= 100.0;
+        }
+
         if (i->lootmode != 0 && !(i->lootmode & loot._DifficultyMask))    // Do not add if instance mode mismatch
             continue;
 
         if (i->ClassificationMask && !(i->ClassificationMask & loot._ClassificationMask))
             continue;
 
-        if (!i->Roll(rate, lootOwner->GetMap()->IsDungeon(), _isZoneLoot))
+        if (!i->Roll(rate, lootOwner->GetMap()->IsDungeon(), _isZoneLoot, rolls[rollIndex % 64]))
             continue;                                         // Bad luck for the entry
 
         if (!CheckItemCondition(lootOwner, i->itemid, i->type))
@@ -171,7 +171,8 @@ struct LootStoreItem
     // displayid is filled in IsValid() which must be called after
     LootStoreItem(uint32 _itemid, uint8 _type, float _chanceOrQuestChance, uint16 _lootmode, uint8 _group, int32 _mincountOrRef, uint32 _maxcount);
 
-    bool Roll(bool rate, bool isDungeon = false, bool isZoneLoot = false) const;                             // Checks if the entry takes it's chance (at loot generation)
+    // Checks if the entry takes it's chance (at loot generation), roll is a rand_chance() drawn by the caller or negative to roll here
+    bool Roll(bool rate, bool isDungeon = false, bool isZoneLoot = false, double roll = -1.0) const;
     bool IsValid(LootStore const& store, uint32 entry) const;
                                                             // Checks correctness of values
 };
@@ -311,6 +312,8 @@ class LootTemplate
         void ProcessChallengeChest(Loot& loot, uint32 lootId, Challenge* _challenge) const;
         void ProcessItemLoot(Loot& loot) const;
         void CopyConditions(ConditionList conditions);
+        // Builds the sampling tables of the groups, called once the template is loaded
+        void Compile();
         void ProcessWorld(Loot& loot, bool rate, bool ignore = false) const;
         void ProcessLuck(Loot& loot, uint32 entry, bool ignore = false) const;
         void ProcessBossLoot(Loot& loot) const;
@@ -396,8 +399,9 @@ struct Loot
     void AddOrReplaceItem(uint32 itemID, uint32 _count, bool isRes = false, bool update = false);
 
     void clear();
-    bool empty() const { return items.empty() && gold == 0; }
-    bool isLooted() const { return gold == 0 && unlootedCount == 0; }
+    // a pending loot is neither empty nor looted, it is rolled on first access
+    bool empty() const { return !_pendingStore && items.empty() && gold == 0; }
+    bool isLooted() const { return !_pendingStore && gold == 0 && unlootedCount == 0; }
 
     void NotifyItemRemoved(uint8 lootIndex);
     void NotifyQuestItemRemoved(uint8 questIndex);
@@ -411,6 +415,11 @@ struct Loot
 
     void generateMoneyLoot(uint32 minAmount, uint32 maxAmount, bool isDungeon = false);
     bool FillLoot(uint32 lootId, LootStore const& store, Player* lootOwner, bool noGroup, bool noEmptyError = false, WorldObject const* lootFrom = nullptr);
+    // Remembers a FillLoot(lootId, store, lootOwner, false) call, made by FillPendingLoot when the loot is first accessed
+    void SetPendingLoot(uint32 lootId, LootStore const& store, ObjectGuid const& lootOwner);
+    bool HasPendingLoot() const { return _pendingStore != nullptr; }
+    // lootOwner of the pending fill if still around lootFrom, accessor otherwise
+    void FillPendingLoot(Player* accessor, WorldObject const* lootFrom);
     void AutoStoreItems(bool isGO = false);
 
     // Inserts the item into the loot (called by LootTemplate processors)
@@ -452,6 +461,10 @@ private:
 
     Player* m_lootOwner;
     int32 _levelBonus;
+
+    LootStore const* _pendingStore = nullptr;
+    uint32 _pendingLootId = 0;
+    ObjectGuid _pendingOwner;
 };
 
 typedef std::map<ObjectGuid, Loot> PersonalLootMap;
@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2008-2016 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GridPreloader.h"
+#include "Log.h"
+#include "Map.h"
+#include "MapTree.h"
+#include "StringFormat.h"
+#include "Timer.h"
+#include "World.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+    // prepared terrain nobody entered is dropped after this long
+    uint32 const PreloadExpireTime = 60 * IN_MILLISECONDS;
+
+    void WarmFile(std::string const& fileName)
+    {
+        FILE* file = fopen(fileName.c_str(), "rb");
+        if (!file)
+            return;
+
+        char buffer[64 * 1024];
+        while (fread(buffer, 1, sizeof(buffer), file) == sizeof(buffer))
+            ;
+
+        fclose(file);
+    }
+}
+
+GridPreloader::GridPreloader() : _stopping(false), _lookahead(0), _lastPurge(0), _requested(0), _terrainPrefetched(0), _terrainSync(0),
+    _terrainWasted(0), _gridsPreloaded(0), _gridsLoaded(0), _workerNanoseconds(0)
+{
+}
+
+GridPreloader::~GridPreloader()
+{
+    Unload();
+}
+
+GridPreloader* GridPreloader::instance()
+{
+    static GridPreloader instance;
+    return &instance;
+}
+
+void GridPreloader::Initialize()
+{
+    uint32 threads = sWorld->getIntConfig(CONFIG_GRID_PRELOAD_THREADS);
+    if (!threads || IsEnabled())
+        return;
+
+    _lookahead = sWorld->getIntConfig(CONFIG_GRID_PRELOAD_LOOKAHEAD);
+    _stopping = false;
+    for (uint32 i = 0; i < threads; ++i)
+        _workers.emplace_back(&GridPreloader::WorkerThread, this);
+
+    TC_LOG_INFO(LOG_FILTER_SERVER_LOADING, "Grid preloading started with %u threads, %u ms lookahead", threads, _lookahead);
+}
+
+void GridPreloader::Unload()
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _stopping = true;
+    }
+
+    _condition.notify_all();
+    for (std::thread& worker : _workers)
+        worker.join();
+
+    _workers.clear();
+    _queue.clear();
+    for (auto& job : _jobs)
+        delete job.second.Terrain;
+
+    _jobs.clear();
+}
+
+void GridPreloader::Request(uint32 mapId, uint32 gx, uint32 gy)
+{
+    if (!IsEnabled())
+        return;
+
+    uint64 key = MakeKey(mapId, gx, gy);
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        PurgeExpired(getMSTime());
+        if (!_jobs.emplace(key, Job()).second)
+            return;
+
+        _queue.push_back(key);
+    }
+
+    ++_requested;
+    _condition.notify_one();
+}
+
+bool GridPreloader::IsReady(uint32 mapId, uint32 gx, uint32 gy)
+{
+    if (!IsEnabled())
+        return false;
+
+    std::lock_guard<std::mutex> lock(_lock);
+    auto itr = _jobs.find(MakeKey(mapId, gx, gy));
+    return itr != _jobs.end() && itr->second.State == JOB_READY;
+}
+
+GridMap* GridPreloader::TakeGridMap(uint32 mapId, uint32 gx, uint32 gy)
+{
+    if (!IsEnabled())
+        return nullptr;
+
+    GridMap* terrain = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        auto itr = _jobs.find(MakeKey(mapId, gx, gy));
+        if (itr != _jobs.end())
+        {
+            switch (itr->second.State)
+            {
+                case JOB_READY:
+                    terrain = itr->second.Terrain;
+                    _jobs.erase(itr);
+                    break;
+                case JOB_WORKING:
+                    // the worker drops its result, waiting for it would stall the map just the same
+                    itr->second.Canceled = true;
+                    break;
+                default:
+                    _queue.erase(std::find(_queue.begin(), _queue.end(), itr->first));
+                    _jobs.erase(itr);
+                    break;
+            }
+        }
+    }
+
+    if (terrain)
+        ++_terrainPrefetched;
+    else
+        ++_terrainSync;
+
+    return terrain;
+}
+
+void GridPreloader::OnGridLoaded()
+{
+    if (IsEnabled())
+        ++_gridsLoaded;
+}
+
+void GridPreloader::OnGridPreloaded()
+{
+    ++_gridsPreloaded;
+}
+
+void GridPreloader::WorkerThread()
+{
+    for (;;)
+    {
+        uint64 key;
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _condition.wait(lock, [this] { return _stopping || !_queue.empty(); });
+            if (_stopping)
+                return;
+
+            key = _queue.front();
+            _queue.pop_front();
+            _jobs[key].State = JOB_WORKING;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        GridMap* terrain = Prepare(key);
+        _workerNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(_lock);
+        auto itr = _jobs.find(key);
+        if (!terrain || itr->second.Canceled)
+        {
+            // a failed read is repeated by the map thread, which also reports the error
+            delete terrain;
+            _jobs.erase(itr);
+            continue;
+        }
+
+        itr->second.State = JOB_READY;
+        itr->second.Terrain = terrain;
+        itr->second.ReadyTime = getMSTime();
+    }
+}
+
+GridMap* GridPreloader::Prepare(uint64 key)
+{
+    uint32 mapId = uint32(key >> 32);
+    uint32 gx = uint32(key >> 16) & 0xFFFF;
+    uint32 gy = uint32(key) & 0xFFFF;
+    std::string dataPath = sWorld->GetDataPath();
+
+    // the vmap and mmap managers are not thread safe, their tiles are only read here so
+    // that loading them on the map thread is served from the page cache
+    WarmFile(dataPath + "vmaps/" + VMAP::StaticMapTree::getTileFileName(mapId, gx, gy));
+    WarmFile(Trinity::StringFormat("%smmaps/%04u%02u%02u.mmtile", dataPath.c_str(), mapId, gx, gy));
+
+    GridMap* terrain = new GridMap();
+    if (!terrain->loadData(Trinity::StringFormat("%smaps/%04u_%02u_%02u.map", dataPath.c_str(), mapId, gx, gy).c_str()))
+    {
+        delete terrain;
+        return nullptr;
+    }
+
+    return terrain;
+}
+
+void GridPreloader::PurgeExpired(uint32 now)
+{
+    if (getMSTimeDiff(_lastPurge, now) < PreloadExpireTime / 10)
+        return;
+
+    _lastPurge = now;
+    for (auto itr = _jobs.begin(); itr != _jobs.end();)
+    {
+        if (itr->second.State == JOB_READY && getMSTimeDiff(itr->second.ReadyTime, now) >= PreloadExpireTime)
+        {
+            delete itr->second.Terrain;
+            itr = _jobs.erase(itr);
+            ++_terrainWasted;
+        }
+        else
+            ++itr;
+    }
+}
+
+GridPreloader::Stats GridPreloader::GetStats() const
+{
+    Stats stats;
+    stats.Requested = _requested.load(std::memory_order_relaxed);
+    stats.TerrainPrefetched = _terrainPrefetched.load(std::memory_order_relaxed);
+    stats.TerrainSync = _terrainSync.load(std::memory_order_relaxed);
+    stats.TerrainWasted = _terrainWasted.load(std::memory_order_relaxed);
+    stats.GridsPreloaded = _gridsPreloaded.load(std::memory_order_relaxed);
+    stats.GridsLoaded = _gridsLoaded.load(std::memory_order_relaxed);
+    stats.WorkerMicroseconds = _workerNanoseconds.load(std::memory_order_relaxed) / 1000;
+    return stats;
+}
+
+void GridPreloader::ResetStats()
+{
+    _requested = 0;
+    _terrainPrefetched = 0;
+    _terrainSync = 0;
+    _terrainWasted = 0;
+    _gridsPreloaded = 0;
+    _gridsLoaded = 0;
+    _workerNanoseconds = 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2008-2016 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_GRIDPRELOADER_H
+#define TRINITY_GRIDPRELOADER_H
+
+#include "Define.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class GridMap;
+
+/*
+ * Reads the terrain of grids players are about to enter on worker threads.
+ * Maps predict the grids from player movement and flight paths (Map::UpdateGridPreload),
+ * the workers read the .map file into a GridMap and pull the vmap and mmap tiles into
+ * the page cache. Map::LoadMapImpl takes the prepared GridMap instead of reading the
+ * file itself; creatures and gameobjects are still created on the map thread.
+ */
+class GridPreloader
+{
+public:
+    struct Stats
+    {
+        uint64 Requested;           // terrain jobs queued by predictions
+        uint64 TerrainPrefetched;   // grid maps handed over ready
+        uint64 TerrainSync;         // grid maps read on the map thread
+        uint64 TerrainWasted;       // prepared but never entered
+        uint64 GridsPreloaded;      // grid objects loaded ahead of the players
+        uint64 GridsLoaded;         // all grid object loads
+        uint64 WorkerMicroseconds;
+    };
+
+    static GridPreloader* instance();
+
+    void Initialize();
+    void Unload();
+
+    bool IsEnabled() const { return !_workers.empty(); }
+    uint32 GetLookahead() const { return _lookahead; }
+
+    /// queues the terrain of the grid, no-op while it is already queued or ready
+    void Request(uint32 mapId, uint32 gx, uint32 gy);
+    /// terrain of the grid is waiting in memory
+    bool IsReady(uint32 mapId, uint32 gx, uint32 gy);
+    /// GridMap read by a worker, nullptr when the map thread has to read it itself
+    GridMap* TakeGridMap(uint32 mapId, uint32 gx, uint32 gy);
+
+    void OnGridLoaded();
+    void OnGridPreloaded();
+
+    Stats GetStats() const;
+    void ResetStats();
+
+private:
+    GridPreloader();
+    ~GridPreloader();
+
+    enum JobState
+    {
+        JOB_QUEUED,
+        JOB_WORKING,
+        JOB_READY
+    };
+
+    struct Job
+    {
+        JobState State = JOB_QUEUED;
+        bool Canceled = false;
+        GridMap* Terrain = nullptr;
+        uint32 ReadyTime = 0;
+    };
+
+    static uint64 MakeKey(uint32 mapId, uint32 gx, uint32 gy) { return uint64(mapId) << 32 | gx << 16 | gy; }
+
+    void WorkerThread();
+    GridMap* Prepare(uint64 key);
+    void PurgeExpired(uint32 now);
+
+    std::vector<std::thread> _workers;
+    std::mutex _lock;
+    std::condition_variable _condition;
+    std::deque<uint64> _queue;
+    std::unordered_map<uint64, Job> _jobs;
+    bool _stopping;
+    uint32 _lookahead;
+    uint32 _lastPurge;
+
+    std::atomic<uint64> _requested;
+    std::atomic<uint64> _terrainPrefetched;
+    std::atomic<uint64> _terrainSync;
+    std::atomic<uint64> _terrainWasted;
+    std::atomic<uint64> _gridsPreloaded;
+    std::atomic<uint64> _gridsLoaded;
+    std::atomic<uint64> _workerNanoseconds;
+};
+
+#define sGridPreloader GridPreloader::instance()
+
+#endif
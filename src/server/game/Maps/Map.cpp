@@ -27,6 +27,7 @@
 #include "GridInfo.h"
 #include "GridNotifiers.h"
 #include "GridNotifiersImpl.h"
+#include "GridPreloader.h"
 #include "Group.h"
 #include "InstancePackets.h"
 #include "InstanceScript.h"
@@ -34,6 +35,7 @@
 #include "Map.h"
 #include "MapInstanced.h"
 #include "MapManager.h"
+#include "MapObjectPool.h"
 #include "MiscPackets.h"
 #include "MMapFactory.h"
 #include "ObjectAccessor.h"
@@ -47,6 +49,7 @@
 #include "Transport.h"
 #include "Vehicle.h"
 #include "VMapFactory.h"
+#include "WaypointMovementGenerator.h"
 #include "WeatherMgr.h"
 #include "WildBattlePet.h"
 #include "WorldStateMgr.h"
@@ -296,6 +299,9 @@ Map::~Map()
     // MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(GetId(), i_InstanceId);
 
     b_isMapStop = true;
+
+    // objects still alive somewhere keep the pools until they are deleted
+    _objectPools->Release();
 }
 
 MapEntry const* Map::GetEntry() const
@@ -440,10 +446,16 @@ void Map::LoadMapImpl(Map* map, int gx, int gy, bool reload)
     #ifdef WIN32
     TC_LOG_INFO(LOG_FILTER_MAPS, "Loading map %s gx: %i, gy: %i", fileName.c_str(), gx, gy);
     #endif
-    // loading data
-    map->GridMaps[gx][gy] = new GridMap();
-    if (!map->GridMaps[gx][gy]->loadData(fileName.c_str()))
-        TC_LOG_ERROR(LOG_FILTER_MAPS, "Error loading map file: \n %s\n", fileName.c_str());
+    // loading data, unless a preload worker already did
+    if (!reload)
+        map->GridMaps[gx][gy] = sGridPreloader->TakeGridMap(map->GetId(), gx, gy);
+
+    if (!map->GridMaps[gx][gy])
+    {
+        map->GridMaps[gx][gy] = new GridMap();
+        if (!map->GridMaps[gx][gy]->loadData(fileName.c_str()))
+            TC_LOG_ERROR(LOG_FILTER_MAPS, "Error loading map file: \n %s\n", fileName.c_str());
+    }
 
     sScriptMgr->OnLoadGridMap(map, map->GridMaps[gx][gy], gx, gy);
 }
@@ -562,7 +574,11 @@ m_activeNonPlayersIter(m_activeNonPlayers.end()), i_grids(), GridMaps()
     b_isMapUnload = false;
     b_isMapStop = false;
     OutdoorPvPList = nullptr;
+    _objectPools = new MapObjectPools();
     BattlefieldList = nullptr;
+    m_wildBattlePetCursor = 0;
+    m_wildBattlePetSpawned = 0;
+    memset(&m_wildBattlePetStats, 0, sizeof(m_wildBattlePetStats));
 
     if (IsBattlegroundOrArena())
     {
@@ -598,6 +614,7 @@ m_activeNonPlayersIter(m_activeNonPlayers.end()), i_grids(), GridMaps()
     Map::InitVisibilityDistance();
 
     _weatherUpdateTimer.SetInterval(time_t(1 * IN_MILLISECONDS));
+    _gridPreloadTimer.SetInterval(time_t(1 * IN_MILLISECONDS));
 
     MMAP::MMapFactory::createOrGetMMapManager()->loadMapInstance(sWorld->GetDataPath(), GetId(), GetThreadID());
 
@@ -874,6 +891,7 @@ bool Map::EnsureGridLoaded(const Cell &cell)
     ngrid->setGridObjectDataLoaded(true);
 
     Trinity::ObjectGridLoader::LoadN(*ngrid, this, cell);
+    sGridPreloader->OnGridLoaded();
 
     //Hook for garrisones spawn system
     onEnsureGridLoaded(ngrid, cell);
@@ -885,6 +903,108 @@ bool Map::EnsureGridLoaded(const Cell &cell)
     return true;
 }
 
+// Predicts the grids players are heading to, from their flight path or from the distance
+// covered since the previous prediction, and has their terrain read by the preload workers.
+// Once the terrain is in memory the objects of the nearest predicted grid are loaded here,
+// one grid per call, so crossing into it does not stall the map.
+void Map::UpdateGridPreload()
+{
+    uint32 now = getMSTime();
+    float lookahead = sGridPreloader->GetLookahead() / float(IN_MILLISECONDS);
+    float reach = GetVisibilityRange();
+
+    float preloadTravel = std::numeric_limits<float>::max();
+    float preloadX = 0.0f, preloadY = 0.0f;
+
+    auto predict = [&](float x, float y, float travel)
+    {
+        GridCoord coord = Trinity::ComputeGridCoord(x, y);
+        if (!coord.IsCoordValid() || IsGridLoaded(coord))
+            return;
+
+        uint32 gx = (MAX_NUMBER_OF_GRIDS - 1) - coord.x_coord;
+        uint32 gy = (MAX_NUMBER_OF_GRIDS - 1) - coord.y_coord;
+        if (!GridMaps[gx][gy] && !m_parentMap->GridMaps[gx][gy] && !sGridPreloader->IsReady(GetId(), gx, gy))
+        {
+            sGridPreloader->Request(GetId(), gx, gy);
+            return;
+        }
+
+        if (travel < preloadTravel)
+        {
+            preloadTravel = travel;
+            preloadX = x;
+            preloadY = y;
+        }
+    };
+
+    std::unordered_map<ObjectGuid, GridPreloadSample> samples;
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        Player* player = itr->getSource();
+        if (!player || !player->IsInWorld())
+            continue;
+
+        float x = player->GetPositionX();
+        float y = player->GetPositionY();
+
+        if (player->isInFlight())
+        {
+            FlightPathMovementGenerator* flight = dynamic_cast<FlightPathMovementGenerator*>(player->GetMotionMaster()->top());
+            if (!flight)
+                continue;
+
+            float distance = player->GetSpeed(MOVE_FLIGHT) * lookahead + reach;
+            float travel = 0.0f;
+            TaxiPathNodeList const& path = flight->GetPath();
+            for (uint32 i = flight->GetCurrentNode(); i < path.size() && travel < distance; ++i)
+            {
+                TaxiPathNodeEntry const* node = path[i];
+                if (node->ContinentID != GetId())
+                    break;
+
+                travel += std::hypot(node->Loc.X - x, node->Loc.Y - y);
+                x = node->Loc.X;
+                y = node->Loc.Y;
+                predict(x, y, travel);
+            }
+
+            continue;
+        }
+
+        samples[player->GetGUID()] = { x, y, now };
+
+        auto sample = _gridPreloadSamples.find(player->GetGUID());
+        if (sample == _gridPreloadSamples.end())
+            continue;
+
+        uint32 elapsed = getMSTimeDiff(sample->second.Time, now);
+        if (!elapsed)
+            continue;
+
+        float dx = (x - sample->second.X) * IN_MILLISECONDS / elapsed;
+        float dy = (y - sample->second.Y) * IN_MILLISECONDS / elapsed;
+        float speed = std::hypot(dx, dy);
+        // standing still, or teleported since the previous sample
+        if (speed < 1.0f || speed > 100.0f)
+            continue;
+
+        float distance = speed * lookahead + reach;
+        for (float travel = SIZE_OF_GRIDS / 2; ; travel += SIZE_OF_GRIDS / 2)
+        {
+            travel = std::min(travel, distance);
+            predict(x + dx / speed * travel, y + dy / speed * travel, travel);
+            if (travel >= distance)
+                break;
+        }
+    }
+
+    _gridPreloadSamples.swap(samples);
+
+    if (preloadTravel != std::numeric_limits<float>::max() && EnsureGridLoaded(Cell(preloadX, preloadY)))
+        sGridPreloader->OnGridPreloaded();
+}
+
 void Map::LoadGrid(float x, float y)
 {
     EnsureGridLoaded(Cell(x, y));
@@ -915,6 +1035,8 @@ bool Map::AddPlayerToMap(Player* player, bool initPlayer /*= true*/)
     if (!player->IsInWorld())
         return false;
 
+    player->BindTimerWheel(&m_timerWheel);
+
     if (initPlayer)
         SendInitSelf(player);
 
@@ -982,6 +1104,8 @@ bool Map::AddToMap(T *obj)
     if (!obj->IsInWorld())
         obj->AddToWorld();
 
+    obj->BindTimerWheel(&m_timerWheel);
+
     if (GameObject* go = obj->ToGameObject())
         if (StaticTransport* staticTransport = go->ToStaticTransport())
             AddStaticTransport(staticTransport);
@@ -1016,6 +1140,7 @@ bool Map::AddToMap(Transport* obj)
     }
 
     obj->AddToWorld();
+    obj->BindTimerWheel(&m_timerWheel);
     AddTransport(obj);
 
     // Broadcast creation to players
@@ -1045,6 +1170,8 @@ void Map::Update(const uint32 t_diff)
     if (b_isMapUnload) // Need update if start unload???
         return;
 
+    MapObjectPools::Scope objectPoolScope(_objectPools);
+
     volatile uint32 _mapId = GetId();
     volatile uint32 _instanceId = GetInstanceId();
 
@@ -1052,7 +1179,8 @@ void Map::Update(const uint32 t_diff)
 
     m_Functions.Update(t_diff);
 
-    _dynamicTree.update(t_diff);
+    // object events and functions, before the objects update like they ran at the start of Unit::Update
+    m_timerWheel.Advance(t_diff);
 
     /// update active cells around players and active objects
     resetMarkedCells();
@@ -1185,6 +1313,16 @@ void Map::Update(const uint32 t_diff)
         _weatherUpdateTimer.Reset();
     }
 
+    if (sGridPreloader->IsEnabled())
+    {
+        _gridPreloadTimer.Update(t_diff);
+        if (_gridPreloadTimer.Passed())
+        {
+            UpdateGridPreload();
+            _gridPreloadTimer.Reset();
+        }
+    }
+
     _ms = GetMSTimeDiffToNow(_s);
     if (_ms > 250)
         sLog->outDiff("Map::Update ScriptsProcess mapId %u Update time - %ums diff %u Players online: %lu i_InstanceId %u activeEntry %u activeEncounter %u", GetId(), _ms, t_diff, m_sessions.size(), i_InstanceId, m_activeEntry, m_activeEncounter);
@@ -1291,6 +1429,8 @@ void Map::Update(const uint32 t_diff)
 
 void Map::UpdateSessions(uint32 diff)
 {
+    MapObjectPools::Scope objectPoolScope(_objectPools);
+
     volatile uint32 _mapId = GetId();
     volatile uint32 _instanceId = GetInstanceId();
 
@@ -1375,6 +1515,8 @@ void Map::RemovePlayerFromMap(Player* player, bool remove)
     if (InstanceScript* data_s = player->GetInstanceScript())
         data_s->OnPlayerLeaveForScript(player);
 
+    // pending events keep their remaining delay and go on with the next map
+    player->BindTimerWheel(nullptr);
     player->RemoveFromWorld();
     if (!remove)
         SendRemoveTransports(player);
@@ -1397,6 +1539,7 @@ void Map::RemoveFromMap(T *obj, bool remove)
     if (Creature* creature = obj->ToCreature())
         RemoveBattlePet(creature);
 
+    obj->BindTimerWheel(nullptr);
     obj->RemoveFromWorld();
     if (obj->isActiveObject())
         RemoveFromActive(obj);
@@ -1423,6 +1566,7 @@ void Map::RemoveFromMap(T *obj, bool remove)
 template<>
 void Map::RemoveFromMap(Transport* obj, bool remove)
 {
+    obj->BindTimerWheel(nullptr);
     obj->RemoveFromWorld();
 
     UpdateData data(GetId());
@@ -1525,7 +1669,7 @@ void Map::GameObjectRelocation(GameObject* go, float x, float y, float z, float
     else
     {
         go->Relocate(x, y, z, orientation);
-        go->UpdateModelPosition(true);
+        go->UpdateModelPosition();
         go->UpdateObjectVisibility(false);
         RemoveGameObjectFromMoveList(go);
     }
@@ -3043,6 +3187,14 @@ float Map::GetGridMapHeigh(float x, float y) const
 }
 
 float Map::GetHeight(float x, float y, float z, bool checkVMap /*= true*/, float maxSearchDist /*= DEFAULT_HEIGHT_SEARCH*/) const
+{
+    if (_queryCache.IsEnabled())
+        return _queryCache.GetHeight(x, y, z, checkVMap, maxSearchDist, [&]() { return CalculateHeight(x, y, z, checkVMap, maxSearchDist); });
+
+    return CalculateHeight(x, y, z, checkVMap, maxSearchDist);
+}
+
+float Map::CalculateHeight(float x, float y, float z, bool checkVMap, float maxSearchDist) const
 {
     // find raw .map surface under Z coordinates
     float mapHeight = VMAP_INVALID_HEIGHT_VALUE;
@@ -3368,8 +3520,25 @@ float Map::GetWaterLevel(float x, float y) const
 
 bool Map::isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, std::set<uint32> const& phases, DynamicTreeCallback* dCallback /*= nullptr*/) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2)
-        && _dynamicTree.isInLineOfSight({ x1, y1, z1 }, { x2, y2, z2 }, phases, dCallback);
+    // callers asking for the blocking gameobject always trace
+    if (!_queryCache.IsEnabled() || dCallback)
+        return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2)
+            && _dynamicTree.isInLineOfSight({ x1, y1, z1 }, { x2, y2, z2 }, phases, dCallback);
+
+    return _queryCache.GetLineOfSight(x1, y1, z1, x2, y2, z2, phases, _dynamicTree.getGeneration(),
+        [&]() { return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2); },
+        [&]() { return _dynamicTree.isInLineOfSight({ x1, y1, z1 }, { x2, y2, z2 }, phases, false); });
+}
+
+uint64 Map::isInLineOfSight(G3D::Vector3 const& origin, G3D::Vector3 const* targets, uint32 count, std::set<uint32> const& phases) const
+{
+    // static geometry is traced in ray packets, gameobject models only for the rays that made it through
+    uint64 visible = VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), origin, targets, count);
+    for (uint32 i = 0; i < count; ++i)
+        if ((visible & (UI64LIT(1) << i)) && !_dynamicTree.isInLineOfSight(origin, targets[i], phases, false))
+            visible &= ~(UI64LIT(1) << i);
+
+    return visible;
 }
 
 bool Map::getObjectHitPos(std::set<uint32> const& phases, bool otherUsePlayerPhasingRules, Position startPos, Position destPos, float modifyDist, DynamicTreeCallback* dCallback /*= nullptr*/)
@@ -3741,6 +3910,9 @@ void Map::AddObjectToSwitchList(WorldObject* obj, bool on)
 
 void Map::RemoveAllObjectsInRemoveList()
 {
+    // blocks freed since the previous removal phase can be reused from now on
+    _objectPools->Reclaim();
+
     while (!i_objectsToSwitch.empty())
     {
         std::map<WorldObject*, bool>::iterator itr = i_objectsToSwitch.begin();
@@ -3842,11 +4014,12 @@ uint32 Map::GetPlayersCountExceptGMs() const
 
 void Map::SendToPlayers(WorldPacket const* data) const
 {
+    BroadcastPacket shared(data);
     for (MapRefManager::const_iterator itr = m_mapRefManager.begin(), next; itr != m_mapRefManager.end(); itr = next)
     {
         next = itr;
         ++next;
-        itr->getSource()->SendDirectMessage(data);
+        itr->getSource()->SendDirectMessage(shared.Share());
     }
 }
 
@@ -5335,11 +5508,17 @@ void Map::UpdateLoop(volatile uint32 _mapID)
 {
     cds::threading::Manager::attachThread();
 
+    MapObjectPools::Scope objectPoolScope(_objectPools);
+
     uint32 realCurrTime = 0;
     uint32 realPrevTime = getMSTime();
 
     uint32 prevSleepTime = 0;
 
+    // this thread only updates this map, seeding it makes the rolls of the map reproducible
+    if (uint32 randomSeed = sWorld->getIntConfig(CONFIG_MAP_RANDOM_SEED))
+        rand_seed_thread(randomSeed ^ (GetId() * 0x9E3779B1u) ^ (GetInstanceId() * 0x85EBCA77u));
+
     // TC_LOG_ERROR(LOG_FILTER_WORLDSERVER, "Map::UpdateLoop Run _mapID %u thread %u", _mapID, std::this_thread::get_id());
 
     while (!b_isMapStop)
@@ -5457,7 +5636,7 @@ void Map::SetMapUpdateInterval()
     i_timer_op.SetInterval(1000); // OutdoorPvP timer update
     i_timer_op.Reset();
 
-    i_timer_bp.SetInterval(30000); // WildBattlePet timer update
+    i_timer_bp.SetInterval(sWorld->getIntConfig(CONFIG_WILD_BATTLE_PET_UPDATE_INTERVAL)); // WildBattlePet timer update
     i_timer_bp.Reset();
 }
 
@@ -5587,36 +5766,104 @@ void Map::TerminateThread()
 void Map::AddBattlePet(Creature* creature)
 {
     if (sWildBattlePetMgr->IsBattlePet(creature->GetEntry()))
-        m_wildBattlePetPool[creature->GetCurrentZoneID()][creature->GetEntry()].ToBeReplaced.insert(creature);
+    {
+        WildBattlePetPool& pool = m_wildBattlePetPool[creature->GetCurrentZoneID()][creature->GetEntry()];
+        pool.ToBeReplaced.insert(creature);
+        pool.CandidatesDirty = true;
+    }
     else if (creature->isWildBattlePet())
+    {
         sWildBattlePetMgr->EnableWildBattle(creature);
+        ++m_wildBattlePetSpawned;
+    }
 }
 
 void Map::RemoveBattlePet(Creature* creature)
 {
     if (sWildBattlePetMgr->IsBattlePet(creature->GetEntry()))
-        m_wildBattlePetPool[creature->GetCurrentZoneID()][creature->GetEntry()].ToBeReplaced.erase(creature);
+    {
+        WildBattlePetPool& pool = m_wildBattlePetPool[creature->GetCurrentZoneID()][creature->GetEntry()];
+        pool.ToBeReplaced.erase(creature);
+        // the candidates must not outlive the creature
+        pool.CandidatesDirty = true;
+        pool.Candidates.clear();
+    }
 }
 
 void Map::PopulateBattlePet(uint32 diff)
 {
     uint32 _s = getMSTime();
-    for (auto& zone : m_wildBattlePetPool)
+
+    m_wildBattlePetStats.Zones = uint32(m_wildBattlePetPool.size());
+    m_wildBattlePetStats.ZonesObserved = 0;
+    m_wildBattlePetStats.ZonesVisited = 0;
+    m_wildBattlePetStats.Spawned = m_wildBattlePetSpawned;
+    m_wildBattlePetStats.Replaced = 0;
+    m_wildBattlePetStats.UpdateTime = 0;
+    m_wildBattlePetStats.TotalSpawned += m_wildBattlePetSpawned;
+    m_wildBattlePetSpawned = 0;
+
+    if (m_wildBattlePetPool.empty())
+        return;
+
+    // zones nobody is in are left as they are, their pets are replaced once someone comes to look
+    std::set<uint16> observedZones;
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+        if (Player* player = itr->getSource())
+            if (player->IsInWorld() && m_wildBattlePetPool.count(player->GetCurrentZoneID()))
+                observedZones.insert(player->GetCurrentZoneID());
+
+    m_wildBattlePetStats.ZonesObserved = uint32(observedZones.size());
+    if (observedZones.empty())
+        return;
+
+    // zones are taken in turns from where the budget ran out on the last pass
+    uint32 budget = sWorld->getIntConfig(CONFIG_WILD_BATTLE_PET_SPAWN_BUDGET);
+    auto first = observedZones.lower_bound(m_wildBattlePetCursor);
+    if (first == observedZones.end())
+        first = observedZones.begin();
+
+    m_wildBattlePetCursor = 0;
+    auto zoneItr = first;
+    do
     {
-        uint16 zoneId = zone.first;
-        for (auto& iter : zone.second)
+        uint16 zoneId = *zoneItr;
+        if (!budget)
         {
-            uint32 entry = iter.first;
-            WildPetPoolTemplate* petTemplate = sWildBattlePetMgr->GetWildPetTemplate(GetId(), zoneId, entry);
-            if (!petTemplate)
-                continue;
+            m_wildBattlePetCursor = zoneId;
+            break;
+        }
+
+        ++m_wildBattlePetStats.ZonesVisited;
+        for (auto& iter : m_wildBattlePetPool[zoneId])
+        {
+            if (!budget)
+                break;
+
+            WildBattlePetPool& pool = iter.second;
+            if (!pool.TemplateResolved)
+            {
+                pool.Template = sWildBattlePetMgr->GetWildPetTemplate(GetId(), zoneId, iter.first);
+                if (pool.Template && sDB2Manager.HasBattlePetSpeciesFlag(pool.Template->Species, BATTLEPET_SPECIES_FLAG_UNTAMEABLE))
+                    pool.Template = nullptr;
 
-            sWildBattlePetMgr->Populate(petTemplate, &iter.second);
+                pool.TemplateResolved = true;
+            }
+
+            uint32 replaced = sWildBattlePetMgr->Populate(pool.Template, &pool, budget);
+            m_wildBattlePetStats.Replaced += replaced;
+            budget -= replaced;
         }
+
+        if (++zoneItr == observedZones.end())
+            zoneItr = observedZones.begin();
     }
-    uint32 _ms = GetMSTimeDiffToNow(_s);
-    if (_ms > 200)
-        sLog->outDiff("Map::PopulateBattlePet mapId %u Update time - %ums diff %u", GetId(), _ms, diff);
+    while (zoneItr != first);
+
+    m_wildBattlePetStats.TotalReplaced += m_wildBattlePetStats.Replaced;
+    m_wildBattlePetStats.UpdateTime = GetMSTimeDiffToNow(_s);
+    if (m_wildBattlePetStats.UpdateTime > 200)
+        sLog->outDiff("Map::PopulateBattlePet mapId %u Update time - %ums diff %u", GetId(), m_wildBattlePetStats.UpdateTime, diff);
 }
 
 void Map::DepopulateBattlePet()
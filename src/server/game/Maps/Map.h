@@ -26,12 +26,14 @@
 #include "DynamicTree.h"
 #include "GameObjectModel.h"
 #include "GridDefines.h"
+#include "MapQueryCache.h"
 #include "MapRefManager.h"
 #include "SharedDefines.h"
 #include "Timer.h"
 #include "Weather.h"
 #include "NGrid.h"
 #include "FunctionProcessor.h"
+#include "TimerWheel.h"
 #include "World.h"
 #include "ThreadPoolMap.hpp"
 
@@ -54,6 +56,7 @@ class InstanceMap;
 class InstanceSave;
 class InstanceScript;
 class MapInstanced;
+class MapObjectPools;
 class Object;
 class OutdoorPvP;
 class Player;
@@ -541,10 +544,17 @@ class Map
         float GetWaterOrGroundLevel(std::set<uint32> const& phases, float x, float y, float z, float* ground = nullptr, bool swim = false) const;
         float GetHeight(std::set<uint32> const& phases, float x, float y, float z, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH, DynamicTreeCallback* dCallback = nullptr) const;
         bool isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, std::set<uint32> const& phases, DynamicTreeCallback* dCallback = nullptr) const;
+        // line of sight from origin to up to VMAP_MAX_LOS_BATCH targets, bit i of the result is set if targets[i] is visible
+        uint64 isInLineOfSight(G3D::Vector3 const& origin, G3D::Vector3 const* targets, uint32 count, std::set<uint32> const& phases) const;
         void Balance() { _dynamicTree.balance(); }
         void RemoveGameObjectModel(GameObjectModel const& model) { _dynamicTree.remove(model); }
         void InsertGameObjectModel(GameObjectModel const& model) { _dynamicTree.insert(model); }
+        void UpdateGameObjectModel(GameObjectModel const& model) { _dynamicTree.update(model); }
         bool ContainsGameObjectModel(GameObjectModel const& model) const { return _dynamicTree.contains(model);}
+        // a model in the tree moved or had its collision toggled
+        void OnGameObjectModelChanged() { _dynamicTree.markChanged(); }
+        MapQueryCache& GetQueryCache() const { return _queryCache; }
+        MapObjectPools& GetObjectPools() const { return *_objectPools; }
         bool getObjectHitPos(std::set<uint32> const& phases, Position startPos, Position destPos, float modifyDist, DynamicTreeCallback* dCallback = nullptr);
         bool getObjectHitPos(std::set<uint32> const& phases, bool otherUsePlayerPhasingRules, Position startPos, Position destPos, float modifyDist, DynamicTreeCallback* dCallback = nullptr);
         bool getObjectHitPos(std::set<uint32> const& phases, bool otherUsePlayerPhasingRules, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float &ry, float& rz, float modifyDist, DynamicTreeCallback* dCallback = nullptr);
@@ -596,6 +606,8 @@ class Map
         std::recursive_mutex m_objectsAddToMap_lock;
 
         FunctionProcessor m_Functions;
+        // runs the event and function processors of the objects on the map, see WorldObject::BindTimerWheel
+        SharedTimerWheel m_timerWheel;
         time_t m_respawnChallenge;
 
         SessionMap m_sessions;
@@ -636,6 +648,20 @@ class Map
         void RemoveBattlePet(Creature* creature);
         WildBattlePetPool* GetWildBattlePetPool(Creature* creature);
 
+        struct WildBattlePetStats
+        {
+            uint32 Zones;               // zones with wild battle pet pools
+            uint32 ZonesObserved;       // ... with players in them during the last pass
+            uint32 ZonesVisited;        // ... populated by the last pass before the budget ran out
+            uint32 Spawned;             // wild battle pets spawned by the map since the pass before
+            uint32 Replaced;            // creatures replaced by wild battle pets in the last pass
+            uint32 UpdateTime;
+            uint64 TotalSpawned;
+            uint64 TotalReplaced;
+        };
+
+        WildBattlePetStats const& GetWildBattlePetStats() const { return m_wildBattlePetStats; }
+
         uint32 m_activeEntry;
         uint32 m_activeEncounter;
 
@@ -697,6 +723,7 @@ class Map
         bool EnsureGridLoaded(Cell const&);
         virtual bool onEnsureGridLoaded(NGrid* grid, Cell const& cell) { return true; }
         void EnsureGridLoadedForActiveObject(Cell const&, WorldObject* object);
+        void UpdateGridPreload();
 
         NGrid * getNGrid(uint32 x, uint32 y) const
         {
@@ -709,8 +736,12 @@ class Map
         void PopulateBattlePet(uint32 diff);
         void DepopulateBattlePet();
         std::map<uint16, std::map<uint32, WildBattlePetPool>> m_wildBattlePetPool;
+        uint16 m_wildBattlePetCursor;
+        uint32 m_wildBattlePetSpawned;
+        WildBattlePetStats m_wildBattlePetStats;
 
     protected:
+        float CalculateHeight(float x, float y, float z, bool checkVMap, float maxSearchDist) const;
         void SetUnloadReferenceLock(const GridCoord &p, bool on) { getNGrid(p.x_coord, p.y_coord)->setUnloadReferenceLock(on); }
 
         MapEntry const* i_mapEntry;
@@ -720,6 +751,8 @@ class Map
         uint32 m_unloadTimer;
         float m_VisibleDistance;
         DynamicMapTree _dynamicTree;
+        mutable MapQueryCache _queryCache;
+        MapObjectPools* _objectPools;
 
         MapRefManager m_mapRefManager;
         MapRefManager::iterator m_mapRefIter;
@@ -746,6 +779,16 @@ class Map
         ZoneDynamicInfoMap _zoneDynamicInfo;
         IntervalTimer _weatherUpdateTimer;
 
+        struct GridPreloadSample
+        {
+            float X;
+            float Y;
+            uint32 Time;
+        };
+
+        IntervalTimer _gridPreloadTimer;
+        std::unordered_map<ObjectGuid, GridPreloadSample> _gridPreloadSamples;  // player positions of the previous prediction
+
         //used for fast base_map (e.g. MapInstanced class object) search for
         //InstanceMaps and BattlegroundMaps...
         Map* m_parentMap;                                           // points to MapInstanced* or self (always same map id)
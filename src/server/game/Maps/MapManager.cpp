@@ -23,6 +23,7 @@
 #include "Corpse.h"
 #include "DatabaseEnv.h"
 #include "GridDefines.h"
+#include "GridPreloader.h"
 #include "Group.h"
 #include "GuildMgr.h"
 #include "InstanceSaveMgr.h"
@@ -52,6 +53,7 @@ MapManager::~MapManager()
 
 void MapManager::Initialize()
 {
+    sGridPreloader->Initialize();
 }
 
 void MapManager::InitializeVisibilityDistanceInfo()
@@ -367,6 +369,8 @@ void MapManager::UnloadAll()
     // Wait when map is stop update
     std::this_thread::sleep_for(Milliseconds(1000));
 
+    sGridPreloader->Unload();
+
     for (uint16 i = 0; i < _mapCount; ++i)
     {
         if (Map* map = i_maps[i])
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2008-2016 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapObjectPool.h"
+#include "World.h"
+#include <algorithm>
+#include <new>
+
+namespace
+{
+    // in front of every block, pooled or not, so operator delete finds where the block came from
+    struct alignas(16) BlockHeader
+    {
+        MapObjectPool* Pool;
+        uint32 SizeClass;
+    };
+
+    std::size_t const BlockAlignment = alignof(BlockHeader);
+
+    thread_local MapObjectPools* CurrentPools = nullptr;
+}
+
+MapObjectPool::MapObjectPool() : _owner(nullptr), _blocksPerSlab(0), _live(0), _peak(0)
+{
+}
+
+MapObjectPool::~MapObjectPool()
+{
+    for (void* slab : _slabs)
+        ::operator delete(slab);
+}
+
+void MapObjectPool::Initialize(MapObjectPools* owner, uint32 blocksPerSlab)
+{
+    _owner = owner;
+    _blocksPerSlab = blocksPerSlab;
+}
+
+void* MapObjectPool::Allocate(std::size_t size)
+{
+    std::size_t blockSize = (sizeof(BlockHeader) + size + BlockAlignment - 1) & ~(BlockAlignment - 1);
+
+    std::unique_lock<std::mutex> lock(_lock);
+
+    uint32 sizeClass = 0;
+    while (sizeClass < _sizeClasses.size() && _sizeClasses[sizeClass].Size != blockSize)
+        ++sizeClass;
+
+    if (sizeClass == _sizeClasses.size())
+        _sizeClasses.push_back({ blockSize, { }, { } });
+
+    SizeClass& sizeClassData = _sizeClasses[sizeClass];
+    if (sizeClassData.Free.empty())
+    {
+        char* slab = static_cast<char*>(::operator new(blockSize * _blocksPerSlab));
+        _slabs.push_back(slab);
+        sizeClassData.Free.reserve(sizeClassData.Free.size() + _blocksPerSlab);
+        // handed out from the front of the slab first
+        for (uint32 i = _blocksPerSlab; i > 0; --i)
+            sizeClassData.Free.push_back(slab + blockSize * (i - 1));
+    }
+
+    BlockHeader* header = static_cast<BlockHeader*>(sizeClassData.Free.back());
+    sizeClassData.Free.pop_back();
+    _peak = std::max(_peak, ++_live);
+    lock.unlock();
+
+    _owner->AddReference();
+    header->Pool = this;
+    header->SizeClass = sizeClass;
+    return header + 1;
+}
+
+void MapObjectPool::Deallocate(void* block, uint32 sizeClass)
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _sizeClasses[sizeClass].Pending.push_back(block);
+        --_live;
+    }
+
+    // may be the last reference of a map that is already gone
+    _owner->Release();
+}
+
+void MapObjectPool::Reclaim()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    for (SizeClass& sizeClass : _sizeClasses)
+    {
+        sizeClass.Free.insert(sizeClass.Free.end(), sizeClass.Pending.begin(), sizeClass.Pending.end());
+        sizeClass.Pending.clear();
+    }
+}
+
+MapObjectPool::Stats MapObjectPool::GetStats()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    Stats stats;
+    stats.Live = _live;
+    stats.Peak = _peak;
+    stats.Free = 0;
+    stats.Pending = 0;
+    stats.Slabs = uint32(_slabs.size());
+    for (SizeClass const& sizeClass : _sizeClasses)
+    {
+        stats.Free += uint32(sizeClass.Free.size());
+        stats.Pending += uint32(sizeClass.Pending.size());
+    }
+
+    return stats;
+}
+
+MapObjectPools::Scope::Scope(MapObjectPools* pools) : _previous(CurrentPools)
+{
+    CurrentPools = pools;
+}
+
+MapObjectPools::Scope::~Scope()
+{
+    CurrentPools = _previous;
+}
+
+MapObjectPools::MapObjectPools() : _references(1)
+{
+    _pools[MAP_OBJECT_POOL_CREATURE].Initialize(this, sWorld->getIntConfig(CONFIG_MAP_OBJECT_POOL_CREATURE));
+    _pools[MAP_OBJECT_POOL_GAMEOBJECT].Initialize(this, sWorld->getIntConfig(CONFIG_MAP_OBJECT_POOL_GAMEOBJECT));
+    _pools[MAP_OBJECT_POOL_AREATRIGGER].Initialize(this, sWorld->getIntConfig(CONFIG_MAP_OBJECT_POOL_AREATRIGGER));
+    _pools[MAP_OBJECT_POOL_DYNAMICOBJECT].Initialize(this, sWorld->getIntConfig(CONFIG_MAP_OBJECT_POOL_DYNAMICOBJECT));
+}
+
+void MapObjectPools::Release()
+{
+    if (--_references == 0)
+        delete this;
+}
+
+void MapObjectPools::Reclaim()
+{
+    for (MapObjectPool& pool : _pools)
+        if (pool.IsEnabled())
+            pool.Reclaim();
+}
+
+void* MapObjectPools::Allocate(MapObjectPoolType type, std::size_t size)
+{
+    if (CurrentPools && CurrentPools->_pools[type].IsEnabled())
+        return CurrentPools->_pools[type].Allocate(size);
+
+    BlockHeader* header = static_cast<BlockHeader*>(::operator new(sizeof(BlockHeader) + size));
+    header->Pool = nullptr;
+    header->SizeClass = 0;
+    return header + 1;
+}
+
+void MapObjectPools::Free(void* block)
+{
+    if (!block)
+        return;
+
+    BlockHeader* header = static_cast<BlockHeader*>(block) - 1;
+    if (MapObjectPool* pool = header->Pool)
+        pool->Deallocate(header, header->SizeClass);
+    else
+        ::operator delete(header);
+}
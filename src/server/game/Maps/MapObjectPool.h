@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2008-2016 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_MAPOBJECTPOOL_H
+#define TRINITY_MAPOBJECTPOOL_H
+
+#include "Define.h"
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+enum MapObjectPoolType
+{
+    MAP_OBJECT_POOL_CREATURE,
+    MAP_OBJECT_POOL_GAMEOBJECT,
+    MAP_OBJECT_POOL_AREATRIGGER,
+    MAP_OBJECT_POOL_DYNAMICOBJECT,
+    MAX_MAP_OBJECT_POOLS
+};
+
+class MapObjectPools;
+
+/*
+ * Slabs of equally sized blocks for one object type of one map. Subclasses
+ * (TempSummon, Pet, Transport...) get a free list of their own size. Freed
+ * blocks wait in a pending list until the next removal phase of the map, so
+ * memory of an object deleted this tick is never handed to a new object before
+ * everything still pointing at it has run.
+ */
+class MapObjectPool
+{
+public:
+    struct Stats
+    {
+        uint32 Live;
+        uint32 Peak;
+        uint32 Free;
+        uint32 Pending;
+        uint32 Slabs;
+    };
+
+    MapObjectPool();
+    ~MapObjectPool();
+
+    void Initialize(MapObjectPools* owner, uint32 blocksPerSlab);
+    bool IsEnabled() const { return _blocksPerSlab != 0; }
+
+    void* Allocate(std::size_t size);
+    void Deallocate(void* block, uint32 sizeClass);
+    void Reclaim();
+
+    Stats GetStats();
+
+private:
+    struct SizeClass
+    {
+        std::size_t Size;
+        std::vector<void*> Free;
+        std::vector<void*> Pending;
+    };
+
+    MapObjectPools* _owner;
+    uint32 _blocksPerSlab;
+    std::mutex _lock;
+    std::vector<SizeClass> _sizeClasses;
+    std::vector<void*> _slabs;
+    uint32 _live;
+    uint32 _peak;
+};
+
+/*
+ * Pools of every pooled type of one map. Objects are taken from the pools of
+ * the map whose thread creates them (see Scope), anything created elsewhere
+ * uses the heap. The map and every live block hold a reference, so objects
+ * deleted after their map still find their pool.
+ */
+class MapObjectPools
+{
+public:
+    class Scope
+    {
+    public:
+        explicit Scope(MapObjectPools* pools);
+        ~Scope();
+
+    private:
+        MapObjectPools* _previous;
+    };
+
+    MapObjectPools();
+
+    void Release();
+    void Reclaim();
+
+    bool IsEnabled(MapObjectPoolType type) const { return _pools[type].IsEnabled(); }
+    MapObjectPool::Stats GetStats(MapObjectPoolType type) { return _pools[type].GetStats(); }
+
+    static void* Allocate(MapObjectPoolType type, std::size_t size);
+    static void Free(void* block);
+
+private:
+    friend class MapObjectPool;
+
+    ~MapObjectPools() { }
+
+    void AddReference() { ++_references; }
+
+    MapObjectPool _pools[MAX_MAP_OBJECT_POOLS];
+    std::atomic<uint32> _references;
+};
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2008-2016 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapQueryCache.h"
+#include "World.h"
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    uint64 Mix(uint64 hash, uint64 value)
+    {
+        hash ^= value + UI64LIT(0x9E3779B97F4A7C15) + (hash << 6) + (hash >> 2);
+        hash ^= hash >> 31;
+        hash *= UI64LIT(0xBF58476D1CE4E5B9);
+        return hash;
+    }
+
+    uint64 Quantize(float value, float invPrecision)
+    {
+        return uint64(int64(std::floor(value * invPrecision + 0.5f)));
+    }
+}
+
+MapQueryCache::MapQueryCache() : _size(0), _duration(0), _invPrecision(1.0f), _staticCost(0), _dynamicCost(0), _heightCost(0),
+    _lineOfSightHits(0), _lineOfSightPartialHits(0), _lineOfSightMisses(0), _heightHits(0), _heightMisses(0), _savedNanoseconds(0)
+{
+    uint32 size = sWorld->getIntConfig(CONFIG_MAP_QUERY_CACHE_SIZE);
+    if (!size)
+        return;
+
+    // power of two, the slot is picked by masking the key
+    _size = 1;
+    while (_size < size)
+        _size <<= 1;
+
+    _duration = sWorld->getIntConfig(CONFIG_MAP_QUERY_CACHE_DURATION);
+    _invPrecision = 1.0f / sWorld->getFloatConfig(CONFIG_MAP_QUERY_CACHE_PRECISION);
+    _lineOfSight.reset(new LineOfSightEntry[_size]);
+    _height.reset(new HeightEntry[_size]);
+}
+
+uint64 MapQueryCache::LineOfSightKey(float x1, float y1, float z1, float x2, float y2, float z2) const
+{
+    uint64 hash = 0;
+    hash = Mix(hash, Quantize(x1, _invPrecision));
+    hash = Mix(hash, Quantize(y1, _invPrecision));
+    hash = Mix(hash, Quantize(z1, _invPrecision));
+    hash = Mix(hash, Quantize(x2, _invPrecision));
+    hash = Mix(hash, Quantize(y2, _invPrecision));
+    hash = Mix(hash, Quantize(z2, _invPrecision));
+    return hash;
+}
+
+uint64 MapQueryCache::HeightKey(float x, float y, float z, bool checkVMap, float maxSearchDist) const
+{
+    uint32 searchDist;
+    memcpy(&searchDist, &maxSearchDist, sizeof(searchDist));
+
+    uint64 hash = checkVMap ? 1 : 2;
+    hash = Mix(hash, Quantize(x, _invPrecision));
+    hash = Mix(hash, Quantize(y, _invPrecision));
+    hash = Mix(hash, Quantize(z, _invPrecision));
+    hash = Mix(hash, searchDist);
+    return hash;
+}
+
+uint32 MapQueryCache::PhaseHash(std::set<uint32> const& phases)
+{
+    uint64 hash = phases.size();
+    for (uint32 phase : phases)
+        hash = Mix(hash, phase);
+
+    return uint32(hash ^ (hash >> 32));
+}
+
+MapQueryCache::Stats MapQueryCache::GetStats() const
+{
+    Stats stats;
+    stats.LineOfSightHits = _lineOfSightHits.load(std::memory_order_relaxed);
+    stats.LineOfSightPartialHits = _lineOfSightPartialHits.load(std::memory_order_relaxed);
+    stats.LineOfSightMisses = _lineOfSightMisses.load(std::memory_order_relaxed);
+    stats.HeightHits = _heightHits.load(std::memory_order_relaxed);
+    stats.HeightMisses = _heightMisses.load(std::memory_order_relaxed);
+    stats.SavedMicroseconds = _savedNanoseconds.load(std::memory_order_relaxed) / 1000;
+    return stats;
+}
+
+void MapQueryCache::ResetStats()
+{
+    _lineOfSightHits = 0;
+    _lineOfSightPartialHits = 0;
+    _lineOfSightMisses = 0;
+    _heightHits = 0;
+    _heightMisses = 0;
+    _savedNanoseconds = 0;
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2008-2016 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_MAPQUERYCACHE_H
+#define TRINITY_MAPQUERYCACHE_H
+
+#include "Define.h"
+#include "Timer.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+
+/*
+ * Short lived answers of Map::isInLineOfSight and Map::GetHeight, keyed by the
+ * query positions rounded to Map.QueryCache.Precision. Terrain and vmaps never
+ * change, so the static part of an answer only expires with its age. The
+ * gameobject part of a line of sight answer is reused only while the phases and
+ * the DynamicMapTree generation are the same as when it was computed.
+ */
+class MapQueryCache
+{
+public:
+    struct Stats
+    {
+        uint64 LineOfSightHits;
+        uint64 LineOfSightPartialHits;   // static part reused, gameobjects traced again
+        uint64 LineOfSightMisses;
+        uint64 HeightHits;
+        uint64 HeightMisses;
+        uint64 SavedMicroseconds;        // estimated from the average cost of the queries answered
+    };
+
+    MapQueryCache();
+
+    bool IsEnabled() const { return _size != 0; }
+
+    template<class StaticCheck, class DynamicCheck>
+    bool GetLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, std::set<uint32> const& phases, uint32 generation,
+        StaticCheck&& staticCheck, DynamicCheck&& dynamicCheck);
+
+    template<class HeightQuery>
+    float GetHeight(float x, float y, float z, bool checkVMap, float maxSearchDist, HeightQuery&& query);
+
+    Stats GetStats() const;
+    void ResetStats();
+
+private:
+    struct LineOfSightEntry
+    {
+        uint64 Key = 0;
+        uint32 Expire = 0;
+        uint32 Generation = 0;
+        uint32 Phases = 0;
+        bool StaticVisible = false;
+        bool DynamicKnown = false;
+        bool DynamicVisible = false;
+    };
+
+    struct HeightEntry
+    {
+        uint64 Key = 0;
+        uint32 Expire = 0;
+        float Height = 0.0f;
+    };
+
+    static uint32 const LockStripes = 16;
+
+    uint64 LineOfSightKey(float x1, float y1, float z1, float x2, float y2, float z2) const;
+    uint64 HeightKey(float x, float y, float z, bool checkVMap, float maxSearchDist) const;
+    static uint32 PhaseHash(std::set<uint32> const& phases);
+    // striped by slot, every key landing in a slot takes the same lock
+    std::mutex& GetLock(uint64 key) { return _locks[(key & (_size - 1)) % LockStripes]; }
+    static bool IsAlive(uint32 expire, uint32 now) { return int32(expire - now) > 0; }
+
+    template<class Query>
+    static auto Timed(Query&& query, std::atomic<uint32>& averageCost) -> decltype(query());
+    void AddSaved(std::atomic<uint32> const& averageCost) { _savedNanoseconds.fetch_add(averageCost.load(std::memory_order_relaxed), std::memory_order_relaxed); }
+
+    uint32 _size;
+    uint32 _duration;
+    float _invPrecision;
+    std::unique_ptr<LineOfSightEntry[]> _lineOfSight;
+    std::unique_ptr<HeightEntry[]> _height;
+    std::mutex _locks[LockStripes];
+
+    std::atomic<uint32> _staticCost;
+    std::atomic<uint32> _dynamicCost;
+    std::atomic<uint32> _heightCost;
+
+    std::atomic<uint64> _lineOfSightHits;
+    std::atomic<uint64> _lineOfSightPartialHits;
+    std::atomic<uint64> _lineOfSightMisses;
+    std::atomic<uint64> _heightHits;
+    std::atomic<uint64> _heightMisses;
+    std::atomic<uint64> _savedNanoseconds;
+};
+
+template<class Query>
+auto MapQueryCache::Timed(Query&& query, std::atomic<uint32>& averageCost) -> decltype(query())
+{
+    auto start = std::chrono::steady_clock::now();
+    auto result = query();
+    uint32 cost = uint32(std::min<int64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(), 0x7FFFFFFF));
+    // running average, lost updates between threads do not matter
+    uint32 average = averageCost.load(std::memory_order_relaxed);
+    averageCost.store(average ? average - average / 8 + cost / 8 : cost, std::memory_order_relaxed);
+    return result;
+}
+
+template<class StaticCheck, class DynamicCheck>
+bool MapQueryCache::GetLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, std::set<uint32> const& phases, uint32 generation,
+    StaticCheck&& staticCheck, DynamicCheck&& dynamicCheck)
+{
+    uint64 key = LineOfSightKey(x1, y1, z1, x2, y2, z2);
+    uint32 phaseHash = PhaseHash(phases);
+    uint32 now = getMSTime();
+    LineOfSightEntry& slot = _lineOfSight[key & (_size - 1)];
+
+    LineOfSightEntry entry;
+    {
+        std::lock_guard<std::mutex> lock(GetLock(key));
+        entry = slot;
+    }
+
+    bool staticKnown = entry.Key == key && IsAlive(entry.Expire, now);
+    if (staticKnown && (!entry.StaticVisible || (entry.DynamicKnown && entry.Generation == generation && entry.Phases == phaseHash)))
+    {
+        ++_lineOfSightHits;
+        AddSaved(_staticCost);
+        if (entry.StaticVisible)
+            AddSaved(_dynamicCost);
+        return entry.StaticVisible && entry.DynamicVisible;
+    }
+
+    if (staticKnown)
+    {
+        ++_lineOfSightPartialHits;
+        AddSaved(_staticCost);
+    }
+    else
+    {
+        ++_lineOfSightMisses;
+        entry = LineOfSightEntry();
+        entry.Key = key;
+        entry.Expire = now + _duration;
+        entry.StaticVisible = Timed(staticCheck, _staticCost);
+    }
+
+    if (entry.StaticVisible)
+    {
+        entry.DynamicVisible = Timed(dynamicCheck, _dynamicCost);
+        entry.DynamicKnown = true;
+        entry.Generation = generation;
+        entry.Phases = phaseHash;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(GetLock(key));
+        slot = entry;
+    }
+
+    return entry.StaticVisible && entry.DynamicVisible;
+}
+
+template<class HeightQuery>
+float MapQueryCache::GetHeight(float x, float y, float z, bool checkVMap, float maxSearchDist, HeightQuery&& query)
+{
+    uint64 key = HeightKey(x, y, z, checkVMap, maxSearchDist);
+    uint32 now = getMSTime();
+    HeightEntry& slot = _height[key & (_size - 1)];
+
+    {
+        std::lock_guard<std::mutex> lock(GetLock(key));
+        if (slot.Key == key && IsAlive(slot.Expire, now))
+        {
+            ++_heightHits;
+            AddSaved(_heightCost);
+            return slot.Height;
+        }
+    }
+
+    ++_heightMisses;
+    float height = Timed(query, _heightCost);
+
+    std::lock_guard<std::mutex> lock(GetLock(key));
+    slot.Key = key;
+    slot.Expire = now + _duration;
+    slot.Height = height;
+    return height;
+}
+
+#endif // TRINITY_MAPQUERYCACHE_H
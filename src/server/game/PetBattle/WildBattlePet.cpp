@@ -80,41 +80,43 @@ void WildBattlePetMgr::Load()
     TC_LOG_INFO(LOG_FILTER_SERVER_LOADING, ">> Loaded %u species definitions.", count);
 }
 
-void WildBattlePetMgr::Populate(WildPetPoolTemplate* wTemplate, WildBattlePetPool* pTemplate)
+uint32 WildBattlePetMgr::Populate(WildPetPoolTemplate* wTemplate, WildBattlePetPool* pTemplate, uint32 budget)
 {
-    if (!wTemplate)
-        return;
-
-    if (wTemplate->Max <= pTemplate->Replaced.size())
-        return;
-
-    if (sDB2Manager.HasBattlePetSpeciesFlag(wTemplate->Species, BATTLEPET_SPECIES_FLAG_UNTAMEABLE))
-        return;
+    if (!wTemplate || wTemplate->Max <= pTemplate->Replaced.size())
+        return 0;
 
-    std::vector<Creature*> availableForReplacement;
-    if (!pTemplate->ToBeReplaced.empty())
-        for (auto itr2 = pTemplate->ToBeReplaced.begin(); itr2 != pTemplate->ToBeReplaced.end(); ++itr2)
-            if (pTemplate->ReplacedRelation.find((*itr2)->GetGUID()) == pTemplate->ReplacedRelation.end())
-                availableForReplacement.push_back(*itr2);
+    if (pTemplate->CandidatesDirty)
+    {
+        pTemplate->Candidates.clear();
+        for (Creature* creature : pTemplate->ToBeReplaced)
+            if (pTemplate->ReplacedRelation.find(creature->GetGUID()) == pTemplate->ReplacedRelation.end())
+                pTemplate->Candidates.push_back(creature);
 
-    if (availableForReplacement.empty())
-        return;
+        std::shuffle(pTemplate->Candidates.begin(), pTemplate->Candidates.end(), std::mt19937(std::random_device()()));
+        pTemplate->CandidatesDirty = false;
+    }
 
-    std::shuffle(availableForReplacement.begin(), availableForReplacement.end(), std::mt19937(std::random_device()()));
+    uint32 replaced = 0;
+    while (!pTemplate->Candidates.empty() && replaced < budget && wTemplate->Max > pTemplate->Replaced.size())
+    {
+        // a creature that can't be replaced now is tried again once the pool changes
+        Creature* creature = pTemplate->Candidates.back();
+        pTemplate->Candidates.pop_back();
+        if (ReplaceCreature(creature, wTemplate, pTemplate))
+            ++replaced;
+    }
 
-    uint32 replaceCount = wTemplate->Max - pTemplate->Replaced.size();
-    for (size_t y = 0; y < availableForReplacement.size() && y < replaceCount; y++)
-        ReplaceCreature(availableForReplacement[y], wTemplate, pTemplate);
+    return replaced;
 }
 
-void WildBattlePetMgr::ReplaceCreature(Creature* creature, WildPetPoolTemplate* wTemplate, WildBattlePetPool* pTemplate)
+bool WildBattlePetMgr::ReplaceCreature(Creature* creature, WildPetPoolTemplate* wTemplate, WildBattlePetPool* pTemplate)
 {
     if (!creature->FindMap())
-        return;
+        return false;
 
     BattlePetSpeciesEntry const* speciesInfo = sBattlePetSpeciesStore.LookupEntry(wTemplate->Species);
     if (!speciesInfo)
-        return;
+        return false;
 
     auto replacementCreature = new Creature();
     replacementCreature->m_isTempWorldObject = true;
@@ -122,7 +124,7 @@ void WildBattlePetMgr::ReplaceCreature(Creature* creature, WildPetPoolTemplate*
     if (!replacementCreature->Create(sObjectMgr->GetGenerator<HighGuid::Creature>()->Generate(), creature->GetMap(), creature->GetPhaseMask(), speciesInfo->CreatureID, 0, 0, creature->m_positionX, creature->m_positionY, creature->m_positionZ, creature->m_orientation))
     {
         delete replacementCreature;
-        return;
+        return false;
     }
 
     replacementCreature->SetHomePosition(*replacementCreature);
@@ -193,7 +195,7 @@ void WildBattlePetMgr::ReplaceCreature(Creature* creature, WildPetPoolTemplate*
     if (!creature->GetMap()->AddToMap(replacementCreature))
     {
         delete replacementCreature;
-        return;
+        return false;
     }
 
     // Despawn replaced creature
@@ -203,6 +205,7 @@ void WildBattlePetMgr::ReplaceCreature(Creature* creature, WildPetPoolTemplate*
 
     pTemplate->ReplacedRelation[creature->GetGUID()] = replacementCreature->GetGUID();
     pTemplate->Replaced.insert(replacementCreature);
+    return true;
 }
 
 void WildBattlePetMgr::EnableWildBattle(Creature* creature)
@@ -315,6 +318,7 @@ void WildBattlePetMgr::UnreplaceCreature(Creature* creature)
     creature->Respawn();
 
     pTemplate->ReplacedRelation.erase(creature->GetGUID());
+    pTemplate->CandidatesDirty = true;
 }
 
 bool WildBattlePetMgr::IsWildPet(Creature* creature)
@@ -19,13 +19,6 @@
 
 class Creature;
 
-struct WildBattlePetPool
-{
-    std::set<Creature*> ToBeReplaced;
-    std::set<Creature*> Replaced;
-    std::map<ObjectGuid, ObjectGuid> ReplacedRelation;
-};
-
 struct WildPetPoolTemplate
 {
     uint32 Species{};
@@ -37,6 +30,21 @@ struct WildPetPoolTemplate
     uint32 MaxLevel{};
 };
 
+struct WildBattlePetPool
+{
+    std::set<Creature*> ToBeReplaced;
+    std::set<Creature*> Replaced;
+    std::map<ObjectGuid, ObjectGuid> ReplacedRelation;
+
+    /// shuffled creatures of ToBeReplaced not replaced yet, rebuilt when CandidatesDirty is set
+    std::vector<Creature*> Candidates;
+    bool CandidatesDirty = true;
+
+    /// nullptr when the zone has no pool for the entry or the species can't be tamed
+    WildPetPoolTemplate* Template = nullptr;
+    bool TemplateResolved = false;
+};
+
 class WildBattlePetZonePools
 {
 public:
@@ -53,10 +61,11 @@ public:
 
     void Load();
 
-    void Populate(WildPetPoolTemplate* wTemplate, WildBattlePetPool* pTemplate);
+    /// replaces up to budget creatures of the pool, returns how many were replaced
+    uint32 Populate(WildPetPoolTemplate* wTemplate, WildBattlePetPool* pTemplate, uint32 budget);
     void Depopulate(WildBattlePetPool* pTemplate);
 
-    void ReplaceCreature(Creature* creature, WildPetPoolTemplate* wTemplate, WildBattlePetPool* pTemplate);
+    bool ReplaceCreature(Creature* creature, WildPetPoolTemplate* wTemplate, WildBattlePetPool* pTemplate);
     void EnableWildBattle(Creature* creature);
     void UnreplaceCreature(Creature* creature);
 
@@ -52,6 +52,56 @@
 
 UnusedScriptNamesContainer UnusedScriptNames;
 
+namespace
+{
+#if defined(__GNUC__) || defined(__clang__)
+    // Itanium C++ ABI: a pointer to member function is { ptr, adj }. For a virtual function ptr holds
+    // its offset in the vtable, flagged by the lowest bit of ptr, or of adj on ARM.
+    struct MemberFunctionPointer
+    {
+        std::ptrdiff_t Ptr;
+        std::ptrdiff_t Adj;
+    };
+
+    // Offset of a virtual member function in the vtable, -1 when it can't be told
+    template<class Hook>
+    std::ptrdiff_t GetVTableOffset(Hook hook)
+    {
+        static_assert(sizeof(Hook) == sizeof(MemberFunctionPointer), "Unexpected pointer to member function layout");
+
+        MemberFunctionPointer pointer;
+        memcpy(&pointer, &hook, sizeof(pointer));
+#if defined(__arm__) || defined(__aarch64__)
+        if (!(pointer.Adj & 1) || (pointer.Adj >> 1))
+            return -1;
+
+        return pointer.Ptr;
+#else
+        if (!(pointer.Ptr & 1) || pointer.Adj)
+            return -1;
+
+        return pointer.Ptr - 1;
+#endif
+    }
+
+    void const* const* GetVTable(void const* object)
+    {
+        return *static_cast<void const* const* const*>(object);
+    }
+
+    void const* GetVTableEntry(void const* const* vtable, std::ptrdiff_t offset)
+    {
+        return *reinterpret_cast<void const* const*>(reinterpret_cast<char const*>(vtable) + offset);
+    }
+#else
+    // other ABIs don't tell, scripts then subscribe to every hook of their type
+    template<class Hook>
+    std::ptrdiff_t GetVTableOffset(Hook /*hook*/) { return -1; }
+    void const* const* GetVTable(void const* /*object*/) { return nullptr; }
+    void const* GetVTableEntry(void const* const* /*vtable*/, std::ptrdiff_t /*offset*/) { return nullptr; }
+#endif
+}
+
 // This is the global static registry of scripts.
 template<class TScript>
 class ScriptRegistry
@@ -65,10 +115,18 @@ class ScriptRegistry
         // after server startup.
         static ScriptMap ScriptPointerList;
 
+        // Bumped whenever ScriptPointerList changes, hook subscriber lists are rebuilt from it.
+        static std::atomic<uint32> Generation;
+
         static void AddScript(TScript* const script)
         {
             ASSERT(script);
 
+            // AddScript runs in the TScript constructor, so the script still has the TScript vtable here.
+            // Overrides can only be told once the script is fully built, see OverridesHook.
+            if (!TypeVTable)
+                TypeVTable = GetVTable(script);
+
             // See if the script is using the same memory as another script. If this happens, it means that
             // someone forgot to allocate new memory for a script.
             for (ScriptMapIterator it = ScriptPointerList.begin(); it != ScriptPointerList.end(); ++it)
@@ -106,6 +164,7 @@ class ScriptRegistry
                     if (!existing)
                     {
                         ScriptPointerList[id] = script;
+                        ++Generation;
                         sScriptMgr->IncrementScriptCount();
 
 #ifdef SCRIPTS
@@ -131,6 +190,7 @@ class ScriptRegistry
             {
                 // We're dealing with a code-only script; just add it.
                 ScriptPointerList[_scriptIdCounter++] = script;
+                ++Generation;
                 sScriptMgr->IncrementScriptCount();
             }
         }
@@ -145,10 +205,25 @@ class ScriptRegistry
             return nullptr;
         }
 
+        // Whether the script overrides hook, compares the function its vtable holds for the hook with
+        // the TScript one. True when the pointer to member can't be decoded.
+        template<class Hook>
+        static bool OverridesHook(TScript const* script, Hook hook)
+        {
+            std::ptrdiff_t offset = GetVTableOffset(hook);
+            if (offset < 0 || !TypeVTable)
+                return true;
+
+            return GetVTableEntry(GetVTable(script), offset) != GetVTableEntry(TypeVTable, offset);
+        }
+
     private:
 
         // Counter used for code-only scripts.
         static uint32 _scriptIdCounter;
+
+        // vtable of TScript itself, the default hook implementations
+        static void const* const* TypeVTable;
 };
 
 // Utility macros to refer to the script registry.
@@ -167,9 +242,145 @@ class ScriptRegistry
         return R; \
     for (SCR_REG_ITR(T) C = SCR_REG_LST(T).begin(); \
         C != SCR_REG_LST(T).end(); ++C)
-#define FOREACH_SCRIPT(T) \
-    FOR_SCRIPTS(T, itr, end) \
-    itr->second
+
+namespace
+{
+    // Broadcast hook calls made by one thread, only that thread writes it
+    class HookInvocationCounter
+    {
+        public:
+            HookInvocationCounter();
+            ~HookInvocationCounter();
+
+            void Increment() { _invocations.store(_invocations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+            uint64 Get() const { return _invocations.load(std::memory_order_relaxed); }
+
+        private:
+            std::atomic<uint64> _invocations;
+    };
+
+    std::mutex HookInvocationCountersLock;
+    std::vector<HookInvocationCounter const*> HookInvocationCounters;
+    uint64 ExitedThreadHookInvocations = 0;
+
+    HookInvocationCounter::HookInvocationCounter() : _invocations(0)
+    {
+        std::lock_guard<std::mutex> lock(HookInvocationCountersLock);
+        HookInvocationCounters.push_back(this);
+    }
+
+    HookInvocationCounter::~HookInvocationCounter()
+    {
+        std::lock_guard<std::mutex> lock(HookInvocationCountersLock);
+        ExitedThreadHookInvocations += Get();
+        HookInvocationCounters.erase(std::find(HookInvocationCounters.begin(), HookInvocationCounters.end(), this));
+    }
+
+    thread_local HookInvocationCounter ThreadHookInvocations;
+
+    class ScriptHookBase;
+
+    std::mutex ScriptHooksLock;
+    std::vector<ScriptHookBase*> ScriptHooks;
+
+    class ScriptHookBase
+    {
+        public:
+            ScriptHookBase()
+            {
+                std::lock_guard<std::mutex> lock(ScriptHooksLock);
+                ScriptHooks.push_back(this);
+            }
+
+            virtual void FreeRetiredSubscribers() = 0;
+
+        protected:
+            ~ScriptHookBase() = default;
+    };
+
+    // Scripts of type TScript that override one hook, so a hook nobody overrides costs an empty check.
+    // The list is rebuilt on the first call after the registry changed. Registry changes only happen
+    // while no hook is dispatched (load and unload), the replaced lists are freed there as well.
+    template<class TScript, class Hook>
+    class ScriptHook : public ScriptHookBase
+    {
+        public:
+            typedef std::vector<TScript*> SubscriberList;
+
+            explicit ScriptHook(Hook hook) : _hook(hook), _subscribers(nullptr), _generation(0) { }
+
+            SubscriberList const& GetSubscribers()
+            {
+                ThreadHookInvocations.Increment();
+
+                SubscriberList const* subscribers = _subscribers.load(std::memory_order_acquire);
+                if (!subscribers || _generation.load(std::memory_order_acquire) != ScriptRegistry<TScript>::Generation.load(std::memory_order_acquire))
+                    subscribers = Rebuild();
+
+                return *subscribers;
+            }
+
+            void FreeRetiredSubscribers() override
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                _retired.clear();
+            }
+
+        private:
+            SubscriberList const* Rebuild()
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+
+                uint32 generation = ScriptRegistry<TScript>::Generation.load(std::memory_order_acquire);
+                if (_current && _generation.load(std::memory_order_relaxed) == generation)
+                    return _current.get();
+
+                std::unique_ptr<SubscriberList> subscribers = Trinity::make_unique<SubscriberList>();
+                for (auto const& pair : ScriptRegistry<TScript>::ScriptPointerList)
+                    if (ScriptRegistry<TScript>::OverridesHook(pair.second, _hook))
+                        subscribers->push_back(pair.second);
+
+                if (_current)
+                    _retired.push_back(std::move(_current));
+
+                _current = std::move(subscribers);
+                _subscribers.store(_current.get(), std::memory_order_release);
+                _generation.store(generation, std::memory_order_release);
+                return _current.get();
+            }
+
+            Hook _hook;
+            std::atomic<SubscriberList const*> _subscribers;
+            std::atomic<uint32> _generation;
+            std::mutex _lock;
+            std::unique_ptr<SubscriberList> _current;
+            std::vector<std::unique_ptr<SubscriberList>> _retired;
+    };
+
+    // Only call it while no hook can be dispatched
+    void FreeRetiredHookSubscribers()
+    {
+        std::lock_guard<std::mutex> lock(ScriptHooksLock);
+        for (ScriptHookBase* hook : ScriptHooks)
+            hook->FreeRetiredSubscribers();
+    }
+}
+
+// Calls hook H on the scripts of type T overriding it.
+#define FOREACH_SCRIPT_HOOK(T, H, ...) \
+    { \
+        static ScriptHook<T, decltype(&T::H)> hook(&T::H); \
+        for (T* script : hook.GetSubscribers()) \
+            script->H(__VA_ARGS__); \
+    }
+
+// Same for an overloaded hook, S is the parameter list of the overload.
+#define FOREACH_SCRIPT_OVERLOADED_HOOK(T, H, S, ...) \
+    { \
+        static ScriptHook<T, void (T::*)S> hook(&T::H); \
+        for (T* script : hook.GetSubscribers()) \
+            script->H(__VA_ARGS__); \
+    }
 
 // Utility macros for finding specific scripts.
 #define GET_SCRIPT_NO_RET(T, I, V) \
@@ -263,7 +474,7 @@ struct TSpellSummary
     uint8 Effects;                                          // set of enum SelectEffect
 } *SpellSummary;
 
-ScriptMgr::ScriptMgr() : _scriptCount(0)
+ScriptMgr::ScriptMgr() : _scriptCount(0), _hookRateSampleTime(getMSTime()), _hookRateSampleCount(0), _hookRate(0)
 {
     _scheduledScripts = 0;
     _script_loader_callback = nullptr;
@@ -271,6 +482,34 @@ ScriptMgr::ScriptMgr() : _scriptCount(0)
 
 ScriptMgr::~ScriptMgr() = default;
 
+uint64 ScriptMgr::GetHookInvocationCount() const
+{
+    std::lock_guard<std::mutex> lock(HookInvocationCountersLock);
+
+    uint64 invocations = ExitedThreadHookInvocations;
+    for (HookInvocationCounter const* counter : HookInvocationCounters)
+        invocations += counter->Get();
+
+    return invocations;
+}
+
+uint32 ScriptMgr::GetHookInvocationRate()
+{
+    std::lock_guard<std::mutex> lock(_hookRateLock);
+
+    uint32 now = getMSTime();
+    uint32 elapsed = getMSTimeDiff(_hookRateSampleTime, now);
+    if (elapsed >= IN_MILLISECONDS)
+    {
+        uint64 invocations = GetHookInvocationCount();
+        _hookRate = uint32((invocations - _hookRateSampleCount) * IN_MILLISECONDS / elapsed);
+        _hookRateSampleTime = now;
+        _hookRateSampleCount = invocations;
+    }
+
+    return _hookRate;
+}
+
 void ScriptMgr::Initialize()
 {
     uint32 oldMSTime = getMSTime();
@@ -292,6 +531,9 @@ void ScriptMgr::Initialize()
     }
 #endif
 
+    // lists built while the scripts were loading
+    FreeRetiredHookSubscribers();
+
     TC_LOG_INFO(LOG_FILTER_SERVER_LOADING, ">> Loaded %u C++ scripts in %u ms", GetScriptCount(), GetMSTimeDiffToNow(oldMSTime));
 }
 
@@ -300,7 +542,8 @@ void ScriptMgr::Unload()
     #define SCR_CLEAR(T) \
         for (SCR_REG_ITR(T) itr = SCR_REG_LST(T).begin(); itr != SCR_REG_LST(T).end(); ++itr) \
             delete itr->second; \
-        SCR_REG_LST(T).clear();
+        SCR_REG_LST(T).clear(); \
+        ++ScriptRegistry<T>::Generation;
 
     // Clear scripts for every script type.
     SCR_CLEAR(SpellScriptLoader);
@@ -335,6 +578,8 @@ void ScriptMgr::Unload()
 
     #undef SCR_CLEAR
 
+    FreeRetiredHookSubscribers();
+
     delete[] SpellSummary;
     delete[] UnitAI::AISpellInfo;
 }
@@ -478,52 +723,52 @@ SpellScriptLoader* ScriptMgr::GetSpellScriptLoader(uint32 scriptId)
 
 void ScriptMgr::OnOpenStateChange(bool open)
 {
-    FOREACH_SCRIPT(WorldScript)->OnOpenStateChange(open);
+    FOREACH_SCRIPT_HOOK(WorldScript, OnOpenStateChange, open);
 }
 
 void ScriptMgr::OnConfigLoad(bool reload)
 {
-    FOREACH_SCRIPT(WorldScript)->OnConfigLoad(reload);
+    FOREACH_SCRIPT_HOOK(WorldScript, OnConfigLoad, reload);
 }
 
 void ScriptMgr::OnMotdChange(std::string& newMotd)
 {
-    FOREACH_SCRIPT(WorldScript)->OnMotdChange(newMotd);
+    FOREACH_SCRIPT_HOOK(WorldScript, OnMotdChange, newMotd);
 }
 
 void ScriptMgr::OnShutdownInitiate(ShutdownExitCode code, ShutdownMask mask)
 {
-    FOREACH_SCRIPT(WorldScript)->OnShutdownInitiate(code, mask);
+    FOREACH_SCRIPT_HOOK(WorldScript, OnShutdownInitiate, code, mask);
 }
 
 void ScriptMgr::OnShutdownCancel()
 {
-    FOREACH_SCRIPT(WorldScript)->OnShutdownCancel();
+    FOREACH_SCRIPT_HOOK(WorldScript, OnShutdownCancel);
 }
 
 void ScriptMgr::OnHonorCalculation(float& honor, uint8 level, float multiplier)
 {
-    FOREACH_SCRIPT(FormulaScript)->OnHonorCalculation(honor, level, multiplier);
+    FOREACH_SCRIPT_HOOK(FormulaScript, OnHonorCalculation, honor, level, multiplier);
 }
 
 void ScriptMgr::OnGrayLevelCalculation(uint8& grayLevel, uint8 playerLevel)
 {
-    FOREACH_SCRIPT(FormulaScript)->OnGrayLevelCalculation(grayLevel, playerLevel);
+    FOREACH_SCRIPT_HOOK(FormulaScript, OnGrayLevelCalculation, grayLevel, playerLevel);
 }
 
 void ScriptMgr::OnColorCodeCalculation(XPColorChar& color, uint8 playerLevel, uint8 mobLevel)
 {
-    FOREACH_SCRIPT(FormulaScript)->OnColorCodeCalculation(color, playerLevel, mobLevel);
+    FOREACH_SCRIPT_HOOK(FormulaScript, OnColorCodeCalculation, color, playerLevel, mobLevel);
 }
 
 void ScriptMgr::OnZeroDifferenceCalculation(uint8& diff, uint8 playerLevel)
 {
-    FOREACH_SCRIPT(FormulaScript)->OnZeroDifferenceCalculation(diff, playerLevel);
+    FOREACH_SCRIPT_HOOK(FormulaScript, OnZeroDifferenceCalculation, diff, playerLevel);
 }
 
 void ScriptMgr::OnBaseGainCalculation(uint32& gain, uint8 playerLevel, uint8 mobLevel)
 {
-    FOREACH_SCRIPT(FormulaScript)->OnBaseGainCalculation(gain, playerLevel, mobLevel);
+    FOREACH_SCRIPT_HOOK(FormulaScript, OnBaseGainCalculation, gain, playerLevel, mobLevel);
 }
 
 void ScriptMgr::OnGainCalculation(uint32& gain, Player* player, Unit* unit)
@@ -531,12 +776,12 @@ void ScriptMgr::OnGainCalculation(uint32& gain, Player* player, Unit* unit)
     ASSERT(player);
     ASSERT(unit);
 
-    FOREACH_SCRIPT(FormulaScript)->OnGainCalculation(gain, player, unit);
+    FOREACH_SCRIPT_HOOK(FormulaScript, OnGainCalculation, gain, player, unit);
 }
 
 void ScriptMgr::OnGroupRateCalculation(float& rate, uint32 count, bool isRaid)
 {
-    FOREACH_SCRIPT(FormulaScript)->OnGroupRateCalculation(rate, count, isRaid);
+    FOREACH_SCRIPT_HOOK(FormulaScript, OnGroupRateCalculation, rate, count, isRaid);
 }
 
 #define SCR_MAP_BGN(M, V, I, E, C, T) \
@@ -631,7 +876,7 @@ void ScriptMgr::OnPlayerEnterMap(Map* map, Player* player)
     ASSERT(map);
     ASSERT(player);
 
-    FOREACH_SCRIPT(PlayerScript)->OnMapChanged(player);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnMapChanged, player);
 
     SCR_MAP_BGN(WorldMapScript, map, itr, end, entry, IsWorldMap);
         itr->second->OnPlayerEnter(map, player);
@@ -1053,7 +1298,7 @@ void ScriptMgr::OnAuctionAdd(AuctionHouseObject* ah, AuctionEntry* entry)
     ASSERT(ah);
     ASSERT(entry);
 
-    FOREACH_SCRIPT(AuctionHouseScript)->OnAuctionAdd(ah, entry);
+    FOREACH_SCRIPT_HOOK(AuctionHouseScript, OnAuctionAdd, ah, entry);
 }
 
 void ScriptMgr::OnAuctionRemove(AuctionHouseObject* ah, AuctionEntry* entry)
@@ -1061,7 +1306,7 @@ void ScriptMgr::OnAuctionRemove(AuctionHouseObject* ah, AuctionEntry* entry)
     ASSERT(ah);
     ASSERT(entry);
 
-    FOREACH_SCRIPT(AuctionHouseScript)->OnAuctionRemove(ah, entry);
+    FOREACH_SCRIPT_HOOK(AuctionHouseScript, OnAuctionRemove, ah, entry);
 }
 
 void ScriptMgr::OnAuctionSuccessful(AuctionHouseObject* ah, AuctionEntry* entry)
@@ -1069,7 +1314,7 @@ void ScriptMgr::OnAuctionSuccessful(AuctionHouseObject* ah, AuctionEntry* entry)
     ASSERT(ah);
     ASSERT(entry);
 
-    FOREACH_SCRIPT(AuctionHouseScript)->OnAuctionSuccessful(ah, entry);
+    FOREACH_SCRIPT_HOOK(AuctionHouseScript, OnAuctionSuccessful, ah, entry);
 }
 
 void ScriptMgr::OnAuctionExpire(AuctionHouseObject* ah, AuctionEntry* entry)
@@ -1077,7 +1322,7 @@ void ScriptMgr::OnAuctionExpire(AuctionHouseObject* ah, AuctionEntry* entry)
     ASSERT(ah);
     ASSERT(entry);
 
-    FOREACH_SCRIPT(AuctionHouseScript)->OnAuctionExpire(ah, entry);
+    FOREACH_SCRIPT_HOOK(AuctionHouseScript, OnAuctionExpire, ah, entry);
 }
 
 bool ScriptMgr::OnConditionCheck(Condition* condition, ConditionSourceInfo& sourceInfo)
@@ -1180,12 +1425,12 @@ void ScriptMgr::OnRelocate(Transport* transport, uint32 waypointId, uint32 mapId
 
 void ScriptMgr::OnStartup()
 {
-    FOREACH_SCRIPT(WorldScript)->OnStartup();
+    FOREACH_SCRIPT_HOOK(WorldScript, OnStartup);
 }
 
 void ScriptMgr::OnShutdown()
 {
-    FOREACH_SCRIPT(WorldScript)->OnShutdown();
+    FOREACH_SCRIPT_HOOK(WorldScript, OnShutdown);
 }
 
 bool ScriptMgr::OnCriteriaCheck(AchievementCriteriaData const* data, Player* source, Unit* target)
@@ -1218,294 +1463,294 @@ uint32 ScriptMgr::OnSelectItemReward(AchievementReward const* data, Player* sour
 // Player
 void ScriptMgr::OnPVPKill(Player* killer, Player* killed)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnPVPKill(killer, killed);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnPVPKill, killer, killed);
 }
 
 void ScriptMgr::OnCreatureKill(Player* killer, Creature* killed)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnCreatureKill(killer, killed);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnCreatureKill, killer, killed);
 }
 
 void ScriptMgr::OnPlayerKilledByCreature(Creature* killer, Player* killed)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnPlayerKilledByCreature(killer, killed);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnPlayerKilledByCreature, killer, killed);
 }
 
 void ScriptMgr::OnPlayerDeath(Player* player)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnDeath(player);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnDeath, player);
 }
 
 void ScriptMgr::OnPlayerLevelChanged(Player* player, uint8 oldLevel)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnLevelChanged(player, oldLevel);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnLevelChanged, player, oldLevel);
 }
 
 void ScriptMgr::OnPlayerFreeTalentPointsChanged(Player* player, uint32 points)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnFreeTalentPointsChanged(player, points);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnFreeTalentPointsChanged, player, points);
 }
 
 void ScriptMgr::OnPlayerTalentsReset(Player* player, bool noCost)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnTalentsReset(player, noCost);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnTalentsReset, player, noCost);
 }
 
 void ScriptMgr::OnPlayerMoneyChanged(Player* player, int64& amount)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnMoneyChanged(player, amount);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnMoneyChanged, player, amount);
 }
 
 void ScriptMgr::OnGivePlayerXP(Player* player, uint32& amount, Unit* victim)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnGiveXP(player, amount, victim);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnGiveXP, player, amount, victim);
 }
 
 void ScriptMgr::OnPlayerReputationChange(Player* player, uint32 factionID, int32& standing, bool incremental)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnReputationChange(player, factionID, standing, incremental);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnReputationChange, player, factionID, standing, incremental);
 }
 
 void ScriptMgr::OnPlayerDuelRequest(Player* target, Player* challenger)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnDuelRequest(target, challenger);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnDuelRequest, target, challenger);
 }
 
 void ScriptMgr::OnPlayerDuelStart(Player* player1, Player* player2)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnDuelStart(player1, player2);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnDuelStart, player1, player2);
 }
 
 void ScriptMgr::OnPlayerDuelEnd(Player* winner, Player* loser, DuelCompleteType type)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnDuelEnd(winner, loser, type);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnDuelEnd, winner, loser, type);
 }
 
 void ScriptMgr::OnPlayerChat(Player* player, uint32 type, uint32 lang, std::string& msg)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnChat(player, type, lang, msg);
+    FOREACH_SCRIPT_OVERLOADED_HOOK(PlayerScript, OnChat, (Player*, uint32, uint32, std::string&), player, type, lang, msg);
 }
 
 void ScriptMgr::OnPlayerChat(Player* player, uint32 type, uint32 lang, std::string& msg, Player* receiver)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnChat(player, type, lang, msg, receiver);
+    FOREACH_SCRIPT_OVERLOADED_HOOK(PlayerScript, OnChat, (Player*, uint32, uint32, std::string&, Player*), player, type, lang, msg, receiver);
 }
 
 void ScriptMgr::OnPlayerChat(Player* player, uint32 type, uint32 lang, std::string& msg, Group* group)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnChat(player, type, lang, msg, group);
+    FOREACH_SCRIPT_OVERLOADED_HOOK(PlayerScript, OnChat, (Player*, uint32, uint32, std::string&, Group*), player, type, lang, msg, group);
 }
 
 void ScriptMgr::OnPlayerChat(Player* player, uint32 type, uint32 lang, std::string& msg, Guild* guild)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnChat(player, type, lang, msg, guild);
+    FOREACH_SCRIPT_OVERLOADED_HOOK(PlayerScript, OnChat, (Player*, uint32, uint32, std::string&, Guild*), player, type, lang, msg, guild);
 }
 
 void ScriptMgr::OnPlayerChat(Player* player, uint32 type, uint32 lang, std::string& msg, Channel* channel)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnChat(player, type, lang, msg, channel);
+    FOREACH_SCRIPT_OVERLOADED_HOOK(PlayerScript, OnChat, (Player*, uint32, uint32, std::string&, Channel*), player, type, lang, msg, channel);
 }
 
 void ScriptMgr::OnPlayerClearEmote(Player* player)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnClearEmote(player);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnClearEmote, player);
 }
 
 void ScriptMgr::OnPlayerTextEmote(Player* player, uint32 textEmote, uint32 emoteNum, ObjectGuid const& guid)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnTextEmote(player, textEmote, emoteNum, guid);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnTextEmote, player, textEmote, emoteNum, guid);
 }
 
 void ScriptMgr::OnPlayerSpellCast(Player* player, Spell* spell, bool skipCheck)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnSpellCast(player, spell, skipCheck);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnSpellCast, player, spell, skipCheck);
 }
 
 void ScriptMgr::OnPlayerLogin(Player* player, bool firstLogin /*= false*/)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnLogin(player);
-    FOREACH_SCRIPT(PlayerScript)->OnLogin(player, firstLogin);
+    FOREACH_SCRIPT_OVERLOADED_HOOK(PlayerScript, OnLogin, (Player*), player);
+    FOREACH_SCRIPT_OVERLOADED_HOOK(PlayerScript, OnLogin, (Player*, bool), player, firstLogin);
 }
 
 void ScriptMgr::OnSessionLogin(WorldSession* session)
 {
-    FOREACH_SCRIPT(SessionScript)->OnLogin(session);
+    FOREACH_SCRIPT_HOOK(SessionScript, OnLogin, session);
 }
 
 void ScriptMgr::OnPlayerLogout(Player* player)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnLogout(player);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnLogout, player);
 }
 
 void ScriptMgr::OnPlayerCreate(Player* player)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnCreate(player);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnCreate, player);
 }
 
 void ScriptMgr::OnPlayerDelete(ObjectGuid const& guid)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnDelete(guid);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnDelete, guid);
 }
 
 void ScriptMgr::OnPlayerBindToInstance(Player* player, Difficulty difficulty, uint32 mapid, bool permanent)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnBindToInstance(player, difficulty, mapid, permanent);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnBindToInstance, player, difficulty, mapid, permanent);
 }
 
 void ScriptMgr::OnMovementInform(Player* player, uint32 moveType, uint32 ID)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnMovementInform(player, moveType, ID);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnMovementInform, player, moveType, ID);
 }
 
 void ScriptMgr::OnUpdate(Player* player, uint32 diff)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnUpdate(player, diff);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnUpdate, player, diff);
 }
 
 void ScriptMgr::OnPlayerSpellLearned(Player* player, uint32 spellID)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnSpellLearned(player, spellID);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnSpellLearned, player, spellID);
 }
 
 void ScriptMgr::OnPlayerUpdateZone(Player* player, uint32 newZone, uint32 newArea)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnUpdateZone(player, newZone, newArea);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnUpdateZone, player, newZone, newArea);
 }
 
 void ScriptMgr::OnPlayerUpdateArea(Player* player, uint32 newArea)
 {
-	FOREACH_SCRIPT(PlayerScript)->OnUpdateArea(player, newArea);
+	FOREACH_SCRIPT_HOOK(PlayerScript, OnUpdateArea, player, newArea);
 }
 
 void ScriptMgr::OnPlayerRepop(Player* player)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnPlayerRepop(player);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnPlayerRepop, player);
 }
 
 void ScriptMgr::OnPetBattleFinish(Player* player)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnPetBattleFinish(player);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnPetBattleFinish, player);
 }
 
 void ScriptMgr::OnPlayerWhoListCall(Player* player, const std::set<ObjectGuid> & playersGuids)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnWhoListCall(player, playersGuids);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnWhoListCall, player, playersGuids);
 }
 
 void ScriptMgr::OnPlayerSendMail(Player* player, std::string& subject, std::string& body, ObjectGuid receiverGuid)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnSendMail(player, subject, body, receiverGuid);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnSendMail, player, subject, body, receiverGuid);
 }
 
 void ScriptMgr::OnPlayerQuestReward(Player* player, Quest const* quest)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnQuestReward(player, quest);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnQuestReward, player, quest);
 }
 void ScriptMgr::OnPlayerEnterCombat(Player* player, Unit* target)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnEnterCombat(player, target);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnEnterCombat, player, target);
 }
 
 void ScriptMgr::OnMovieComplete(Player* player, uint32 movieId)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnMovieComplete(player, movieId);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnMovieComplete, player, movieId);
 }
 
 // Guild
 void ScriptMgr::OnGuildAddMember(Guild* guild, Player* player, uint8& plRank)
 {
-    FOREACH_SCRIPT(GuildScript)->OnAddMember(guild, player, plRank);
+    FOREACH_SCRIPT_HOOK(GuildScript, OnAddMember, guild, player, plRank);
 }
 
 void ScriptMgr::OnGuildRemoveMember(Guild* guild, Player* player, bool isDisbanding, bool isKicked)
 {
-    FOREACH_SCRIPT(GuildScript)->OnRemoveMember(guild, player, isDisbanding, isKicked);
+    FOREACH_SCRIPT_HOOK(GuildScript, OnRemoveMember, guild, player, isDisbanding, isKicked);
 }
 
 void ScriptMgr::OnGuildMOTDChanged(Guild* guild, std::string const& newMotd)
 {
-    FOREACH_SCRIPT(GuildScript)->OnMOTDChanged(guild, newMotd);
+    FOREACH_SCRIPT_HOOK(GuildScript, OnMOTDChanged, guild, newMotd);
 }
 
 void ScriptMgr::OnGuildInfoChanged(Guild* guild, std::string const& newInfo)
 {
-    FOREACH_SCRIPT(GuildScript)->OnInfoChanged(guild, newInfo);
+    FOREACH_SCRIPT_HOOK(GuildScript, OnInfoChanged, guild, newInfo);
 }
 
 void ScriptMgr::OnGuildCreate(Guild* guild, Player* leader, std::string const& name)
 {
-    FOREACH_SCRIPT(GuildScript)->OnCreate(guild, leader, name);
+    FOREACH_SCRIPT_HOOK(GuildScript, OnCreate, guild, leader, name);
 }
 
 void ScriptMgr::OnGuildDisband(Guild* guild)
 {
-    FOREACH_SCRIPT(GuildScript)->OnDisband(guild);
+    FOREACH_SCRIPT_HOOK(GuildScript, OnDisband, guild);
 }
 
 void ScriptMgr::OnGuildMemberWitdrawMoney(Guild* guild, Player* player, uint64 &amount, bool isRepair)
 {
-    FOREACH_SCRIPT(GuildScript)->OnMemberWitdrawMoney(guild, player, amount, isRepair);
+    FOREACH_SCRIPT_HOOK(GuildScript, OnMemberWitdrawMoney, guild, player, amount, isRepair);
 }
 
 void ScriptMgr::OnGuildMemberDepositMoney(Guild* guild, Player* player, uint64 &amount)
 {
-    FOREACH_SCRIPT(GuildScript)->OnMemberDepositMoney(guild, player, amount);
+    FOREACH_SCRIPT_HOOK(GuildScript, OnMemberDepositMoney, guild, player, amount);
 }
 
 void ScriptMgr::OnGuildItemMove(Guild* guild, Player* player, Item* pItem, bool isSrcBank, uint8 srcContainer, uint8 srcSlotId, bool isDestBank, uint8 destContainer, uint8 destSlotId)
 {
-    FOREACH_SCRIPT(GuildScript)->OnItemMove(guild, player, pItem, isSrcBank, srcContainer, srcSlotId, isDestBank, destContainer, destSlotId);
+    FOREACH_SCRIPT_HOOK(GuildScript, OnItemMove, guild, player, pItem, isSrcBank, srcContainer, srcSlotId, isDestBank, destContainer, destSlotId);
 }
 
 void ScriptMgr::OnGuildEvent(Guild* guild, uint8 eventType, uint32 playerGuid1, uint32 playerGuid2, uint8 newRank)
 {
-    FOREACH_SCRIPT(GuildScript)->OnEvent(guild, eventType, playerGuid1, playerGuid2, newRank);
+    FOREACH_SCRIPT_HOOK(GuildScript, OnEvent, guild, eventType, playerGuid1, playerGuid2, newRank);
 }
 
 void ScriptMgr::OnGuildBankEvent(Guild* guild, uint8 eventType, uint8 tabId, uint32 playerGuid, uint32 itemOrMoney, uint16 itemStackCount, uint8 destTabId)
 {
-    FOREACH_SCRIPT(GuildScript)->OnBankEvent(guild, eventType, tabId, playerGuid, itemOrMoney, itemStackCount, destTabId);
+    FOREACH_SCRIPT_HOOK(GuildScript, OnBankEvent, guild, eventType, tabId, playerGuid, itemOrMoney, itemStackCount, destTabId);
 }
 
 // Group
 void ScriptMgr::OnGroupAddMember(Group* group, ObjectGuid const& guid)
 {
     ASSERT(group);
-    FOREACH_SCRIPT(GroupScript)->OnAddMember(group, guid);
+    FOREACH_SCRIPT_HOOK(GroupScript, OnAddMember, group, guid);
 }
 
 void ScriptMgr::OnGroupInviteMember(Group* group, ObjectGuid const& guid)
 {
     ASSERT(group);
-    FOREACH_SCRIPT(GroupScript)->OnInviteMember(group, guid);
+    FOREACH_SCRIPT_HOOK(GroupScript, OnInviteMember, group, guid);
 }
 
 void ScriptMgr::OnGroupRemoveMember(Group* group, ObjectGuid const& guid, RemoveMethod method, ObjectGuid const& kicker, const char* reason)
 {
     ASSERT(group);
-    FOREACH_SCRIPT(GroupScript)->OnRemoveMember(group, guid, method, kicker, reason);
+    FOREACH_SCRIPT_HOOK(GroupScript, OnRemoveMember, group, guid, method, kicker, reason);
 }
 
 void ScriptMgr::OnGroupChangeLeader(Group* group, ObjectGuid const& newLeaderGuid, ObjectGuid const& oldLeaderGuid)
 {
     ASSERT(group);
-    FOREACH_SCRIPT(GroupScript)->OnChangeLeader(group, newLeaderGuid, oldLeaderGuid);
+    FOREACH_SCRIPT_HOOK(GroupScript, OnChangeLeader, group, newLeaderGuid, oldLeaderGuid);
 }
 
 void ScriptMgr::OnGroupDisband(Group* group)
 {
     ASSERT(group);
-    FOREACH_SCRIPT(GroupScript)->OnDisband(group);
+    FOREACH_SCRIPT_HOOK(GroupScript, OnDisband, group);
 }
 
 void ScriptMgr::OnWorldStateCreate(uint32 variableID, uint32 value, uint8 type)
 {
-    FOREACH_SCRIPT(WorldStateScript)->OnCreate(variableID, value, type);
+    FOREACH_SCRIPT_HOOK(WorldStateScript, OnCreate, variableID, value, type);
 }
 
 void ScriptMgr::OnWorldStateDelete(uint32 variableID, uint8 type)
 {
-    FOREACH_SCRIPT(WorldStateScript)->OnDelete(variableID, type);
+    FOREACH_SCRIPT_HOOK(WorldStateScript, OnDelete, variableID, type);
 }
 
 void ScriptMgr::OnQuestStatusChange(Player* player, Quest const* quest, QuestStatus oldStatus, QuestStatus newStatus)
@@ -1718,22 +1963,24 @@ QuestScript::QuestScript(std::string name) : ScriptObject(name)
 
 void ScriptMgr::OnLootItem(Player* player, Item* item, uint32 count)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnLootItem(player, item, count);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnLootItem, player, item, count);
 }
 
 void ScriptMgr::OnCreateItem(Player* player, Item* item, uint32 count)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnCreateItem(player, item, count);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnCreateItem, player, item, count);
 }
 
 void ScriptMgr::OnQuestRewardItem(Player* player, Item* item, uint32 count)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnQuestRewardItem(player, item, count);
+    FOREACH_SCRIPT_HOOK(PlayerScript, OnQuestRewardItem, player, item, count);
 }
 
 // Instantiate static members of ScriptRegistry.
 template<class TScript> std::unordered_map<uint32, TScript*> ScriptRegistry<TScript>::ScriptPointerList;
 template<class TScript> uint32 ScriptRegistry<TScript>::_scriptIdCounter = 0;
+template<class TScript> std::atomic<uint32> ScriptRegistry<TScript>::Generation(0);
+template<class TScript> void const* const* ScriptRegistry<TScript>::TypeVTable = nullptr;
 
 // Specialize for each script type class like so:
 template class ScriptRegistry<AchievementCriteriaScript>;
@@ -1770,7 +2017,7 @@ template class ScriptRegistry<QuestScript>;
 // Undefine utility macros.
 #undef GET_SCRIPT_RET
 #undef GET_SCRIPT
-#undef FOREACH_SCRIPT
+#undef FOREACH_SCRIPT_HOOK
 #undef FOR_SCRIPTS_RET
 #undef FOR_SCRIPTS
 #undef SCR_REG_LST
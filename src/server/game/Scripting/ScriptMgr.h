@@ -20,6 +20,7 @@
 #define SC_SCRIPTMGR_H
 
 #include <atomic>
+#include <mutex>
 #include "Common.h"
 #include "DB2Stores.h"
 #include "Player.h"
@@ -903,6 +904,10 @@ class ScriptMgr
         void IncrementScriptCount() { ++_scriptCount; }
         uint32 GetScriptCount() const { return _scriptCount; }
 
+        // broadcast hook calls since startup, and per second since the previous rate query
+        uint64 GetHookInvocationCount() const;
+        uint32 GetHookInvocationRate();
+
         typedef void(*ScriptLoaderCallbackType)();
 
         /// Sets the script loader callback which is invoked to load scripts
@@ -1127,6 +1132,11 @@ class ScriptMgr
 
         uint32 _scriptCount;
 
+        std::mutex _hookRateLock;
+        uint32 _hookRateSampleTime;
+        uint64 _hookRateSampleCount;
+        uint32 _hookRate;
+
         //atomic op counter for active scripts amount
         std::atomic_long _scheduledScripts;
         ScriptLoaderCallbackType _script_loader_callback;
@@ -75,4 +75,7 @@ class WorldPacket : public ByteBuffer
         ConnectionType _connection;
 };
 
+// Immutable packet queued by reference on every socket it is sent to
+typedef std::shared_ptr<WorldPacket const> SharedWorldPacket;
+
 #endif
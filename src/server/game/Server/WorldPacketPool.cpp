@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2008-2016 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WorldPacketPool.h"
+#include <mutex>
+
+namespace
+{
+    // storage of bigger packets (addon messages, chat...) is not kept around
+    std::size_t const MaxPooledPacketSize = 4096;
+    std::size_t const MaxFreePackets = 16384;
+
+    std::mutex PoolsLock;
+    std::vector<WorldPacketPool*> Pools;
+
+    void Increment(std::atomic<uint64>& counter)
+    {
+        // only the owning thread writes the counters
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+}
+
+WorldPacketPool::WorldPacketPool() : _returned(nullptr), _acquired(0), _recycled(0), _allocated(0), _freeCount(0)
+{
+}
+
+WorldPacketPool* WorldPacketPool::ForCurrentThread()
+{
+    thread_local WorldPacketPool* pool = nullptr;
+    if (!pool)
+    {
+        pool = new WorldPacketPool();
+
+        std::lock_guard<std::mutex> lock(PoolsLock);
+        Pools.push_back(pool);
+    }
+
+    return pool;
+}
+
+PooledWorldPacket* WorldPacketPool::Acquire(uint16 opcode, ConnectionType connection, uint8 const* data, std::size_t size)
+{
+    if (_free.empty())
+        TakeReturned();
+
+    PooledWorldPacket* packet;
+    if (_free.empty())
+    {
+        packet = new PooledWorldPacket();
+        packet->Pool = this;
+        Increment(_allocated);
+    }
+    else
+    {
+        packet = _free.back();
+        _free.pop_back();
+        Increment(_recycled);
+    }
+
+    Increment(_acquired);
+    _freeCount.store(uint32(_free.size()), std::memory_order_relaxed);
+
+    packet->Packet.Initialize(opcode, size, connection);
+    if (size)
+        packet->Packet.append(data, size);
+
+    return packet;
+}
+
+void WorldPacketPool::Release(PooledWorldPacket* packet)
+{
+    if (!packet)
+        return;
+
+    if (packet->Packet.size() > MaxPooledPacketSize)
+        packet->Packet = WorldPacket();
+
+    WorldPacketPool* pool = packet->Pool;
+    PooledWorldPacket* head = pool->_returned.load(std::memory_order_relaxed);
+    do
+        packet->NextReturned = head;
+    while (!pool->_returned.compare_exchange_weak(head, packet, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void WorldPacketPool::TakeReturned()
+{
+    // only this thread takes from the stack, so popping everything at once is ABA safe
+    PooledWorldPacket* packet = _returned.exchange(nullptr, std::memory_order_acquire);
+    while (packet)
+    {
+        PooledWorldPacket* next = packet->NextReturned;
+        if (_free.size() < MaxFreePackets)
+            _free.push_back(packet);
+        else
+            delete packet;
+
+        packet = next;
+    }
+}
+
+std::vector<WorldPacketPool::Stats> WorldPacketPool::GetAllStats()
+{
+    std::lock_guard<std::mutex> lock(PoolsLock);
+
+    std::vector<Stats> stats;
+    stats.reserve(Pools.size());
+    for (WorldPacketPool const* pool : Pools)
+    {
+        Stats poolStats;
+        poolStats.Acquired = pool->_acquired.load(std::memory_order_relaxed);
+        poolStats.Recycled = pool->_recycled.load(std::memory_order_relaxed);
+        poolStats.Allocated = pool->_allocated.load(std::memory_order_relaxed);
+        poolStats.Free = pool->_freeCount.load(std::memory_order_relaxed);
+        stats.push_back(poolStats);
+    }
+
+    return stats;
+}
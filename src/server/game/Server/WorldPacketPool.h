@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2008-2016 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITYCORE_WORLDPACKETPOOL_H
+#define TRINITYCORE_WORLDPACKETPOOL_H
+
+#include "WorldPacket.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class WorldPacketPool;
+
+struct PooledWorldPacket
+{
+    WorldPacket Packet;
+    WorldPacketPool* Pool = nullptr;
+    PooledWorldPacket* NextReturned = nullptr;
+};
+
+/*
+ * Client packets of one network thread. The thread takes packets (and their storage)
+ * from its own free list without locking; whoever is done with a packet pushes it on
+ * a lock free return stack the network thread empties when its free list runs dry.
+ * Pools live as long as the process, packets may outlast the thread that read them.
+ */
+class WorldPacketPool
+{
+public:
+    struct Deleter
+    {
+        void operator()(PooledWorldPacket* packet) const { WorldPacketPool::Release(packet); }
+    };
+
+    struct Stats
+    {
+        uint64 Acquired;
+        uint64 Recycled;    // served from the free list
+        uint64 Allocated;   // had to be created
+        uint32 Free;
+    };
+
+    /// pool of the calling network thread
+    static WorldPacketPool* ForCurrentThread();
+
+    /// client packet with a copy of the data, hand back with Release()
+    PooledWorldPacket* Acquire(uint16 opcode, ConnectionType connection, uint8 const* data, std::size_t size);
+    /// any thread
+    static void Release(PooledWorldPacket* packet);
+
+    static std::vector<Stats> GetAllStats();
+
+private:
+    WorldPacketPool();
+
+    void TakeReturned();
+
+    std::vector<PooledWorldPacket*> _free;
+    std::atomic<PooledWorldPacket*> _returned;
+
+    std::atomic<uint64> _acquired;
+    std::atomic<uint64> _recycled;
+    std::atomic<uint64> _allocated;
+    std::atomic<uint32> _freeCount;
+};
+
+typedef std::unique_ptr<PooledWorldPacket, WorldPacketPool::Deleter> PooledWorldPacketPtr;
+
+#endif
@@ -44,6 +44,7 @@
 #include "Log.h"
 #include "MapManager.h"
 #include "MiscPackets.h"
+#include "MovementPackets.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
 #include "Opcodes.h"
@@ -58,6 +59,7 @@
 #include "WardenWin.h"
 #include "World.h"
 #include "WorldPacket.h"
+#include "WorldPacketPool.h"
 #include "WorldSession.h"
 #include "WorldSocket.h"
 
@@ -94,6 +96,9 @@ WorldSession::WorldSession(uint32 id, std::string&& name, uint32 battlenetAccoun
    _tutorialsChanged(false),
    recruiterId(recruiter),
    isRecruiter(isARecruiter),
+   _recvSequence(0),
+   _recvRequeuedCount(0),
+   _recvQueuePeak(0),
    timeCharEnumOpcode(0),
    playerLoginCounter(0),
    forceExit(false),
@@ -163,9 +168,8 @@ WorldSession::~WorldSession()
     delete _warden;
 
     ///- empty incoming packet queue
-    WorldPacket* packet = nullptr;
-    while (_recvQueue.next(packet))
-        delete packet;
+    while (PooledWorldPacket* packet = NextReceivedPacket())
+        WorldPacketPool::Release(packet);
 
     LoginDatabase.PExecute("UPDATE account SET online = 0 WHERE id = %u;", GetAccountId());     // One-time query
     sWorld->DecreaseSessionCount();
@@ -226,64 +230,247 @@ ObjectGuid::LowType WorldSession::GetGuidLow() const
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const* packet, bool forced /*= false*/)
 {
+    ConnectionType conIdx;
+    if (!CanSendPacket(*packet, forced, conIdx))
+        return;
+
     uint32 opcode = packet->GetOpcode();
+    uint32 packetSize = packet->size();
+    uint32 start_time = getMSTime();
+    const_cast<WorldPacket*>(packet)->FlushBits();
+
+    if (m_Socket[conIdx]) // http://pastebin.com/8ntVgj49
+        m_Socket[conIdx]->SendPacket(*packet);
+
+    if ((getMSTime() - start_time) > 50)
+        sLog->outDiff(" >> SendPacket DIFF %u player_guid %u _mapID_ %i AccountId %u opcode %u packetSize %u", getMSTime() - start_time, (_player && !_player->IsDelete()) ? _player->GetGUIDLow() : 0, (_player && !_player->IsDelete()) ? _player->GetMapId() : -1, GetAccountId(), opcode, packetSize);
+}
+
+void WorldSession::SendPacket(SharedWorldPacket const& packet, bool forced /*= false*/)
+{
+    ConnectionType conIdx;
+    if (!CanSendPacket(*packet, forced, conIdx))
+        return;
+
+    uint32 start_time = getMSTime();
+
+    if (m_Socket[conIdx])
+        m_Socket[conIdx]->SendPacket(packet);
+
+    if ((getMSTime() - start_time) > 50)
+        sLog->outDiff(" >> SendPacket DIFF %u player_guid %u _mapID_ %i AccountId %u opcode %u packetSize %u", getMSTime() - start_time, (_player && !_player->IsDelete()) ? _player->GetGUIDLow() : 0, (_player && !_player->IsDelete()) ? _player->GetMapId() : -1, GetAccountId(), packet->GetOpcode(), uint32(packet->size()));
+}
+
+bool WorldSession::CanSendPacket(WorldPacket const& packet, bool forced, ConnectionType& conIdx) const
+{
+    uint32 opcode = packet.GetOpcode();
     if (opcode == NULL_OPCODE)
     {
         TC_LOG_ERROR(LOG_FILTER_GENERAL, "Prevented sending of NULL_OPCODE to %s", GetPlayerName(false).c_str());
-        return;
+        return false;
     }
     if (opcode == MAX_OPCODE)
     {
         TC_LOG_ERROR(LOG_FILTER_GENERAL, "Prevented sending of wrong opcode to %s", GetPlayerName(false).c_str());
-        return;
+        return false;
     }
 
     ServerOpcodeHandler const* handler = opcodeTable[static_cast<OpcodeServer>(opcode)];
     if (!handler)
     {
         TC_LOG_ERROR(LOG_FILTER_GENERAL, "Prevented sending of opcode %u with non existing handler to %s", opcode, GetPlayerName().c_str());
-        return;
+        return false;
     }
 
-    ConnectionType conIdx = handler->ConnectionIndex;
-    if (packet->GetConnection() != CONNECTION_TYPE_DEFAULT)
+    conIdx = handler->ConnectionIndex;
+    if (packet.GetConnection() != CONNECTION_TYPE_DEFAULT)
     {
-        if (packet->GetConnection() != CONNECTION_TYPE_INSTANCE && IsInstanceOnlyOpcode(opcode))
+        if (packet.GetConnection() != CONNECTION_TYPE_INSTANCE && IsInstanceOnlyOpcode(opcode))
         {
-            TC_LOG_ERROR(LOG_FILTER_GENERAL, "Prevented sending of instance only opcode %u with connection type %u to %s", opcode, packet->GetConnection(), GetPlayerName().c_str());
-            return;
+            TC_LOG_ERROR(LOG_FILTER_GENERAL, "Prevented sending of instance only opcode %u with connection type %u to %s", opcode, packet.GetConnection(), GetPlayerName().c_str());
+            return false;
         }
 
-        conIdx = packet->GetConnection();
+        conIdx = packet.GetConnection();
     }
 
     if (!m_Socket[conIdx])
     {
         TC_LOG_DEBUG(LOG_FILTER_GENERAL, "Prevented sending of %s to non existent socket %u to %s", GetOpcodeNameForLogging(static_cast<OpcodeServer>(opcode)).c_str(), conIdx, GetPlayerName().c_str());
-        return;
+        return false;
     }
 
     if (!forced && handler->Status == STATUS_UNHANDLED)
     {
         TC_LOG_ERROR(LOG_FILTER_GENERAL, "Prevented sending disabled opcode %s to %s", GetOpcodeNameForLogging(static_cast<OpcodeServer>(opcode)).c_str(), GetPlayerName().c_str());
-        return;
+        return false;
     }
 
-    uint32 packetSize = packet->size();
-    uint32 start_time = getMSTime();
-    const_cast<WorldPacket*>(packet)->FlushBits();
+    return true;
+}
 
-    if (m_Socket[conIdx]) // http://pastebin.com/8ntVgj49
-        m_Socket[conIdx]->SendPacket(*packet);
+BroadcastPacket::~BroadcastPacket()
+{
+    FlushRecipients();
+}
 
-    if ((getMSTime() - start_time) > 50)
-        sLog->outDiff(" >> SendPacket DIFF %u player_guid %u _mapID_ %i AccountId %u opcode %u packetSize %u", getMSTime() - start_time, (_player && !_player->IsDelete()) ? _player->GetGUIDLow() : 0, (_player && !_player->IsDelete()) ? _player->GetMapId() : -1, GetAccountId(), opcode, packetSize);
+BroadcastPacket::BroadcastPacket(BroadcastPacket&& other) noexcept : _packet(other._packet), _shared(std::move(other._shared)), _recipients(other._recipients)
+{
+    other._recipients = 0;
+}
+
+BroadcastPacket& BroadcastPacket::operator=(BroadcastPacket&& other) noexcept
+{
+    if (this != &other)
+    {
+        FlushRecipients();
+        _packet = other._packet;
+        _shared = std::move(other._shared);
+        _recipients = other._recipients;
+        other._recipients = 0;
+    }
+
+    return *this;
+}
+
+void BroadcastPacket::FlushRecipients()
+{
+    if (!_recipients)
+        return;
+
+    World::BroadcastRecipientCount += _recipients;
+    _recipients = 0;
+}
+
+SharedWorldPacket const& BroadcastPacket::Share()
+{
+    if (!_shared)
+    {
+        std::shared_ptr<WorldPacket> packet = std::make_shared<WorldPacket>(*_packet);
+        packet->FlushBits();
+        _shared = std::move(packet);
+
+        ++World::BroadcastPacketCount;
+        World::BroadcastBytesCopied += _shared->size();
+    }
+
+    ++_recipients;
+    return _shared;
 }
 
 /// Add an incoming packet to the queue
-void WorldSession::QueuePacket(WorldPacket* new_packet)
+void WorldSession::QueuePacket(PooledWorldPacket* new_packet)
+{
+    ReceivedPacket received;
+    received.Packet = new_packet;
+    received.Sequence = _recvSequence.fetch_add(1, std::memory_order_relaxed);
+    _recvQueue[new_packet->Packet.GetConnection() == CONNECTION_TYPE_INSTANCE ? CONNECTION_TYPE_INSTANCE : CONNECTION_TYPE_REALM].Push(received);
+}
+
+uint32 WorldSession::GetReceiveQueueSize() const
+{
+    uint32 size = _recvRequeuedCount.load(std::memory_order_relaxed);
+    for (SPSCQueue<ReceivedPacket> const& queue : _recvQueue)
+        size += uint32(queue.Size());
+
+    return size;
+}
+
+SPSCQueue<WorldSession::ReceivedPacket>* WorldSession::OldestReceiveQueue()
+{
+    SPSCQueue<ReceivedPacket>* oldest = nullptr;
+    uint64 sequence = 0;
+    for (SPSCQueue<ReceivedPacket>& queue : _recvQueue)
+    {
+        if (ReceivedPacket const* received = queue.Front())
+        {
+            if (!oldest || received->Sequence < sequence)
+            {
+                oldest = &queue;
+                sequence = received->Sequence;
+            }
+        }
+    }
+
+    return oldest;
+}
+
+/// Oldest received packet of both connections, requeued ones first
+PooledWorldPacket* WorldSession::NextReceivedPacket()
+{
+    if (!_recvRequeued.empty())
+    {
+        PooledWorldPacket* packet = _recvRequeued.front();
+        _recvRequeued.pop_front();
+        _recvRequeuedCount.store(uint32(_recvRequeued.size()), std::memory_order_relaxed);
+        return packet;
+    }
+
+    SPSCQueue<ReceivedPacket>* queue = OldestReceiveQueue();
+    if (!queue)
+        return nullptr;
+
+    PooledWorldPacket* packet = queue->Front()->Packet;
+    queue->Pop();
+    return packet;
+}
+
+/// Packet NextReceivedPacket() would return, left in the queue
+PooledWorldPacket* WorldSession::PeekReceivedPacket()
+{
+    if (!_recvRequeued.empty())
+        return _recvRequeued.front();
+
+    SPSCQueue<ReceivedPacket>* queue = OldestReceiveQueue();
+    return queue ? queue->Front()->Packet : nullptr;
+}
+
+namespace
+{
+    bool PeekMovementInfo(WorldPacket& packet, MovementInfo& movementInfo)
+    {
+        bool valid = true;
+        try
+        {
+            packet >> movementInfo;
+        }
+        catch (ByteBufferException const&)
+        {
+            valid = false;
+        }
+
+        // the handler reads the packet again
+        packet.rpos(0);
+        packet.ResetBitReader();
+        return valid;
+    }
+
+    bool IsPlainHeartbeat(MovementInfo const& movementInfo)
+    {
+        return !movementInfo.hasFallData && !movementInfo.hasSpline && movementInfo.RemoveForcesIDs.empty();
+    }
+}
+
+/// The heartbeat only moves its mover to a position the next waiting packet moves it past
+bool WorldSession::IsSupersededHeartbeat(WorldPacket& packet)
 {
-    _recvQueue.add(new_packet);
+    PooledWorldPacket* next = PeekReceivedPacket();
+    if (!next || next->Packet.GetOpcode() != CMSG_MOVE_HEARTBEAT)
+        return false;
+
+    MovementInfo current;
+    MovementInfo newer;
+    if (!PeekMovementInfo(packet, current) || !PeekMovementInfo(next->Packet, newer))
+        return false;
+
+    if (!IsPlainHeartbeat(current) || !IsPlainHeartbeat(newer) || current.Guid != newer.Guid)
+        return false;
+
+    // flag changes (walk, swim, strafe...) are kept, as is boarding or leaving a transport
+    if (current.MoveFlags[0] != newer.MoveFlags[0] || current.MoveFlags[1] != newer.MoveFlags[1])
+        return false;
+
+    return current.hasTransportData == newer.hasTransportData && current.transport.Guid == newer.transport.Guid;
 }
 
 /// Logging helper for unexpected opcodes
@@ -332,10 +519,10 @@ bool WorldSession::Update(uint32 diff, Map* map)
 
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// not process packets if socket already closed
-    WorldPacket* packet = nullptr;
+    PooledWorldPacket* pooledPacket = nullptr;
     //! Delete packet after processing by default
     bool deletePacket = true;
-    std::vector<WorldPacket*> requeuePackets;
+    std::vector<PooledWorldPacket*> requeuePackets;
     uint32 processedPackets = 0;
 
     // don`t delete this, need for debug info in crashlog
@@ -343,21 +530,42 @@ bool WorldSession::Update(uint32 diff, Map* map)
     volatile int32 _mapID_ = (_player && !_player->IsDelete()) ? _player->GetMapId() : -1;
     // volatile Position* _pos_ = new Position(*_player);
 
+    uint32 coalesceHeartbeats = sWorld->getIntConfig(CONFIG_MOVEMENT_COALESCE_HEARTBEATS);
+    bool coalesce = coalesceHeartbeats == 2 || (coalesceHeartbeats == 1 && map && map->IsBattlegroundOrArena());
+    uint32 heartbeats = 0;
+    uint32 heartbeatsCoalesced = 0;
+
+    uint32 recvQueueSize = GetReceiveQueueSize();
+    if (recvQueueSize > _recvQueuePeak.load(std::memory_order_relaxed))
+        _recvQueuePeak.store(recvQueueSize, std::memory_order_relaxed);
+
     uint32 _ms = GetMSTimeDiffToNow(_s);
     if (_ms > 200)
-        sLog->outDiff("WorldSession::Update 0 _mapID_ %i Update time - %ums diff %u _player_guid_ %u _recvQueue %u", _mapID_, _ms, diff, _player_guid_, _recvQueue.size());
+        sLog->outDiff("WorldSession::Update 0 _mapID_ %i Update time - %ums diff %u _player_guid_ %u _recvQueue %u", _mapID_, _ms, diff, _player_guid_, recvQueueSize);
 
-    if (_recvQueue.size() > 20000) // Prevent ddos
+    if (recvQueueSize > 20000) // Prevent ddos
     {
-        sLog->outSpamm("WorldSession::Update ddos KickPlayer _mapID_ %i Update time - %ums diff %u _player_guid_ %u _recvQueue %u", _mapID_, _ms, diff, _player_guid_, _recvQueue.size());
-        while (_recvQueue.next(packet))
-            delete packet;
+        sLog->outSpamm("WorldSession::Update ddos KickPlayer _mapID_ %i Update time - %ums diff %u _player_guid_ %u _recvQueue %u", _mapID_, _ms, diff, _player_guid_, recvQueueSize);
+        while ((pooledPacket = NextReceivedPacket()))
+            WorldPacketPool::Release(pooledPacket);
         KickPlayer();
     }
 
-    while (m_Socket[CONNECTION_TYPE_REALM] && map == m_map && _recvQueue.next(packet))
+    while (m_Socket[CONNECTION_TYPE_REALM] && map == m_map && (pooledPacket = NextReceivedPacket()))
     {
+        WorldPacket* packet = &pooledPacket->Packet;
         OpcodeClient opcode = static_cast<OpcodeClient>(packet->GetOpcode());
+        if (opcode == CMSG_MOVE_HEARTBEAT)
+        {
+            ++heartbeats;
+            if (coalesce && IsSupersededHeartbeat(*packet))
+            {
+                WorldPacketPool::Release(pooledPacket);
+                ++heartbeatsCoalesced;
+                continue;
+            }
+        }
+
         uint32 packetSize = packet->size();
         ClientOpcodeHandler const* opHandle = opcodeTable[opcode];
         try
@@ -372,7 +580,7 @@ bool WorldSession::Update(uint32 diff, Map* map)
                         //! the client to be in world yet. We will re-add the packets to the bottom of the queue and process them later.
                         if (!m_playerRecentlyLogout)
                         {
-                            requeuePackets.push_back(packet);
+                            requeuePackets.push_back(pooledPacket);
                             deletePacket = false;
                             #ifdef WIN32
                             TC_LOG_ERROR(LOG_FILTER_NETWORKIO, "Re-enqueueing packet with opcode %s with with status STATUS_LOGGEDIN. Player is currently not in world yet.", GetOpcodeNameForLogging(opcode).c_str());
@@ -437,7 +645,7 @@ bool WorldSession::Update(uint32 diff, Map* map)
         }
 
         if (deletePacket)
-            delete packet;
+            WorldPacketPool::Release(pooledPacket);
 
         deletePacket = true;
         processedPackets++;
@@ -457,9 +665,19 @@ bool WorldSession::Update(uint32 diff, Map* map)
 
     _ms = GetMSTimeDiffToNow(_s);
     if (_ms > 200)
-        sLog->outDiff("WorldSession::Update 1 _mapID_ %i Update time - %ums diff %u _player_guid_ %u _recvQueue %u", _mapID_, _ms, diff, _player_guid_, _recvQueue.size());
+        sLog->outDiff("WorldSession::Update 1 _mapID_ %i Update time - %ums diff %u _player_guid_ %u _recvQueue %u", _mapID_, _ms, diff, _player_guid_, GetReceiveQueueSize());
 
-    _recvQueue.readd(requeuePackets.begin(), requeuePackets.end());
+    if (heartbeats)
+    {
+        World::HeartbeatCount += heartbeats;
+        World::HeartbeatCoalescedCount += heartbeatsCoalesced;
+    }
+
+    if (!requeuePackets.empty())
+    {
+        _recvRequeued.insert(_recvRequeued.begin(), requeuePackets.begin(), requeuePackets.end());
+        _recvRequeuedCount.store(uint32(_recvRequeued.size()), std::memory_order_relaxed);
+    }
 
     if (map != m_map)
     {
@@ -471,7 +689,7 @@ bool WorldSession::Update(uint32 diff, Map* map)
 
     _ms = GetMSTimeDiffToNow(_s);
     if (_ms > 200)
-        sLog->outDiff("WorldSession::Update 2 _mapID_ %i Update time - %ums diff %u _player_guid_ %u _recvQueue %u", _mapID_, _ms, diff, _player_guid_, _recvQueue.size());
+        sLog->outDiff("WorldSession::Update 2 _mapID_ %i Update time - %ums diff %u _player_guid_ %u _recvQueue %u", _mapID_, _ms, diff, _player_guid_, GetReceiveQueueSize());
 
     if (map != m_map)
     {
@@ -527,7 +745,7 @@ bool WorldSession::Update(uint32 diff, Map* map)
 
     _ms = GetMSTimeDiffToNow(_s);
     if (_ms > 200)
-        sLog->outDiff("WorldSession::Update 3 _mapID_ %i Update time - %ums diff %u _player_guid_ %u _recvQueue %u", _mapID_, _ms, diff, _player_guid_, _recvQueue.size());
+        sLog->outDiff("WorldSession::Update 3 _mapID_ %i Update time - %ums diff %u _player_guid_ %u _recvQueue %u", _mapID_, _ms, diff, _player_guid_, GetReceiveQueueSize());
 
     m_sUpdate = false;
     return true;
@@ -785,10 +1003,7 @@ void WorldSession::LogoutPlayer(bool Save)
     }
 
     if (m_Socket[CONNECTION_TYPE_INSTANCE])
-    {
-        m_Socket[CONNECTION_TYPE_INSTANCE]->CloseSocket();
-        m_Socket[CONNECTION_TYPE_INSTANCE].reset();
-    }
+        CloseInstanceConnection();
 
     // SetMap(NULL);
     m_playerLogout = false;
@@ -802,6 +1017,24 @@ void WorldSession::LogoutPlayer(bool Save)
 }
 
 /// Kick a player out of the World
+void WorldSession::AddInstanceConnection(std::shared_ptr<WorldSocket> sock)
+{
+    // _recvQueue[CONNECTION_TYPE_INSTANCE] has a single producer, the old socket may still be read
+    // by another network thread, so it lets go of the session before the new one gets it
+    if (m_Socket[CONNECTION_TYPE_INSTANCE] && m_Socket[CONNECTION_TYPE_INSTANCE] != sock)
+        CloseInstanceConnection();
+
+    m_Socket[CONNECTION_TYPE_INSTANCE] = sock;
+}
+
+void WorldSession::CloseInstanceConnection()
+{
+    // detached first, closing alone leaves the session to the socket until its OnClose
+    m_Socket[CONNECTION_TYPE_INSTANCE]->ClearWorldSession();
+    m_Socket[CONNECTION_TYPE_INSTANCE]->CloseSocket();
+    m_Socket[CONNECTION_TYPE_INSTANCE].reset();
+}
+
 void WorldSession::KickPlayer()
 {
     for (auto & i : m_Socket)
@@ -31,6 +31,7 @@
 #include "Opcodes.h"
 #include "Packet.h"
 #include "SharedDefines.h"
+#include "SPSCQueue.h"
 #include "World.h"
 #include "WorldPacket.h"
 #include "DatabaseEnvFwd.h"
@@ -64,6 +65,7 @@ struct DeclinedName;
 struct ItemTemplate;
 struct MovementInfo;
 struct PetBattleRequest;
+struct PooledWorldPacket;
 struct Position;
 struct CharacterTemplate;
 
@@ -1012,6 +1014,30 @@ enum DeclinedNameResult
     DECLINED_NAMES_RESULT_ERROR     = 1
 };
 
+// Copies a broadcast packet once, on the first recipient, and hands the same payload to every other one
+// Recipients are counted locally and added to World::BroadcastRecipientCount once, on destruction
+class BroadcastPacket
+{
+    public:
+        BroadcastPacket() : _packet(nullptr), _recipients(0) { }
+        explicit BroadcastPacket(WorldPacket const* packet) : _packet(packet), _recipients(0) { }
+        ~BroadcastPacket();
+
+        BroadcastPacket(BroadcastPacket const&) = delete;
+        BroadcastPacket& operator=(BroadcastPacket const&) = delete;
+        BroadcastPacket(BroadcastPacket&& other) noexcept;
+        BroadcastPacket& operator=(BroadcastPacket&& other) noexcept;
+
+        SharedWorldPacket const& Share();
+
+    private:
+        void FlushRecipients();
+
+        WorldPacket const* _packet;
+        SharedWorldPacket _shared;
+        uint32 _recipients;
+};
+
 struct CharEnumInfoData
 {
     ObjectGuid GuildGuid;
@@ -1062,7 +1088,9 @@ class WorldSession
         bool IsAddonRegistered(std::string const& prefix);
 
         void SendPacket(WorldPacket const* packet, bool forced = false);
-        void AddInstanceConnection(std::shared_ptr<WorldSocket> sock) { m_Socket[CONNECTION_TYPE_INSTANCE] = sock; }
+        void SendPacket(SharedWorldPacket const& packet, bool forced = false);
+        void AddInstanceConnection(std::shared_ptr<WorldSocket> sock);
+        void CloseInstanceConnection();
         void SendNotification(const char *format, ...) ATTR_PRINTF(2, 3);
         void SendNotification(uint32 string_id, ...);
         void SendPetNameInvalid(uint32 error, ObjectGuid const& guid, std::string const& name, DeclinedName *declinedName = nullptr);
@@ -1134,7 +1162,10 @@ class WorldSession
         bool CanLogout() { return canLogout; }
         void SetCanLogout() { canLogout = true; }
 
-        void QueuePacket(WorldPacket* new_packet);
+        /// network thread of the packet's connection, at most one per connection type
+        void QueuePacket(PooledWorldPacket* new_packet);
+        uint32 GetReceiveQueueSize() const;
+        uint32 GetReceiveQueuePeak() const { return _recvQueuePeak.load(std::memory_order_relaxed); }
         bool Update(uint32 diff, Map* map = nullptr);
 
         /// Handle the authentication waiting queue (to be completed)
@@ -2051,6 +2082,7 @@ class WorldSession
         uint32 m_classMask = 0;
 
     private:
+        bool CanSendPacket(WorldPacket const& packet, bool forced, ConnectionType& conIdx) const;
         void ProcessQueryCallbacks();
 
         QueryResultHolderFuture _realmAccountLoginCallback;
@@ -2118,7 +2150,22 @@ class WorldSession
         bool _filterAddonMessages;
         uint32 recruiterId;
         bool isRecruiter;
-        LockedQueue<WorldPacket*> _recvQueue;
+        struct ReceivedPacket
+        {
+            PooledWorldPacket* Packet;
+            uint64 Sequence;                                // arrival order across the connections
+        };
+
+        SPSCQueue<ReceivedPacket>* OldestReceiveQueue();
+        PooledWorldPacket* NextReceivedPacket();
+        PooledWorldPacket* PeekReceivedPacket();
+        bool IsSupersededHeartbeat(WorldPacket& packet);
+
+        SPSCQueue<ReceivedPacket> _recvQueue[MAX_CONNECTION_TYPES];    // fed by the socket holding the session, see AddInstanceConnection
+        std::atomic<uint64> _recvSequence;
+        std::deque<PooledWorldPacket*> _recvRequeued;       // session update only
+        std::atomic<uint32> _recvRequeuedCount;
+        std::atomic<uint32> _recvQueuePeak;
         time_t timeCharEnumOpcode;
         uint8 playerLoginCounter;
         uint32 expireTime;
@@ -29,6 +29,7 @@
 #include "SHA256.h"
 #include "World.h"
 #include "Warden.h"
+#include "WorldPacketPool.h"
 #include "Duration.h"
 #include "RealmList.h"
 
@@ -239,7 +240,7 @@ bool WorldSocket::Update()
         auto queued = std::move(_aBufferQueue.front());
         _aBufferQueue.pop();
 
-        uint32 packetSize = queued.size();
+        uint32 packetSize = queued.GetPacket().size();
         if (packetSize > MinSizeForCompression && queued.NeedsEncryption())
             packetSize = compressBound(packetSize) + sizeof(CompressedWorldPacket);
 
@@ -366,6 +367,13 @@ void WorldSocket::SetWorldSession(WorldSessionPtr session)
     _authed = true;
 }
 
+void WorldSocket::ClearWorldSession()
+{
+    // ReadDataHandler queues packets while holding the lock
+    std::lock_guard<std::mutex> sessionGuard(_worldSessionLock);
+    _worldSession = nullptr;
+}
+
 bool WorldSocket::ReadHeaderHandler()
 {
     ASSERT(_headerBuffer.GetActiveSize() == SizeOfHeader, "Header size " SZFMTD " different than expected %u", _headerBuffer.GetActiveSize(), SizeOfHeader);
@@ -389,7 +397,10 @@ WorldSocket::ReadDataHandlerResult WorldSocket::ReadDataHandler()
 {
     auto opcode = static_cast<OpcodeClient>(reinterpret_cast<PacketHeader*>(_headerBuffer.GetReadPointer())->Command);
 
-    WorldPacket packet(opcode, std::move(_packetBuffer), GetConnectionType());
+    // copied into pooled storage, the payload buffer keeps its own for the next packet
+    PooledWorldPacketPtr pooledPacket(WorldPacketPool::ForCurrentThread()->Acquire(opcode, GetConnectionType(), _packetBuffer.GetReadPointer(), _packetBuffer.GetActiveSize()));
+    _packetBuffer.Reset();
+    WorldPacket& packet = pooledPacket->Packet;
 
     sPacketLog->LogPacket(packet, CLIENT_TO_SERVER, GetRemoteIpAddress(), GetRemotePort(), GetConnectionType());
 
@@ -528,8 +539,7 @@ WorldSocket::ReadDataHandlerResult WorldSocket::ReadDataHandler()
             if (opcode != CMSG_UI_TIME_REQUEST)
                 _worldSession->ResetTimeOutTime();
 
-            // Copy the packet to the heap before enqueuing
-            _worldSession->QueuePacket(new WorldPacket(std::move(packet)));
+            _worldSession->QueuePacket(pooledPacket.release());
             break;
         }
     }
@@ -549,13 +559,33 @@ void WorldSocket::LogOpcodeText(OpcodeClient opcode, std::unique_lock<std::mutex
 
 void WorldSocket::SendPacket(WorldPacket const& packet)
 {
-    if (!IsOpen())
+    if (!CanQueuePacket(packet))
+        return;
+
+    _bufferQueueLock.lock();
+    _bufferQueue.emplace(packet, _authCrypt.IsInitialized());
+    _bufferQueueLock.unlock();
+}
+
+void WorldSocket::SendPacket(SharedWorldPacket const& sharedPacket)
+{
+    if (!CanQueuePacket(*sharedPacket))
         return;
 
+    _bufferQueueLock.lock();
+    _bufferQueue.emplace(sharedPacket, _authCrypt.IsInitialized());
+    _bufferQueueLock.unlock();
+}
+
+bool WorldSocket::CanQueuePacket(WorldPacket const& packet)
+{
+    if (!IsOpen())
+        return false;
+
     // uint32 opcode = packet.GetOpcode();
     uint32 packetSize = packet.size();
     if (packetSize > 0x7FFFFFF) // If packet size bugget, don`t send it http://pastebin.com/Q0xG8aGp
-        return;
+        return false;
 
     sPacketLog->LogPacket(packet, SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort(), GetConnectionType());
 
@@ -564,13 +594,12 @@ void WorldSocket::SendPacket(WorldPacket const& packet)
         TC_LOG_INFO(LOG_FILTER_OPCODES, "S->C: %s Size %u %s connection %i, connectionType %i", GetOpcodeNameForLogging(static_cast<OpcodeServer>(packet.GetOpcode())).c_str(), packetSize, GetRemoteIpAddress().to_string().c_str(), packet.GetConnection(), GetConnectionType());
     #endif
 
-    _bufferQueueLock.lock();
-    _bufferQueue.emplace(EncryptablePacket(packet, _authCrypt.IsInitialized()));
-    _bufferQueueLock.unlock();
+    return true;
 }
 
-void WorldSocket::WritePacketToBuffer(EncryptablePacket const& packet, MessageBuffer& buffer)
+void WorldSocket::WritePacketToBuffer(EncryptablePacket const& queued, MessageBuffer& buffer)
 {
+    WorldPacket const& packet = queued.GetPacket();
     uint32 opcode = packet.GetOpcode();
     uint32 packetSize = packet.size();
 
@@ -578,7 +607,7 @@ void WorldSocket::WritePacketToBuffer(EncryptablePacket const& packet, MessageBu
     uint8* headerPos = buffer.GetWritePointer();
     buffer.WriteCompleted(SizeOfHeader);
 
-    if (packetSize > MinSizeForCompression && packet.NeedsEncryption())
+    if (packetSize > MinSizeForCompression && queued.NeedsEncryption())
     {
         CompressedWorldPacket cmp;
         cmp.UncompressedSize = packetSize + 2;
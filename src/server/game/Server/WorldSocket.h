@@ -29,14 +29,19 @@
 
 struct z_stream_s;
 
-class EncryptablePacket : public WorldPacket
+class EncryptablePacket
 {
 public:
-    EncryptablePacket(WorldPacket const& packet, bool encrypt) : WorldPacket(packet), _encrypt(encrypt) { }
+    EncryptablePacket(WorldPacket const& packet, bool encrypt) : _packet(packet), _encrypt(encrypt) { }
+    // broadcast payloads are queued by reference, see BroadcastPacket
+    EncryptablePacket(SharedWorldPacket packet, bool encrypt) : _shared(std::move(packet)), _encrypt(encrypt) { }
 
+    WorldPacket const& GetPacket() const { return _shared ? *_shared : _packet; }
     bool NeedsEncryption() const { return _encrypt; }
 
 private:
+    WorldPacket _packet;
+    SharedWorldPacket _shared;
     bool _encrypt;
 };
 
@@ -90,12 +95,15 @@ public:
     bool Update() override;
 
     void SendPacket(WorldPacket const& packet);
+    void SendPacket(SharedWorldPacket const& packet);
 
     ConnectionType GetConnectionType() const { return _type; }
 
     void SendAuthResponseError(uint32 code);
     void HandleEnableEncryptionAck();
     void SetWorldSession(WorldSessionPtr session);
+    /// Stops queueing packets into the session, returns after a packet being queued right now is in
+    void ClearWorldSession();
 
 protected:
     void OnClose() override;
@@ -114,6 +122,8 @@ private:
     void CheckIpCallback(PreparedQueryResult result);
     void InitializeHandler(boost::system::error_code error, std::size_t transferedBytes);
     void LogOpcodeText(OpcodeClient opcode, std::unique_lock<std::mutex> const& guard) const;
+    /// open check, size sanity and packet log shared by both SendPacket overloads
+    bool CanQueuePacket(WorldPacket const& packet);
     void WritePacketToBuffer(EncryptablePacket const& packet, MessageBuffer& buffer);
     uint32 CompressPacket(uint8* buffer, WorldPacket const& packet);
 
@@ -64,14 +64,14 @@ uint32 Battlenet::GameUtilitiesService::HandleRealmListRequest(std::unordered_ma
     if (subRegion != params.end())
         subRegionId = subRegion->second->string_value();
 
-    std::vector<uint8> compressed = sRealmList->GetRealmList(realm.Build, subRegionId, sConfigMgr->GetIntDefault("Battlegroup", 1));
+    RealmList::CompressedPayload realmList = sRealmList->GetRealmList(realm.Build, subRegionId, sConfigMgr->GetIntDefault("Battlegroup", 1));
 
-    if (compressed.empty())
+    if (!realmList)
         return ERROR_UTIL_SERVER_FAILED_TO_SERIALIZE_RESPONSE;
 
     Attribute* attribute = response->add_attribute();
     attribute->set_name("Param_RealmList");
-    attribute->mutable_value()->set_blob_value(compressed.data(), compressed.size());
+    attribute->mutable_value()->set_blob_value(realmList->data(), realmList->size());
 
     JSON::RealmList::RealmCharacterCountList realmCharacterCounts;
     for (auto const& characterCount : _session->GetRealmCharacterCounts())
@@ -84,6 +84,7 @@ uint32 Battlenet::GameUtilitiesService::HandleRealmListRequest(std::unordered_ma
     std::string json = "JSONRealmCharacterCountList:" + JSON::Serialize(realmCharacterCounts);
 
     uLongf compressedLength = compressBound(json.length());
+    std::vector<uint8> compressed;
     compressed.resize(4 + compressedLength);
     *reinterpret_cast<uint32*>(compressed.data()) = json.length() + 1;
 
@@ -885,8 +885,8 @@ void Spell::SelectImplicitBetweenTargets(SpellEffIndex effIndex, SpellImplicitTa
         }
 
         Trinity::WorldObjectSpellBetweenTargetCheck check(width, dist, m_caster, center, referer, m_spellInfo, selectionType, condList);
-        Trinity::WorldObjectListSearcher<Trinity::WorldObjectSpellBetweenTargetCheck> searcher(m_caster, targets, check, containerTypeMask);
-        SearchTargets<Trinity::WorldObjectListSearcher<Trinity::WorldObjectSpellBetweenTargetCheck> >(searcher, containerTypeMask, m_caster, m_caster, dist);
+        Trinity::WorldObjectSpatialListSearcher<Trinity::WorldObjectSpellBetweenTargetCheck> searcher(m_caster, targets, check, containerTypeMask);
+        SearchTargets<Trinity::WorldObjectSpatialListSearcher<Trinity::WorldObjectSpellBetweenTargetCheck> >(searcher, containerTypeMask, m_caster, m_caster, dist);
 
         TC_LOG_DEBUG(LOG_FILTER_SPELLS_AURAS, "Spell::SelectImplicitBetweenTargets angle %f, dist %f, x %f, y %f, Id %u, targets.size %u", angle, dist, center->GetPositionX(), center->GetPositionY(), m_spellInfo->Id, targets.size());
 
@@ -938,8 +938,8 @@ void Spell::SelectImplicitConeTargets(SpellEffIndex effIndex, SpellImplicitTarge
     if (uint32 containerTypeMask = GetSearcherTypeMask(objectType, condList))
     {
         Trinity::WorldObjectSpellConeTargetCheck check(coneAngle, radius, caster, m_spellInfo, selectionType, condList);
-        Trinity::WorldObjectListSearcher<Trinity::WorldObjectSpellConeTargetCheck> searcher(caster, targets, check, containerTypeMask);
-        SearchTargets<Trinity::WorldObjectListSearcher<Trinity::WorldObjectSpellConeTargetCheck> >(searcher, containerTypeMask, caster, caster, radius);
+        Trinity::WorldObjectSpatialListSearcher<Trinity::WorldObjectSpellConeTargetCheck> searcher(caster, targets, check, containerTypeMask);
+        SearchTargets<Trinity::WorldObjectSpatialListSearcher<Trinity::WorldObjectSpellConeTargetCheck> >(searcher, containerTypeMask, caster, caster, radius);
 
         CallScriptObjectAreaTargetSelectHandlers(targets, effIndex, targetType.GetTarget());
 
@@ -1761,8 +1761,8 @@ void Spell::SelectImplicitTrajTargets()
 
     std::list<WorldObject*> targets;
     Trinity::WorldObjectSpellTrajTargetCheck check(dist2d, m_targets.GetSrcPos(), m_caster, m_spellInfo);
-    Trinity::WorldObjectListSearcher<Trinity::WorldObjectSpellTrajTargetCheck> searcher(m_caster, targets, check, GRID_MAP_TYPE_MASK_ALL);
-    SearchTargets<Trinity::WorldObjectListSearcher<Trinity::WorldObjectSpellTrajTargetCheck> > (searcher, GRID_MAP_TYPE_MASK_ALL, m_caster, m_targets.GetSrcPos(), dist2d);
+    Trinity::WorldObjectSpatialListSearcher<Trinity::WorldObjectSpellTrajTargetCheck> searcher(m_caster, targets, check, GRID_MAP_TYPE_MASK_ALL);
+    SearchTargets<Trinity::WorldObjectSpatialListSearcher<Trinity::WorldObjectSpellTrajTargetCheck> > (searcher, GRID_MAP_TYPE_MASK_ALL, m_caster, m_targets.GetSrcPos(), dist2d);
     if (targets.empty())
         return;
 
@@ -2055,8 +2055,86 @@ void Spell::SearchAreaTargets(std::list<WorldObject*>& targets, float range, Pos
         return;
     Unit* caster = m_originalCaster ? m_originalCaster : m_caster;
     Trinity::WorldObjectSpellAreaTargetCheck check(range, position, caster, referer, m_spellInfo, selectionType, condList, allowObjectSize);
-    Trinity::WorldObjectListSearcher<Trinity::WorldObjectSpellAreaTargetCheck> searcher(caster, targets, check, containerTypeMask);
-    SearchTargets<Trinity::WorldObjectListSearcher<Trinity::WorldObjectSpellAreaTargetCheck> > (searcher, containerTypeMask, caster, position, range);
+    // every target is seen from the same center, trace them together once the search is done
+    check._deferLineOfSight = !m_spellInfo->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) && caster->IsInWorld();
+    std::size_t const existingTargets = targets.size();
+    Trinity::WorldObjectSpatialListSearcher<Trinity::WorldObjectSpellAreaTargetCheck> searcher(caster, targets, check, containerTypeMask);
+    SearchTargets<Trinity::WorldObjectSpatialListSearcher<Trinity::WorldObjectSpellAreaTargetCheck> > (searcher, containerTypeMask, caster, position, range);
+    if (check._deferLineOfSight)
+        FilterAreaTargetsInLineOfSight(targets, std::next(targets.begin(), existingTargets), position, caster);
+}
+
+void Spell::FilterAreaTargetsInLineOfSight(std::list<WorldObject*>& targets, std::list<WorldObject*>::iterator first, Position const* position, Unit* caster)
+{
+    // same rays as WorldObject::IsWithinLOS from each target to the center, traced from the center instead.
+    // Gameobject models are tested with the phases of the target, so targets are batched per phase set.
+    struct PhaseBatch
+    {
+        std::set<uint32> const* Phases;
+        G3D::Vector3 Ends[VMAP_MAX_LOS_BATCH];
+        std::list<WorldObject*>::iterator Targets[VMAP_MAX_LOS_BATCH];
+        uint32 Count;
+    };
+
+    static uint32 const MaxPhaseBatches = 4;
+
+    G3D::Vector3 center(position->GetPositionX(), position->GetPositionY(), position->GetPositionZ() + 2.f);
+    PhaseBatch batches[MaxPhaseBatches];
+    uint32 batchCount = 0;
+
+    auto flush = [&](PhaseBatch& batch)
+    {
+        uint64 visible = caster->GetMap()->isInLineOfSight(center, batch.Ends, batch.Count, *batch.Phases);
+        for (uint32 i = 0; i < batch.Count; ++i)
+            if (!(visible & (UI64LIT(1) << i)))
+                targets.erase(batch.Targets[i]);
+        batch.Count = 0;
+    };
+
+    for (auto itr = first; itr != targets.end();)
+    {
+        WorldObject* target = *itr;
+        if (!target->IsInWorld())
+        {
+            ++itr;
+            continue;
+        }
+
+        PhaseBatch* batch = nullptr;
+        if (!target->GetTransport())
+        {
+            std::set<uint32> const& phases = target->GetPhases();
+            for (uint32 i = 0; i < batchCount && !batch; ++i)
+                if (*batches[i].Phases == phases)
+                    batch = &batches[i];
+
+            if (!batch && batchCount < MaxPhaseBatches)
+            {
+                batch = &batches[batchCount++];
+                batch->Phases = &phases;
+                batch->Count = 0;
+            }
+        }
+
+        // passengers are checked against the transport model, targets beyond MaxPhaseBatches phase sets one by one
+        if (!batch)
+        {
+            if (!target->IsWithinLOS(center.x, center.y, position->GetPositionZ()))
+                itr = targets.erase(itr);
+            else
+                ++itr;
+            continue;
+        }
+
+        batch->Ends[batch->Count] = G3D::Vector3(target->GetPositionX(), target->GetPositionY(), target->GetPositionZH() + 2.f);
+        batch->Targets[batch->Count++] = itr++;
+        if (batch->Count == VMAP_MAX_LOS_BATCH)
+            flush(*batch);
+    }
+
+    for (uint32 i = 0; i < batchCount; ++i)
+        if (batches[i].Count)
+            flush(batches[i]);
 }
 
 void Spell::SearchChainTargets(std::list<WorldObject*>& targets, uint32 chainTargets, WorldObject* target, SpellTargetObjectTypes objectType, SpellTargetCheckTypes selectType, ConditionList* condList, bool isChainHeal)
@@ -7511,8 +7589,9 @@ SpellCastResult Spell::CheckCast(bool strict)
                 if (!(m_targets.GetUnitTarget()->GetUInt32Value(UNIT_FIELD_FLAGS) & UNIT_FLAG_SKINNABLE))
                     return SPELL_FAILED_TARGET_UNSKINNABLE;
 
+                // loot still waiting to be rolled is not looted either
                 Creature* creature = m_targets.GetUnitTarget()->ToCreature();
-                if (creature->GetCreatureType() != CREATURE_TYPE_CRITTER && !creature->loot.isLooted())
+                if (creature->GetCreatureType() != CREATURE_TYPE_CRITTER && (!creature->loot.isLooted() || creature->loot.HasPendingLoot()))
                     return SPELL_FAILED_TARGET_NOT_LOOTED;
 
                 break;
@@ -9409,8 +9488,20 @@ void Spell::HandleLaunchPhase()
     for (float& i : multiplier)
         i = 0.0f;
 
+    // crit rolls of the targets are drawn in blocks
+    double critRolls[64];
+    size_t rollIndex = 0;
     for (TargetInfoPtr info : m_UniqueTargetInfo)
     {
+        if (rollIndex % 64 == 0)
+        {
+            size_t count = std::min<size_t>(64, m_UniqueTargetInfo.size() - rollIndex);
+            rand_norm_fill(critRolls, count);
+            for (size_t r = 0; r < count; ++r)
+                critRolls[r] *= 100.0;
+        }
+        double critRoll = critRolls[rollIndex++ % 64];
+
         if (!info->effectMask)
             continue;
 
@@ -9427,11 +9518,11 @@ void Spell::HandleLaunchPhase()
                     multiplier[i] *= m_spellInfo->GetEffect(i, m_diffMode)->CalcDamageMultiplier(m_originalCaster, this);
             }
         }
-        DoAllEffectOnLaunchTarget(info, multiplier);
+        DoAllEffectOnLaunchTarget(info, multiplier, critRoll);
     }
 }
 
-void Spell::DoAllEffectOnLaunchTarget(TargetInfoPtr targetInfo, float* multiplier)
+void Spell::DoAllEffectOnLaunchTarget(TargetInfoPtr targetInfo, float* multiplier, double critRoll)
 {
     Unit* unit = nullptr;
     Unit* caster = m_caster;
@@ -9508,7 +9599,7 @@ void Spell::DoAllEffectOnLaunchTarget(TargetInfoPtr targetInfo, float* multiplie
 
     if (targetInfo->damage || canCritTo)
     {
-        if ((m_originalCaster ? m_originalCaster : m_caster)->isSpellCrit(unit, m_spellInfo, m_spellSchoolMask, m_attackType, critChance, this))
+        if ((m_originalCaster ? m_originalCaster : m_caster)->isSpellCrit(unit, m_spellInfo, m_spellSchoolMask, m_attackType, critChance, this, critRoll))
             targetInfo->AddMask(TARGET_INFO_CRIT);
     }
 
@@ -10817,7 +10908,7 @@ bool WorldObjectSpellNearbyTargetCheck::operator()(WorldObject* target)
 
 WorldObjectSpellAreaTargetCheck::WorldObjectSpellAreaTargetCheck(float range, Position const* position, Unit* caster,
     Unit* referer, SpellInfo const* spellInfo, SpellTargetCheckTypes selectionType, ConditionList* condList, bool allowObjectSize)
-    : WorldObjectSpellTargetCheck(caster, referer, spellInfo, selectionType, condList), _range(range), _position(position), _allowObjectSize(allowObjectSize)
+    : WorldObjectSpellTargetCheck(caster, referer, spellInfo, selectionType, condList), _range(range), _position(position), _allowObjectSize(allowObjectSize), _deferLineOfSight(false)
 {
 }
 
@@ -10831,12 +10922,17 @@ bool WorldObjectSpellAreaTargetCheck::operator()(WorldObject* target)
         if (!_caster->IsValidDesolateHostTarget(_target, _spellInfo))
             return false;
 
-    if (!_spellInfo->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) && !target->IsWithinLOS(_position->m_positionX, _position->m_positionY, _position->m_positionZ))
+    if (!_deferLineOfSight && !_spellInfo->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) && !target->IsWithinLOS(_position->m_positionX, _position->m_positionY, _position->m_positionZ))
         return false;
 
     return WorldObjectSpellTargetCheck::operator ()(target);
 }
 
+SpatialFilter WorldObjectSpellAreaTargetCheck::GetSpatialFilter() const
+{
+    return SpatialFilter(_position->GetPositionX(), _position->GetPositionY(), _position->GetPositionZ(), _range, _allowObjectSize);
+}
+
 WorldObjectSpellBetweenTargetCheck::WorldObjectSpellBetweenTargetCheck(float width, float range, Unit* caster, Position const* position, Unit* referer,
     SpellInfo const* spellInfo, SpellTargetCheckTypes selectionType, ConditionList* condList)
     : WorldObjectSpellAreaTargetCheck(range, caster, caster, referer, spellInfo, selectionType, condList), _width(width), _range(range), _position(position)
@@ -10882,6 +10978,17 @@ bool WorldObjectSpellConeTargetCheck::operator()(WorldObject* target)
     return WorldObjectSpellAreaTargetCheck::operator ()(target);
 }
 
+SpatialFilter WorldObjectSpellConeTargetCheck::GetSpatialFilter() const
+{
+    SpatialFilter filter = WorldObjectSpellAreaTargetCheck::GetSpatialFilter();
+
+    // back and line cones are left to the exact check
+    if (!(_spellInfo->AttributesCu[0] & (SPELL_ATTR0_CU_CONE_BACK | SPELL_ATTR0_CU_CONE_LINE)) && _coneAngle >= 0.0f)
+        filter.SetFrontArc(_caster->GetPositionX(), _caster->GetPositionY(), _caster->GetOrientation(), _coneAngle);
+
+    return filter;
+}
+
 WorldObjectSpellTrajTargetCheck::WorldObjectSpellTrajTargetCheck(float range, Position const* position, Unit* caster, SpellInfo const* spellInfo)
     : WorldObjectSpellAreaTargetCheck(range, position, caster, caster, spellInfo, TARGET_CHECK_DEFAULT, nullptr)
 {
@@ -21,6 +21,7 @@
 
 #include "GridDefines.h"
 #include "SharedDefines.h"
+#include "SpatialFilter.h"
 #include "SpellScript.h"
 #include "ObjectMgr.h"
 #include "SpellInfo.h"
@@ -390,6 +391,7 @@ class Spell
 
         WorldObject* SearchNearbyTarget(float range, SpellTargetObjectTypes objectType, SpellTargetCheckTypes selectionType, ConditionList* condList = nullptr);
         void SearchAreaTargets(std::list<WorldObject*>& targets, float range, Position const* position, Unit* referer, SpellTargetObjectTypes objectType, SpellTargetCheckTypes selectionType, ConditionList* condList, bool allowObjectSize = true);
+        void FilterAreaTargetsInLineOfSight(std::list<WorldObject*>& targets, std::list<WorldObject*>::iterator first, Position const* position, Unit* caster);
         void SearchChainTargets(std::list<WorldObject*>& targets, uint32 chainTargets, WorldObject* target, SpellTargetObjectTypes objectType, SpellTargetCheckTypes selectType, ConditionList* condList, bool isChainHeal);
 
         void preparePetCast(SpellCastTargets const* targets, Unit* target, Unit* pet, ObjectGuid petGuid, Player* player);
@@ -699,7 +701,7 @@ class Spell
         bool UpdateChanneledTargetList();
         bool IsValidDeadOrAliveTarget(Unit const* target) const;
         void HandleLaunchPhase();
-        void DoAllEffectOnLaunchTarget(TargetInfoPtr targetInfo, float* multiplier);
+        void DoAllEffectOnLaunchTarget(TargetInfoPtr targetInfo, float* multiplier, double critRoll);
 
         void PrepareTargetProcessing();
         void FinishTargetProcessing();
@@ -801,8 +803,10 @@ namespace Trinity
         float _range;
         Position const* _position;
         bool _allowObjectSize;
+        bool _deferLineOfSight;  // line of sight is left to the searcher, see Spell::SearchAreaTargets
         WorldObjectSpellAreaTargetCheck(float range, Position const* position, Unit* caster, Unit* referer, SpellInfo const* spellInfo, SpellTargetCheckTypes selectionType, ConditionList* condList, bool allowObjectSize = true);
         bool operator()(WorldObject* target);
+        SpatialFilter GetSpatialFilter() const;
     };
 
     struct WorldObjectSpellBetweenTargetCheck : WorldObjectSpellAreaTargetCheck
@@ -818,6 +822,7 @@ namespace Trinity
         float _coneAngle;
         WorldObjectSpellConeTargetCheck(float coneAngle, float range, Unit* caster, SpellInfo const* spellInfo, SpellTargetCheckTypes selectionType, ConditionList* condList);
         bool operator()(WorldObject* target);
+        SpatialFilter GetSpatialFilter() const;
     };
 
     struct WorldObjectSpellTrajTargetCheck : WorldObjectSpellAreaTargetCheck
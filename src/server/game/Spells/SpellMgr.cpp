@@ -1774,6 +1774,7 @@ void SpellMgr::LoadSpellProcEvents()
     uint32 oldMSTime = getMSTime();
 
     mSpellProcEventMap.clear();                             // need for reload case
+    ++mSpellProcEventVersion;                               // units rebuild their proc aura buckets
     mSpellProcEventMap.resize(GetSpellInfoStoreSize());
 
     //                                               0      1           2                3                 4                 5                 6                 7          8       9        10            11        12
@@ -1214,6 +1214,7 @@ class SpellMgr
 
         // Spell proc event table
         const std::vector<SpellProcEventEntry>* GetSpellProcEvent(uint32 spellId) const;
+        uint32 GetSpellProcEventVersion() const { return mSpellProcEventVersion; } // changes on every (re)load of spell_proc_event
         bool IsSpellProcEventCanTriggeredBy(SpellProcEventEntry const* spellProcEvent, uint32 EventProcFlag, SpellInfo const* procSpell, uint32 procFlags, uint32 procExtra, bool active);
 
         // Spell bonus data table
@@ -1317,6 +1318,7 @@ class SpellMgr
         SpellGroupSpellMap         mSpellGroupSpell;
         SpellGroupStackMap         mSpellGroupStack;
         SpellProcEventMap          mSpellProcEventMap;
+        uint32                     mSpellProcEventVersion = 0;
 
         SpellBonusMap              mSpellBonusMap;
         SpellBonusVector           mSpellBonusVector;
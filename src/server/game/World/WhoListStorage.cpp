@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2008-2016 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WhoListStorage.h"
+#include "AccountMgr.h"
+#include "DB2Stores.h"
+#include "Guild.h"
+#include "ObjectAccessor.h"
+#include "ObjectMgr.h"
+#include "Player.h"
+#include "Util.h"
+#include "WorldSession.h"
+
+namespace
+{
+    uint64 MakeTrigram(wchar_t const* chars)
+    {
+        return (uint64(uint32(chars[0]) & 0x1FFFFF) << 42) | (uint64(uint32(chars[1]) & 0x1FFFFF) << 21) | uint64(uint32(chars[2]) & 0x1FFFFF);
+    }
+
+    void IndexTrigrams(WhoListSnapshot::TrigramIndex& index, std::wstring const& text, uint32 row)
+    {
+        for (std::size_t i = 0; i + 3 <= text.size(); ++i)
+        {
+            WhoListSnapshot::RowList& rows = index[MakeTrigram(text.data() + i)];
+            if (rows.empty() || rows.back() != row)
+                rows.push_back(row);
+        }
+    }
+}
+
+WhoListSnapshot::RowList const* WhoListSnapshot::FindCandidates(TrigramIndex const& index, std::wstring const& needle) const
+{
+    if (needle.size() < 3)
+        return nullptr;
+
+    static RowList const NoRows;
+
+    // every row containing needle is listed under each of its trigrams, the shortest list is enough
+    RowList const* candidates = nullptr;
+    for (std::size_t i = 0; i + 3 <= needle.size(); ++i)
+    {
+        auto itr = index.find(MakeTrigram(needle.data() + i));
+        if (itr == index.end())
+            return &NoRows;
+
+        if (!candidates || itr->second.size() < candidates->size())
+            candidates = &itr->second;
+    }
+
+    return candidates;
+}
+
+bool WhoListSnapshot::IsVisibleGloballyFor(uint32 row, ObjectGuid const& viewer, uint8 viewerSecurity) const
+{
+    if (Guids[row] == viewer)
+        return true;
+
+    if (!viewerSecurity && Flags[row] & WHO_ROW_FLAG_INVISIBLE_STATUS)
+        return false;
+
+    if (Flags[row] & WHO_ROW_FLAG_VISIBLE)
+        return true;
+
+    if (!AccountMgr::IsPlayerAccount(viewerSecurity))
+        return Security[row] <= viewerSecurity;
+
+    return false;
+}
+
+WhoListStorageMgr* WhoListStorageMgr::instance()
+{
+    static WhoListStorageMgr instance;
+    return &instance;
+}
+
+void WhoListStorageMgr::Update()
+{
+    std::shared_ptr<WhoListSnapshot> snapshot = std::make_shared<WhoListSnapshot>();
+    LocaleConstant locale = sObjectMgr->GetDBCLocaleIndex();
+
+    HashMapHolder<Player>::GetLock().lock_shared();
+
+    HashMapHolder<Player>::MapType const& players = sObjectAccessor->GetPlayers();
+    std::size_t reserve = players.size();
+    snapshot->Guids.reserve(reserve);
+    snapshot->Teams.reserve(reserve);
+    snapshot->Security.reserve(reserve);
+    snapshot->Flags.reserve(reserve);
+    snapshot->Levels.reserve(reserve);
+    snapshot->Classes.reserve(reserve);
+    snapshot->Races.reserve(reserve);
+    snapshot->Zones.reserve(reserve);
+    snapshot->Names.reserve(reserve);
+    snapshot->GuildNames.reserve(reserve);
+    snapshot->GuildGuids.reserve(reserve);
+    snapshot->GuildDisplayNames.reserve(reserve);
+    snapshot->PlayerData.reserve(reserve);
+
+    for (auto const& pair : players)
+    {
+        Player* player = pair.second;
+        if (!player || !player->IsInWorld() || !player->GetSession())
+            continue;
+
+        std::wstring name;
+        if (!Utf8toWStr(player->GetName(), name))
+            continue;
+
+        std::string guildName;
+        ObjectGuid guildGuid;
+        if (Guild* guild = player->GetGuild())
+        {
+            guildName = guild->GetName();
+            guildGuid = guild->GetGUID();
+        }
+
+        std::wstring wGuildName;
+        if (!Utf8toWStr(guildName, wGuildName))
+            continue;
+
+        WorldPackets::Query::PlayerGuidLookupData playerData;
+        if (!playerData.Initialize(player->GetGUID(), player))
+            continue;
+
+        wstrToLower(name);
+        wstrToLower(wGuildName);
+
+        uint8 flags = 0;
+        if (player->IsVisible())
+            flags |= WHO_ROW_FLAG_VISIBLE;
+        if (player->HasInvisibleStatus())
+            flags |= WHO_ROW_FLAG_INVISIBLE_STATUS;
+        if (player->isGameMaster())
+            flags |= WHO_ROW_FLAG_GAMEMASTER;
+
+        int32 zoneId = player->GetCurrentZoneID();
+
+        snapshot->Guids.push_back(player->GetGUID());
+        snapshot->Teams.push_back(player->GetTeam());
+        snapshot->Security.push_back(uint8(player->GetSession()->GetSecurity()));
+        snapshot->Flags.push_back(flags);
+        snapshot->Levels.push_back(player->getLevel());
+        snapshot->Classes.push_back(player->getClass());
+        snapshot->Races.push_back(player->getRace());
+        snapshot->Zones.push_back(zoneId);
+        snapshot->Names.push_back(std::move(name));
+        snapshot->GuildNames.push_back(std::move(wGuildName));
+        snapshot->GuildGuids.push_back(guildGuid);
+        snapshot->GuildDisplayNames.push_back(std::move(guildName));
+        snapshot->PlayerData.push_back(std::move(playerData));
+
+        if (!snapshot->ZoneNames.count(zoneId))
+        {
+            std::wstring& zoneName = snapshot->ZoneNames[zoneId];
+            if (AreaTableEntry const* areaEntry = sAreaTableStore.LookupEntry(zoneId))
+                if (Utf8toWStr(areaEntry->AreaName->Str[locale], zoneName))
+                    wstrToLower(zoneName);
+        }
+    }
+
+    HashMapHolder<Player>::GetLock().unlock_shared();
+
+    for (uint32 row = 0; row < snapshot->GetRowCount(); ++row)
+    {
+        IndexTrigrams(snapshot->NameIndex, snapshot->Names[row], row);
+        IndexTrigrams(snapshot->GuildIndex, snapshot->GuildNames[row], row);
+    }
+
+    _snapshot.store(std::move(snapshot), std::memory_order_release);
+}
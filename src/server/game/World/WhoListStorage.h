@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2008-2016 TrinityCore <http://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WhoListStorage_h__
+#define WhoListStorage_h__
+
+#include "Common.h"
+#include "ObjectGuid.h"
+#include "QueryPackets.h"
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+
+class Player;
+
+enum WhoListRowFlags : uint8
+{
+    WHO_ROW_FLAG_VISIBLE            = 0x01,     // Unit::IsVisible
+    WHO_ROW_FLAG_INVISIBLE_STATUS   = 0x02,     // Player::HasInvisibleStatus
+    WHO_ROW_FLAG_GAMEMASTER         = 0x04      // Player::isGameMaster
+};
+
+// Immutable copy of what /who filters on, one row per online player. Names and guild names are
+// stored lowercased, the trigram indexes list the rows containing each three character sequence.
+struct WhoListSnapshot
+{
+    typedef std::vector<uint32> RowList;
+    typedef std::unordered_map<uint64, RowList> TrigramIndex;
+
+    std::vector<ObjectGuid> Guids;
+    std::vector<uint32> Teams;
+    std::vector<uint8> Security;
+    std::vector<uint8> Flags;
+    std::vector<uint8> Levels;
+    std::vector<uint8> Classes;
+    std::vector<uint8> Races;
+    std::vector<int32> Zones;
+    std::vector<std::wstring> Names;
+    std::vector<std::wstring> GuildNames;
+    std::vector<ObjectGuid> GuildGuids;
+    std::vector<std::string> GuildDisplayNames;
+    std::vector<WorldPackets::Query::PlayerGuidLookupData> PlayerData;
+
+    std::unordered_map<int32, std::wstring> ZoneNames;  // lowercased, in the dbc locale of the server
+
+    TrigramIndex NameIndex;
+    TrigramIndex GuildIndex;
+
+    uint32 GetRowCount() const { return uint32(Guids.size()); }
+
+    // Rows that may contain needle, nullptr if the index cannot narrow the search (needle shorter than a trigram)
+    RowList const* FindCandidates(TrigramIndex const& index, std::wstring const& needle) const;
+
+    // Same rules as Player::IsVisibleGloballyFor
+    bool IsVisibleGloballyFor(uint32 row, ObjectGuid const& viewer, uint8 viewerSecurity) const;
+};
+
+class WhoListStorageMgr
+{
+    WhoListStorageMgr() = default;
+    ~WhoListStorageMgr() = default;
+
+public:
+    static WhoListStorageMgr* instance();
+
+    // Rebuilds the snapshot from the online players, world thread only
+    void Update();
+
+    std::shared_ptr<WhoListSnapshot const> GetSnapshot() const { return _snapshot.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<std::shared_ptr<WhoListSnapshot const>> _snapshot;
+};
+
+#define sWhoListStorageMgr WhoListStorageMgr::instance()
+
+#endif // WhoListStorage_h__
@@ -105,6 +105,7 @@
 #include "WardenMgr.h"
 #include "WaypointMovementGenerator.h"
 #include "WeatherMgr.h"
+#include "WhoListStorage.h"
 #include "WildBattlePet.h"
 #include "WordFilterMgr.h"
 #include "World.h"
@@ -133,6 +134,17 @@ float World::ZoneUpdateDistanceRangeLimit = 5.0f;
 
 uint64 World::SendSize[OPCODE_COUNT] = { 0 };
 uint64 World::SendCount[OPCODE_COUNT] = { 0 };
+std::atomic<uint64> World::PlayerSaveCount(0);
+std::atomic<uint64> World::PlayerSaveStatements(0);
+std::atomic<uint64> World::BroadcastPacketCount(0);
+std::atomic<uint64> World::BroadcastRecipientCount(0);
+std::atomic<uint64> World::BroadcastBytesCopied(0);
+std::atomic<uint64> World::LootFillCount(0);
+std::atomic<uint64> World::LootOpenCount(0);
+std::atomic<uint64> World::LootDeferredCount(0);
+std::atomic<uint64> World::LootDeferredDropCount(0);
+std::atomic<uint64> World::HeartbeatCount(0);
+std::atomic<uint64> World::HeartbeatCoalescedCount(0);
 
 /// World constructor
 World::World() : isEventKillStart(false), mail_timer(0), mail_timer_expires(0), blackmarket_timer(0), m_updateTime(0), m_currentTime(0), m_sessionCount(0), m_maxSessionCount(0),
@@ -370,8 +382,9 @@ void World::ProcessLinkInstanceSocket(std::pair<std::weak_ptr<WorldSocket>, uint
             return;
         }
 
-        sock->SetWorldSession(session);
+        // the previous instance socket is detached before the new one can queue packets
         session->AddInstanceConnection(sock);
+        sock->SetWorldSession(session);
         session->HandleContinuePlayerLogin();
     }
 }
@@ -544,6 +557,7 @@ void World::LoadConfigSettings(bool reload)
     rate_values[RATE_DROP_ITEM_REFERENCED] = sConfigMgr->GetFloatDefault("Rate.Drop.Item.Referenced", 1.0f);
     rate_values[RATE_DROP_ITEM_REFERENCED_AMOUNT] = sConfigMgr->GetFloatDefault("Rate.Drop.Item.ReferencedAmount", 1.0f);
     m_bool_configs[CONFIG_DROP_DUNGEON_ONLY_X1] = sConfigMgr->GetBoolDefault("Rate.Drop.Dungeon", false);
+    m_bool_configs[CONFIG_LOOT_DEFER_CORPSE] = sConfigMgr->GetBoolDefault("Loot.DeferCorpseLoot", true);
     rate_values[RATE_DROP_CURRENCY]        =  sConfigMgr->GetFloatDefault("Rate.Drop.Currency", 1.0f);
     rate_values[RATE_DROP_CURRENCY_AMOUNT] =  sConfigMgr->GetFloatDefault("Rate.Drop.Currency.Amount", 1.0f);
     rate_values[RATE_DROP_MONEY]    = sConfigMgr->GetFloatDefault("Rate.Drop.Money", 1.0f);
@@ -965,6 +979,7 @@ void World::LoadConfigSettings(bool reload)
     m_bool_configs[CONFIG_CAST_UNSTUCK] = sConfigMgr->GetBoolDefault("CastUnstuck", true);
     m_int_configs[CONFIG_MAX_SPELL_CASTS_IN_CHAIN]  = sConfigMgr->GetIntDefault("MaxSpellCastsInChain", 10);
     m_int_configs[CONFIG_INSTANCE_RESET_TIME_HOUR]  = sConfigMgr->GetIntDefault("Instance.ResetTimeHour", 6);
+    m_int_configs[CONFIG_INSTANCE_RESET_UPDATE_BUDGET] = std::max(sConfigMgr->GetIntDefault("Instance.ResetUpdateBudget", 5), 1);
     m_int_configs[CONFIG_INSTANCE_DAILY_RESET]  = sConfigMgr->GetIntDefault("Instance.DailyReset", 1);
     m_int_configs[CONFIG_INSTANCE_WEEKLY_RESET]  = sConfigMgr->GetIntDefault("Instance.WeeklyReset", 7);
     m_int_configs[CONFIG_INSTANCE_UNLOAD_DELAY] = sConfigMgr->GetIntDefault("Instance.UnloadDelay", 30 * MINUTE * IN_MILLISECONDS);
@@ -1310,6 +1325,12 @@ void World::LoadConfigSettings(bool reload)
     TC_LOG_INFO(LOG_FILTER_SERVER_LOADING, "VMap data directory is: %svmaps", m_dataPath.c_str());
 
     m_int_configs[CONFIG_MAX_WHO] = sConfigMgr->GetIntDefault("MaxWhoListReturns", 49);
+    m_int_configs[CONFIG_WHO_LIST_UPDATE_INTERVAL] = sConfigMgr->GetIntDefault("WhoList.UpdateInterval", 5);
+    if (m_int_configs[CONFIG_WHO_LIST_UPDATE_INTERVAL] < 1)
+    {
+        TC_LOG_ERROR(LOG_FILTER_SERVER_LOADING, "WhoList.UpdateInterval (%u) must be > 0. Using 1 instead.", m_int_configs[CONFIG_WHO_LIST_UPDATE_INTERVAL]);
+        m_int_configs[CONFIG_WHO_LIST_UPDATE_INTERVAL] = 1;
+    }
     m_bool_configs[CONFIG_LIMIT_WHO_ONLINE] = sConfigMgr->GetBoolDefault("LimitWhoOnline", true);
     m_bool_configs[CONFIG_PET_LOS] = sConfigMgr->GetBoolDefault("vmap.petLOS", true);
     m_bool_configs[CONFIG_START_ALL_SPELLS] = sConfigMgr->GetBoolDefault("PlayerStart.AllSpells", false);
@@ -1332,6 +1353,19 @@ void World::LoadConfigSettings(bool reload)
     m_int_configs[CONFIG_MIN_LOG_UPDATE] = sConfigMgr->GetIntDefault("MinRecordUpdateTimeDiff", 100);
     m_int_configs[CONFIG_NUMTHREADS] = sConfigMgr->GetIntDefault("MapUpdate.Threads", 1);
     m_int_configs[CONFIG_MAP_NUMTHREADS] = sConfigMgr->GetIntDefault("MapUpdate.Map.Threads", 1);
+    m_int_configs[CONFIG_MAP_RANDOM_SEED] = sConfigMgr->GetIntDefault("MapUpdate.RandomSeed", 0);
+    m_int_configs[CONFIG_MAP_QUERY_CACHE_SIZE] = std::min(sConfigMgr->GetIntDefault("Map.QueryCache.Size", 0), 1 << 20);
+    m_int_configs[CONFIG_MAP_QUERY_CACHE_DURATION] = std::max(sConfigMgr->GetIntDefault("Map.QueryCache.Duration", 1000), 1);
+    m_float_configs[CONFIG_MAP_QUERY_CACHE_PRECISION] = std::max(sConfigMgr->GetFloatDefault("Map.QueryCache.Precision", 0.1f), 0.01f);
+    m_int_configs[CONFIG_GRID_PRELOAD_THREADS] = std::min(sConfigMgr->GetIntDefault("Map.GridPreload.Threads", 0), 8);
+    m_int_configs[CONFIG_GRID_PRELOAD_LOOKAHEAD] = std::max(sConfigMgr->GetIntDefault("Map.GridPreload.Lookahead", 10000), 1000);
+    m_int_configs[CONFIG_MAP_OBJECT_POOL_CREATURE] = std::min(sConfigMgr->GetIntDefault("Map.ObjectPool.Creature", 0), 4096);
+    m_int_configs[CONFIG_MAP_OBJECT_POOL_GAMEOBJECT] = std::min(sConfigMgr->GetIntDefault("Map.ObjectPool.GameObject", 0), 4096);
+    m_int_configs[CONFIG_MAP_OBJECT_POOL_AREATRIGGER] = std::min(sConfigMgr->GetIntDefault("Map.ObjectPool.AreaTrigger", 0), 4096);
+    m_int_configs[CONFIG_MAP_OBJECT_POOL_DYNAMICOBJECT] = std::min(sConfigMgr->GetIntDefault("Map.ObjectPool.DynamicObject", 0), 4096);
+    m_int_configs[CONFIG_WILD_BATTLE_PET_UPDATE_INTERVAL] = std::max(sConfigMgr->GetIntDefault("Map.WildBattlePet.UpdateInterval", 30000), 1000);
+    m_int_configs[CONFIG_WILD_BATTLE_PET_SPAWN_BUDGET] = std::max(sConfigMgr->GetIntDefault("Map.WildBattlePet.SpawnBudget", 10), 1);
+    m_int_configs[CONFIG_MOVEMENT_COALESCE_HEARTBEATS] = std::min(sConfigMgr->GetIntDefault("Movement.CoalesceHeartbeats", 0), 2);
     m_int_configs[CONFIG_MAX_RESULTS_LOOKUP_COMMANDS] = sConfigMgr->GetIntDefault("Command.LookupMaxResults", 0);
 
     // chat logging
@@ -1512,6 +1546,7 @@ void World::LoadConfigSettings(bool reload)
     m_bool_configs[CONFIG_ANTICHEAT_NOTIFY_CHEATERS] = sConfigMgr->GetBoolDefault("Anticheat.NotifyCheaters", false);
     m_bool_configs[CONFIG_ANTICHEAT_LOG_DATA] = sConfigMgr->GetBoolDefault("Anticheat.LogData", false);
     m_bool_configs[CONFIG_ANTICHEAT_DETAIL_LOG] = sConfigMgr->GetBoolDefault("Anticheat.Detail.Log", false);
+    m_bool_configs[CONFIG_ANTICHEAT_CAPTURE_ENABLED] = sConfigMgr->GetBoolDefault("Anticheat.Capture.Enable", false);
 
     m_int_configs[CONFIG_ANTICHEAT_MAX_ALLOWED_DESYNC] = sConfigMgr->GetIntDefault("Anticheat.MaxAllowedDesync", 0);
     m_int_configs[CONFIG_ANTICHEAT_GM_ANNOUNCE_MASK] = sConfigMgr->GetIntDefault("Anticheat.GMAnnounceMask", 0);
@@ -2248,6 +2283,8 @@ void World::SetInitialWorldSettings()
     m_timers[WUPDATE_GUILDSAVE].SetInterval(getIntConfig(CONFIG_GUILD_SAVE_INTERVAL) * MINUTE * IN_MILLISECONDS);
 
     m_timers[WUPDATE_BLACKMARKET].SetInterval(10 * IN_MILLISECONDS);
+
+    m_timers[WUPDATE_WHO_LIST].SetInterval(getIntConfig(CONFIG_WHO_LIST_UPDATE_INTERVAL) * IN_MILLISECONDS);
     blackmarket_timer = 0;
 
     //to set mailtimer to return mails every day between 4 and 5 am
@@ -2677,6 +2714,13 @@ void World::Update(uint32 diff)
         sGuildMgr->SaveGuilds();
     }
 
+    ///- Rebuild the snapshot /who queries are answered from
+    if (m_timers[WUPDATE_WHO_LIST].Passed())
+    {
+        m_timers[WUPDATE_WHO_LIST].Reset();
+        sWhoListStorageMgr->Update();
+    }
+
     sPetBattleSystem->Update(diff);
 
     sInstanceSaveMgr->Update();
@@ -3839,7 +3883,7 @@ void World::InstanceDailyResetTime()
 
     sWorld->setWorldState(WS_INSTANCE_DAILY_RESET_TIME, m_NextInstanceDailyReset);
 
-    SQLTransaction trans = CharacterDatabase.BeginTransaction();
+    std::vector<InstanceSaveManager::MapDifficultyKey> maps;
     for (auto& mapDifficultyPair : sDB2Manager.GetAllMapsDifficultyes())
     {
         for (auto& difficultyPair : mapDifficultyPair.second)
@@ -3852,11 +3896,10 @@ void World::InstanceDailyResetTime()
                 continue;
 
             if (i_map->IsNonRaidDungeon())
-                sInstanceSaveMgr->ResetOrWarnAll(mapid, difficulty, trans);
+                maps.emplace_back(mapid, difficulty);
         }
     }
-    CharacterDatabase.CommitTransaction(trans);
-    CharacterDatabase.WaitExecution();
+    sInstanceSaveMgr->QueueGlobalReset("daily", maps);
 
     if (sWorld->getBoolConfig(CONFIG_WORLD_QUEST))
         sQuestDataStore->GenerateWorldQuestUpdate();
@@ -3872,7 +3915,7 @@ void World::InstanceWeeklyResetTime()
 
     sWorld->setWorldState(WS_INSTANCE_WEEKLY_RESET_TIME, m_NextInstanceWeeklyReset);
 
-    SQLTransaction trans = CharacterDatabase.BeginTransaction();
+    std::vector<InstanceSaveManager::MapDifficultyKey> maps;
     for (auto& mapDifficultyPair : sDB2Manager.GetAllMapsDifficultyes())
     {
         for (auto& difficultyPair : mapDifficultyPair.second)
@@ -3883,11 +3926,10 @@ void World::InstanceWeeklyResetTime()
                 continue;
 
             if (i_map->IsRaid())
-                sInstanceSaveMgr->ResetOrWarnAll(mapid, static_cast<Difficulty>(difficultyPair.first), trans);
+                maps.emplace_back(mapid, static_cast<Difficulty>(difficultyPair.first));
         }
     }
-    CharacterDatabase.CommitTransaction(trans);
-    CharacterDatabase.WaitExecution();
+    sInstanceSaveMgr->QueueGlobalReset("weekly", maps);
 }
 
 void World::ChallengeKeyResetTime()
@@ -91,6 +91,7 @@ enum WorldTimers
     WUPDATE_BLACKMARKET,
     WUPDATE_AHBOT,
     WUPDATE_DONATE_AND_SERVICES,
+    WUPDATE_WHO_LIST,
 
     WUPDATE_COUNT
 };
@@ -174,6 +175,7 @@ enum WorldBoolConfigs
     CONFIG_AUTOBROADCAST,
     CONFIG_ALLOW_TICKETS,
     CONFIG_DROP_DUNGEON_ONLY_X1,
+    CONFIG_LOOT_DEFER_CORPSE,
     CONFIG_DBC_ENFORCE_ITEM_ATTRIBUTES,
     CONFIG_PRESERVE_CUSTOM_CHANNELS,
     CONFIG_PDUMP_NO_PATHS,
@@ -236,6 +238,7 @@ enum WorldBoolConfigs
     CONFIG_ANTICHEAT_NOTIFY_CHEATERS,
     CONFIG_ANTICHEAT_LOG_DATA,
     CONFIG_ANTICHEAT_DETAIL_LOG,
+    CONFIG_ANTICHEAT_CAPTURE_ENABLED,
     CONFIG_OBLITERUM_LEVEL_ENABLE,
     CONFIG_PVP_LEVEL_ENABLE,
     CONFIG_PARAGON_ENABLE,
@@ -268,6 +271,7 @@ enum WorldFloatConfigs
     CONFIG_FLOAT_VARIABLE_FOR_DEBUG_0,
     CONFIG_FLOAT_VARIABLE_FOR_DEBUG_1,
     CONFIG_CAP_KILL_CREATURE_POINTS,
+    CONFIG_MAP_QUERY_CACHE_PRECISION,
     FLOAT_CONFIG_VALUE_COUNT
 };
 
@@ -316,6 +320,7 @@ enum WorldIntConfigs
     CONFIG_MAX_RECRUIT_A_FRIEND_BONUS_PLAYER_LEVEL_DIFFERENCE,
     CONFIG_MAX_SPELL_CASTS_IN_CHAIN,
     CONFIG_INSTANCE_RESET_TIME_HOUR,
+    CONFIG_INSTANCE_RESET_UPDATE_BUDGET,
     CONFIG_INSTANCE_DAILY_RESET,
     CONFIG_INSTANCE_HALF_WEEK_RESET,
     CONFIG_INSTANCE_WEEKLY_RESET,
@@ -389,6 +394,7 @@ enum WorldIntConfigs
     CONFIG_ARENA_START_PERSONAL_RATING,
     CONFIG_ARENA_START_MATCHMAKER_RATING,
     CONFIG_MAX_WHO,
+    CONFIG_WHO_LIST_UPDATE_INTERVAL,
     CONFIG_HONOR_AFTER_DUEL,
     CONFIG_PVP_TOKEN_MAP_TYPE,
     CONFIG_PVP_TOKEN_ID,
@@ -399,6 +405,18 @@ enum WorldIntConfigs
     CONFIG_PLAYER_ALLOW_COMMANDS,
     CONFIG_NUMTHREADS,
     CONFIG_MAP_NUMTHREADS,
+    CONFIG_MAP_RANDOM_SEED,
+    CONFIG_MAP_QUERY_CACHE_SIZE,
+    CONFIG_MAP_QUERY_CACHE_DURATION,
+    CONFIG_GRID_PRELOAD_THREADS,
+    CONFIG_GRID_PRELOAD_LOOKAHEAD,
+    CONFIG_MAP_OBJECT_POOL_CREATURE,
+    CONFIG_MAP_OBJECT_POOL_GAMEOBJECT,
+    CONFIG_MAP_OBJECT_POOL_AREATRIGGER,
+    CONFIG_MAP_OBJECT_POOL_DYNAMICOBJECT,
+    CONFIG_WILD_BATTLE_PET_UPDATE_INTERVAL,
+    CONFIG_WILD_BATTLE_PET_SPAWN_BUDGET,
+    CONFIG_MOVEMENT_COALESCE_HEARTBEATS,
     CONFIG_LOGDB_CLEARINTERVAL,
     CONFIG_LOGDB_CLEARTIME,
     CONFIG_CLIENTCACHE_VERSION,
@@ -702,6 +720,17 @@ class World
         static std::atomic<uint32> m_worldLoopCounter;
         static uint64 SendSize[OPCODE_COUNT];
         static uint64 SendCount[OPCODE_COUNT];
+        static std::atomic<uint64> PlayerSaveCount;         // Player::SaveToDB calls since startup
+        static std::atomic<uint64> PlayerSaveStatements;    // character db statements queued by those saves
+        static std::atomic<uint64> BroadcastPacketCount;    // payloads shared through BroadcastPacket
+        static std::atomic<uint64> BroadcastRecipientCount; // sessions those payloads were queued on
+        static std::atomic<uint64> BroadcastBytesCopied;    // bytes copied into the shared payloads
+        static std::atomic<uint64> LootFillCount;           // Loot::FillLoot calls
+        static std::atomic<uint64> LootOpenCount;           // Player::SendLoot calls
+        static std::atomic<uint64> LootDeferredCount;       // corpse loots left to be rolled on first access
+        static std::atomic<uint64> LootDeferredDropCount;   // deferred loots cleared without ever being rolled
+        static std::atomic<uint64> HeartbeatCount;          // CMSG_MOVE_HEARTBEAT received by session updates
+        static std::atomic<uint64> HeartbeatCoalescedCount; // ... dropped for a newer heartbeat of the same mover
 
         static World* instance();
 
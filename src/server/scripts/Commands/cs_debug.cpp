@@ -19,13 +19,16 @@
 #include "Cell.h"
 #include "ChallengeMgr.h"
 #include "Chat.h"
+#include "ConditionMgr.h"
 #include "GridNotifiers.h"
+#include "GridPreloader.h"
 #include "Group.h"
 #include "GroupMgr.h"
 #include "LFGListMgr.h"
 #include "LFGMgr.h"
 #include "LFGQueue.h"
 #include "MapManager.h"
+#include "MapObjectPool.h"
 #include "ObjectMgr.h"
 #include "ObjectVisitors.hpp"
 #include "OutdoorPvP.h"
@@ -36,6 +39,9 @@
 #include "PlayerDefines.h"
 #include "ScriptMgr.h"
 #include "Vehicle.h"
+#include "VMapFactory.h"
+#include "WorldPacketPool.h"
+#include <chrono>
 #include <fstream>
 #include "Garrison.h"
 
@@ -101,6 +107,13 @@ public:
             { "load_z",         SEC_ADMINISTRATOR,  false, &HandleDebugLoadZ,                  ""},
             { "lootrecipient",  SEC_GAMEMASTER,     false, &HandleDebugGetLootRecipientCommand, ""},
             { "los",            SEC_MODERATOR,      false, &HandleDebugLoSCommand,             ""},
+            { "losbench",       SEC_ADMINISTRATOR,  false, &HandleDebugLoSBenchCommand,        ""},
+            { "querycache",     SEC_ADMINISTRATOR,  false, &HandleDebugQueryCacheCommand,      ""},
+            { "gridpreload",    SEC_ADMINISTRATOR,  false, &HandleDebugGridPreloadCommand,     ""},
+            { "objectpool",     SEC_ADMINISTRATOR,  false, &HandleDebugObjectPoolCommand,      ""},
+            { "conditionbench", SEC_ADMINISTRATOR,  false, &HandleDebugConditionBenchCommand,  ""},
+            { "wildbattlepet",  SEC_ADMINISTRATOR,  false, &HandleDebugWildBattlePetCommand,   ""},
+            { "packetpool",     SEC_ADMINISTRATOR,  false, &HandleDebugPacketPoolCommand,      ""},
             { "mailstatus",     SEC_ADMINISTRATOR,  false, &HandleSendMailStatus,              ""},
             { "mapinfo",        SEC_ADMINISTRATOR,  false, &HandleDebugGetMapInfoCommand,      ""},
             { "mastery",        SEC_REALM_LEADER,   false, &HandleDebugModifyMasteryCommand,        ""},
@@ -1333,6 +1346,202 @@ public:
         return true;
     }
 
+    // .debug losbench [rays] [radius] - traces random rays around the player one by one and batched, reports rays per second
+    // and the rays on which both traces disagree
+    static bool HandleDebugLoSBenchCommand(ChatHandler* handler, char const* args)
+    {
+        Player* player = handler->GetSession()->GetPlayer();
+
+        uint32 rays = 6400;
+        float radius = 40.0f;
+        if (char* raysStr = strtok((char*)args, " "))
+        {
+            rays = std::min<uint32>(std::max(atoi(raysStr), 1), 1000000);
+            if (char* radiusStr = strtok(nullptr, " "))
+                radius = std::max<float>(atof(radiusStr), 1.0f);
+        }
+
+        Map* map = player->GetMap();
+        G3D::Vector3 origin(player->GetPositionX(), player->GetPositionY(), player->GetPositionZ() + 2.f);
+        std::vector<G3D::Vector3> targets(rays);
+        for (G3D::Vector3& target : targets)
+        {
+            float angle = frand(0.0f, 2 * float(M_PI));
+            float dist = frand(0.0f, radius);
+            target = G3D::Vector3(origin.x + dist * std::cos(angle), origin.y + dist * std::sin(angle), origin.z + frand(-radius, radius) * 0.25f);
+        }
+
+        uint32 visibleSingle = 0;
+        std::vector<bool> singleResults(rays);
+        auto start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < rays; ++i)
+        {
+            singleResults[i] = map->isInLineOfSight(origin.x, origin.y, origin.z, targets[i].x, targets[i].y, targets[i].z, player->GetPhases());
+            if (singleResults[i])
+                ++visibleSingle;
+        }
+        auto single = std::chrono::steady_clock::now() - start;
+
+        uint32 visibleBatched = 0;
+        std::vector<uint64> batchResults((rays + VMAP_MAX_LOS_BATCH - 1) / VMAP_MAX_LOS_BATCH);
+        start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < rays; i += VMAP_MAX_LOS_BATCH)
+        {
+            uint32 count = std::min<uint32>(rays - i, VMAP_MAX_LOS_BATCH);
+            uint64 visible = map->isInLineOfSight(origin, &targets[i], count, player->GetPhases());
+            batchResults[i / VMAP_MAX_LOS_BATCH] = visible;
+            for (; visible; visible &= visible - 1)
+                ++visibleBatched;
+        }
+        auto batched = std::chrono::steady_clock::now() - start;
+
+        // same segments both ways, any difference is a bug in the batched trace
+        uint32 mismatches = 0;
+        for (uint32 i = 0; i < rays; ++i)
+            if (singleResults[i] != bool(batchResults[i / VMAP_MAX_LOS_BATCH] & (UI64LIT(1) << (i % VMAP_MAX_LOS_BATCH))))
+                ++mismatches;
+
+        double singleSecs = std::max(std::chrono::duration<double>(single).count(), 1e-9);
+        double batchedSecs = std::max(std::chrono::duration<double>(batched).count(), 1e-9);
+        handler->PSendSysMessage("LoS bench: %u rays within %.1f yards of map %u", rays, radius, map->GetId());
+        handler->PSendSysMessage("Single: %.0f rays/s, %u visible", rays / singleSecs, visibleSingle);
+        handler->PSendSysMessage("Batched: %.0f rays/s, %u visible (%.2fx)", rays / batchedSecs, visibleBatched, singleSecs / batchedSecs);
+        handler->PSendSysMessage("Disagreements: %u", mismatches);
+        return true;
+    }
+
+    // .debug querycache [reset] - line of sight and height cache counters of the current map
+    static bool HandleDebugQueryCacheCommand(ChatHandler* handler, char const* args)
+    {
+        Map* map = handler->GetSession()->GetPlayer()->GetMap();
+        MapQueryCache& cache = map->GetQueryCache();
+        if (!cache.IsEnabled())
+        {
+            handler->PSendSysMessage("Query cache of map %u is disabled (Map.QueryCache.Size)", map->GetId());
+            return true;
+        }
+
+        MapQueryCache::Stats stats = cache.GetStats();
+        uint64 lineOfSightTotal = stats.LineOfSightHits + stats.LineOfSightPartialHits + stats.LineOfSightMisses;
+        uint64 heightTotal = stats.HeightHits + stats.HeightMisses;
+        handler->PSendSysMessage("Query cache of map %u instance %u", map->GetId(), map->GetInstanceId());
+        handler->PSendSysMessage("Line of sight: " UI64FMTD " hits, " UI64FMTD " partial hits, " UI64FMTD " misses (%.1f%% hit rate)",
+            stats.LineOfSightHits, stats.LineOfSightPartialHits, stats.LineOfSightMisses, lineOfSightTotal ? 100.0 * stats.LineOfSightHits / lineOfSightTotal : 0.0);
+        handler->PSendSysMessage("Height: " UI64FMTD " hits, " UI64FMTD " misses (%.1f%% hit rate)",
+            stats.HeightHits, stats.HeightMisses, heightTotal ? 100.0 * stats.HeightHits / heightTotal : 0.0);
+        handler->PSendSysMessage("Saved about " UI64FMTD " ms of queries", stats.SavedMicroseconds / 1000);
+
+        if (args && strcmp(args, "reset") == 0)
+        {
+            cache.ResetStats();
+            handler->SendSysMessage("Counters reset");
+        }
+        return true;
+    }
+
+    // .debug gridpreload [reset] - grids loaded ahead of players against grids loaded when entered
+    static bool HandleDebugGridPreloadCommand(ChatHandler* handler, char const* args)
+    {
+        if (!sGridPreloader->IsEnabled())
+        {
+            handler->SendSysMessage("Grid preloading is disabled (Map.GridPreload.Threads)");
+            return true;
+        }
+
+        GridPreloader::Stats stats = sGridPreloader->GetStats();
+        uint64 terrainTotal = stats.TerrainPrefetched + stats.TerrainSync;
+        handler->PSendSysMessage("Terrain: " UI64FMTD " requested, " UI64FMTD " prefetched, " UI64FMTD " read on the map thread, " UI64FMTD " unused (%.1f%% prefetched)",
+            stats.Requested, stats.TerrainPrefetched, stats.TerrainSync, stats.TerrainWasted, terrainTotal ? 100.0 * stats.TerrainPrefetched / terrainTotal : 0.0);
+        handler->PSendSysMessage("Grids: " UI64FMTD " loaded ahead, " UI64FMTD " loaded on demand",
+            stats.GridsPreloaded, stats.GridsLoaded - std::min(stats.GridsPreloaded, stats.GridsLoaded));
+        handler->PSendSysMessage("Workers spent " UI64FMTD " ms reading terrain", stats.WorkerMicroseconds / 1000);
+
+        if (args && strcmp(args, "reset") == 0)
+        {
+            sGridPreloader->ResetStats();
+            handler->SendSysMessage("Counters reset");
+        }
+        return true;
+    }
+
+    // .debug objectpool - pooled objects of the current map
+    static bool HandleDebugObjectPoolCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        static char const* const poolNames[MAX_MAP_OBJECT_POOLS] = { "Creature", "GameObject", "AreaTrigger", "DynamicObject" };
+
+        Map* map = handler->GetSession()->GetPlayer()->GetMap();
+        handler->PSendSysMessage("Object pools of map %u instance %u", map->GetId(), map->GetInstanceId());
+        for (uint32 i = 0; i < MAX_MAP_OBJECT_POOLS; ++i)
+        {
+            if (!map->GetObjectPools().IsEnabled(MapObjectPoolType(i)))
+            {
+                handler->PSendSysMessage("%s: not pooled (Map.ObjectPool.%s)", poolNames[i], poolNames[i]);
+                continue;
+            }
+
+            MapObjectPool::Stats stats = map->GetObjectPools().GetStats(MapObjectPoolType(i));
+
+            handler->PSendSysMessage("%s: %u live, %u peak, %u free, %u waiting for the removal phase, %u slabs",
+                poolNames[i], stats.Live, stats.Peak, stats.Free, stats.Pending, stats.Slabs);
+        }
+        return true;
+    }
+
+    // .debug conditionbench [iterations] - every loaded condition list against the selected unit or yourself
+    static bool HandleDebugConditionBenchCommand(ChatHandler* handler, char const* args)
+    {
+        uint32 iterations = args && *args ? uint32(atoi(args)) : 100;
+        if (!iterations)
+            iterations = 1;
+
+        Unit* target = handler->getSelectedUnit();
+        if (!target)
+            target = handler->GetSession()->GetPlayer();
+
+        ConditionMgr::BenchmarkResult result = sConditionMgr->BenchmarkConditions(target, iterations);
+        uint64 evaluations = uint64(result.Lists) * iterations;
+
+        handler->PSendSysMessage("%u condition lists (%u compiled, %u ops), %u met by %s", result.Lists, result.CompiledLists, result.Ops, result.Met, target->GetName());
+        handler->PSendSysMessage("Interpreted: " UI64FMTD " us (%.3f us per list)", result.InterpretedMicroseconds, evaluations ? double(result.InterpretedMicroseconds) / evaluations : 0.0);
+        handler->PSendSysMessage("Compiled: " UI64FMTD " us (%.3f us per list)", result.CompiledMicroseconds, evaluations ? double(result.CompiledMicroseconds) / evaluations : 0.0);
+        if (result.Mismatches)
+            handler->PSendSysMessage("%u lists evaluated differently", result.Mismatches);
+        return true;
+    }
+
+    // .debug wildbattlepet - wild battle pet population of the current map
+    static bool HandleDebugWildBattlePetCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        Map* map = handler->GetSession()->GetPlayer()->GetMap();
+        Map::WildBattlePetStats const& stats = map->GetWildBattlePetStats();
+
+        handler->PSendSysMessage("Wild battle pets of map %u instance %u: %u zones, %u with players, %u visited by the last pass (%u ms)",
+            map->GetId(), map->GetInstanceId(), stats.Zones, stats.ZonesObserved, stats.ZonesVisited, stats.UpdateTime);
+        handler->PSendSysMessage("Last pass: %u spawned, %u replaced (budget %u)", stats.Spawned, stats.Replaced, sWorld->getIntConfig(CONFIG_WILD_BATTLE_PET_SPAWN_BUDGET));
+        handler->PSendSysMessage("Total: " UI64FMTD " spawned, " UI64FMTD " replaced", stats.TotalSpawned, stats.TotalReplaced);
+        return true;
+    }
+
+    // .debug packetpool - client packet pools of the network threads and the receive queue of the selected player or yourself
+    static bool HandleDebugPacketPoolCommand(ChatHandler* handler, char const* /*args*/)
+    {
+        std::vector<WorldPacketPool::Stats> pools = WorldPacketPool::GetAllStats();
+        for (uint32 i = 0; i < pools.size(); ++i)
+        {
+            WorldPacketPool::Stats const& stats = pools[i];
+            handler->PSendSysMessage("Pool %u: " UI64FMTD " packets, %.1f%% recycled, " UI64FMTD " allocated, %u free", i, stats.Acquired,
+                stats.Acquired ? 100.0 * stats.Recycled / stats.Acquired : 0.0, stats.Allocated, stats.Free);
+        }
+
+        Player* target = handler->getSelectedPlayer();
+        if (!target)
+            target = handler->GetSession()->GetPlayer();
+
+        WorldSession* session = target->GetSession();
+        handler->PSendSysMessage("Receive queue of %s: %u packets, %u peak", target->GetName(), session->GetReceiveQueueSize(), session->GetReceiveQueuePeak());
+        return true;
+    }
+
     static bool HandleDebugSetAuraStateCommand(ChatHandler* handler, char const* args)
     {
         if (!*args)
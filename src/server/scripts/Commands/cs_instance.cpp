@@ -160,6 +160,15 @@ public:
         handler->PSendSysMessage("players bound: %d", sInstanceSaveMgr->GetNumBoundPlayersTotal());
         handler->PSendSysMessage("groups bound: %d", sInstanceSaveMgr->GetNumBoundGroupsTotal());
 
+        InstanceSaveManager::GlobalReset current, last;
+        if (sInstanceSaveMgr->GetGlobalResetProgress(current, last))
+            handler->PSendSysMessage("%s reset running for %u ms (%u ms busy over %u updates): %u saves scanned, %u reset, %u players notified, map %u/%u",
+                current.Name.c_str(), current.Duration, current.BusyTime, current.Ticks, current.SavesScanned, current.SavesReset, current.PlayersNotified,
+                current.NextMap, uint32(current.MapIds.size()));
+        if (!last.Name.empty())
+            handler->PSendSysMessage("last %s reset took %u ms (%u ms busy over %u updates): %u saves reset, %u extensions ended, %u players notified, %u instances",
+                last.Name.c_str(), last.Duration, last.BusyTime, last.Ticks, last.SavesReset, last.SavesExtended, last.PlayersNotified, last.MapsReset);
+
         return true;
     }
 
@@ -133,6 +133,27 @@ public:
         handler->PSendSysMessage("Map delay: %u ms diff %u", updateTimeMap, sWorld->getIntConfig(CONFIG_INTERVAL_MAPUPDATE));
         handler->PSendSysMessage("Session delay: %u ms diff %u", updateSessionTime, sWorld->getIntConfig(CONFIG_INTERVAL_MAP_SESSION_UPDATE));
 
+        uint64 playerSaves = World::PlayerSaveCount;
+        uint64 playerSaveStatements = World::PlayerSaveStatements;
+        handler->PSendSysMessage("Player saves: " UI64FMTD ", statements per save: %.1f", playerSaves, playerSaves ? float(playerSaveStatements) / playerSaves : 0.0f);
+        handler->PSendSysMessage("Script hook calls: %u/s", sScriptMgr->GetHookInvocationRate());
+
+        uint64 broadcasts = World::BroadcastPacketCount;
+        uint64 broadcastRecipients = World::BroadcastRecipientCount;
+        uint64 broadcastBytes = World::BroadcastBytesCopied;
+        handler->PSendSysMessage("Broadcast packets: " UI64FMTD ", recipients per packet: %.1f, bytes copied per packet: %.1f (1 allocation)", broadcasts,
+            broadcasts ? float(broadcastRecipients) / broadcasts : 0.0f, broadcasts ? float(broadcastBytes) / broadcasts : 0.0f);
+
+        uint64 lootDeferred = World::LootDeferredCount;
+        uint64 lootDeferredDropped = World::LootDeferredDropCount;
+        handler->PSendSysMessage("Loot generated: " UI64FMTD ", opened: " UI64FMTD ", deferred: " UI64FMTD " (" UI64FMTD " never rolled)",
+            uint64(World::LootFillCount), uint64(World::LootOpenCount), lootDeferred, lootDeferredDropped);
+
+        uint64 heartbeats = World::HeartbeatCount;
+        uint64 heartbeatsCoalesced = World::HeartbeatCoalescedCount;
+        handler->PSendSysMessage("Movement heartbeats: " UI64FMTD ", coalesced: " UI64FMTD " (%.1f%%)", heartbeats, heartbeatsCoalesced,
+            heartbeats ? 100.0f * heartbeatsCoalesced / heartbeats : 0.0f);
+
         // Can't use sWorld->ShutdownMsg here in case of console command
         if (sWorld->IsShuttingDown())
             handler->PSendSysMessage(LANG_SHUTDOWN_TIMELEFT, secsToTimeString(sWorld->GetShutDownTimeLeft()).c_str());
@@ -32,6 +32,50 @@
 
 namespace Trinity {
 
+/*
+ * @struct ContainerPositions mirrors the position and reach of the elements
+ * of a ContainerMapList in structure-of-arrays form, at the same offsets as the
+ * elements. Spatial searches test it before dereferencing any element.
+ */
+struct ContainerPositions
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> reach;
+
+    std::size_t size() const { return x.size(); }
+
+    void add(float px, float py, float pz, float r)
+    {
+        x.push_back(px);
+        y.push_back(py);
+        z.push_back(pz);
+        reach.push_back(r);
+    }
+
+    void set(std::size_t offset, float px, float py, float pz, float r)
+    {
+        x[offset] = px;
+        y[offset] = py;
+        z[offset] = pz;
+        reach[offset] = r;
+    }
+
+    // same swap with back and pop as the element vector
+    void remove(std::size_t offset)
+    {
+        std::size_t last = x.size() - 1;
+        if (offset != last)
+            set(offset, x[last], y[last], z[last], reach[last]);
+
+        x.pop_back();
+        y.pop_back();
+        z.pop_back();
+        reach.pop_back();
+    }
+};
+
 namespace Detail {
 
 /*
@@ -43,6 +87,7 @@ template <typename T>
 struct ContainerMapList
 {
     std::vector<T*> elements;
+    ContainerPositions positions;
 };
 
 template <>
@@ -122,7 +167,7 @@ public:
     void insert(SpecificType *obj)
     {
         auto &m = Detail::mapForType<SpecificType>(m_objectMap);
-        obj->AddToGrid(m.elements);
+        obj->AddToGrid(m.elements, m.positions);
     }
 
     ObjectMap & objectMap() { return m_objectMap; }
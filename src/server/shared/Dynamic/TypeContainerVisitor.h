@@ -36,10 +36,14 @@ namespace Detail {
 template <typename Visitor>
 void VisitorHelper(Visitor &/*v*/, ContainerMapList<TypeNull> &/*c*/) { }
 
+// visitors that can use the position mirror get it along with the elements
 template <typename Visitor, typename T>
 void VisitorHelper(Visitor &v, ContainerMapList<T> &c)
 {
-    v.Visit(c.elements);
+    if constexpr (requires { v.Visit(c.elements, c.positions); })
+        v.Visit(c.elements, c.positions);
+    else
+        v.Visit(c.elements);
 }
 
 // recursion container map list
@@ -33,7 +33,32 @@
 #include "Config.h"
 #include "Resolver.h"
 
-RealmList::RealmList() : _updateInterval(0)
+namespace
+{
+    // everything a client can see of a realm in the realm list or a realm entry
+    typedef std::tuple<uint32, std::string, uint8, uint32, uint8, uint32> RealmListState;
+
+    RealmListState GetRealmListState(Realm const& realm)
+    {
+        return RealmListState(realm.Build, realm.Name, realm.Type, uint32(realm.Flags), realm.Timezone, uint32(realm.PopulationLevel));
+    }
+
+    RealmList::CompressedPayload CompressJSON(std::string const& json)
+    {
+        uLong compressedLength = compressBound(json.length() + 1);
+        std::shared_ptr<std::vector<uint8>> compressed = std::make_shared<std::vector<uint8>>(4 + compressedLength);
+        *reinterpret_cast<uint32*>(compressed->data()) = json.length() + 1;
+
+        if (compress(compressed->data() + 4, &compressedLength, reinterpret_cast<uint8 const*>(json.c_str()), json.length() + 1) != Z_OK)
+            return nullptr;
+
+        compressed->resize(compressedLength + 4);
+        compressed->shrink_to_fit();
+        return compressed;
+    }
+}
+
+RealmList::RealmList() : _updateInterval(0), _realmListVersion(0)
 {
 }
 
@@ -133,11 +158,16 @@ void RealmList::UpdateRealms(boost::system::error_code const& error)
     PreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_REALMLIST);
     PreparedQueryResult result = LoginDatabase.Query(stmt);
 
+    std::lock_guard<std::recursive_mutex> guard(i_RealmList_lock);
+
     std::map<Battlenet::RealmHandle, std::string> existingRealms;
+    std::map<uint32, RealmListState> previousStates;
     for (auto const& p : _realms)
+    {
         existingRealms[p.first] = p.second.Name;
+        previousStates[p.first.GetAddress()] = GetRealmListState(p.second);
+    }
 
-    std::lock_guard<std::recursive_mutex> guard(i_RealmList_lock);
     _realms.clear();
 
     // Circle through results and add them to the realm map
@@ -217,6 +247,18 @@ void RealmList::UpdateRealms(boost::system::error_code const& error)
     for (auto & existingRealm : existingRealms)
         TC_LOG_INFO(LOG_FILTER_REALMLIST, "Removed realm \"%s\".", existingRealm.second.c_str());
 
+    std::map<uint32, RealmListState> currentStates;
+    for (auto const& p : _realms)
+        currentStates[p.first.GetAddress()] = GetRealmListState(p.second);
+
+    if (currentStates != previousStates || !_realmListVersion)
+    {
+        ++_realmListVersion;
+        _realmListCache.clear();
+        _realmEntryCache.clear();
+        TC_LOG_DEBUG(LOG_FILTER_REALMLIST, "Realm list changed, version %u.", _realmListVersion);
+    }
+
     if (_updateInterval)
     {
         _updateTimer->expires_from_now(boost::posix_time::seconds(_updateInterval));
@@ -257,60 +299,84 @@ void RealmList::WriteSubRegions(bgs::protocol::game_utilities::v1::GetAllValuesF
         response->add_attribute_value()->set_string_value(subRegion);
 }
 
-std::vector<uint8> RealmList::GetRealmEntryJSON(Battlenet::RealmHandle const& id, uint32 build) const
+RealmList::CompressedPayload RealmList::GetRealmEntryJSON(Battlenet::RealmHandle const& id, uint32 build) const
+{
+    std::lock_guard<std::recursive_mutex> guard(i_RealmList_lock);
+    Realm const* realm = GetRealm(id);
+    if (!realm || (realm->Flags & REALM_FLAG_OFFLINE) || realm->Build != build)
+        return nullptr;
+
+    CompressedPayload& payload = _realmEntryCache[std::make_pair(realm->Id.GetAddress(), build)];
+    if (!payload)
+        payload = BuildRealmEntryJSON(*realm);
+
+    return payload;
+}
+
+RealmList::CompressedPayload RealmList::GetRealmList(uint32 build, std::string const& subRegion, uint8 Battlegroup) const
 {
-    std::vector<uint8> compressed;
-    if (Realm const* realm = GetRealm(id))
+    std::lock_guard<std::recursive_mutex> guard(i_RealmList_lock);
+
+    auto itr = _realmListCache.find(std::make_tuple(build, subRegion, Battlegroup));
+    if (itr != _realmListCache.end())
+        return itr->second;
+
+    // only keys that match a realm are cached, anything a client makes up gets the shared empty list
+    bool hasRealms = std::any_of(_realms.begin(), _realms.end(), [&](RealmMap::value_type const& realm)
     {
-        if (!(realm->Flags & REALM_FLAG_OFFLINE) && realm->Build == build)
-        {
-            JSON::RealmList::RealmEntry realmEntry;
-            realmEntry.set_wowrealmaddress(realm->Id.GetAddress());
-            realmEntry.set_cfgtimezonesid(1);
-            realmEntry.set_populationstate(std::max(uint32(realm->PopulationLevel), 1u));
-            realmEntry.set_cfgcategoriesid(realm->Timezone);
-
-            JSON::RealmList::ClientVersion* version = realmEntry.mutable_version();
-            if (RealmBuildInfo const* buildInfo = GetBuildInfo(realm->Build))
-            {
-                version->set_versionmajor(buildInfo->MajorVersion);
-                version->set_versionminor(buildInfo->MinorVersion);
-                version->set_versionrevision(buildInfo->BugfixVersion);
-                version->set_versionbuild(buildInfo->Build);
-            }
-            else
-            {
-                version->set_versionmajor(7);
-                version->set_versionminor(0);
-                version->set_versionrevision(3);
-                version->set_versionbuild(realm->Build);
-            }
+        return realm.second.Id.GetSubRegionAddress() == subRegion && realm.second.Build == build && realm.second.Id.Site == Battlegroup;
+    });
 
-            realmEntry.set_cfgrealmsid(realm->Id.Realm);
-            realmEntry.set_flags(realm->Flags);
-            realmEntry.set_name(realm->Name);
-            realmEntry.set_cfgconfigsid(realm->GetConfigId());
-            realmEntry.set_cfglanguagesid(1);
+    if (!hasRealms)
+    {
+        if (!_emptyRealmList)
+            _emptyRealmList = BuildRealmList(build, subRegion, Battlegroup);
 
-            std::string json = "JamJSONRealmEntry:" + JSON::Serialize(realmEntry);
+        return _emptyRealmList;
+    }
 
-            uLong compressedLength = compressBound(json.length());
-            compressed.resize(compressedLength + 4);
-            *reinterpret_cast<uint32*>(compressed.data()) = json.length() + 1;
+    CompressedPayload payload = BuildRealmList(build, subRegion, Battlegroup);
+    if (payload)
+        _realmListCache[std::make_tuple(build, subRegion, Battlegroup)] = payload;
 
-            if (compress(compressed.data() + 4, &compressedLength, reinterpret_cast<uint8 const*>(json.c_str()), json.length() + 1) == Z_OK)
-                compressed.resize(compressedLength + 4);
-            else
-                compressed.clear();
-        }
+    return payload;
+}
+
+RealmList::CompressedPayload RealmList::BuildRealmEntryJSON(Realm const& realm) const
+{
+    JSON::RealmList::RealmEntry realmEntry;
+    realmEntry.set_wowrealmaddress(realm.Id.GetAddress());
+    realmEntry.set_cfgtimezonesid(1);
+    realmEntry.set_populationstate(std::max(uint32(realm.PopulationLevel), 1u));
+    realmEntry.set_cfgcategoriesid(realm.Timezone);
+
+    JSON::RealmList::ClientVersion* version = realmEntry.mutable_version();
+    if (RealmBuildInfo const* buildInfo = GetBuildInfo(realm.Build))
+    {
+        version->set_versionmajor(buildInfo->MajorVersion);
+        version->set_versionminor(buildInfo->MinorVersion);
+        version->set_versionrevision(buildInfo->BugfixVersion);
+        version->set_versionbuild(buildInfo->Build);
+    }
+    else
+    {
+        version->set_versionmajor(7);
+        version->set_versionminor(0);
+        version->set_versionrevision(3);
+        version->set_versionbuild(realm.Build);
     }
 
-    return compressed;
+    realmEntry.set_cfgrealmsid(realm.Id.Realm);
+    realmEntry.set_flags(realm.Flags);
+    realmEntry.set_name(realm.Name);
+    realmEntry.set_cfgconfigsid(realm.GetConfigId());
+    realmEntry.set_cfglanguagesid(1);
+
+    return CompressJSON("JamJSONRealmEntry:" + JSON::Serialize(realmEntry));
 }
 
-std::vector<uint8> RealmList::GetRealmList(uint32 build, std::string const& subRegion, uint8 Battlegroup) const
+RealmList::CompressedPayload RealmList::BuildRealmList(uint32 build, std::string const& subRegion, uint8 Battlegroup) const
 {
-    std::lock_guard<std::recursive_mutex> guard(i_RealmList_lock);
     JSON::RealmList::RealmListUpdates realmList;
     for (auto const& realm : _realms)
     {
@@ -354,18 +420,7 @@ std::vector<uint8> RealmList::GetRealmList(uint32 build, std::string const& subR
         state->set_deleting(false);
     }
 
-    std::string json = "JSONRealmListUpdates:" + JSON::Serialize(realmList);
-
-    uLong compressedLength = compressBound(json.length());
-    std::vector<uint8> compressed;
-    compressed.resize(4 + compressedLength);
-    *reinterpret_cast<uint32*>(compressed.data()) = json.length() + 1;
-
-    compress(compressed.data() + 4, &compressedLength, reinterpret_cast<uint8 const*>(json.c_str()), json.length() + 1);
-
-    compressed.resize(compressedLength + 4);
-
-    return compressed;
+    return CompressJSON("JSONRealmListUpdates:" + JSON::Serialize(realmList));
 }
 
 uint32 RealmList::JoinRealm(uint32 realmAddress, uint32 /*build*/, boost::asio::ip::address const& clientAddress, std::array<uint8, 32> const& clientSecret, LocaleConstant locale, std::string const& os, std::string accountName, bgs::protocol::game_utilities::v1::ClientResponse* response) const
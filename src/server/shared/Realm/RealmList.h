@@ -23,6 +23,8 @@
 #include "Realm.h"
 #include <map>
 #include <array>
+#include <memory>
+#include <tuple>
 #include <vector>
 #include <unordered_set>
 #include <boost/asio.hpp>
@@ -81,6 +83,8 @@ class RealmList
 public:
     typedef std::map<Battlenet::RealmHandle, Realm> RealmMap;
     typedef std::map<uint32, boost::asio::ip::address> RealmIPMap;
+    /// Compressed JSON blob sent to clients, shared between all sessions until the realm list changes
+    typedef std::shared_ptr<std::vector<uint8> const> CompressedPayload;
 
     static RealmList* Instance();
 
@@ -96,8 +100,9 @@ public:
     uint32 GetMinorMajorBugfixVersionForBuild(uint32 build) const;
     std::unordered_set<std::string> const& GetSubRegions() const { return _subRegions; }
     void WriteSubRegions(bgs::protocol::game_utilities::v1::GetAllValuesForAttributeResponse* response) const;
-    std::vector<uint8> GetRealmEntryJSON(Battlenet::RealmHandle const& id, uint32 build) const;
-    std::vector<uint8> GetRealmList(uint32 build, std::string const& subRegion, uint8 Battlegroup) const;
+    CompressedPayload GetRealmEntryJSON(Battlenet::RealmHandle const& id, uint32 build) const;
+    CompressedPayload GetRealmList(uint32 build, std::string const& subRegion, uint8 Battlegroup) const;
+    uint32 GetRealmListVersion() const { return _realmListVersion; }
     boost::asio::ip::address GetAddressForClient(uint32 RealmID);
     uint32 JoinRealm(uint32 realmAddress, uint32 build, boost::asio::ip::address const& clientAddress, std::array<uint8, 32> const& clientSecret, LocaleConstant locale, std::string const& os, std::string accountName, bgs::protocol::game_utilities::v1::ClientResponse* response) const;
 
@@ -107,6 +112,8 @@ private:
     void LoadBuildInfo();
     void UpdateRealms(boost::system::error_code const& error);
     void UpdateRealm(Battlenet::RealmHandle const& id, uint32 build, std::string const& name, boost::asio::ip::address const& address, boost::asio::ip::address const& localAddr, boost::asio::ip::address const& localSubmask, uint16 port, uint8 icon, RealmFlags flag, uint8 timezone, AccountTypes allowedSecurityLevel, float population);
+    CompressedPayload BuildRealmEntryJSON(Realm const& realm) const;
+    CompressedPayload BuildRealmList(uint32 build, std::string const& subRegion, uint8 Battlegroup) const;
 
     std::vector<RealmBuildInfo> _builds;
     RealmMap _realms;
@@ -115,6 +122,12 @@ private:
     uint32 _updateInterval;
     std::unique_ptr<boost::asio::deadline_timer> _updateTimer;
     std::unique_ptr<boost::asio::ip::tcp_resolver> _resolver;
+
+    // payloads are built on first request and dropped only when UpdateRealms sees a change clients can observe
+    uint32 _realmListVersion;
+    mutable std::map<std::tuple<uint32, std::string, uint8>, CompressedPayload> _realmListCache;
+    mutable std::map<std::pair<uint32, uint32>, CompressedPayload> _realmEntryCache;
+    mutable CompressedPayload _emptyRealmList;
     mutable std::recursive_mutex i_RealmList_lock;
 };
 
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Replays movement captures (Anticheat.Capture.Enable) through the anticheat movement checks
+// and reports the cost of every detector group and what they detected.
+
+#include "AnticheatMovementChecks.h"
+#include "Banner.h"
+#include "GridDefines.h"
+#include "MovementCapture.h"
+#include "VMapManager2.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /// Ground height and LOS from vmaps, tiles are loaded the first time a packet needs them.
+    /// worldserver also uses the .map height grids, those live in the game library, so heights can differ where no vmap model is present.
+    class VMapTerrain : public AnticheatTerrain
+    {
+        public:
+            explicit VMapTerrain(std::string const& vmapPath) : _vmapPath(vmapPath), _mapId(0) { }
+
+            void SetMap(uint32 mapId) { _mapId = mapId; }
+
+            float GetHeight(float x, float y, float z) const override
+            {
+                EnsureTileLoaded(x, y);
+                return _manager.getHeight(_mapId, x, y, z + 2.0f, 250.0f);
+            }
+
+            bool IsInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2) const override
+            {
+                EnsureTileLoaded(x1, y1);
+                EnsureTileLoaded(x2, y2);
+                return _manager.isInLineOfSight(_mapId, x1, y1, z1, x2, y2, z2);
+            }
+
+            uint32 GetLoadedTileCount() const { return uint32(_loadedTiles.size()); }
+
+        private:
+            void EnsureTileLoaded(float x, float y) const
+            {
+                GridCoord grid = Trinity::ComputeGridCoord(x, y);
+                int gx = (MAX_NUMBER_OF_GRIDS - 1) - grid.x_coord;
+                int gy = (MAX_NUMBER_OF_GRIDS - 1) - grid.y_coord;
+                uint64 key = (uint64(_mapId) << 16) | (gx << 8) | gy;
+                if (_loadedTiles.insert(key).second)
+                    _manager.loadMap(_vmapPath.c_str(), _mapId, gx, gy);
+            }
+
+            mutable VMAP::VMapManager2 _manager;
+            mutable std::set<uint64> _loadedTiles;
+            std::string _vmapPath;
+            uint32 _mapId;
+    };
+
+    struct ReplayStats
+    {
+        uint64 Packets = 0;
+        uint64 Rejected = 0;
+        uint64 FarTeleports = 0;
+        uint64 Detections[CHEATS_COUNT] = { };
+    };
+
+    void Replay(MovementCaptureReader const& capture, AnticheatCheckConfig const& config, VMapTerrain* terrain, ReplayStats& stats)
+    {
+        AnticheatMovementChecks checks;
+        checks.Init();
+
+        MovementSample last = MovementSample();
+        for (MovementCaptureRecord const& record : capture.GetRecords())
+        {
+            switch (record.Type)
+            {
+                case CAPTURE_RECORD_MOVEMENT:
+                {
+                    if (terrain)
+                        terrain->SetMap(record.MapId);
+
+                    AnticheatMovementContext context;
+                    context.Opcode = record.Opcode;
+                    context.MapId = record.MapId;
+                    context.State = record.State;
+                    context.Last = &last;
+                    context.Current = &record.Sample;
+                    context.Terrain = terrain;
+
+                    AnticheatMovementResult result;
+                    checks.Check(context, config, result);
+
+                    ++stats.Packets;
+                    if (!result.Accepted)
+                    {
+                        ++stats.Rejected;
+                        break;
+                    }
+
+                    // worldserver drops detections of game masters
+                    if (!(record.State & MOVER_STATE_GAMEMASTER))
+                    {
+                        uint32 cheats = result.Cheats | result.FlagCheats;
+                        for (uint32 i = 0; i < CHEATS_COUNT; ++i)
+                            if (cheats & (1 << i))
+                                ++stats.Detections[i];
+                    }
+
+                    // zone exceptions (lifts) are not known offline, count every jump past the limit
+                    if (result.SpeedHack && result.RealDistance2DSq > 20.0f * 20.0f)
+                        ++stats.FarTeleports;
+
+                    last = record.Sample;
+                    break;
+                }
+                case CAPTURE_RECORD_LAST_MOVEMENT:
+                    last = record.Sample;
+                    break;
+                case CAPTURE_RECORD_ORDER_SENT:
+                    checks.OrderSent(record.Opcode, record.ServerTime);
+                    break;
+                case CAPTURE_RECORD_SPEED_ACK:
+                    checks._clientSpeeds[record.MoveType] = record.Speed;
+                    break;
+                case CAPTURE_RECORD_SPEEDS:
+                    memcpy(checks._clientSpeeds, record.Speeds, sizeof(checks._clientSpeeds));
+                    break;
+                case CAPTURE_RECORD_KNOCK_BACK:
+                    checks.OnKnockBack(record.Speed);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    double TimeReplay(std::vector<MovementCaptureReader> const& captures, AnticheatCheckConfig const& config, VMapTerrain* terrain, uint32 iterations, ReplayStats& stats)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < iterations; ++i)
+        {
+            stats = ReplayStats();
+            for (MovementCaptureReader const& capture : captures)
+                Replay(capture, config, terrain, stats);
+        }
+
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+    }
+
+    void PrintUsage(char const* program)
+    {
+        std::cout << "usage: " << program << " [options] <capture file>..." << std::endl
+            << "  -d <data dir>       load <data dir>/vmaps for ground height and line of sight checks" << std::endl
+            << "  -i <iterations>     replay every capture this many times per measure (default 10)" << std::endl
+            << "  -multijump          Anticheat.AntiMultiJump.Enable" << std::endl
+            << "  -speedhack          Anticheat.AntiSpeedHack.Enable" << std::endl
+            << "  -interpolation      Anticheat.AntiSpeedHack.UseInterpolation" << std::endl
+            << "  -maxdesync <ms>     Anticheat.MaxAllowedDesync" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Trinity::Banner::Show("Anticheat replay", [](char const* text) { std::cout << text << std::endl; }, nullptr);
+
+    AnticheatCheckConfig config;
+    std::string dataDir;
+    uint32 iterations = 10;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-d") && i + 1 < argc)
+            dataDir = argv[++i];
+        else if (!strcmp(argv[i], "-i") && i + 1 < argc)
+            iterations = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-multijump"))
+            config.AntiMultiJump = true;
+        else if (!strcmp(argv[i], "-speedhack"))
+            config.AntiSpeedHack = true;
+        else if (!strcmp(argv[i], "-interpolation"))
+            config.Interpolation = true;
+        else if (!strcmp(argv[i], "-maxdesync") && i + 1 < argc)
+            config.MaxAllowedDesync = atoi(argv[++i]);
+        else if (argv[i][0] == '-')
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        else
+            files.push_back(argv[i]);
+    }
+
+    if (files.empty())
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<MovementCaptureReader> captures;
+    for (std::string const& file : files)
+    {
+        captures.emplace_back();
+        if (!captures.back().Load(file))
+        {
+            std::cout << "could not read capture " << file << std::endl;
+            captures.pop_back();
+        }
+    }
+
+    if (captures.empty())
+        return 1;
+
+    std::unique_ptr<VMapTerrain> terrain;
+    if (!dataDir.empty())
+        terrain.reset(new VMapTerrain(dataDir + "/vmaps"));
+
+    // first pass loads the terrain tiles, keep it out of the measures
+    ReplayStats total;
+    TimeReplay(captures, config, terrain.get(), 1, total);
+
+    std::cout << captures.size() << " capture(s), " << total.Packets << " movement packets, " << total.Rejected << " rejected (server controlled movement)";
+    if (terrain)
+        std::cout << ", " << terrain->GetLoadedTileCount() << " vmap tiles";
+    std::cout << std::endl << std::endl;
+
+    if (!total.Packets)
+        return 0;
+
+    ReplayStats stats;
+    AnticheatCheckConfig detectorConfig = config;
+    detectorConfig.Detectors = 0;
+    double const baseline = TimeReplay(captures, detectorConfig, terrain.get(), iterations, stats);
+
+    printf("%-14s %12s %14s\n", "Detector", "ns/packet", "packets/s");
+    printf("%-14s %12.1f %14.0f\n", "(dispatch)", baseline / total.Packets, total.Packets * 1e9 / baseline);
+    for (uint32 detector = 0; detector < ANTICHEAT_DETECTOR_COUNT; ++detector)
+    {
+        detectorConfig.Detectors = 1 << detector;
+        double const elapsed = std::max(TimeReplay(captures, detectorConfig, terrain.get(), iterations, stats) - baseline, 0.0);
+        printf("%-14s %12.1f %14.0f\n", GetAnticheatDetectorName(AnticheatDetector(detector)), elapsed / total.Packets, elapsed > 0.0 ? total.Packets * 1e9 / elapsed : 0.0);
+    }
+
+    double const all = TimeReplay(captures, config, terrain.get(), iterations, stats);
+    printf("%-14s %12.1f %14.0f\n\n", "All", all / total.Packets, total.Packets * 1e9 / all);
+
+    printf("%-22s %10s %10s\n", "Detection", "packets", "per 10k");
+    for (uint32 i = 0; i < CHEATS_COUNT; ++i)
+        if (stats.Detections[i])
+            printf("%-22s %10llu %10.2f\n", GetCheatTypeNameFromFlag(CheatType(i)), (unsigned long long)stats.Detections[i], stats.Detections[i] * 10000.0 / stats.Packets);
+    printf("%-22s %10llu %10.2f\n", "FarTeleport (kick)", (unsigned long long)stats.FarTeleports, stats.FarTeleports * 10000.0 / stats.Packets);
+
+    return 0;
+}
@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Mixes gameobject model moves with line of sight, hit position and height queries on the
+// DynamicMapTree grid and compares the previous layout (BIH rebuilt after every change) with the refitted BVH.
+
+#include "Banner.h"
+#include "Define.h"
+#include "BoundingIntervalHierarchyWrapper.h"
+#include "DynamicBoundingVolumeHierarchy.h"
+#include "RegularGrid.h"
+#include <G3D/AABox.h>
+#include <G3D/Ray.h>
+#include <G3D/Vector3.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    struct BenchConfig
+    {
+        uint32 Objects = 2000;
+        uint32 Movers = 50;         // transports and other models moving every tick
+        uint32 Rays = 500;          // line of sight, hit position and height queries per tick
+        uint32 Ticks = 1000;
+        float Speed = 0.5f;         // yards per tick, a transport at 10 yd/s with 50 ms map updates
+        float Extent = 800.0f;      // side of the populated square, spans several grid cells
+        uint32 Seed = 1;
+    };
+
+    struct BenchModel
+    {
+        G3D::AABox Bounds;
+        G3D::Vector3 Velocity;
+
+        bool IntersectRay(G3D::Ray const& ray, float& maxDist) const
+        {
+            // slab test, the bounds stand in for the model triangles
+            G3D::Vector3 const& org = ray.origin();
+            G3D::Vector3 const& dir = ray.direction();
+            float tNear = 0.0f, tFar = maxDist;
+            for (int i = 0; i < 3; ++i)
+            {
+                float invDir = 1.0f / dir[i];
+                float t1 = (Bounds.low()[i] - org[i]) * invDir;
+                float t2 = (Bounds.high()[i] - org[i]) * invDir;
+                if (t1 > t2)
+                    std::swap(t1, t2);
+                tNear = std::max(tNear, t1);
+                tFar = std::min(tFar, t2);
+                if (tNear > tFar)
+                    return false;
+            }
+
+            maxDist = tNear;
+            return true;
+        }
+    };
+
+    struct BenchRayCallback
+    {
+        bool Hit = false;
+
+        bool operator()(G3D::Ray const& ray, BenchModel const& model, float& maxDist)
+        {
+            if (!model.IntersectRay(ray, maxDist))
+                return false;
+
+            Hit = true;
+            return true;
+        }
+    };
+
+    float const HeightSearchDistance = 50.0f;
+
+    struct BenchAnswer
+    {
+        bool InLineOfSight;
+        float HitDistance;          // closest model along the ray, the ray length when nothing is hit
+        float Height;               // highest model below the ray end, -inf when there is none
+    };
+
+    struct BenchResult
+    {
+        double UpdateMs = 0.0;
+        double QueryMs = 0.0;
+        uint32 Hits = 0;
+        std::vector<BenchAnswer> Answers;
+    };
+
+    typedef std::chrono::steady_clock Clock;
+
+    double ElapsedMs(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+}
+
+template<> struct BoundsTrait<BenchModel>
+{
+    static void getBounds(BenchModel const& model, G3D::AABox& out) { out = model.Bounds; }
+    static void getBounds2(BenchModel const* model, G3D::AABox& out) { out = model->Bounds; }
+};
+
+template<> struct PositionTrait<BenchModel>
+{
+    static void getPosition(BenchModel const& model, G3D::Vector3& p) { p = model.Bounds.center(); }
+};
+
+template<> struct HashTrait<BenchModel>
+{
+    static size_t hashCode(BenchModel const& model) { return (size_t)(void*)&model; }
+};
+
+namespace
+{
+    std::vector<BenchModel> CreateScene(BenchConfig const& config)
+    {
+        std::mt19937 rng(config.Seed);
+        std::uniform_real_distribution<float> position(-config.Extent / 2, config.Extent / 2);
+        std::uniform_real_distribution<float> size(1.0f, 12.0f);
+        std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+
+        std::vector<BenchModel> models(config.Objects);
+        for (uint32 i = 0; i < config.Objects; ++i)
+        {
+            G3D::Vector3 low(position(rng), position(rng), size(rng) - 6.0f);
+            G3D::Vector3 extent(size(rng), size(rng), size(rng));
+            models[i].Bounds = G3D::AABox(low, low + extent);
+            if (i < config.Movers)
+                models[i].Velocity = G3D::Vector3(direction(rng), direction(rng), 0.0f).directionOrZero() * config.Speed;
+        }
+
+        return models;
+    }
+
+    std::vector<std::pair<G3D::Vector3, G3D::Vector3>> CreateRays(BenchConfig const& config, uint32 tick)
+    {
+        std::mt19937 rng(config.Seed * 7919 + tick);
+        std::uniform_real_distribution<float> position(-config.Extent / 2, config.Extent / 2);
+        std::uniform_real_distribution<float> offset(-40.0f, 40.0f);
+        std::uniform_real_distribution<float> height(0.0f, 10.0f);
+
+        std::vector<std::pair<G3D::Vector3, G3D::Vector3>> rays(config.Rays);
+        for (auto& ray : rays)
+        {
+            ray.first = G3D::Vector3(position(rng), position(rng), height(rng));
+            ray.second = ray.first + G3D::Vector3(offset(rng), offset(rng), height(rng) - 5.0f);
+        }
+
+        return rays;
+    }
+
+    void MoveModel(BenchModel& model, uint32 tick)
+    {
+        // movers turn around every 200 ticks so they stay inside the scene
+        G3D::Vector3 step = (tick / 200) % 2 ? -model.Velocity : model.Velocity;
+        model.Bounds = G3D::AABox(model.Bounds.low() + step, model.Bounds.high() + step);
+    }
+
+    template<class Tree, class Move>
+    BenchResult Run(BenchConfig const& config, Move&& move)
+    {
+        BenchResult result;
+        result.Answers.reserve(size_t(config.Ticks) * config.Rays);
+
+        std::vector<BenchModel> models = CreateScene(config);
+        Tree tree;
+        for (BenchModel const& model : models)
+            tree.insert(model);
+        tree.balance();
+
+        for (uint32 tick = 0; tick < config.Ticks; ++tick)
+        {
+            Clock::time_point start = Clock::now();
+            for (uint32 i = 0; i < config.Movers && i < models.size(); ++i)
+                move(tree, models[i], tick);
+            result.UpdateMs += ElapsedMs(start);
+
+            std::vector<std::pair<G3D::Vector3, G3D::Vector3>> rays = CreateRays(config, tick);
+            start = Clock::now();
+            for (auto const& ray : rays)
+            {
+                // same queries as DynamicMapTree::isInLineOfSight, getObjectHitPos and getHeight
+                float length = (ray.second - ray.first).magnitude();
+                G3D::Ray r = G3D::Ray::fromOriginAndDirection(ray.first, (ray.second - ray.first) / length);
+                BenchAnswer answer;
+
+                float maxDist = length;
+                BenchRayCallback sight;
+                tree.intersectRay(r, sight, maxDist, ray.second, true);
+                answer.InLineOfSight = !sight.Hit;
+
+                answer.HitDistance = length;
+                BenchRayCallback hit;
+                tree.intersectRay(r, hit, answer.HitDistance, ray.second);
+
+                G3D::Vector3 top(ray.second.x, ray.second.y, ray.second.z + 0.5f);
+                float searchDist = HeightSearchDistance;
+                BenchRayCallback height;
+                tree.intersectZAllignedRay(G3D::Ray::fromOriginAndDirection(top, G3D::Vector3(0.0f, 0.0f, -1.0f)), height, searchDist);
+                answer.Height = height.Hit ? top.z - searchDist : -G3D::finf();
+
+                result.Answers.push_back(answer);
+                if (sight.Hit)
+                    ++result.Hits;
+            }
+            result.QueryMs += ElapsedMs(start);
+        }
+
+        return result;
+    }
+
+    void PrintUsage(char const* program)
+    {
+        std::cout << "usage: " << program << " [options]" << std::endl
+            << "  -n <objects>        gameobject models in the scene (default 2000)" << std::endl
+            << "  -m <movers>         models moving every tick (default 50)" << std::endl
+            << "  -r <rays>           rays per tick, each one queried three ways (default 500)" << std::endl
+            << "  -t <ticks>          map updates to simulate (default 1000)" << std::endl
+            << "  -v <speed>          yards a mover travels per tick (default 0.5)" << std::endl
+            << "  -s <seed>           scene seed (default 1)" << std::endl;
+    }
+
+    void PrintResult(char const* name, BenchConfig const& config, BenchResult const& result)
+    {
+        double updates = double(config.Movers) * config.Ticks;
+        double rays = 3.0 * config.Rays * config.Ticks;
+        printf("%-10s %12.0f %12.0f %10.3f %10.3f %8u\n", name,
+            result.UpdateMs > 0.0 ? updates / result.UpdateMs * 1000.0 : 0.0,
+            result.QueryMs > 0.0 ? rays / result.QueryMs * 1000.0 : 0.0,
+            (result.UpdateMs + result.QueryMs) / config.Ticks,
+            result.UpdateMs / config.Ticks, result.Hits);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Trinity::Banner::Show("Dynamic tree benchmark", [](char const* text) { std::cout << text << std::endl; }, nullptr);
+
+    BenchConfig config;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            config.Objects = uint32(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-m") && i + 1 < argc)
+            config.Movers = uint32(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc)
+            config.Rays = uint32(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+            config.Ticks = uint32(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-v") && i + 1 < argc)
+            config.Speed = float(atof(argv[++i]));
+        else if (!strcmp(argv[i], "-s") && i + 1 < argc)
+            config.Seed = uint32(atoi(argv[++i]));
+        else
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!config.Objects || !config.Ticks)
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    printf("%u models, %u moving %.2f yd per tick, %u rays per tick, %u ticks\n\n", config.Objects, config.Movers, config.Speed, config.Rays, config.Ticks);
+
+    typedef RegularGrid2D<BenchModel, BIHWrap<BenchModel> > RebuildTree;
+    typedef RegularGrid2D<BenchModel, DynamicBVH<BenchModel> > RefitTree;
+
+    // every move dirties the cell, its BIH is rebuilt by the next ray through it
+    BenchResult rebuild = Run<RebuildTree>(config, [](RebuildTree& tree, BenchModel& model, uint32 tick)
+    {
+        tree.remove(model);
+        MoveModel(model, tick);
+        tree.insert(model);
+    });
+
+    BenchResult refit = Run<RefitTree>(config, [](RefitTree& tree, BenchModel& model, uint32 tick)
+    {
+        MoveModel(model, tick);
+        tree.update(model);
+    });
+
+    // both trees run the same slab test on the same models, the closest hits must match exactly
+    uint32 mismatches = 0;
+    for (std::size_t i = 0; i < rebuild.Answers.size() && i < refit.Answers.size(); ++i)
+    {
+        BenchAnswer const& a = rebuild.Answers[i];
+        BenchAnswer const& b = refit.Answers[i];
+        if (a.InLineOfSight != b.InLineOfSight || a.HitDistance != b.HitDistance || a.Height != b.Height)
+            ++mismatches;
+    }
+
+    printf("%-10s %12s %12s %10s %10s %8s\n", "tree", "updates/s", "queries/s", "ms/tick", "upd ms", "hits");
+    PrintResult("rebuild", config, rebuild);
+    PrintResult("refit", config, refit);
+    printf("\n%u mismatching answers (line of sight, hit distance or height)\n", mismatches);
+    return mismatches ? 2 : 0;
+}
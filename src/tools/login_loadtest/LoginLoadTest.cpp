@@ -0,0 +1,406 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Drives the bnetserver REST login (LoginREST.Port) with concurrent launcher-like clients
+// and reports logins per second and login latency.
+
+#include "Banner.h"
+#include "Define.h"
+#include <boost/asio/buffers_iterator.hpp>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using boost::asio::ip::tcp;
+
+namespace
+{
+    struct LoadTestConfig
+    {
+        std::string Host = "127.0.0.1";
+        std::string Port = "8081";
+        std::string Account = "TEST@TEST";
+        std::string Password = "TEST";
+        uint32 Connections = 100;
+        uint32 Logins = 10000;
+        uint32 Threads = 1;
+        bool Reconnect = false;     // new connection (and TLS handshake) for every login, like a launcher reconnect storm
+        bool FetchForm = false;     // GET the login form before posting it, like the launcher does
+    };
+
+    struct LoadTestStats
+    {
+        std::atomic<uint32> Remaining{ 0 };
+        std::atomic<uint32> Succeeded{ 0 };
+        std::atomic<uint32> Rejected{ 0 };     // answered without a ticket (wrong credentials)
+        std::atomic<uint32> Busy{ 0 };         // 503, LoginREST.MaxPendingLogins reached
+        std::atomic<uint32> Failed{ 0 };       // connection, handshake or protocol errors
+        std::atomic<uint32> Handshakes{ 0 };
+
+        std::mutex LatencyLock;
+        std::vector<double> Latencies;         // ms, POST sent to response read
+    };
+
+    class LoginClient : public std::enable_shared_from_this<LoginClient>
+    {
+    public:
+        LoginClient(boost::asio::io_context& ioContext, boost::asio::ssl::context& sslContext, tcp::resolver::results_type const& endpoints,
+            LoadTestConfig const& config, LoadTestStats& stats)
+            : _ioContext(ioContext), _sslContext(sslContext), _endpoints(endpoints), _config(config), _stats(stats), _statusCode(0)
+        {
+        }
+
+        void Start()
+        {
+            if (!TakeLogin())
+                return;
+
+            Connect();
+        }
+
+    private:
+        typedef boost::asio::ssl::stream<tcp::socket> SslStream;
+
+        bool TakeLogin()
+        {
+            uint32 remaining = _stats.Remaining.load();
+            while (remaining)
+                if (_stats.Remaining.compare_exchange_weak(remaining, remaining - 1))
+                    return true;
+
+            return false;
+        }
+
+        void Connect()
+        {
+            _stream.reset(new SslStream(_ioContext, _sslContext));
+            _buffer.consume(_buffer.size());
+
+            std::shared_ptr<LoginClient> self = shared_from_this();
+            boost::asio::async_connect(_stream->lowest_layer(), _endpoints, [self](boost::system::error_code const& error, tcp::endpoint const&)
+            {
+                if (error)
+                    return self->Fail();
+
+                boost::system::error_code ignored;
+                self->_stream->lowest_layer().set_option(tcp::no_delay(true), ignored);
+                self->_stream->async_handshake(boost::asio::ssl::stream_base::client, [self](boost::system::error_code const& error)
+                {
+                    if (error)
+                        return self->Fail();
+
+                    ++self->_stats.Handshakes;
+                    if (self->_config.FetchForm)
+                        self->SendForm();
+                    else
+                        self->SendLogin();
+                });
+            });
+        }
+
+        void SendForm()
+        {
+            _request = "GET /bnetserver/login/ HTTP/1.1\r\n"
+                "Host: " + _config.Host + "\r\n"
+                "Connection: keep-alive\r\n"
+                "\r\n";
+
+            std::shared_ptr<LoginClient> self = shared_from_this();
+            SendRequest([self]()
+            {
+                if (self->_statusCode != 200)
+                    return self->Fail();
+
+                // LoginREST.MaxKeepAliveRequests reached, post the form on a new connection
+                if (!self->_keepAlive)
+                {
+                    self->Close();
+                    self->Connect();
+                    return;
+                }
+
+                self->SendLogin();
+            });
+        }
+
+        void SendLogin()
+        {
+            std::string body = "{\"platform_id\":\"Win\",\"program_id\":\"WoW\",\"version\":\"7.3.5\",\"inputs\":["
+                "{\"input_id\":\"account_name\",\"value\":\"" + _config.Account + "\"},"
+                "{\"input_id\":\"password\",\"value\":\"" + _config.Password + "\"}]}";
+
+            _request = "POST /bnetserver/login/ HTTP/1.1\r\n"
+                "Host: " + _config.Host + "\r\n"
+                "Content-Type: application/json;charset=utf-8\r\n"
+                "Content-Length: " + std::to_string(body.length()) + "\r\n"
+                "Connection: " + (_config.Reconnect ? "close" : "keep-alive") + "\r\n"
+                "\r\n" + body;
+
+            _sent = std::chrono::steady_clock::now();
+
+            std::shared_ptr<LoginClient> self = shared_from_this();
+            SendRequest([self]()
+            {
+                double latency = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - self->_sent).count();
+                {
+                    std::lock_guard<std::mutex> lock(self->_stats.LatencyLock);
+                    self->_stats.Latencies.push_back(latency);
+                }
+
+                if (self->_statusCode == 503)
+                    ++self->_stats.Busy;
+                else if (self->_statusCode != 200)
+                    return self->Fail();
+                else if (self->_body.find("\"login_ticket\"") != std::string::npos)
+                    ++self->_stats.Succeeded;
+                else
+                    ++self->_stats.Rejected;
+
+                self->Next();
+            });
+        }
+
+        void Next()
+        {
+            if (!TakeLogin())
+            {
+                Close();
+                return;
+            }
+
+            if (_config.Reconnect || !_keepAlive)
+            {
+                Close();
+                Connect();
+            }
+            else if (_config.FetchForm)
+                SendForm();
+            else
+                SendLogin();
+        }
+
+        template<typename Callback>
+        void SendRequest(Callback&& onResponse)
+        {
+            std::shared_ptr<LoginClient> self = shared_from_this();
+            boost::asio::async_write(*_stream, boost::asio::buffer(_request), [self, onResponse](boost::system::error_code const& error, std::size_t)
+            {
+                if (error)
+                    return self->Fail();
+
+                boost::asio::async_read_until(*self->_stream, self->_buffer, "\r\n\r\n", [self, onResponse](boost::system::error_code const& error, std::size_t headerSize)
+                {
+                    if (error)
+                        return self->Fail();
+
+                    std::size_t contentLength = 0;
+                    if (!self->ParseHeader(headerSize, contentLength))
+                        return self->Fail();
+
+                    std::size_t buffered = self->_buffer.size();
+                    std::size_t missing = buffered < contentLength ? contentLength - buffered : 0;
+                    boost::asio::async_read(*self->_stream, self->_buffer, boost::asio::transfer_exactly(missing), [self, onResponse, contentLength](boost::system::error_code const& error, std::size_t)
+                    {
+                        if (error)
+                            return self->Fail();
+
+                        self->_body.assign(boost::asio::buffers_begin(self->_buffer.data()), boost::asio::buffers_begin(self->_buffer.data()) + contentLength);
+                        self->_buffer.consume(contentLength);
+                        onResponse();
+                    });
+                });
+            });
+        }
+
+        bool ParseHeader(std::size_t headerSize, std::size_t& contentLength)
+        {
+            std::string header(boost::asio::buffers_begin(_buffer.data()), boost::asio::buffers_begin(_buffer.data()) + headerSize);
+            _buffer.consume(headerSize);
+
+            // HTTP/1.1 200 OK
+            if (header.compare(0, 9, "HTTP/1.1 ") != 0)
+                return false;
+
+            _statusCode = uint32(atoi(header.c_str() + 9));
+            _keepAlive = header.find("Connection: close") == std::string::npos;
+
+            std::string::size_type lengthPos = header.find("Content-Length: ");
+            contentLength = lengthPos != std::string::npos ? std::strtoul(header.c_str() + lengthPos + 16, nullptr, 10) : 0;
+            return true;
+        }
+
+        void Fail()
+        {
+            ++_stats.Failed;
+            Close();
+
+            // keep the configured concurrency, the failed login is not retried
+            if (TakeLogin())
+                Connect();
+        }
+
+        void Close()
+        {
+            if (!_stream)
+                return;
+
+            boost::system::error_code ignored;
+            _stream->lowest_layer().shutdown(tcp::socket::shutdown_both, ignored);
+            _stream->lowest_layer().close(ignored);
+        }
+
+        boost::asio::io_context& _ioContext;
+        boost::asio::ssl::context& _sslContext;
+        tcp::resolver::results_type _endpoints;
+        LoadTestConfig const& _config;
+        LoadTestStats& _stats;
+
+        std::unique_ptr<SslStream> _stream;
+        boost::asio::streambuf _buffer;
+        std::string _request;
+        std::string _body;
+        uint32 _statusCode;
+        bool _keepAlive = true;
+        std::chrono::steady_clock::time_point _sent;
+    };
+
+    double Percentile(std::vector<double> const& sorted, double percentile)
+    {
+        if (sorted.empty())
+            return 0.0;
+
+        std::size_t index = std::min(sorted.size() - 1, std::size_t(sorted.size() * percentile / 100.0));
+        return sorted[index];
+    }
+
+    void PrintUsage(char const* program)
+    {
+        std::cout << "usage: " << program << " [options]" << std::endl
+            << "  -h <host>           bnetserver address (default 127.0.0.1)" << std::endl
+            << "  -p <port>           LoginREST.Port (default 8081)" << std::endl
+            << "  -u <account>        account e-mail (default TEST@TEST)" << std::endl
+            << "  -w <password>       account password (default TEST)" << std::endl
+            << "  -c <connections>    concurrent clients (default 100)" << std::endl
+            << "  -n <logins>         total logins (default 10000)" << std::endl
+            << "  -t <threads>        client io threads (default 1)" << std::endl
+            << "  -reconnect          new connection for every login instead of keep-alive" << std::endl
+            << "  -form               fetch the login form before every login" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Trinity::Banner::Show("Login load test", [](char const* text) { std::cout << text << std::endl; }, nullptr);
+
+    LoadTestConfig config;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-h") && i + 1 < argc)
+            config.Host = argv[++i];
+        else if (!strcmp(argv[i], "-p") && i + 1 < argc)
+            config.Port = argv[++i];
+        else if (!strcmp(argv[i], "-u") && i + 1 < argc)
+            config.Account = argv[++i];
+        else if (!strcmp(argv[i], "-w") && i + 1 < argc)
+            config.Password = argv[++i];
+        else if (!strcmp(argv[i], "-c") && i + 1 < argc)
+            config.Connections = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            config.Logins = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+            config.Threads = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-reconnect"))
+            config.Reconnect = true;
+        else if (!strcmp(argv[i], "-form"))
+            config.FetchForm = true;
+        else
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    boost::asio::io_context ioContext;
+
+    // bnetserver uses a self signed certificate
+    boost::asio::ssl::context sslContext(boost::asio::ssl::context::tls_client);
+    sslContext.set_verify_mode(boost::asio::ssl::verify_none);
+
+    boost::system::error_code error;
+    tcp::resolver resolver(ioContext);
+    tcp::resolver::results_type endpoints = resolver.resolve(config.Host, config.Port, error);
+    if (error)
+    {
+        std::cout << "could not resolve " << config.Host << ":" << config.Port << " - " << error.message() << std::endl;
+        return 1;
+    }
+
+    LoadTestStats stats;
+    stats.Remaining = config.Logins;
+    stats.Latencies.reserve(config.Logins);
+
+    std::cout << "Logging in " << config.Logins << " times with " << config.Connections << " clients on " << config.Host << ":" << config.Port
+        << (config.Reconnect ? " (connection per login)" : " (keep-alive)") << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (uint32 i = 0; i < config.Connections; ++i)
+        std::make_shared<LoginClient>(ioContext, sslContext, endpoints, config, stats)->Start();
+
+    std::vector<std::thread> threads;
+    for (uint32 i = 1; i < config.Threads; ++i)
+        threads.emplace_back([&ioContext]() { ioContext.run(); });
+
+    ioContext.run();
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::sort(stats.Latencies.begin(), stats.Latencies.end());
+
+    printf("\n%-22s %10u\n", "Logins (ticket)", stats.Succeeded.load());
+    printf("%-22s %10u\n", "Rejected (no ticket)", stats.Rejected.load());
+    printf("%-22s %10u\n", "Busy (503)", stats.Busy.load());
+    printf("%-22s %10u\n", "Failed", stats.Failed.load());
+    printf("%-22s %10u\n", "TLS handshakes", stats.Handshakes.load());
+    printf("%-22s %10.2f\n", "Elapsed (s)", elapsed);
+    printf("%-22s %10.1f\n", "Logins/s", (stats.Succeeded + stats.Rejected) / elapsed);
+    printf("%-22s %10.2f\n", "Latency p50 (ms)", Percentile(stats.Latencies, 50.0));
+    printf("%-22s %10.2f\n", "Latency p95 (ms)", Percentile(stats.Latencies, 95.0));
+    printf("%-22s %10.2f\n", "Latency p99 (ms)", Percentile(stats.Latencies, 99.0));
+    printf("%-22s %10.2f\n", "Latency max (ms)", stats.Latencies.empty() ? 0.0 : stats.Latencies.back());
+
+    return stats.Failed ? 1 : 0;
+}
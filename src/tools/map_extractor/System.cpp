@@ -29,10 +29,14 @@
 #include <CascLib.h>
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/operations.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <deque>
 #include <fstream>
+#include <mutex>
 #include <set>
+#include <thread>
 #include <unordered_map>
 #include <cstdlib>
 #include <cstring>
@@ -98,6 +102,11 @@ float CONF_flat_liquid_delta_limit = 0.001f; // If max - min less this value - l
 
 uint32 CONF_Locale = 0;
 
+// ADTs converted at the same time, reading from the storage is serialized
+uint32 CONF_Threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+std::mutex CascStorageLock;
+
 #define CASC_LOCALES_COUNT 17
 
 char const* CascLocaleNames[CASC_LOCALES_COUNT] =
@@ -149,6 +158,7 @@ void Usage(char const* prg)
         "-e extract only MAP(1)/DBC(2)/Camera(4)/gt(8) - standard: all(15)\n"\
         "-f height stored as int (less map size but lost some accuracy) 1 by default\n"\
         "-l dbc locale\n"\
+        "-t number of threads converting map tiles - standard: all cores\n"\
         "Example: %s -f 0 -i \"c:\\games\\game\"\n", prg, prg);
     exit(1);
 }
@@ -163,6 +173,7 @@ void HandleArgs(int argc, char* arg[])
         // f - use float to int conversion
         // h - limit minimum height
         // l - dbc locale
+        // t - threads
         if (arg[c][0] != '-')
             Usage(arg[0]);
 
@@ -207,6 +218,12 @@ void HandleArgs(int argc, char* arg[])
                 else
                     Usage(arg[0]);
                 break;
+            case 't':
+                if (c + 1 < argc)                            // all ok
+                    CONF_Threads = std::max(atoi(arg[c++ + 1]), 1);
+                else
+                    Usage(arg[0]);
+                break;
             case 'h':
                 Usage(arg[0]);
                 break;
@@ -441,24 +458,24 @@ float selectUInt16StepStore(float maxDiff)
 {
     return 65535 / maxDiff;
 }
-// Temporary grid data store
-uint16 area_ids[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+// Temporary grid data store, one per worker thread converting ADTs
+thread_local uint16 area_ids[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
 
-float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-float V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
-uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-uint16 uint16_V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
-uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
-uint8  uint8_V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
+thread_local float V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local float V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
+thread_local uint16 uint16_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local uint16 uint16_V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
+thread_local uint8  uint8_V8[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local uint8  uint8_V9[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
 
-uint16 liquid_entry[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
-uint8 liquid_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
-bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];
-float liquid_height[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
-uint8 holes[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID][8];
+thread_local uint16 liquid_entry[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+thread_local uint8 liquid_flags[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
+thread_local bool  liquid_show[ADT_GRID_SIZE][ADT_GRID_SIZE];
+thread_local float liquid_height[ADT_GRID_SIZE+1][ADT_GRID_SIZE+1];
+thread_local uint8 holes[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID][8];
 
-int16 flight_box_max[3][3];
-int16 flight_box_min[3][3];
+thread_local int16 flight_box_max[3][3];
+thread_local int16 flight_box_min[3][3];
 
 LiquidVertexFormatType adt_MH2O::GetLiquidVertexFormat(adt_liquid_instance const* liquidInstance) const
 {
@@ -498,8 +515,11 @@ bool ConvertADT(std::string const& inputPath, std::string const& outputPath, int
 {
     ChunkedFile adt;
 
-    if (!adt.loadFile(CascStorage, inputPath))
-        return false;
+    {
+        std::lock_guard<std::mutex> lock(CascStorageLock);
+        if (!adt.loadFile(CascStorage, inputPath))
+            return false;
+    }
 
     // Prepare map header
     map_fileheader map;
@@ -1070,7 +1090,6 @@ bool IsDeepWaterIgnored(uint32 mapId, uint32 x, uint32 y)
 void ExtractMaps(uint32 build)
 {
     std::string storagePath;
-    std::string outputFileName;
 
     printf("Extracting maps...\n");
 
@@ -1092,6 +1111,15 @@ void ExtractMaps(uint32 build)
         if (!wdt.loadFile(CascStorage, storagePath, false))
             continue;
 
+        struct AdtJob
+        {
+            std::string StoragePath;
+            std::string OutputFileName;
+            uint32 X;
+            uint32 Y;
+        };
+
+        std::vector<AdtJob> jobs;
         FileChunk* chunk = wdt.GetChunk("MAIN");
         for (uint32 y = 0; y < WDT_MAP_SIZE; ++y)
         {
@@ -1100,15 +1128,34 @@ void ExtractMaps(uint32 build)
                 if (!(chunk->As<wdt_MAIN>()->adt_list[y][x].flag & 0x1))
                     continue;
 
-                storagePath = Trinity::StringFormat("World\\Maps\\%s\\%s_%u_%u.adt", map_ids[z].name, map_ids[z].name, x, y);
-                outputFileName =  Trinity::StringFormat("%s/maps/%04u_%02u_%02u.map", output_path.string().c_str(), map_ids[z].id, y, x);
-                bool ignoreDeepWater = IsDeepWaterIgnored(map_ids[z].id, y, x);
-                ConvertADT(storagePath, outputFileName, y, x, build, ignoreDeepWater);
+                jobs.push_back({ Trinity::StringFormat("World\\Maps\\%s\\%s_%u_%u.adt", map_ids[z].name, map_ids[z].name, x, y),
+                    Trinity::StringFormat("%s/maps/%04u_%02u_%02u.map", output_path.string().c_str(), map_ids[z].id, y, x), x, y });
             }
-
-            // draw progress bar
-            printf("Processing........................%d%%\r", (100 * (y+1)) / WDT_MAP_SIZE);
         }
+
+        // tiles are independent, each worker takes the next one until all are converted
+        std::atomic<std::size_t> nextJob(0);
+        std::atomic<std::size_t> doneJobs(0);
+        auto worker = [&]()
+        {
+            for (std::size_t i = nextJob++; i < jobs.size(); i = nextJob++)
+            {
+                AdtJob const& job = jobs[i];
+                bool ignoreDeepWater = IsDeepWaterIgnored(map_ids[z].id, job.Y, job.X);
+                ConvertADT(job.StoragePath, job.OutputFileName, job.Y, job.X, build, ignoreDeepWater);
+
+                // draw progress bar
+                printf("Processing........................%d%%\r", int(100 * ++doneJobs / jobs.size()));
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (uint32 i = 1; i < CONF_Threads && i < jobs.size(); ++i)
+            workers.emplace_back(worker);
+
+        worker();
+        for (std::thread& thread : workers)
+            thread.join();
     }
 
     printf("\n");
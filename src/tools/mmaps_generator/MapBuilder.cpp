@@ -23,17 +23,19 @@
 #include "PathCommon.h"
 #include "StringFormat.h"
 #include "VMapFactory.h"
+#include "VMapDefinitions.h"
 #include "VMapManager2.h"
 #include <DetourCommon.h>
 #include <DetourNavMesh.h>
 #include <DetourNavMeshBuilder.h>
+#include <boost/filesystem/operations.hpp>
 #include <climits>
 
 namespace MMAP
 {
     MapBuilder::MapBuilder(float maxWalkableAngle, bool skipLiquid,
         bool skipContinents, bool skipJunkMaps, bool skipBattlegrounds,
-        bool debugOutput, bool bigBaseUnit, int mapid, const char* offMeshFilePath) :
+        bool debugOutput, bool bigBaseUnit, int mapid, const char* offMeshFilePath, bool incremental) :
         m_terrainBuilder     (NULL),
         m_debugOutput        (debugOutput),
         m_offMeshFilePath    (offMeshFilePath),
@@ -45,6 +47,11 @@ namespace MMAP
         m_mapid              (mapid),
         m_totalTiles         (0u),
         m_totalTilesProcessed(0u),
+        m_incremental        (incremental),
+        m_manifest           ("mmaps/tiles.manifest"),
+        m_tilesBuilt         (0u),
+        m_tilesWritten       (0u),
+        m_tilesSkipped       (0u),
         m_rcContext          (NULL),
         _cancelationToken    (false)
     {
@@ -53,6 +60,12 @@ namespace MMAP
         m_rcContext = new rcContext(false);
 
         discoverTiles();
+
+        if (m_incremental)
+        {
+            m_manifest.load();
+            loadOffMeshInputs();
+        }
     }
 
     /**************************************************************************/
@@ -363,8 +376,19 @@ namespace MMAP
             return;
         }
 
-        buildTile(mapID, tileX, tileY, navMesh);
+        uint64 inputHash = m_incremental ? getTileInputHash(mapID, tileX, tileY) : 0;
+        bool hasTile = buildTile(mapID, tileX, tileY, navMesh);
         dtFreeNavMesh(navMesh);
+
+        ++m_tilesBuilt;
+        if (hasTile)
+            ++m_tilesWritten;
+
+        if (m_incremental)
+        {
+            m_manifest.update(mapID, tileX, tileY, inputHash, hasTile);
+            m_manifest.save();
+        }
     }
 
     /**************************************************************************/
@@ -393,19 +417,34 @@ namespace MMAP
                 // unpack tile coords
                 StaticMapTree::unpackTileID((*it), tileX, tileY);
 
-                if (!shouldSkipTile(mapID, tileX, tileY))
-                    buildTile(mapID, tileX, tileY, navMesh);
+                uint64 inputHash = m_incremental ? getTileInputHash(mapID, tileX, tileY) : 0;
+                if (shouldSkipTile(mapID, tileX, tileY, inputHash))
+                    ++m_tilesSkipped;
+                else
+                {
+                    bool hasTile = buildTile(mapID, tileX, tileY, navMesh);
+                    ++m_tilesBuilt;
+                    if (hasTile)
+                        ++m_tilesWritten;
+
+                    if (m_incremental)
+                        m_manifest.update(mapID, tileX, tileY, inputHash, hasTile);
+                }
                 ++m_totalTilesProcessed;
             }
 
             dtFreeNavMesh(navMesh);
+
+            // saved after every map, an interrupted run only builds the remaining maps again
+            if (m_incremental)
+                m_manifest.save();
         }
 
         printf("[Map %04u] Complete!\n", mapID);
     }
 
     /**************************************************************************/
-    void MapBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh)
+    bool MapBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh)
     {
         printf("%u%% [Map %04i] Building tile [%02u,%02u]\n", percentageDone(m_totalTiles, m_totalTilesProcessed), mapID, tileX, tileY);
 
@@ -419,7 +458,7 @@ namespace MMAP
 
         // if there is no data, give up now
         if (!meshData.solidVerts.size() && !meshData.liquidVerts.size())
-            return;
+            return false;
 
         // remove unused vertices
         TerrainBuilder::cleanVertices(meshData.solidVerts, meshData.solidTris);
@@ -431,7 +470,7 @@ namespace MMAP
         allVerts.append(meshData.solidVerts);
 
         if (!allVerts.size())
-            return;
+            return false;
 
         // get bounds of current tile
         float bmin[3], bmax[3];
@@ -440,7 +479,7 @@ namespace MMAP
         m_terrainBuilder->loadOffMeshConnections(mapID, tileX, tileY, meshData, m_offMeshFilePath);
 
         // build navmesh tile
-        buildMoveMapTile(mapID, tileX, tileY, meshData, bmin, bmax, navMesh);
+        return buildMoveMapTile(mapID, tileX, tileY, meshData, bmin, bmax, navMesh);
     }
 
     /**************************************************************************/
@@ -525,7 +564,7 @@ namespace MMAP
     }
 
     /**************************************************************************/
-    void MapBuilder::buildMoveMapTile(uint32 mapID, uint32 tileX, uint32 tileY,
+    bool MapBuilder::buildMoveMapTile(uint32 mapID, uint32 tileX, uint32 tileY,
         MeshData &meshData, float bmin[3], float bmax[3],
         dtNavMesh* navMesh)
     {
@@ -701,7 +740,7 @@ namespace MMAP
             delete[] pmmerge;
             delete[] dmmerge;
             delete[] tiles;
-            return;
+            return false;
         }
         rcMergePolyMeshes(m_rcContext, pmmerge, nmerge, *iv.polyMesh);
 
@@ -712,7 +751,7 @@ namespace MMAP
             delete[] pmmerge;
             delete[] dmmerge;
             delete[] tiles;
-            return;
+            return false;
         }
         rcMergePolyMeshDetails(m_rcContext, dmmerge, nmerge, *iv.polyMeshDetail);
 
@@ -772,6 +811,7 @@ namespace MMAP
         // will hold final navmesh
         unsigned char* navData = NULL;
         int navDataSize = 0;
+        bool written = false;
 
         do
         {
@@ -853,6 +893,7 @@ namespace MMAP
             // write data
             fwrite(navData, sizeof(unsigned char), navDataSize, file);
             fclose(file);
+            written = true;
 
             // now that tile is written to disk, we can unload it
             navMesh->removeTile(tileRef, NULL, NULL);
@@ -872,6 +913,8 @@ namespace MMAP
             iv.generateObjFile(mapID, tileX, tileY, meshData);
             iv.writeIV(mapID, tileX, tileY);
         }
+
+        return written;
     }
 
     /**************************************************************************/
@@ -1079,7 +1122,21 @@ namespace MMAP
     }
 
     /**************************************************************************/
-    bool MapBuilder::shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY)
+    bool MapBuilder::shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY, uint64 inputHash)
+    {
+        if (!m_incremental)
+            return isTileFileValid(mapID, tileX, tileY);
+
+        bool hasTile = false;
+        if (!m_manifest.isUpToDate(mapID, tileX, tileY, inputHash, hasTile))
+            return false;
+
+        // unchanged inputs, only built again if its mmtile went missing
+        return !hasTile || isTileFileValid(mapID, tileX, tileY);
+    }
+
+    /**************************************************************************/
+    bool MapBuilder::isTileFileValid(uint32 mapID, uint32 tileX, uint32 tileY)
     {
         char fileName[255];
         sprintf(fileName, "mmaps/%04u%02i%02i.mmtile", mapID, tileY, tileX);
@@ -1102,6 +1159,128 @@ namespace MMAP
         return true;
     }
 
+    /**************************************************************************/
+    void MapBuilder::loadOffMeshInputs()
+    {
+        if (m_offMeshFilePath == NULL)
+            return;
+
+        FILE* fp = fopen(m_offMeshFilePath, "rb");
+        if (!fp)
+            return;
+
+        // same format as TerrainBuilder::loadOffMeshConnections, the lines of a tile are its input
+        char buf[512];
+        while (fgets(buf, sizeof(buf), fp))
+        {
+            float p0[3], p1[3];
+            uint32 mid, tx, ty;
+            float size;
+            if (sscanf(buf, "%u %u,%u (%f %f %f) (%f %f %f) %f", &mid, &tx, &ty,
+                &p0[0], &p0[1], &p0[2], &p1[0], &p1[1], &p1[2], &size) != 10)
+                continue;
+
+            m_offMeshInputs[uint64(mid) << 32 | StaticMapTree::packTileID(tx, ty)].append(buf);
+        }
+
+        fclose(fp);
+    }
+
+    /**************************************************************************/
+    uint64 MapBuilder::getTileInputHash(uint32 mapID, uint32 tileX, uint32 tileY)
+    {
+        uint64 hash = TileManifest::HASH_SEED;
+
+        // build settings and the navmesh parameters written by buildNavMesh
+        uint32 settings[] = { MMAP_VERSION, uint32(DT_NAVMESH_VERSION), uint32(m_bigBaseUnit), uint32(m_terrainBuilder->usesLiquids()) };
+        hash = TileManifest::hash(hash, settings, sizeof(settings));
+        hash = TileManifest::hash(hash, &m_maxWalkableAngle, sizeof(m_maxWalkableAngle));
+        hash = TileManifest::hashFile(hash, Trinity::StringFormat("mmaps/%04u.mmap", mapID));
+
+        // terrain and liquid of the tile and the borders of its neighbours, see TerrainBuilder::loadMap
+        hash = hashMapFile(hash, mapID, tileX, tileY);
+        hash = hashMapFile(hash, mapID, tileX + 1, tileY);
+        hash = hashMapFile(hash, mapID, tileX - 1, tileY);
+        hash = hashMapFile(hash, mapID, tileX, tileY + 1);
+        hash = hashMapFile(hash, mapID, tileX, tileY - 1);
+
+        // model spawns of the tile and the models they place, with the same swapped coordinates as loadVMap
+        VMapManager2* vmapManager = static_cast<VMapManager2*>(VMapFactory::createOrGetVMapManager());
+        std::string vmapTileName = "vmaps/" + StaticMapTree::getTileFileName(mapID, tileY, tileX);
+        if (!boost::filesystem::exists(vmapTileName))
+        {
+            int32 parentMapId = vmapManager->getParentMapId(mapID);
+            if (parentMapId != -1)
+                vmapTileName = "vmaps/" + StaticMapTree::getTileFileName(parentMapId, tileY, tileX);
+        }
+
+        hash = TileManifest::hashFile(hash, vmapTileName);
+        if (FILE* vmapTile = fopen(vmapTileName.c_str(), "rb"))
+        {
+            char chunk[8];
+            uint32 numSpawns = 0;
+            if (fread(chunk, 1, 8, vmapTile) == 8 && memcmp(chunk, VMAP_MAGIC, 8) == 0 && fread(&numSpawns, sizeof(uint32), 1, vmapTile) == 1)
+            {
+                for (uint32 i = 0; i < numSpawns; ++i)
+                {
+                    ModelSpawn spawn;
+                    if (!ModelSpawn::readFromFile(vmapTile, spawn))
+                        break;
+
+                    hash = hashModelFile(hash, spawn.name);
+                }
+            }
+
+            fclose(vmapTile);
+        }
+
+        // off-mesh connections, see TerrainBuilder::loadOffMeshConnections
+        auto offMesh = m_offMeshInputs.find(uint64(mapID) << 32 | StaticMapTree::packTileID(tileX, tileY));
+        if (offMesh != m_offMeshInputs.end())
+            hash = TileManifest::hash(hash, offMesh->second.data(), offMesh->second.size());
+
+        return hash;
+    }
+
+    /**************************************************************************/
+    uint64 MapBuilder::hashMapFile(uint64 hash, uint32 mapID, uint32 tileX, uint32 tileY)
+    {
+        std::string mapFileName = Trinity::StringFormat("maps/%04u_%02u_%02u.map", mapID, tileY, tileX);
+        if (!boost::filesystem::exists(mapFileName))
+        {
+            int32 parentMapId = static_cast<VMapManager2*>(VMapFactory::createOrGetVMapManager())->getParentMapId(mapID);
+            if (parentMapId != -1)
+                mapFileName = Trinity::StringFormat("maps/%04d_%02u_%02u.map", parentMapId, tileY, tileX);
+        }
+
+        return TileManifest::hashFile(hash, mapFileName);
+    }
+
+    /**************************************************************************/
+    uint64 MapBuilder::hashModelFile(uint64 hash, std::string const& name)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_modelHashLock);
+            auto itr = m_modelHashes.find(name);
+            if (itr != m_modelHashes.end())
+                return TileManifest::hash(hash, &itr->second, sizeof(itr->second));
+        }
+
+        // models are shared by many tiles, each file is read once
+        uint64 modelHash = TileManifest::hashFile(TileManifest::HASH_SEED, "vmaps/" + name + ".vmo");
+
+        std::lock_guard<std::mutex> lock(m_modelHashLock);
+        m_modelHashes[name] = modelHash;
+        return TileManifest::hash(hash, &modelHash, sizeof(modelHash));
+    }
+
+    /**************************************************************************/
+    void MapBuilder::printSummary() const
+    {
+        printf("Tiles rebuilt: %u (%u with a navmesh), skipped: %u (%s)\n", uint32(m_tilesBuilt), uint32(m_tilesWritten), uint32(m_tilesSkipped),
+            m_incremental ? "inputs unchanged" : "already built");
+    }
+
     /**************************************************************************/
     uint32 MapBuilder::percentageDone(uint32 totalTiles, uint32 totalTilesBuilt)
     {
@@ -24,10 +24,13 @@
 #include <map>
 #include <list>
 #include <atomic>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
 
 #include "TerrainBuilder.h"
 #include "IntermediateValues.h"
+#include "TileManifest.h"
 
 #include "Recast.h"
 #include "DetourNavMesh.h"
@@ -84,7 +87,8 @@ namespace MMAP
                 bool debugOutput         = false,
                 bool bigBaseUnit         = false,
                 int mapid                = -1,
-                const char* offMeshFilePath = NULL);
+                const char* offMeshFilePath = NULL,
+                bool incremental         = true);
 
             ~MapBuilder();
 
@@ -100,6 +104,9 @@ namespace MMAP
 
             void WorkerThread();
 
+            // prints how many tiles were built and how many were skipped as unchanged
+            void printSummary() const;
+
         private:
             // detect maps and tiles
             void discoverTiles();
@@ -107,10 +114,11 @@ namespace MMAP
 
             void buildNavMesh(uint32 mapID, dtNavMesh* &navMesh);
 
-            void buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh);
+            // returns true if a mmtile was written
+            bool buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh);
 
             // move map building
-            void buildMoveMapTile(uint32 mapID,
+            bool buildMoveMapTile(uint32 mapID,
                 uint32 tileX,
                 uint32 tileY,
                 MeshData &meshData,
@@ -125,7 +133,14 @@ namespace MMAP
 
             bool shouldSkipMap(uint32 mapID);
             bool isTransportMap(uint32 mapID);
-            bool shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY);
+            bool shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY, uint64 inputHash);
+            bool isTileFileValid(uint32 mapID, uint32 tileX, uint32 tileY);
+
+            // incremental builds
+            void loadOffMeshInputs();
+            uint64 getTileInputHash(uint32 mapID, uint32 tileX, uint32 tileY);
+            uint64 hashMapFile(uint64 hash, uint32 mapID, uint32 tileX, uint32 tileY);
+            uint64 hashModelFile(uint64 hash, std::string const& name);
 
             uint32 percentageDone(uint32 totalTiles, uint32 totalTilesDone);
 
@@ -147,6 +162,15 @@ namespace MMAP
             std::atomic<uint32> m_totalTiles;
             std::atomic<uint32> m_totalTilesProcessed;
 
+            bool m_incremental;
+            TileManifest m_manifest;
+            std::unordered_map<uint64, std::string> m_offMeshInputs;   // off-mesh lines of each map tile
+            std::unordered_map<std::string, uint64> m_modelHashes;
+            std::mutex m_modelHashLock;
+            std::atomic<uint32> m_tilesBuilt;
+            std::atomic<uint32> m_tilesWritten;
+            std::atomic<uint32> m_tilesSkipped;
+
             // build performance - not really used for now
             rcContext* m_rcContext;
 
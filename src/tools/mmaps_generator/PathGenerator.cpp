@@ -99,7 +99,8 @@ bool handleArgs(int argc, char** argv,
                bool &bigBaseUnit,
                char* &offMeshInputPath,
                char* &file,
-               unsigned int& threads)
+               unsigned int& threads,
+               bool &incremental)
 {
     char* param = NULL;
     for (int i = 1; i < argc; ++i)
@@ -234,6 +235,19 @@ bool handleArgs(int argc, char** argv,
             else
                 printf("invalid option for '--bigBaseUnit', using default false\n");
         }
+        else if (strcmp(argv[i], "--incremental") == 0)
+        {
+            param = argv[++i];
+            if (!param)
+                return false;
+
+            if (strcmp(param, "true") == 0)
+                incremental = true;
+            else if (strcmp(param, "false") == 0)
+                incremental = false;
+            else
+                printf("invalid option for '--incremental', using default true\n");
+        }
         else if (strcmp(argv[i], "--offMeshInput") == 0)
         {
             param = argv[++i];
@@ -316,14 +330,15 @@ int main(int argc, char** argv)
          skipBattlegrounds = false,
          debugOutput = false,
          silent = false,
-         bigBaseUnit = false;
+         bigBaseUnit = false,
+         incremental = true;
     char* offMeshInputPath = NULL;
     char* file = NULL;
 
     bool validParam = handleArgs(argc, argv, mapnum,
                                  tileX, tileY, maxAngle,
                                  skipLiquid, skipContinents, skipJunkMaps, skipBattlegrounds,
-                                 debugOutput, silent, bigBaseUnit, offMeshInputPath, file, threads);
+                                 debugOutput, silent, bigBaseUnit, offMeshInputPath, file, threads, incremental);
 
     if (!validParam)
         return silent ? -1 : finish("You have specified invalid parameters", -1);
@@ -360,7 +375,7 @@ int main(int argc, char** argv)
     };
 
     MapBuilder builder(maxAngle, skipLiquid, skipContinents, skipJunkMaps,
-                       skipBattlegrounds, debugOutput, bigBaseUnit, mapnum, offMeshInputPath);
+                       skipBattlegrounds, debugOutput, bigBaseUnit, mapnum, offMeshInputPath, incremental);
 
     uint32 start = getMSTime();
     if (file)
@@ -375,6 +390,10 @@ int main(int argc, char** argv)
     VMAP::VMapFactory::clear();
 
     if (!silent)
+    {
+        if (!file)
+            builder.printSummary();
         printf("Finished. MMAPS were built in %u ms!\n", GetMSTimeDiffToNow(start));
+    }
     return 0;
 }
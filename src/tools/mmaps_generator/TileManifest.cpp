@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TileManifest.h"
+#include <cinttypes>
+#include <cstdio>
+#include <map>
+
+namespace MMAP
+{
+    TileManifest::TileManifest(std::string const& fileName) : m_fileName(fileName)
+    {
+    }
+
+    void TileManifest::load()
+    {
+        FILE* file = fopen(m_fileName.c_str(), "r");
+        if (!file)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        char line[128];
+        while (fgets(line, sizeof(line), file))
+        {
+            uint32 mapID, tileX, tileY, hasTile;
+            uint64 inputHash;
+            if (sscanf(line, "%u %u %u %" SCNx64 " %u", &mapID, &tileX, &tileY, &inputHash, &hasTile) != 5)
+                continue;
+
+            m_entries[makeKey(mapID, tileX, tileY)] = { inputHash, hasTile != 0 };
+        }
+
+        fclose(file);
+        printf("Loaded %u tile hashes from %s\n", uint32(m_entries.size()), m_fileName.c_str());
+    }
+
+    void TileManifest::save() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        // written under a temporary name first, an interrupted run keeps the previous manifest
+        std::string tempFileName = m_fileName + ".tmp";
+        FILE* file = fopen(tempFileName.c_str(), "w");
+        if (!file)
+        {
+            printf("Failed to open %s for writing!\n", tempFileName.c_str());
+            return;
+        }
+
+        // sorted so the file diffs nicely between runs
+        std::map<uint64, Entry> entries(m_entries.begin(), m_entries.end());
+        fprintf(file, "# mapId tileX tileY inputHash hasTile\n");
+        for (auto const& entry : entries)
+            fprintf(file, "%04u %02u %02u %016" PRIx64 " %u\n", uint32(entry.first >> 32), uint32(entry.first >> 16) & 0xFFFF, uint32(entry.first) & 0xFFFF,
+                entry.second.inputHash, entry.second.hasTile ? 1 : 0);
+
+        fclose(file);
+
+        remove(m_fileName.c_str());
+        if (rename(tempFileName.c_str(), m_fileName.c_str()) != 0)
+            printf("Failed to replace %s!\n", m_fileName.c_str());
+    }
+
+    bool TileManifest::isUpToDate(uint32 mapID, uint32 tileX, uint32 tileY, uint64 inputHash, bool& hasTile) const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        auto itr = m_entries.find(makeKey(mapID, tileX, tileY));
+        if (itr == m_entries.end() || itr->second.inputHash != inputHash)
+            return false;
+
+        hasTile = itr->second.hasTile;
+        return true;
+    }
+
+    void TileManifest::update(uint32 mapID, uint32 tileX, uint32 tileY, uint64 inputHash, bool hasTile)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_entries[makeKey(mapID, tileX, tileY)] = { inputHash, hasTile };
+    }
+
+    uint64 TileManifest::hash(uint64 hash, void const* data, std::size_t size)
+    {
+        uint8 const* bytes = static_cast<uint8 const*>(data);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= UI64LIT(0x100000001B3);
+        }
+
+        return hash;
+    }
+
+    uint64 TileManifest::hashFile(uint64 hash, std::string const& fileName)
+    {
+        FILE* file = fopen(fileName.c_str(), "rb");
+        if (!file)
+            return TileManifest::hash(hash, "missing", 7);
+
+        hash = TileManifest::hash(hash, "file", 4);
+
+        uint8 buffer[64 * 1024];
+        std::size_t read;
+        while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+            hash = TileManifest::hash(hash, buffer, read);
+
+        fclose(file);
+        return hash;
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MMAP_TILE_MANIFEST_H
+#define _MMAP_TILE_MANIFEST_H
+
+#include "Define.h"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace MMAP
+{
+    /**
+    Remembers a hash of everything a tile was built from (terrain, liquid, vmap models,
+    off-mesh connections and build settings). A tile whose inputs still hash the same
+    and whose output is still on disk does not have to be built again.
+    */
+    class TileManifest
+    {
+        public:
+            explicit TileManifest(std::string const& fileName);
+
+            void load();
+            void save() const;
+
+            /// true when the tile was built from the same inputs, hasTile tells whether a mmtile was written for it
+            bool isUpToDate(uint32 mapID, uint32 tileX, uint32 tileY, uint64 inputHash, bool& hasTile) const;
+            void update(uint32 mapID, uint32 tileX, uint32 tileY, uint64 inputHash, bool hasTile);
+
+            // 64 bit FNV-1a
+            static uint64 hash(uint64 hash, void const* data, std::size_t size);
+            /// missing files hash differently from empty ones
+            static uint64 hashFile(uint64 hash, std::string const& fileName);
+
+            static uint64 const HASH_SEED = UI64LIT(0xCBF29CE484222325);
+
+        private:
+            struct Entry
+            {
+                uint64 inputHash;
+                bool hasTile;
+            };
+
+            static uint64 makeKey(uint32 mapID, uint32 tileX, uint32 tileY) { return uint64(mapID) << 32 | tileX << 16 | tileY; }
+
+            std::string m_fileName;
+            std::unordered_map<uint64, Entry> m_entries;
+            mutable std::mutex m_lock;
+    };
+}
+
+#endif
@@ -0,0 +1,325 @@
+/*
+ * Copyright (C) 2008-2018 TrinityCore <https://www.trinitycore.org/>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Replays the proc events of a simulated fight against the auras of one unit and compares the
+// previous candidate selection of Unit::ProcDamageAndSpellFor (walk every applied aura) with the
+// ProcAuraBuckets lookup, once with fresh candidate lists per event and once with reused ones.
+
+#include "Banner.h"
+#include "Define.h"
+#include "ProcAuraBuckets.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // ProcFlags from SpellMgr.h, which can not be included without the game library
+    enum BenchProcFlags : uint32
+    {
+        BENCH_PROC_FLAG_KILL                          = 0x00000002,
+        BENCH_PROC_FLAG_DONE_MELEE_AUTO_ATTACK        = 0x00000004,
+        BENCH_PROC_FLAG_TAKEN_MELEE_AUTO_ATTACK       = 0x00000008,
+        BENCH_PROC_FLAG_DONE_SPELL_MELEE_DMG_CLASS    = 0x00000010,
+        BENCH_PROC_FLAG_TAKEN_SPELL_MELEE_DMG_CLASS   = 0x00000020,
+        BENCH_PROC_FLAG_DONE_RANGED_AUTO_ATTACK       = 0x00000040,
+        BENCH_PROC_FLAG_TAKEN_RANGED_AUTO_ATTACK      = 0x00000080,
+        BENCH_PROC_FLAG_DONE_SPELL_RANGED_DMG_CLASS   = 0x00000100,
+        BENCH_PROC_FLAG_TAKEN_SPELL_RANGED_DMG_CLASS  = 0x00000200,
+        BENCH_PROC_FLAG_DONE_SPELL_MAGIC_DMG_CLASS_POS = 0x00004000,
+        BENCH_PROC_FLAG_DONE_SPELL_MAGIC_DMG_CLASS_NEG = 0x00010000,
+        BENCH_PROC_FLAG_TAKEN_SPELL_MAGIC_DMG_CLASS_NEG = 0x00020000,
+        BENCH_PROC_FLAG_DONE_PERIODIC                 = 0x00040000,
+        BENCH_PROC_FLAG_TAKEN_PERIODIC                = 0x00080000,
+        BENCH_PROC_FLAG_TAKEN_DAMAGE                  = 0x00100000,
+        BENCH_PROC_FLAG_DONE_MAINHAND_ATTACK          = 0x00400000,
+        BENCH_PROC_FLAG_DONE_OFFHAND_ATTACK           = 0x00800000,
+
+        BENCH_MELEE_PROC_FLAG_MASK                    = 0x00C0003C,
+        BENCH_RANGED_PROC_FLAG_MASK                   = 0x000003C0,
+        BENCH_SPELL_PROC_FLAG_MASK                    = 0x2003FF30,
+        BENCH_PERIODIC_PROC_FLAG_MASK                 = 0x000C0000
+    };
+
+    // same split as ProcAuraClassMask in Unit.cpp
+    uint32 const BenchClassMask[MAX_PROC_AURA_CLASS] =
+    {
+        BENCH_MELEE_PROC_FLAG_MASK,
+        BENCH_RANGED_PROC_FLAG_MASK,
+        BENCH_SPELL_PROC_FLAG_MASK & ~(BENCH_MELEE_PROC_FLAG_MASK | BENCH_RANGED_PROC_FLAG_MASK),
+        BENCH_PERIODIC_PROC_FLAG_MASK,
+        BENCH_PROC_FLAG_TAKEN_DAMAGE,
+        ~(BENCH_MELEE_PROC_FLAG_MASK | BENCH_RANGED_PROC_FLAG_MASK | BENCH_SPELL_PROC_FLAG_MASK | BENCH_PERIODIC_PROC_FLAG_MASK | BENCH_PROC_FLAG_TAKEN_DAMAGE)
+    };
+
+    struct BenchConfig
+    {
+        uint32 Auras = 80;          // applied auras of the unit, buffs, debuffs, talents and item auras
+        uint32 ProcPercent = 25;    // share of them that can proc
+        uint32 Events = 1000000;
+        uint32 ChurnEvery = 20;     // one aura removed and another applied every this many events
+        uint32 Seed = 1;
+    };
+
+    struct BenchApplication
+    {
+        uint32 Serial;              // creation order, the same in every run
+        uint32 SpellId;
+        bool IsProcAura;
+        uint32 ProcFlags;
+    };
+
+    typedef std::shared_ptr<BenchApplication> BenchApplicationPtr;
+    typedef std::multimap<uint32, BenchApplicationPtr> BenchAuraMap;
+    typedef ProcAuraBuckets<BenchApplicationPtr> BenchBuckets;
+
+    // proc flags of a proc aura, most react to one kind of hit, some to a couple
+    uint32 const AuraProcFlags[] =
+    {
+        BENCH_PROC_FLAG_DONE_MELEE_AUTO_ATTACK | BENCH_PROC_FLAG_DONE_SPELL_MELEE_DMG_CLASS,
+        BENCH_PROC_FLAG_DONE_MELEE_AUTO_ATTACK,
+        BENCH_PROC_FLAG_DONE_MAINHAND_ATTACK | BENCH_PROC_FLAG_DONE_OFFHAND_ATTACK,
+        BENCH_PROC_FLAG_TAKEN_MELEE_AUTO_ATTACK | BENCH_PROC_FLAG_TAKEN_SPELL_MELEE_DMG_CLASS,
+        BENCH_PROC_FLAG_DONE_RANGED_AUTO_ATTACK | BENCH_PROC_FLAG_DONE_SPELL_RANGED_DMG_CLASS,
+        BENCH_PROC_FLAG_DONE_SPELL_MAGIC_DMG_CLASS_NEG,
+        BENCH_PROC_FLAG_DONE_SPELL_MAGIC_DMG_CLASS_POS,
+        BENCH_PROC_FLAG_DONE_SPELL_MAGIC_DMG_CLASS_NEG | BENCH_PROC_FLAG_DONE_PERIODIC,
+        BENCH_PROC_FLAG_TAKEN_SPELL_MAGIC_DMG_CLASS_NEG | BENCH_PROC_FLAG_TAKEN_DAMAGE,
+        BENCH_PROC_FLAG_TAKEN_DAMAGE,
+        BENCH_PROC_FLAG_KILL
+    };
+
+    // proc flags of the events, weighted like a melee fight with a caster on the side
+    struct EventWeight
+    {
+        uint32 ProcFlag;
+        uint32 Weight;
+    };
+
+    EventWeight const EventMix[] =
+    {
+        { BENCH_PROC_FLAG_DONE_MELEE_AUTO_ATTACK | BENCH_PROC_FLAG_DONE_MAINHAND_ATTACK, 30 },
+        { BENCH_PROC_FLAG_TAKEN_MELEE_AUTO_ATTACK | BENCH_PROC_FLAG_TAKEN_DAMAGE, 20 },
+        { BENCH_PROC_FLAG_DONE_SPELL_MELEE_DMG_CLASS | BENCH_PROC_FLAG_DONE_MAINHAND_ATTACK, 10 },
+        { BENCH_PROC_FLAG_DONE_SPELL_MAGIC_DMG_CLASS_NEG, 10 },
+        { BENCH_PROC_FLAG_TAKEN_SPELL_MAGIC_DMG_CLASS_NEG | BENCH_PROC_FLAG_TAKEN_DAMAGE, 5 },
+        { BENCH_PROC_FLAG_DONE_PERIODIC, 15 },
+        { BENCH_PROC_FLAG_TAKEN_PERIODIC | BENCH_PROC_FLAG_TAKEN_DAMAGE, 9 },
+        { BENCH_PROC_FLAG_KILL, 1 }
+    };
+
+    struct BenchResult
+    {
+        double Ms = 0.0;
+        uint64 Candidates = 0;
+        uint64 Checksum = 0;        // order sensitive hash of every candidate list
+    };
+
+    typedef std::chrono::steady_clock Clock;
+
+    double ElapsedMs(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    BenchApplicationPtr CreateApplication(std::mt19937& rng, BenchConfig const& config, uint32 serial)
+    {
+        std::uniform_int_distribution<uint32> spellId(1, 300000);
+        std::uniform_int_distribution<uint32> percent(0, 99);
+        std::uniform_int_distribution<uint32> procFlags(0, sizeof(AuraProcFlags) / sizeof(AuraProcFlags[0]) - 1);
+
+        BenchApplicationPtr app = std::make_shared<BenchApplication>();
+        app->Serial = serial;
+        app->SpellId = spellId(rng);
+        app->IsProcAura = percent(rng) < config.ProcPercent;
+        app->ProcFlags = app->IsProcAura ? AuraProcFlags[procFlags(rng)] : 0;
+        return app;
+    }
+
+    std::vector<uint32> CreateEvents(BenchConfig const& config)
+    {
+        std::vector<uint32> weighted;
+        for (EventWeight const& event : EventMix)
+            weighted.insert(weighted.end(), event.Weight, event.ProcFlag);
+
+        std::mt19937 rng(config.Seed * 7919);
+        std::uniform_int_distribution<std::size_t> pick(0, weighted.size() - 1);
+        std::vector<uint32> events(config.Events);
+        for (uint32& procFlag : events)
+            procFlag = weighted[pick(rng)];
+
+        return events;
+    }
+
+    void Accumulate(BenchResult& result, uint32 spellId, BenchApplication const* app)
+    {
+        ++result.Candidates;
+        result.Checksum = result.Checksum * 1000003 + uint64(spellId) * 31 + app->Serial;
+    }
+
+    // Select runs one proc event, it gets the applied auras and the buckets of the unit
+    template<class Select>
+    BenchResult Run(BenchConfig const& config, std::vector<uint32> const& events, Select&& select)
+    {
+        BenchResult result;
+
+        // every run applies the same auras in the same order, so the lists of all runs must match
+        std::mt19937 rng(config.Seed);
+        BenchAuraMap applied;
+        BenchBuckets buckets(BenchClassMask);
+        std::vector<BenchApplicationPtr> owned;
+        uint32 serial = 0;
+        auto apply = [&](BenchApplicationPtr const& app)
+        {
+            applied.insert(std::make_pair(app->SpellId, app));
+            if (app->IsProcAura)
+                buckets.Add(app->SpellId, app->ProcFlags, app);
+            owned.push_back(app);
+        };
+
+        for (uint32 i = 0; i < config.Auras; ++i)
+            apply(CreateApplication(rng, config, ++serial));
+
+        Clock::time_point start = Clock::now();
+        for (std::size_t i = 0; i < events.size(); ++i)
+        {
+            if (config.ChurnEvery && i % config.ChurnEvery == config.ChurnEvery - 1 && !owned.empty())
+            {
+                std::size_t index = std::uniform_int_distribution<std::size_t>(0, owned.size() - 1)(rng);
+                BenchApplicationPtr app = owned[index];
+                owned[index] = owned.back();
+                owned.pop_back();
+
+                auto range = applied.equal_range(app->SpellId);
+                for (auto itr = range.first; itr != range.second; ++itr)
+                {
+                    if (itr->second == app)
+                    {
+                        applied.erase(itr);
+                        break;
+                    }
+                }
+                buckets.Remove(app->SpellId, app.get());
+                apply(CreateApplication(rng, config, ++serial));
+            }
+
+            select(applied, buckets, events[i], result);
+        }
+
+        result.Ms = ElapsedMs(start);
+        return result;
+    }
+
+    void PrintUsage(char const* program)
+    {
+        std::cout << "usage: " << program << " [options]" << std::endl
+            << "  -a <auras>          applied auras of the unit (default 80)" << std::endl
+            << "  -p <percent>        share of proc capable auras (default 25)" << std::endl
+            << "  -e <events>         proc events to replay (default 1000000)" << std::endl
+            << "  -c <events>         events between two aura changes, 0 for none (default 20)" << std::endl
+            << "  -s <seed>           scene seed (default 1)" << std::endl;
+    }
+
+    void PrintResult(char const* name, BenchConfig const& config, BenchResult const& result)
+    {
+        printf("%-10s %12.0f %10.1f %12.2f\n", name,
+            result.Ms > 0.0 ? config.Events / result.Ms * 1000.0 : 0.0,
+            result.Ms > 0.0 ? result.Ms * 1000000.0 / config.Events : 0.0,
+            double(result.Candidates) / config.Events);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Trinity::Banner::Show("Proc aura benchmark", [](char const* text) { std::cout << text << std::endl; }, nullptr);
+
+    BenchConfig config;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "-a") && i + 1 < argc)
+            config.Auras = uint32(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-p") && i + 1 < argc)
+            config.ProcPercent = uint32(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-e") && i + 1 < argc)
+            config.Events = uint32(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-c") && i + 1 < argc)
+            config.ChurnEvery = uint32(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-s") && i + 1 < argc)
+            config.Seed = uint32(atoi(argv[++i]));
+        else
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!config.Events || config.ProcPercent > 100)
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    printf("%u auras, %u%% proc capable, %u events, an aura change every %u events\n\n", config.Auras, config.ProcPercent, config.Events, config.ChurnEvery);
+
+    std::vector<uint32> events = CreateEvents(config);
+
+    // previous selection, every applied aura is looked at and the flags of the proc ones are checked
+    BenchResult scan = Run(config, events, [](BenchAuraMap const& applied, BenchBuckets const& /*buckets*/, uint32 procFlag, BenchResult& result)
+    {
+        for (BenchAuraMap::const_iterator itr = applied.begin(); itr != applied.end(); ++itr)
+            if (itr->second->IsProcAura && itr->second->ProcFlags & procFlag)
+                Accumulate(result, itr->first, itr->second.get());
+    });
+
+    BenchResult alloc = Run(config, events, [](BenchAuraMap const& /*applied*/, BenchBuckets const& buckets, uint32 procFlag, BenchResult& result)
+    {
+        BenchBuckets::CandidateList candidates;
+        BenchBuckets::AuraList auras;
+        buckets.Collect(procFlag, candidates, auras);
+        for (auto const& aura : auras)
+            Accumulate(result, aura.first, aura.second.get());
+    });
+
+    // what ProcDamageAndSpellFor does, the lists keep their capacity between events
+    BenchBuckets::CandidateList candidates;
+    BenchBuckets::AuraList auras;
+    BenchResult reuse = Run(config, events, [&candidates, &auras](BenchAuraMap const& /*applied*/, BenchBuckets const& buckets, uint32 procFlag, BenchResult& result)
+    {
+        buckets.Collect(procFlag, candidates, auras);
+        for (auto const& aura : auras)
+            Accumulate(result, aura.first, aura.second.get());
+        candidates.clear();
+        auras.clear();
+    });
+
+    printf("%-10s %12s %10s %12s\n", "selection", "events/s", "ns/event", "candidates");
+    PrintResult("scan", config, scan);
+    PrintResult("alloc", config, alloc);
+    PrintResult("reuse", config, reuse);
+
+    bool identical = alloc.Candidates == scan.Candidates && alloc.Checksum == scan.Checksum
+        && reuse.Candidates == scan.Candidates && reuse.Checksum == scan.Checksum;
+
+    printf("\n%s\n", identical ? "identical candidate lists" : "candidate lists differ");
+    return identical ? 0 : 2;
+}
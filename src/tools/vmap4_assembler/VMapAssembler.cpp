@@ -16,8 +16,12 @@
  * with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <string>
 #include <iostream>
+#include <thread>
 
 #include "TileAssembler.h"
 #include "Banner.h"
@@ -28,23 +32,25 @@ int main(int argc, char* argv[])
 
     std::string src = "Buildings";
     std::string dest = "vmaps";
+    unsigned int threads = std::max(std::thread::hardware_concurrency(), 1u);
 
-    if (argc > 3)
+    int positional = 0;
+    for (int i = 1; i < argc; ++i)
     {
-        std::cout << "usage: " << argv[0] << " <raw data dir> <vmap dest dir>" << std::endl;
-        return 1;
-    }
-    else
-    {
-        if (argc > 1)
-            src = argv[1];
-        if (argc > 2)
-            dest = argv[2];
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = static_cast<unsigned int>(std::max(1, atoi(argv[++i])));
+        else if (positional < 2)
+            (positional++ == 0 ? src : dest) = argv[i];
+        else
+        {
+            std::cout << "usage: " << argv[0] << " <raw data dir> <vmap dest dir> [--threads <count>]" << std::endl;
+            return 1;
+        }
     }
 
-    std::cout << "using " << src << " as source directory and writing output to " << dest << std::endl;
+    std::cout << "using " << src << " as source directory and writing output to " << dest << " with " << threads << " threads" << std::endl;
 
-    VMAP::TileAssembler* ta = new VMAP::TileAssembler(src, dest);
+    VMAP::TileAssembler* ta = new VMAP::TileAssembler(src, dest, threads);
 
     if (!ta->convertWorld2())
     {